@@ -26,6 +26,7 @@
 
 
 #include <orea/app/oreapp.hpp>
+#include <orea/app/oreserver.hpp>
 
 #include <orea/app/initbuilders.hpp>
 
@@ -66,14 +67,31 @@ int main(int argc, char** argv) {
         exit(0);
     }
 
-    if (argc != 2) {
-        std::cout << endl << "usage: ORE path/to/ore.xml" << endl << endl;
+    bool server = argc == 3 && string(argv[1]) == "--server";
+
+    if (argc != 2 && !server) {
+        std::cout << endl << "usage: ORE path/to/ore.xml" << endl;
+        std::cout << "       ORE --server path/to/ore.xml" << endl << endl;
         return -1;
     }
 
     ore::analytics::initBuilders();
 
-    string inputFile(argv[1]);
+    string inputFile(argv[server ? 2 : 1]);
+
+    if (server) {
+        // serve requests from stdin, the responses are written to stdout
+        try {
+            auto params = QuantLib::ext::make_shared<Parameters>();
+            params->fromFile(inputFile);
+            OREServer oreServer(params);
+            oreServer.serve(std::cin, std::cout);
+            return 0;
+        } catch (const exception& e) {
+            cout << "ERROR " << e.what() << endl;
+            return -1;
+        }
+    }
 
     try {
         auto params = QuantLib::ext::make_shared<Parameters>();
@@ -336,8 +336,8 @@ def match_sensi_reports(ore1, ore2, deltaHeader1, deltaHeader2, debug=False):
             print("%-25s %-45s %10s %10.2f %10s %10s" % (trade1[i], factor1[i], currency1[i], delta1[i], "----", "----"))
 
 def match_scenario_reports(ore1, ore2, debug=False):
-    sensi1 = ore1.getReport("xvacg-cva-sensi-scenario")
-    sensi2 = ore2.getReport("xvacg-cva-sensi-scenario")
+    sensi1 = ore1.getReport("xvacg-xva-sensi-scenario")
+    sensi2 = ore2.getReport("xvacg-xva-sensi-scenario")
 
     if (debug == True):
         print("ORE 1:")
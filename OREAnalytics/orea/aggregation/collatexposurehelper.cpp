@@ -19,6 +19,10 @@
 #include <orea/aggregation/collatexposurehelper.hpp>
 #include <ql/errors.hpp>
 
+#include <exception>
+#include <string>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -152,6 +156,12 @@ Real CollateralExposureHelper::estimateUncollatValue(const Date& simulationDate,
     return newPv;
 }
 
+template Real CollateralExposureHelper::estimateUncollatValue<Real>(const Date& simulationDate, const Real& npv_t0,
+                                                                    const Date& date_t0,
+                                                                    const vector<vector<Real>>& scenPvProfiles,
+                                                                    const unsigned& scenIndex,
+                                                                    const vector<Date>& dateGrid);
+
 void CollateralExposureHelper::updateMarginCall(const QuantLib::ext::shared_ptr<CollateralAccount>& collat,
                                                 const Real& uncollatValue, const Date& simulationDate,
                                                 const Real& annualisedZeroRate, const CalculationType& calcType,
@@ -186,12 +196,93 @@ void CollateralExposureHelper::updateMarginCall(const QuantLib::ext::shared_ptr<
     }
 }
 
+namespace {
+
+// position of a simulation date on the exposure grid, i1 = null refers to the t0 value, i2 = null means no interpolation
+struct GridPosition {
+    Size i1 = Null<Size>();
+    Size i2 = Null<Size>();
+    Real weight = 0.0;
+};
+
+// scenario independent part of CollateralExposureHelper::estimateUncollatValue()
+GridPosition gridPosition(const Date& simulationDate, const Date& date_t0, const vector<Date>& dateGrid) {
+
+    QL_REQUIRE(simulationDate >= date_t0, "CollatExposureHelper error: simulation date < start date");
+    QL_REQUIRE(dateGrid[0] >= date_t0, "CollatExposureHelper error: cube dateGrid starts before t0");
+
+    GridPosition pos;
+    if (simulationDate >= dateGrid.back()) {
+        pos.i1 = dateGrid.size() - 1; // flat extrapolation
+        return pos;
+    }
+    if (simulationDate == date_t0)
+        return pos;
+    for (Size i = 0; i < dateGrid.size(); i++) {
+        if (dateGrid[i] == simulationDate) {
+            pos.i1 = i;
+            return pos;
+        }
+#ifdef FLAT_INTERPOLATION
+        else if (simulationDate < dateGrid.front()) {
+            pos.i1 = 0;
+            return pos;
+        } else if (i < dateGrid.size() - 1 && simulationDate > dateGrid[i] && simulationDate < dateGrid[i + 1]) {
+            pos.i1 = i + 1;
+            return pos;
+        }
+#endif
+    }
+
+    Date t1, t2;
+    if (simulationDate <= dateGrid[0]) {
+        t1 = date_t0;
+        t2 = dateGrid[0];
+        pos.i2 = 0;
+    } else {
+        vector<Date>::const_iterator it = lower_bound(dateGrid.begin(), dateGrid.end(), simulationDate);
+        QL_REQUIRE(it != dateGrid.end(), "CollatExposureHelper error; "
+                                             << "date interpolation points not found (it.end())");
+        QL_REQUIRE(it != dateGrid.begin(), "CollatExposureHelper error; "
+                                               << "date interpolation points not found (it.begin())");
+        pos.i1 = (it - 1) - dateGrid.begin();
+        pos.i2 = it - dateGrid.begin();
+        t1 = dateGrid[pos.i1];
+        t2 = dateGrid[pos.i2];
+    }
+    pos.weight = double(simulationDate - t1) / double(t2 - t1);
+    return pos;
+}
+
+Real valueAt(const GridPosition& pos, const Real value_t0, const vector<vector<Real>>& values, const Size scenIndex) {
+    Real v1 = pos.i1 == Null<Size>() ? value_t0 : values[pos.i1][scenIndex];
+    if (pos.i2 == Null<Size>())
+        return v1;
+    Real v2 = values[pos.i2][scenIndex];
+    Real v = v1 + ((v2 - v1) * pos.weight);
+    QL_REQUIRE((v1 <= v && v <= v2) || (v1 >= v && v >= v2),
+               "CollatExposureHelper error; "
+                   << "interpolated value " << v << " out of range (" << v1 << " " << v2 << ") "
+                   << "for interpolation weight " << pos.weight << " between grid points "
+                   << (pos.i1 == Null<Size>() ? std::string("t0") : std::to_string(pos.i1)) << " and " << pos.i2);
+    return v;
+}
+
+struct MarginCallDate {
+    Date date;
+    bool eligMarginReqDateUs;
+    bool eligMarginReqDateCtp;
+    GridPosition gridPosition;
+};
+
+} // namespace
+
 QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> CollateralExposureHelper::collateralBalancePaths(
     const QuantLib::ext::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
     const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
     const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
     const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType,
-    const QuantLib::ext::shared_ptr<CollateralBalance>& balance) {
+    const QuantLib::ext::shared_ptr<CollateralBalance>& balance, const Size nThreads) {
 
     try {
         // step 1; build a collateral account object, assuming t0 VM balance from the balance object (zero balance if missing),
@@ -217,45 +308,76 @@ QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
         CollateralAccount baseAcc(csaDef, bal_t0, date_t0);
         DLOG("base current collateral balance: " << bal_t0 << ", " << baseAcc.accountBalance());
 
-        // step 3; build an empty container for the return value(s)
-        QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> scenarioCollatPaths(
-            new vector<QuantLib::ext::shared_ptr<CollateralAccount>>());
-
-        // step 4; start loop over scenarios
+        // step 3; set up the margin call dates and their position on the exposure grid, these are the same for
+        //         all scenarios
         Size numScenarios = nettingSetValues.front().size();
         QL_REQUIRE(numScenarios == csaFxScenarioRates.front().size(), "netting values -v- scenario FX rate mismatch");
         Date simEndDate = std::min(nettingSet_maturity, dateGrid.back()) + csaDef->csaDetails()->marginPeriodOfRisk();
-        for (unsigned i = 0; i < numScenarios; i++) {
-            QuantLib::ext::shared_ptr<CollateralAccount> collat(new CollateralAccount(baseAcc));
-            Date tmpDate = date_t0; // the date which gets evolved
-            Date nextMarginReqDateUs = date_t0;
-            Date nextMarginReqDateCtp = date_t0;
-            while (tmpDate <= simEndDate) {
-                QL_REQUIRE(tmpDate <= nextMarginReqDateUs && tmpDate <= nextMarginReqDateCtp &&
-                               (tmpDate == nextMarginReqDateUs || tmpDate == nextMarginReqDateCtp),
-                           "collateral balance path generation error; invalid time stepping");
-                bool eligMarginReqDateUs = tmpDate == nextMarginReqDateUs ? true : false;
-                bool eligMarginReqDateCtp = tmpDate == nextMarginReqDateCtp ? true : false;
-                Real uncollatVal = estimateUncollatValue(tmpDate, nettingSetPv, date_t0, nettingSetValues, i, dateGrid);
-                Real fxValue = estimateUncollatValue(tmpDate, csaFxTodayRate, date_t0, csaFxScenarioRates, i, dateGrid);
-                Real annualisedZeroRate =
-                    estimateUncollatValue(tmpDate, csaTodayCollatCurve, date_t0, csaScenCollatCurves, i, dateGrid);
-                uncollatVal /= fxValue;
-                updateMarginCall(collat, uncollatVal, tmpDate, annualisedZeroRate, calcType, eligMarginReqDateUs,
-                                 eligMarginReqDateCtp);
-
-                if (nextMarginReqDateUs == tmpDate)
-                    nextMarginReqDateUs = tmpDate + collat->csaDef()->csaDetails()->marginCallFrequency();
-                if (nextMarginReqDateCtp == tmpDate)
-                    nextMarginReqDateCtp = tmpDate + collat->csaDef()->csaDetails()->marginPostFrequency();
-                tmpDate = std::min(nextMarginReqDateUs, nextMarginReqDateCtp);
+        vector<MarginCallDate> marginCallDates;
+        Date tmpDate = date_t0; // the date which gets evolved
+        Date nextMarginReqDateUs = date_t0;
+        Date nextMarginReqDateCtp = date_t0;
+        while (tmpDate <= simEndDate) {
+            QL_REQUIRE(tmpDate <= nextMarginReqDateUs && tmpDate <= nextMarginReqDateCtp &&
+                           (tmpDate == nextMarginReqDateUs || tmpDate == nextMarginReqDateCtp),
+                       "collateral balance path generation error; invalid time stepping");
+            marginCallDates.push_back({tmpDate, tmpDate == nextMarginReqDateUs, tmpDate == nextMarginReqDateCtp,
+                                       gridPosition(tmpDate, date_t0, dateGrid)});
+            if (nextMarginReqDateUs == tmpDate)
+                nextMarginReqDateUs = tmpDate + csaDef->csaDetails()->marginCallFrequency();
+            if (nextMarginReqDateCtp == tmpDate)
+                nextMarginReqDateCtp = tmpDate + csaDef->csaDetails()->marginPostFrequency();
+            tmpDate = std::min(nextMarginReqDateUs, nextMarginReqDateCtp);
+        }
+        QL_REQUIRE(tmpDate > simEndDate, "collateral balance path generation error; while loop terminated too early. ("
+                                             << tmpDate << ", " << simEndDate << ")");
+
+        // step 4; evolve the collateral account along the margin call dates for each scenario
+        QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> scenarioCollatPaths(
+            new vector<QuantLib::ext::shared_ptr<CollateralAccount>>(numScenarios));
+
+        auto simulatePaths = [&](const Size first, const Size last) {
+            for (Size i = first; i < last; i++) {
+                QuantLib::ext::shared_ptr<CollateralAccount> collat(new CollateralAccount(baseAcc));
+                for (auto const& d : marginCallDates) {
+                    Real uncollatVal = valueAt(d.gridPosition, nettingSetPv, nettingSetValues, i);
+                    Real fxValue = valueAt(d.gridPosition, csaFxTodayRate, csaFxScenarioRates, i);
+                    Real annualisedZeroRate = valueAt(d.gridPosition, csaTodayCollatCurve, csaScenCollatCurves, i);
+                    uncollatVal /= fxValue;
+                    updateMarginCall(collat, uncollatVal, d.date, annualisedZeroRate, calcType,
+                                     d.eligMarginReqDateUs, d.eligMarginReqDateCtp);
+                }
+                // set account balance to zero after maturity of portfolio
+                collat->closeAccount(simEndDate + Period(1, Days));
+                (*scenarioCollatPaths)[i] = collat;
+            }
+        };
+
+        Size effThreads = std::max<Size>(1, std::min(nThreads, numScenarios));
+        if (effThreads == 1) {
+            simulatePaths(0, numScenarios);
+        } else {
+            DLOG("Simulate " << numScenarios << " collateral balance paths on " << effThreads << " threads");
+            std::vector<std::thread> workers;
+            std::vector<std::exception_ptr> errors(effThreads);
+            Size chunk = numScenarios / effThreads, rest = numScenarios % effThreads, first = 0;
+            for (Size t = 0; t < effThreads; ++t) {
+                Size last = first + chunk + (t < rest ? 1 : 0);
+                workers.emplace_back([&simulatePaths, &errors, t, first, last]() {
+                    try {
+                        simulatePaths(first, last);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
+                first = last;
             }
-            QL_REQUIRE(tmpDate > simEndDate,
-                       "collateral balance path generation error; while loop terminated too early. ("
-                           << tmpDate << ", " << simEndDate << ")");
-            // set account balance to zero after maturity of portfolio
-            collat->closeAccount(simEndDate + Period(1, Days));
-            scenarioCollatPaths->push_back(collat);
+            for (auto& w : workers)
+                w.join();
+            // report the error of the first failing scenario block, as in a sequential run
+            for (auto const& e : errors)
+                if (e)
+                    std::rethrow_exception(e);
         }
         return scenarioCollatPaths;
     } catch (const std::exception& e) {
@@ -103,13 +103,17 @@ public:
     /*!
       Takes a netting set (and scenario exposures) as input
       and returns collateral balance paths per scenario
+
+      The margin call schedule and the position of the margin call dates on the exposure grid do not depend
+      on the scenario and are set up once, the scenarios are then processed on \p nThreads threads.
     */
     static QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateralBalancePaths(
         const QuantLib::ext::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
         const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
         const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
         const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType = Symmetric,
-        const QuantLib::ext::shared_ptr<CollateralBalance>& balance = QuantLib::ext::shared_ptr<CollateralBalance>());
+        const QuantLib::ext::shared_ptr<CollateralBalance>& balance = QuantLib::ext::shared_ptr<CollateralBalance>(),
+        const Size nThreads = 1);
 };
 
 //! Convert text representation to CollateralExposureHelper::CalculationType
@@ -49,7 +49,8 @@ public:
                               const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData,
                               const std::vector<Real>& creditMigrationDistributionGrid,
                               const std::vector<Size>& creditMigrationTimeSteps,
-                              const Matrix& creditStateCorrelationMatrix, const std::string baseCurrency);
+                              const Matrix& creditStateCorrelationMatrix, const std::string baseCurrency,
+                              const Size nThreads = 1);
 
     void build();
 
@@ -68,6 +69,7 @@ private:
     std::vector<Size> creditMigrationTimeSteps_;
     Matrix creditStateCorrelationMatrix_;
     std::string baseCurrency_;
+    Size nThreads_;
 
     std::vector<Real> upperBucketBounds_;
     std::vector<std::vector<Real>> cdf_;
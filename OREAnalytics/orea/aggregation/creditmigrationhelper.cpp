@@ -32,12 +32,32 @@
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <numeric>
+#include <thread>
+
 using namespace QuantLib;
 using namespace QuantExt;
 
 namespace ore {
 namespace analytics {
 
+void PnlDistributionAccumulator::add(const Array& probabilities, const Real weight) {
+    QL_REQUIRE(probabilities.size() == probabilities_.size(), "PnlDistributionAccumulator: distribution has "
+                                                                   << probabilities.size() << " buckets, expected "
+                                                                   << probabilities_.size());
+    for (Size i = 0; i < probabilities_.size(); ++i)
+        probabilities_[i] += probabilities[i] * weight;
+}
+
+void PnlDistributionAccumulator::merge(const PnlDistributionAccumulator& other) {
+    QL_REQUIRE(other.buckets() == buckets(), "PnlDistributionAccumulator: can not merge distribution with "
+                                                 << other.buckets() << " buckets, expected " << buckets());
+    probabilities_ += other.probabilities_;
+}
+
 CreditMigrationHelper::CreditMigrationHelper(const QuantLib::ext::shared_ptr<CreditSimulationParameters> parameters,
                                              const QuantLib::ext::shared_ptr<NPVCube> cube,
                                              const QuantLib::ext::shared_ptr<NPVCube> nettedCube,
@@ -45,34 +65,36 @@ CreditMigrationHelper::CreditMigrationHelper(const QuantLib::ext::shared_ptr<Cre
                                              const Size cubeIndexCashflows, const Size cubeIndexStateNpvs,
                                              const Real distributionLowerBound, const Real distributionUpperBound,
                                              const Size buckets, const Matrix& globalFactorCorrelation,
-                                             const string& baseCurrency)
+                                             const string& baseCurrency, const Size nThreads)
     : parameters_(parameters), cube_(cube), nettedCube_(nettedCube), aggData_(aggData),
       cubeIndexCashflows_(cubeIndexCashflows), cubeIndexStateNpvs_(cubeIndexStateNpvs),
-      globalFactorCorrelation_(globalFactorCorrelation), baseCurrency_(baseCurrency),
+      globalFactorCorrelation_(globalFactorCorrelation), baseCurrency_(baseCurrency), nThreads_(nThreads),
       creditMode_(parseCreditMode(parameters_->creditMode())),
       loanExposureMode_(parseLoanExposureMode(parameters_->loanExposureMode())),
       evaluation_(parseEvaluation(parameters_->evaluation())),
       bucketing_(distributionLowerBound, distributionUpperBound, buckets) {
 
+    QL_REQUIRE(nThreads_ > 0, "CreditMigrationHelper: nThreads must be positive");
     rescaledTransitionMatrices_.resize(cube_->numDates());
     init();
-    if (evaluation_ == Evaluation::TerminalSimulation)
-        initEntityStateSimulation();
 } // CreditMigrationHelper()
 
 namespace {
 
-Real conditionalProb(const Real p, const Real m, const Real v) {
-    QuantLib::CumulativeNormalDistribution nd;
-    QuantLib::InverseCumulativeNormal icn;
-    if (close_enough(p, 0.0))
+// number of outer samples processed as one block, the result depends on this, but not on the number of threads
+constexpr Size sampleBlockSize = 32;
+
+// conditional cumulative migration probability, icnP is the threshold from migrationThresholds(), m the systemic part
+// of the entity state, v its variance and s = sqrt(1 - v)
+Real conditionalProb(const CumulativeNormalDistribution& nd, const Real icnP, const Real m, const Real v,
+                     const Real s) {
+    if (icnP == -QL_MAX_REAL)
         return 0.0;
-    if (close_enough(p, 1.0))
+    if (icnP == QL_MAX_REAL)
         return 1.0;
-    Real icnP = icn(p);
     if (close_enough(v, 1.0))
         return icnP >= m ? 1.0 : 0.0;
-    return nd((icnP - m) / std::sqrt(1.0 - v));
+    return nd((icnP - m) / s);
 }
 
 Real prob_tauA_lt_tauB_lt_T(const Real pa, const Real pb, const Real T) {
@@ -159,70 +181,115 @@ void CreditMigrationHelper::init() {
 
     const std::vector<Array>& loadings = parameters_->factorLoadings();
     Size f = globalFactorCorrelation_.rows();
-    globalVar_.resize(parameters_->entities().size(), 0.0);
-    for (Size i = 0; i < parameters_->entities().size(); ++i) {
-        // variance of global factors
-        QL_REQUIRE(parameters_->factorLoadings()[i].size() == f, "wrong size for loadings for entity "
-                                                                     << parameters_->entities()[i] << " ("
-                                                                     << loadings.size() << "), expected " << f);
-        // don't optimise, code is simpler, matrix is small
-        for (Size j = 0; j < loadings[i].size(); ++j) {
-            for (Size k = 0; k < loadings[i].size(); ++k) {
-                globalVar_[i] += loadings[i][j] * loadings[i][k] * globalFactorCorrelation_[j][k];
-            }
-        }
+    Size nEntities = parameters_->entities().size();
+    QL_REQUIRE(loadings.size() == nEntities,
+               "got factor loadings for " << loadings.size() << " entities, expected " << nEntities);
+    factorLoadings_ = Matrix(nEntities, f);
+    for (Size i = 0; i < nEntities; ++i) {
+        QL_REQUIRE(loadings[i].size() == f, "wrong size for loadings for entity " << parameters_->entities()[i] << " ("
+                                                                                   << loadings[i].size()
+                                                                                   << "), expected " << f);
+        std::copy(loadings[i].begin(), loadings[i].end(), factorLoadings_.row_begin(i));
     }
 
-    globalStates_.resize(cube_->numDates(), std::vector<std::vector<Real>>(parameters_->entities().size(),
-                                                                           std::vector<Real>(cube_->samples())));
-    Array globalFactors(f);
+    // variance of global factors, i.e. the diagonal of beta * correlation * beta^T
+    Matrix bc = factorLoadings_ * globalFactorCorrelation_;
+    globalVar_.resize(nEntities, 0.0);
+    for (Size i = 0; i < nEntities; ++i)
+        globalVar_[i] = std::inner_product(bc.row_begin(i), bc.row_end(i), factorLoadings_.row_begin(i), 0.0);
+
+    // systemic part of the entity states, one matrix product per date
     std::vector<string> numStr(f);
     for (Size i = 0; i < f; ++i) {
         std::ostringstream num;
         num << i;
         numStr[i] = num.str();
     }
+    Size samples = cube_->samples();
+    Matrix globalFactors(f, samples);
+    globalStates_.resize(cube_->numDates());
     for (Size d = 0; d < cube_->numDates(); ++d) {
-        for (Size i = 0; i < parameters_->entities().size(); ++i) {
-            for (Size j = 0; j < cube_->samples(); ++j) {
-                for (Size ii = 0; ii < f; ++ii) {
-                    globalFactors[ii] = aggData_->get(d, j, AggregationScenarioDataType::CreditState, numStr[ii]);
-                }
-                globalStates_[d][i][j] = DotProduct(loadings[i], globalFactors / std::sqrt(cubeTimes_[d]));
+        Real sqrtT = std::sqrt(cubeTimes_[d]);
+        for (Size ii = 0; ii < f; ++ii) {
+            for (Size j = 0; j < samples; ++j) {
+                globalFactors[ii][j] =
+                    aggData_->get(d, j, AggregationScenarioDataType::CreditState, numStr[ii]) / sqrtT;
             }
         }
+        globalStates_[d] = factorLoadings_ * globalFactors;
     }
 
     LOG("CreditMigration Init done.");
 
 } // init
 
-void CreditMigrationHelper::initEntityStateSimulation() {
-
-    LOG("Init entity state simulation");
-
-    simulatedEntityState_ =
-        std::vector<std::vector<Size>>(parameters_->entities().size(), std::vector<Size>(cube_->samples()));
-
-    LOG("Init entity state simulation done.");
+std::map<string, Matrix> CreditMigrationHelper::migrationThresholds(const std::map<string, Matrix>& transMat) const {
+    InverseCumulativeNormal icn;
+    std::map<string, Matrix> res;
+    for (auto const& [name, m] : transMat) {
+        Matrix t(m.rows(), m.columns());
+        for (Size ii = 0; ii < m.rows(); ++ii) {
+            Real p = 0.0;
+            for (Size jj = 0; jj < m.columns(); ++jj) {
+                p += m[ii][jj];
+                if (close_enough(p, 0.0))
+                    t[ii][jj] = -QL_MAX_REAL;
+                else if (close_enough(p, 1.0))
+                    t[ii][jj] = QL_MAX_REAL;
+                else
+                    t[ii][jj] = icn(p);
+            }
+        }
+        res[name] = t;
+    }
+    return res;
+} // migrationThresholds
 
-} // initEntityStatesSimulation
+void CreditMigrationHelper::conditionalMigrationProbabilities(const Size date,
+                                                              const std::map<string, Matrix>& thresholds,
+                                                              const Size pathBegin, const Size pathEnd,
+                                                              std::vector<std::vector<Array>>& condProbs) const {
+    CumulativeNormalDistribution nd;
+    const std::vector<string>& matrixNames = parameters_->transitionMatrices();
+    const Matrix& globalStates = globalStates_[date];
+    // entity by entity, so that the thresholds and the systemic states are read contiguously
+    for (Size i = 0; i < parameters_->entities().size(); ++i) {
+        const Matrix& t = thresholds.at(matrixNames[i]);
+        Size initialState = parameters_->initialStates()[i];
+        Real v = globalVar_[i];
+        Real sv = std::sqrt(1.0 - v);
+        for (Size path = pathBegin; path < pathEnd; ++path) {
+            Array& p = condProbs[path - pathBegin][i];
+            Real m = globalStates[i][path];
+            Real condProb0 = 0.0;
+            for (Size j = 0; j < n_; ++j) {
+                Real condProb = conditionalProb(nd, t[initialState][j], m, v, sv);
+                p[j] = condProb - condProb0;
+                condProb0 = condProb;
+            }
+            p[n_] = 0.0;
+        }
+    }
+} // conditionalMigrationProbabilities
 
-std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path) {
+std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path,
+                                                                     const std::map<string, Matrix>& thresholds) const {
     std::vector<Matrix> res = std::vector<Matrix>(parameters_->entities().size(), Matrix(n_, n_, 0.0));
 
     const std::vector<string>& matrixNames = parameters_->transitionMatrices();
+    CumulativeNormalDistribution nd;
 
     // build terminal matrices conditional on global states
     Size numWarnings = 0;
-    auto transMat = rescaledTransitionMatrices(date);
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
-        const Matrix& m = transMat.at(matrixNames[i]);
-        for (Size ii = 0; ii < m.rows(); ++ii) {
-            Real p = 0.0, condProb0 = 0.0;
-            for (Size jj = 0; jj < m.columns(); ++jj) {
-                p += m[ii][jj];
-                Real condProb = conditionalProb(p, globalStates_[date][i][path], globalVar_[i]);
+        const Matrix& t = thresholds.at(matrixNames[i]);
+        Real m = globalStates_[date][i][path];
+        Real v = globalVar_[i];
+        Real sv = std::sqrt(1.0 - v);
+        for (Size ii = 0; ii < t.rows(); ++ii) {
+            Real condProb0 = 0.0;
+            for (Size jj = 0; jj < t.columns(); ++jj) {
+                Real condProb = conditionalProb(nd, t[ii][jj], m, v, sv);
                 res[i][ii][jj] = condProb - condProb0;
                 condProb0 = condProb;
             }
@@ -253,43 +320,37 @@ std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size
     return res;
 }
 
-void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, const Size path,
-                                                 const MersenneTwisterUniformRng& mt) {
+void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, const MersenneTwisterUniformRng& mt,
+                                                 std::vector<Size>& entityStates) const {
 
     QL_REQUIRE(evaluation_ != Evaluation::Analytic,
                "CreditMigrationHelper::simulateEntityStates() unexpected call, not in simulation mode");
 
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         Size initialState = parameters_->initialStates()[i];
-            Real tmp = mt.next().value;
-            Size entityState =
-                std::lower_bound(cond[i].row_begin(initialState), cond[i].row_end(initialState), tmp) -
-                cond[i].row_begin(initialState);
-            entityState = std::min(entityState, cond[i].columns() - 1); // play safe
-            simulatedEntityState_[i][path] = entityState;
-            initialState = entityState;
+        Real tmp = mt.next().value;
+        Size entityState = std::lower_bound(cond[i].row_begin(initialState), cond[i].row_end(initialState), tmp) -
+                           cond[i].row_begin(initialState);
+        entityState = std::min(entityState, cond[i].columns() - 1); // play safe
+        entityStates[i] = entityState;
     }
 
 } // simulateEntityStates
 
-Size CreditMigrationHelper::simulatedEntityState(const Size i, const Size path) const {
-    QL_REQUIRE(evaluation_ != Evaluation::Analytic,
-               "CreditMigrationHelper::simulatedEntityState() unexpected call, not in simulation mode");
-    return simulatedEntityState_[i][path];
-} // simulatedEntityState
-
-Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path, const Size n) const {
+Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path,
+                                                 const std::vector<Size>& entityStates) const {
 
     QL_REQUIRE(!parameters_->doubleDefault(),
                "CreditMigrationHelper::generateMigrationPnl() does not support double default");
 
     const std::vector<string>& entities = parameters_->entities();
+    const Size n = n_;
     Real pnl = 0.0;
 
     for (Size i = 0; i < entities.size(); ++i) {
         // compute credit state of entitiy
         // issuer migration risk
-        Size simEntityState = simulatedEntityState(i, path);
+        Size simEntityState = entityStates[i];
         for (auto const& tradeId : issuerTradeIds_[i]) {
             try {
                 Size tid = cube_->idsAndIndexes().at(tradeId);
@@ -354,16 +415,8 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
     const std::vector<string>& matrixNames = parameters_->transitionMatrices();
 
     for (Size i = 0; i < entities.size(); ++i) {
-        // compute conditional migration prob
+        // the conditional migration probs are computed in conditionalMigrationProbabilities()
         Size initialState = parameters_->initialStates()[i];
-        Real p = 0.0, condProb0 = 0.0;
-        const Matrix& m = transMat.at(matrixNames[i]);
-        for (Size j = 0; j < n_; ++j) {
-            p += m[initialState][j];
-            Real condProb = conditionalProb(p, globalStates_[date][i][path], globalVar_[i]);
-            condProbs[i][j] = condProb - condProb0;
-            condProb0 = condProb;
-        }
         // issuer migration risk
         Size cdsCptyIdx = Null<Size>();
         for (auto const& tradeId : issuerTradeIds_[i]) {
@@ -444,86 +497,79 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
     }
 } // generateConditionalMigrationPnl
 
-Array CreditMigrationHelper::pnlDistribution(const Size date) {
-
-    // FIXME if we ask this method for more than one time step, it might be more efficient to
-    // pass a vector of those time steps and compute the distirbutions in one sweep here
-    // in particular step 2b-1 (in forward simulation mode)
+Real CreditMigrationHelper::marketPnl(const Size date, const Size path) const {
+
+    Real cash = 0.0;
+
+    for (Size j = 0; j <= date + 1; ++j) {
+        for (auto const& [tradeId, i] : cube_->idsAndIndexes()) {
+            // get cumulative survival probability on the path
+            Real sp = 1.0;
+            //Real rr = 0.0;
+            // FIXME 1
+            // Methodology question: Do we need/want to multiply with the stochastic discount factor
+            // here if we do an explicit credit default simulation at horizon?
+            // FIXME 2
+            // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
+            // with default prob
+            if (parameters_->zeroMarketPnl() && j > 0) {
+                auto creditCurve = tradeCreditCurves_.find(tradeId);
+                if (creditCurve != tradeCreditCurves_.end())
+                    sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve->second);
+                //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve->second);
+            }
+            if (j == 0) {
+                // at t0 we flip the sign of the npvs to get the initial cash balance
+                cash -= cube_->getT0(i, 0);
+                // collect intermediate cashflows
+                if (cubeIndexCashflows_ != Null<Size>())
+                    cash += cube_->getT0(i, cubeIndexCashflows_);
+            } else if (j <= date) {
+                // collect intermediate cashflows
+                if (cubeIndexCashflows_ != Null<Size>())
+                    cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
+            } else {
+                // at the horizon date we realise the npv
+                cash += sp * cube_->get(i, j - 1, path, 0);
+            }
+        }
+    } // for date
 
-    LOG("Compute PnL distribution for date " << date);
-    QL_REQUIRE(date < cube_->numDates(), "date index " << date << " out of range 0..." << cube_->numDates() - 1);
-    const std::vector<string>& entities = parameters_->entities();
+    return cash;
+} // marketPnl
 
-    // 1 get transition matrices for entities and rescale them to horizon
+void CreditMigrationHelper::accumulatePnlDistribution(const Size date, const std::map<string, Matrix>& transMat,
+                                                      const std::map<string, Matrix>& thresholds,
+                                                      const Size pathBegin, const Size pathEnd,
+                                                      const MersenneTwisterUniformRng* mt,
+                                                      PnlDistributionAccumulator& distribution,
+                                                      Real& sumMarketPnl) const {
 
-    std::map<string, Matrix> transMat; // rescaled transition matrix per (matrix) name
+    const std::vector<string>& entities = parameters_->entities();
+    Real weight = 1.0 / static_cast<Real>(cube_->samples());
 
-    // 1 get transition matrices for time step and compute variance of global factors for each entiity
+    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
 
-    if (parameters_->creditRisk()) {
-        transMat = rescaledTransitionMatrices(date);
+    // 2b-2 conditional migration probabilities for all paths of the block, n+1 states, see below
+    std::vector<std::vector<Array>> blockCondProbs;
+    if (parameters_->creditRisk() && evaluation_ == Evaluation::Analytic) {
+        blockCondProbs.resize(pathEnd - pathBegin, std::vector<Array>(entities.size(), Array(n_ + 1, 0.0)));
+        conditionalMigrationProbabilities(date, thresholds, pathBegin, pathEnd, blockCondProbs);
     }
 
-    // 2 compute conditional pnl distributions and average over paths
+    std::vector<Size> entityStates(entities.size());
 
-    const std::set<std::string>& tradeIds = cube_->ids();
-    Array res(bucketing_.buckets(), 0.0);
-
-    Size numPaths = cube_->samples();
-    Real avgCash = 0.0;
-
-    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
-
-    MersenneTwisterUniformRng mt(parameters_->seed());
-
-    for (Size path = 0; path < numPaths; ++path) {
+    for (Size path = pathBegin; path < pathEnd; ++path) {
 
         // 2a market pnl (t0 to horizon date, over whole cube)
 
-        Real cash = 0.0;
-
-        if (parameters_->marketRisk()) {
-            for (Size j = 0; j <= date + 1; ++j) {
-                for (auto const& tradeId : tradeIds) {
-                    Size i = cube_->idsAndIndexes().at(tradeId);
-                    // get cumulative survival probability on the path
-                    Real sp = 1.0;
-                    //Real rr = 0.0;
-                    // FIXME 1
-                    // Methodology question: Do we need/want to multiply with the stochastic discount factor
-                    // here if we do an explicit credit default simulation at horizon?
-                    // FIXME 2
-                    // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
-                    // with default prob
-                    if (parameters_->zeroMarketPnl() && j > 0 &&
-                        tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
-                        string creditCurve = tradeCreditCurves_.at(tradeId);
-                        sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
-                        //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
-                    }
-                    if (j == 0) {
-                        // at t0 we flip the sign of the npvs to get the initial cash balance
-                        cash -= cube_->getT0(i, 0);
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += cube_->getT0(i, cubeIndexCashflows_);
-                    } else if (j <= date) {
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
-                    } else {
-                        // at the horizon date we realise the npv
-                        cash += sp * cube_->get(i, j - 1, path, 0);
-                    }
-                }
-            } // for data
-        }     // if market risk
+        Real cash = parameters_->marketRisk() ? marketPnl(date, path) : 0.0;
 
         if (!parameters_->creditRisk()) {
             // if we just add scalar market pnl realisations, we don't really need
             // the bucketing algorithm to do that, we just update the result
             // distribution directly
-            res[hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
+            distribution.add(hwBucketing.index(cash), weight);
             continue;
         }
 
@@ -532,16 +578,18 @@ Array CreditMigrationHelper::pnlDistribution(const Size date) {
         std::vector<Array> condProbs, pnl;
 
         if (evaluation_ != Evaluation::Analytic) {
-            // 2b-1 generate pnl on the path using simulated idiosyncratic factors
+            // 2b-1 generate pnl on the path using simulated idiosyncratic factors, the inner paths continue the
+            // rng sequence of the previous outer path
+            QL_REQUIRE(mt, "CreditMigrationHelper::accumulatePnlDistribution(): no rng given in simulation mode");
             condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
             // we could build the distribution more efficiently here, but later in 2c we add the market pnl
             // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
             // these with additional data?
             pnl.resize(1, Array(parameters_->paths(), 0.0));
-            auto cond = initEntityStateSimulation(date, path);
+            auto cond = initEntityStateSimulation(date, path, thresholds);
             for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
-                simulateEntityStates(cond, path, mt);
-                pnl[0][path2] = generateMigrationPnl(date, path, n_);
+                simulateEntityStates(cond, *mt, entityStates);
+                pnl[0][path2] = generateMigrationPnl(date, path, entityStates);
             }
         } else {
             // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
@@ -556,7 +604,7 @@ Array CreditMigrationHelper::pnlDistribution(const Size date) {
             // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
             // additional state
 
-            condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
+            condProbs.swap(blockCondProbs[path - pathBegin]);
             pnl.resize(entities.size(), Array(n_ + 1, 0.0));
             generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
         }
@@ -571,14 +619,104 @@ Array CreditMigrationHelper::pnlDistribution(const Size date) {
         hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
 
         // 2d add pnl contribution of path to result distribution
-        res += hwBucketing.probability() / static_cast<Real>(numPaths);
+        distribution.add(hwBucketing.probability(), weight);
         // average market risk pnl
-        avgCash += cash / static_cast<Real>(numPaths);
+        sumMarketPnl += cash * weight;
 
     } // for path
+} // accumulatePnlDistribution
+
+Array CreditMigrationHelper::pnlDistribution(const Size date) {
+
+    // FIXME if we ask this method for more than one time step, it might be more efficient to
+    // pass a vector of those time steps and compute the distirbutions in one sweep here
+    // in particular step 2b-1 (in forward simulation mode)
+
+    LOG("Compute PnL distribution for date " << date);
+    QL_REQUIRE(date < cube_->numDates(), "date index " << date << " out of range 0..." << cube_->numDates() - 1);
+
+    // 1 get transition matrices for entities and rescale them to horizon
+
+    std::map<string, Matrix> transMat; // rescaled transition matrix per (matrix) name
+    std::map<string, Matrix> thresholds; // thresholds for the conditional migration probabilities per (matrix) name
+
+    // 1 get transition matrices for time step and compute variance of global factors for each entiity
+
+    if (parameters_->creditRisk()) {
+        transMat = rescaledTransitionMatrices(date);
+        thresholds = migrationThresholds(transMat);
+    }
+
+    // 2 compute conditional pnl distributions and average over paths, in blocks of paths
+
+    Size numPaths = cube_->samples();
+    Size nBlocks = (numPaths + sampleBlockSize - 1) / sampleBlockSize;
+    std::vector<PnlDistributionAccumulator> blockDistributions(nBlocks,
+                                                               PnlDistributionAccumulator(bucketing_.buckets()));
+    std::vector<Real> blockMarketPnl(nBlocks, 0.0);
+
+    // in the simulation modes each outer path draws one number per inner path and entity from a single sequence,
+    // each block gets a copy of the rng advanced to its first draw
+    std::vector<MersenneTwisterUniformRng> blockRngs;
+    if (parameters_->creditRisk() && evaluation_ != Evaluation::Analytic) {
+        MersenneTwisterUniformRng mt(parameters_->seed());
+        Size drawsPerBlock = sampleBlockSize * parameters_->paths() * parameters_->entities().size();
+        for (Size b = 0; b < nBlocks; ++b) {
+            blockRngs.push_back(mt);
+            if (b + 1 < nBlocks) {
+                for (Size i = 0; i < drawsPerBlock; ++i)
+                    mt.nextInt32();
+            }
+        }
+    }
+
+    auto processBlock = [this, date, numPaths, &transMat, &thresholds, &blockRngs, &blockDistributions,
+                         &blockMarketPnl](const Size b) {
+        accumulatePnlDistribution(date, transMat, thresholds, b * sampleBlockSize,
+                                  std::min(numPaths, (b + 1) * sampleBlockSize),
+                                  blockRngs.empty() ? nullptr : &blockRngs[b], blockDistributions[b],
+                                  blockMarketPnl[b]);
+    };
+
+    Size nThreads = std::min(nThreads_, nBlocks);
+    if (nThreads <= 1) {
+        for (Size b = 0; b < nBlocks; ++b)
+            processBlock(b);
+    } else {
+        DLOG("Process " << nBlocks << " blocks of " << sampleBlockSize << " paths on " << nThreads << " threads");
+        std::atomic<Size> nextBlock(0);
+        std::vector<std::exception_ptr> errors(nBlocks);
+        std::vector<std::thread> workers;
+        for (Size t = 0; t < nThreads; ++t) {
+            workers.emplace_back([&processBlock, &nextBlock, &errors, nBlocks]() {
+                for (Size b = nextBlock++; b < nBlocks; b = nextBlock++) {
+                    try {
+                        processBlock(b);
+                    } catch (...) {
+                        errors[b] = std::current_exception();
+                    }
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        // rethrow the error of the first failing block, as the single threaded computation would do
+        for (auto const& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    // merge the block results in block order, so that the result does not depend on the number of threads
+    PnlDistributionAccumulator res(bucketing_.buckets());
+    Real avgCash = 0.0;
+    for (Size b = 0; b < nBlocks; ++b) {
+        res.merge(blockDistributions[b]);
+        avgCash += blockMarketPnl[b];
+    }
 
     DLOG("Expected Market Risk PnL at date " << date << ": " << avgCash);
-    return res;
+    return res.probabilities();
 } // pnlDistribution
 
 void CreditMigrationHelper::build(const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades) {
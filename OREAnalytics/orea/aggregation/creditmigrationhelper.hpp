@@ -39,6 +39,27 @@
 namespace ore {
 namespace analytics {
 
+//! PnL distribution on a fixed bucket grid
+/*! The probabilities are accumulated per bucket. Accumulators on the same grid can be merged, this is used to build
+    the distribution from sample blocks processed on different threads. */
+class PnlDistributionAccumulator {
+public:
+    explicit PnlDistributionAccumulator(const Size buckets = 0) : probabilities_(buckets, 0.0) {}
+
+    //! add the given weight to a single bucket
+    void add(const Size bucket, const Real weight) { probabilities_[bucket] += weight; }
+    //! add a distribution on the same bucket grid with the given weight
+    void add(const Array& probabilities, const Real weight);
+    //! add the probabilities of another accumulator on the same bucket grid
+    void merge(const PnlDistributionAccumulator& other);
+
+    Size buckets() const { return probabilities_.size(); }
+    const Array& probabilities() const { return probabilities_; }
+
+private:
+    Array probabilities_;
+};
+
 /*! Helper for credit migration risk calculation
    Dynamics of entity i's state X_i:
      \f$ dX_i = dY_i + dZ_i \f$
@@ -47,7 +68,15 @@ namespace analytics {
      - n correlated global factors \f$ G_j \f$
      - entity specific factor loadings \f$ \beta_{ij} \f$
      - idiosyncratic part \f$ dZ_i = \sigma_i dW_i \f$
-     - independent  Wiener processes W, i.e. \f$ dW_k dW_l = 0 \f$ and \f$ dW_k dG_j = 0 \f$ */
+     - independent  Wiener processes W, i.e. \f$ dW_k dW_l = 0 \f$ and \f$ dW_k dG_j = 0 \f$
+
+   The loadings \f$ \beta_{ij} \f$ are held as an entity by factor matrix, so that the systemic parts of all entities
+   are computed as one matrix product per date. The thresholds of the conditional migration probabilities are computed
+   once per date and transition matrix. The outer samples are processed in fixed blocks which are distributed over
+   nThreads threads. Each block accumulates its own PnL distribution, the block distributions are merged in block
+   order, so that the result does not depend on the number of threads. In the simulation modes the inner paths of all
+   outer samples are drawn from one Mersenne Twister sequence, each block starts from a copy of the generator that is
+   advanced to the first draw of the block before the blocks are processed. */
 class CreditMigrationHelper {
 public:
     enum class CreditMode { Migration, Default };
@@ -59,7 +88,7 @@ public:
                           const QuantLib::ext::shared_ptr<AggregationScenarioData> aggData, const Size cubeIndexCashflows,
                           const Size cubeIndexStateNpvs, const Real distributionLowerBound,
                           const Real distributionUpperBound, const Size buckets, const Matrix& globalFactorCorrelation,
-                          const std::string& baseCurrency);
+                          const std::string& baseCurrency, const Size nThreads = 1);
 
     //! builds the helper for a specific subset of trades stored in the cube
     void build(const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades);
@@ -76,42 +105,60 @@ private:
     std::map<string, Matrix> rescaledTransitionMatrices(const Size date);
 
     /*! Initialise
+      - the entity by factor loading matrix
       - the variance of the global part Y_i of entity state X_i, for all entities
       - the global part Y_i of entity i's state X_i by date index, entity index and sample number
         using the simulated global state paths stored in the aggregation scenario data object */
     void init();
 
-    //! Allocate 3d storage for the simulated idiosyncratic factors by entity, date and sample
-    void initEntityStateSimulation();
+    /*! Inverse cumulative normal of the cumulative transition probabilities by (matrix) name, initial and final state,
+      +/- QL_MAX_REAL if the cumulative probability is one / zero */
+    std::map<string, Matrix> migrationThresholds(const std::map<string, Matrix>& transMat) const;
+
+    /*! Conditional migration probabilities from the initial state for all entities and the given range of global
+      paths, condProbs is indexed by path - pathBegin and entity */
+    void conditionalMigrationProbabilities(const Size date, const std::map<string, Matrix>& thresholds,
+                                           const Size pathBegin, const Size pathEnd,
+                                           std::vector<std::vector<Array>>& condProbs) const;
 
-    /*! Initialise the entity state simulationn for a given date for
+    /*! Initialise the entity state simulation for a given date for
         Evaluation = TerminalSimulation:
         Return transition matrix for each entity for the given date,
         conditional on the global terminal state on the given path */
-    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path);
+    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path,
+                                                  const std::map<string, Matrix>& thresholds) const;
 
     /*! Generate one entity state sample path for all entities given the global state path
         and given the conditional transition matrices for all entities at the terminal date. */
-    void simulateEntityStates(const std::vector<Matrix>& cond, const Size path, const MersenneTwisterUniformRng& mt);
-
-    //! Look up the simulated entity credit state for the given entity, date and path
-    Size simulatedEntityState(const Size i, const Size path) const;
+    void simulateEntityStates(const std::vector<Matrix>& cond, const MersenneTwisterUniformRng& mt,
+                              std::vector<Size>& entityStates) const;
 
     /*! Return a single PnL impact due to credit migration or default of Bond/CDS issuers and default of
-      netting set counterparties on the given global path */
-    Real generateMigrationPnl(const Size date, const Size path, const Size n) const;
+      netting set counterparties on the given global path for the given simulated entity states */
+    Real generateMigrationPnl(const Size date, const Size path, const std::vector<Size>& entityStates) const;
 
-    /*! Return a vector of PnL impacts and associated conditional probabilities for the specified global path,
-      due to credit migration or default of Bond/CDS issuers and default of netting set counterparties */
+    /*! Return a vector of PnL impacts for the specified global path, due to credit migration or default of Bond/CDS
+      issuers and default of netting set counterparties, and adjust the conditional probabilities for double default */
     void generateConditionalMigrationPnl(const Size date, const Size path, const std::map<string, Matrix>& transMat,
                                          std::vector<Array>& condProbs, std::vector<Array>& pnl) const;
 
+    //! Market PnL from t0 to the horizon date on the given global path
+    Real marketPnl(const Size date, const Size path) const;
+
+    /*! Accumulate the PnL distribution over the given range of global paths, in the simulation modes mt must be
+        positioned at the first draw for pathBegin */
+    void accumulatePnlDistribution(const Size date, const std::map<string, Matrix>& transMat,
+                                   const std::map<string, Matrix>& thresholds, const Size pathBegin,
+                                   const Size pathEnd, const MersenneTwisterUniformRng* mt,
+                                   PnlDistributionAccumulator& distribution, Real& sumMarketPnl) const;
+
     QuantLib::ext::shared_ptr<CreditSimulationParameters> parameters_;
     QuantLib::ext::shared_ptr<NPVCube> cube_, nettedCube_;
     QuantLib::ext::shared_ptr<AggregationScenarioData> aggData_;
     Size cubeIndexCashflows_, cubeIndexStateNpvs_;
     Matrix globalFactorCorrelation_;
     std::string baseCurrency_;
+    Size nThreads_;
 
     CreditMode creditMode_;
     LoanExposureMode loanExposureMode_;
@@ -131,14 +178,12 @@ private:
     // Transition matrix rows
     Size n_;
     std::vector<std::map<string, Matrix>> rescaledTransitionMatrices_;
+    // Factor loadings beta_ij by entity and global factor
+    Matrix factorLoadings_;
     // Variance of the systemic part (Y_i) of entity state X_i
     std::vector<Real> globalVar_;
-    // Storage for the simulated idiosyncratic factors Z by entity, sample number
-    std::vector<std::vector<Size>> simulatedEntityState_;
-
-    std::vector<std::vector<Matrix>> entityStateSimulationMatrices_;
-    // Systemic part (Y_i) of entity state X_i by date index, entity index, sample number
-    std::vector<std::vector<std::vector<Real>>> globalStates_;
+    // Systemic part (Y_i) of entity state X_i by date index, as entity by sample number matrix
+    std::vector<Matrix> globalStates_;
 };
 
 CreditMigrationHelper::CreditMode parseCreditMode(const std::string& s);
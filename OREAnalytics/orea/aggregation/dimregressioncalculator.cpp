@@ -23,18 +23,22 @@
 #include <ql/time/calendars/weekendsonly.hpp>
 
 #include <ql/math/distributions/normaldistribution.hpp>
-#include <ql/math/generallinearleastsquares.hpp>
 #include <ql/math/kernelfunctions.hpp>
 #include <ql/methods/montecarlo/lsmbasissystem.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
 #include <qle/math/nadarayawatson.hpp>
-#include <qle/math/stabilisedglls.hpp>
+#include <qle/math/randomvariable.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/error_of_mean.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+
+#include <atomic>
+#include <exception>
+#include <thread>
 
 using namespace std;
 using namespace QuantLib;
@@ -50,15 +54,15 @@ RegressionDynamicInitialMarginCalculator::RegressionDynamicInitialMarginCalculat
     const QuantLib::ext::shared_ptr<CubeInterpretation>& cubeInterpretation,
     const QuantLib::ext::shared_ptr<AggregationScenarioData>& scenarioData, Real quantile, Size horizonCalendarDays,
     Size regressionOrder, std::vector<std::string> regressors, Size localRegressionEvaluations,
-    Real localRegressionBandWidth, const std::map<std::string, Real>& currentIM)
+    Real localRegressionBandWidth, const std::map<std::string, Real>& currentIM, Size nThreads)
 : DynamicInitialMarginCalculator(inputs, portfolio, cube, cubeInterpretation, scenarioData, quantile, horizonCalendarDays,
                                  currentIM),
       regressionOrder_(regressionOrder), regressors_(regressors),
-      localRegressionEvaluations_(localRegressionEvaluations), localRegressionBandWidth_(localRegressionBandWidth) {
+      localRegressionEvaluations_(localRegressionEvaluations), localRegressionBandWidth_(localRegressionBandWidth), nThreads_(nThreads) {
     Size dates = cube_->dates().size();
     Size samples = cube_->samples();
     for (const auto& nettingSetId : nettingSetIds_) {
-        regressorArray_[nettingSetId] = vector<vector<Array>>(dates, vector<Array>(samples));
+        regressorData_[nettingSetId] = vector<Real>(regressors_.empty() ? 0 : dates * regressors_.size() * samples, 0.0);
         nettingSetLocalDIM_[nettingSetId] = vector<vector<Real>>(dates, vector<Real>(samples, 0.0));
         nettingSetZeroOrderDIM_[nettingSetId] = vector<Real>(dates, 0.0);
         nettingSetSimpleDIMh_[nettingSetId] = vector<Real>(dates, 0.0);
@@ -103,18 +107,18 @@ void RegressionDynamicInitialMarginCalculator::build() {
     Size stopDatesLoop = datesLoopSize_;
     Size samples = cube_->samples();
 
-    Size polynomOrder = regressionOrder_;
     LOG("DIM regression polynom order = " << regressionOrder_);
-    LsmBasisSystem::PolynomialType polynomType = LsmBasisSystem::Monomial;
     Size regressionDimension = regressors_.empty() ? 1 : regressors_.size();
     LOG("DIM regression dimension = " << regressionDimension);
-    std::vector<ext::function<Real(Array)>> v(
-        LsmBasisSystem::multiPathBasisSystem(regressionDimension, polynomOrder, polynomType));
-    Real confidenceLevel = QuantLib::InverseCumulativeNormal()(quantile_);
-    LOG("DIM confidence level " << confidenceLevel);
 
-    Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
-    Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
+    // the (netting set, date) pairs for which the DIM is computed by regression
+    struct Task {
+        string nettingSet;
+        Size nettingSetIndex;
+        Size dateIndex;
+        Real nettingSetDimScaling;
+    };
+    vector<Task> tasks;
 
     Size nettingSetCount = 0;
     for (auto n : nettingSetIds_) {
@@ -170,149 +174,236 @@ void RegressionDynamicInitialMarginCalculator::build() {
             nettingSetScaling_.find(n) == nettingSetScaling_.end() ? 1.0 : nettingSetScaling_[n];
         LOG("Netting set DIM scaling factor: " << nettingSetDimScaling);
 
-        for (Size j = 0; j < stopDatesLoop; ++j) {
-            accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
-            accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real npvDefault = nettingSetNPV_[n][j][k];
-                Real flow = nettingSetFLOW_[n][j][k];
-                Real npvCloseOut = nettingSetCloseOutNPV_[n][j][k];
-                accDiff((npvCloseOut * numCloseOut) + (flow * numDefault) - (npvDefault * numDefault));
-                accOneOverNumeraire(1.0 / numDefault);
-            }
+        for (Size j = 0; j < stopDatesLoop; ++j)
+            tasks.push_back({n, nettingSetCount, j, nettingSetDimScaling});
 
-            Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
-            Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
-
-            Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
-            Real E_OneOverNumeraire =
-                mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
-
-            nettingSetZeroOrderDIM_[n][j] = stdevDiff * horizonScaling * confidenceLevel;
-            nettingSetZeroOrderDIM_[n][j] *= E_OneOverNumeraire;
-
-            vector<Real> rx0(samples, 0.0);
-            vector<Array> rx(samples, Array());
-            vector<Real> ry1(samples, 0.0);
-            vector<Real> ry2(samples, 0.0);
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real x = nettingSetNPV_[n][j][k] * numDefault;
-                Real f = nettingSetFLOW_[n][j][k] * numDefault;
-                Real y = nettingSetCloseOutNPV_[n][j][k] * numCloseOut;
-                Real z = (y + f - x);
-                rx[k] = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                rx0[k] = rx[k][0];
-                ry1[k] = z;     // for local regression
-                ry2[k] = z * z; // for least squares regression
-                nettingSetDeltaNPV_[n][j][k] = z;
-                regressorArray_[n][j][k] = rx[k];
-            }
-            vector<Real> delNpvVec_copy = nettingSetDeltaNPV_[n][j];
-            sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
-            Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
-            Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
-            simpleDim_h *= horizonScaling;                                  // the usual scaling factors
-            simpleDim_p *= horizonScaling;                                  // the usual scaling factors
-            nettingSetSimpleDIMh_[n][j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
-            nettingSetSimpleDIMp_[n][j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
-
-            QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
-            if (close_enough(stdevDiff, 0.0)) {
-                LOG("DIM: Zero std dev estimation at step " << j);
-                // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
-                for (Size k = 0; k < samples; ++k) {
-                    nettingSetDIM_[n][j][k] = 0.0;
-                    nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
-            } else {
-                // Least squares polynomial regression with specified polynom order
-                QuantExt::StabilisedGLLS ls(rx, ry2, v, QuantExt::StabilisedGLLS::MeanStdDev);
-                LOG("DIM data normalisation at time step "
-                    << j << ": " << scientific << setprecision(6) << " x-shift = " << ls.xShift() << " x-multiplier = "
-                    << ls.xMultiplier() << " y-shift = " << ls.yShift() << " y-multiplier = " << ls.yMultiplier());
-                LOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6)
-                                                                << ls.transformedCoefficients());
-
-                // Local regression versus first regression variable (i.e. we do not perform a
-                // multidimensional local regression):
-                // We evaluate this at a limited number of samples only for validation purposes.
-                // Note that computational effort scales quadratically with number of samples.
-                // NadarayaWatson needs a large number of samples for good results.
-                QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(),
-                                            GaussianKernel(0.0, localRegressionBandWidth_));
-                Size localRegressionSamples = samples;
-                if (localRegressionEvaluations_ > 0)
-                    localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
-
-                // Evaluate regression function to compute DIM for each scenario
-                for (Size k = 0; k < samples; ++k) {
-                    // Real num1 = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                        AggregationScenarioDataType::Numeraire, j, k);
-                    Array regressor = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                    Real e = ls.eval(regressor, v);
-                    if (e < 0.0)
-                        LOG("Negative variance regression for date " << j << ", sample " << k
-                                                                     << ", regressor = " << regressor);
-
-                    // Note:
-                    // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
-                    //    and to avoid a second regression for the conditional mean
-                    // 2) In particular the linear regression function can yield negative variance values in
-                    //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
-                    //    variance approaching zero. We correct this here by taking the positive part.
-                    Real std = sqrt(std::max(e, 0.0));
-                    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
-                    // Real dim = std * scalingFactor / num1;
-                    Real dim = std * scalingFactor / numDefault;
-                    dimCube_->set(dim, nettingSetCount, j, k);
-                    nettingSetDIM_[n][j][k] = dim;
-                    nettingSetExpectedDIM_[n][j] += dim / samples;
-
-                    // Evaluate the Kernel regression for a subset of the samples only (performance)
-                    if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
-                        // nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / num1;
-                        nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / numDefault;
-                    else
-                        nettingSetLocalDIM_[n][j][k] = 0.0;
+        nettingSetCount++;
+    }
+
+    // The regressions are independent, each task only writes the results for its own netting set and date. The
+    // tasks are distributed dynamically, since the effort per date varies (e.g. zero exposure after maturity).
+    Size nThreads = std::max<Size>(std::min(nThreads_, tasks.size()), 1);
+    LOG("DIM regression for " << tasks.size() << " netting set / date pairs using " << nThreads << " threads");
+    if (nThreads == 1) {
+        for (auto const& t : tasks)
+            buildDate(t.nettingSet, t.nettingSetIndex, t.dateIndex, t.nettingSetDimScaling);
+    } else {
+        std::atomic<Size> nextTask(0);
+        vector<std::exception_ptr> errors(tasks.size());
+        vector<std::thread> workers;
+        for (Size i = 0; i < nThreads; ++i) {
+            workers.emplace_back([this, &tasks, &nextTask, &errors]() {
+                for (Size t = nextTask++; t < tasks.size(); t = nextTask++) {
+                    try {
+                        buildDate(tasks[t].nettingSet, tasks[t].nettingSetIndex, tasks[t].dateIndex,
+                                  tasks[t].nettingSetDimScaling);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
                 }
-            }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        // rethrow the error of the first failing task, as the single threaded computation would do
+        for (auto const& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
         }
+    }
 
-        nettingSetCount++;
+    // the DIM cube is written on the calling thread
+    for (auto const& t : tasks) {
+        const vector<Real>& dim = nettingSetDIM_.at(t.nettingSet)[t.dateIndex];
+        for (Size k = 0; k < samples; ++k)
+            dimCube_->set(dim[k], t.nettingSetIndex, t.dateIndex, k);
     }
+
     LOG("DIM by polynomial regression done");
 }
 
-Array RegressionDynamicInitialMarginCalculator::regressorArray(string nettingSet, Size dateIndex,
-                                                                           Size sampleIndex) {
-    Array a(regressors_.size());
-    for (Size i = 0; i < regressors_.size(); ++i) {
-        string variable = regressors_[i];
-        if (boost::to_upper_copy(variable) ==
-            "NPV") // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
-            a[i] = nettingSetNPV_[nettingSet][dateIndex][sampleIndex];
-        else if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::IndexFixing,
-                                                                      dateIndex, sampleIndex, variable);
+void RegressionDynamicInitialMarginCalculator::buildDate(const string& n, Size nettingSetIndex, Size j,
+                                                         Real nettingSetDimScaling) {
+    Size samples = cube_->samples();
+    Size regressionDimension = regressors_.empty() ? 1 : regressors_.size();
+    Real confidenceLevel = QuantLib::InverseCumulativeNormal()(quantile_);
+    Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
+    Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
+
+    // the containers are set up in the constructor, we only write to the slots of this netting set and date
+    const vector<Real>& npv = nettingSetNPV_.at(n)[j];
+    const vector<Real>& flow = nettingSetFLOW_.at(n)[j];
+    const vector<Real>& closeOutNpv = nettingSetCloseOutNPV_.at(n)[j];
+    vector<Real>& deltaNpv = nettingSetDeltaNPV_.at(n)[j];
+    vector<Real>& dimResult = nettingSetDIM_.at(n)[j];
+    vector<Real>& localDimResult = nettingSetLocalDIM_.at(n)[j];
+    Real& expectedDim = nettingSetExpectedDIM_.at(n)[j];
+
+    fillRegressors(n, j);
+
+    vector<Real> numDefault(samples);
+    accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
+    accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
+    for (Size k = 0; k < samples; ++k) {
+        numDefault[k] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        Real numCloseOut =
+            cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        Real x = npv[k] * numDefault[k];
+        Real f = flow[k] * numDefault[k];
+        Real y = closeOutNpv[k] * numCloseOut;
+        Real z = (y + f - x);
+        deltaNpv[k] = z;
+        accDiff(z);
+        accOneOverNumeraire(1.0 / numDefault[k]);
+    }
+
+    Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
+    Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
+
+    Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
+    Real E_OneOverNumeraire =
+        mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
+
+    nettingSetZeroOrderDIM_.at(n)[j] = stdevDiff * horizonScaling * confidenceLevel;
+    nettingSetZeroOrderDIM_.at(n)[j] *= E_OneOverNumeraire;
+
+    vector<Real> delNpvVec_copy = deltaNpv;
+    sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
+    Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
+    Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
+    simpleDim_h *= horizonScaling;                                      // the usual scaling factors
+    simpleDim_p *= horizonScaling;                                      // the usual scaling factors
+    nettingSetSimpleDIMh_.at(n)[j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
+    nettingSetSimpleDIMp_.at(n)[j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
+
+    auto basisFns = multiPathBasisSystem(regressionDimension, regressionOrder_, LsmBasisSystem::Monomial);
+    QL_REQUIRE(samples > basisFns.size(), "not enough points for regression with polynom order " << regressionOrder_);
+    if (close_enough(stdevDiff, 0.0)) {
+        LOG("DIM: Zero std dev estimation for netting set " << n << " at step " << j);
+        // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
+        for (Size k = 0; k < samples; ++k) {
+            dimResult[k] = 0.0;
+            localDimResult[k] = 0.0;
+        }
+        return;
+    }
+
+    // Least squares polynomial regression of the squared delta NPV with specified polynom order. As in the
+    // StabilisedGLLS the regressors and the regressand are normalised to zero mean and unit variance before the
+    // regression, the basis functions are evaluated on the whole regressor columns.
+    auto normalise = [samples](const Real* u, Real& shift, Real& multiplier) {
+        accumulator_set<Real, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> acc;
+        for (Size k = 0; k < samples; ++k)
+            acc(u[k]);
+        shift = -mean(acc);
+        multiplier = 1.0;
+        Real tmp = boost::accumulators::variance(acc);
+        if (!close_enough(tmp, 0.0))
+            multiplier = 1.0 / std::sqrt(tmp);
+        RandomVariable r(samples);
+        for (Size k = 0; k < samples; ++k)
+            r.set(k, (u[k] + shift) * multiplier);
+        return r;
+    };
+
+    Array xShift(regressionDimension), xMultiplier(regressionDimension);
+    vector<RandomVariable> regressors(regressionDimension);
+    for (Size i = 0; i < regressionDimension; ++i)
+        regressors[i] = normalise(regressorColumn(n, j, i), xShift[i], xMultiplier[i]);
+    vector<Real> squaredDeltaNpv(samples);
+    for (Size k = 0; k < samples; ++k)
+        squaredDeltaNpv[k] = deltaNpv[k] * deltaNpv[k];
+    Real yShift, yMultiplier;
+    RandomVariable regressand = normalise(squaredDeltaNpv.data(), yShift, yMultiplier);
+
+    auto regressorPtrs = vec2vecptr(regressors);
+    Array coefficients =
+        regressionCoefficients(regressand, regressorPtrs, basisFns, Filter(), RandomVariableRegressionMethod::SVD);
+    RandomVariable conditionalVariance = conditionalExpectation(regressorPtrs, basisFns, coefficients);
+    LOG("DIM data normalisation for netting set " << n << " at time step " << j << ": " << scientific << setprecision(6)
+                                                  << " x-shift = " << xShift << " x-multiplier = " << xMultiplier
+                                                  << " y-shift = " << yShift << " y-multiplier = " << yMultiplier);
+    LOG("DIM regression coefficients for netting set " << n << " at time step " << j << ": " << fixed
+                                                       << setprecision(6) << coefficients);
+
+    // Local regression versus first regression variable (i.e. we do not perform a
+    // multidimensional local regression):
+    // We evaluate this at a limited number of samples only for validation purposes.
+    // Note that computational effort scales quadratically with number of samples.
+    // NadarayaWatson needs a large number of samples for good results.
+    const Real* rx0 = regressorColumn(n, j, 0);
+    QuantLib::ext::shared_ptr<QuantExt::NadarayaWatson> lr;
+    Size localRegressionSamples = samples;
+    if (localRegressionEvaluations_ > 0) {
+        lr = QuantLib::ext::make_shared<QuantExt::NadarayaWatson>(rx0, rx0 + samples, deltaNpv.begin(),
+                                                                  GaussianKernel(0.0, localRegressionBandWidth_));
+        localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
+    }
+
+    // Evaluate regression function to compute DIM for each scenario
+    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
+    for (Size k = 0; k < samples; ++k) {
+        Real e = conditionalVariance[k] / yMultiplier - yShift;
+        if (e < 0.0) {
+            Array regressor(regressionDimension);
+            for (Size i = 0; i < regressionDimension; ++i)
+                regressor[i] = regressorColumn(n, j, i)[k];
+            LOG("Negative variance regression for netting set " << n << ", date " << j << ", sample " << k
+                                                                << ", regressor = " << regressor);
+        }
+
+        // Note:
+        // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
+        //    and to avoid a second regression for the conditional mean
+        // 2) In particular the linear regression function can yield negative variance values in
+        //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
+        //    variance approaching zero. We correct this here by taking the positive part.
+        Real std = sqrt(std::max(e, 0.0));
+        Real dim = std * scalingFactor / numDefault[k];
+        dimResult[k] = dim;
+        expectedDim += dim / samples;
+
+        // Evaluate the Kernel regression for a subset of the samples only (performance)
+        if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
+            localDimResult[k] = lr->standardDeviation(rx0[k]) * scalingFactor / numDefault[k];
+        else
+            localDimResult[k] = 0.0;
+    }
+}
+
+void RegressionDynamicInitialMarginCalculator::fillRegressors(const string& nettingSet, Size dateIndex) {
+    if (regressors_.empty())
+        return;
+    Size samples = cube_->samples();
+    Real* data = regressorData_.at(nettingSet).data() + dateIndex * regressors_.size() * samples;
+    for (Size i = 0; i < regressors_.size(); ++i, data += samples) {
+        const string& variable = regressors_[i];
+        // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
+        if (boost::to_upper_copy(variable) == "NPV") {
+            const vector<Real>& npv = nettingSetNPV_.at(nettingSet)[dateIndex];
+            std::copy(npv.begin(), npv.end(), data);
+            continue;
+        }
+        AggregationScenarioDataType type;
+        if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
+            type = AggregationScenarioDataType::IndexFixing;
         else if (scenarioData_->has(AggregationScenarioDataType::FXSpot, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::FXSpot, dateIndex,
-                                                                      sampleIndex, variable);
+            type = AggregationScenarioDataType::FXSpot;
         else if (scenarioData_->has(AggregationScenarioDataType::Generic, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Generic, dateIndex,
-                                                                      sampleIndex, variable);
+            type = AggregationScenarioDataType::Generic;
         else
             QL_FAIL("scenario data does not provide data for " << variable);
+        for (Size k = 0; k < samples; ++k)
+            data[k] = cubeInterpretation_->getDefaultAggregationScenarioData(type, dateIndex, k, variable);
     }
-    return a;
+}
+
+const Real* RegressionDynamicInitialMarginCalculator::regressorColumn(const string& nettingSet, Size dateIndex,
+                                                                      Size regressorIndex) const {
+    if (regressors_.empty())
+        return nettingSetNPV_.at(nettingSet)[dateIndex].data();
+    Size samples = cube_->samples();
+    return regressorData_.at(nettingSet).data() + (dateIndex * regressors_.size() + regressorIndex) * samples;
 }
 
 map<string, Real> RegressionDynamicInitialMarginCalculator::unscaledCurrentDIM() {
@@ -467,8 +558,17 @@ void RegressionDynamicInitialMarginCalculator::exportDimRegression(
             numeraires[k] =
                 cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, timeStep, k);
 
-        auto p = sort_permutation(regressorArray_[nettingSet][timeStep], lessThan);
-        vector<Array> reg = apply_permutation(regressorArray_[nettingSet][timeStep], p);
+        // sort the samples by the first regressor
+        Size regressionDimension = regressors_.empty() ? 1 : regressors_.size();
+        vector<vector<Real>> reg(regressionDimension);
+        for (Size i = 0; i < regressionDimension; ++i) {
+            const Real* column = regressorColumn(nettingSet, timeStep, i);
+            reg[i] = vector<Real>(column, column + samples);
+        }
+        auto lessThan = [](Real a, Real b) { return a < b; };
+        auto p = sort_permutation(reg[0], lessThan);
+        for (auto& r : reg)
+            r = apply_permutation(r, p);
         vector<Real> dim = apply_permutation(nettingSetDIM_[nettingSet][timeStep], p);
         vector<Real> ldim = apply_permutation(nettingSetLocalDIM_[nettingSet][timeStep], p);
         vector<Real> delta = apply_permutation(nettingSetDeltaNPV_[nettingSet][timeStep], p);
@@ -476,7 +576,7 @@ void RegressionDynamicInitialMarginCalculator::exportDimRegression(
 
         QuantLib::ext::shared_ptr<ore::data::Report> regReport = dimRegReports[ii];
         regReport->addColumn("Sample", Size());
-        for (Size k = 0; k < reg[0].size(); ++k) {
+        for (Size k = 0; k < reg.size(); ++k) {
             ostringstream o;
             o << "Regressor_" << k << "_";
             o << (regressors_.empty() ? "NPV" : regressors_[k]);
@@ -493,10 +593,10 @@ void RegressionDynamicInitialMarginCalculator::exportDimRegression(
         // but ExpectedDIM, ZeroOrderDIM and SimpleDIM _are_ reduced by the numeraire.
         // This is so that the regression formula can be manually validated
 
-        for (Size j = 0; j < reg.size(); ++j) {
+        for (Size j = 0; j < samples; ++j) {
             regReport->next().add(j);
-            for (Size k = 0; k < reg[j].size(); ++k)
-                regReport->add(reg[j][k]);
+            for (Size k = 0; k < reg.size(); ++k)
+                regReport->add(reg[k][j]);
             regReport->add(dim[j] * num[j])
                 .add(ldim[j] * num[j])
                 .add(nettingSetExpectedDIM_[nettingSet][timeStep])
@@ -36,6 +36,10 @@ using namespace std;
 /*!
   Dynamic IM is estimated using polynomial and local regression methods applied to the NPV moves over simulation time
   steps across all paths.
+
+  The regressor values are stored in one contiguous buffer per netting set, column by column, and the basis functions
+  are evaluated on whole columns. The regressions for the (netting set, date) pairs are independent and run on nThreads
+  worker threads, each writing its own results, so that the results do not depend on the number of threads.
 */
 class RegressionDynamicInitialMarginCalculator : public DynamicInitialMarginCalculator {
 public:
@@ -63,7 +67,9 @@ public:
         //! Local regression band width in standard deviations of the regression variable
         Real localRegressionBandWidth = 0,
 	//! Actual t0 IM by netting set used to scale the DIM evolution, no scaling if the argument is omitted
-	const std::map<std::string, Real>& currentIM = std::map<std::string, Real>());
+	const std::map<std::string, Real>& currentIM = std::map<std::string, Real>(),
+        //! Number of threads used for the regressions
+        Size nThreads = 1);
 
     map<string, Real> unscaledCurrentDIM() override;
     void build() override;
@@ -78,16 +84,23 @@ public:
     const vector<Real>& simpleResultsLower(const string& nettingSet);
 
 private:
-    //! Compile the array of DIM regressors for the specified netting set, date and sample index
-    Array regressorArray(string nettingSet, Size dateIndex, Size sampleIndex);
+    //! Regression and DIM evaluation for the specified netting set and date
+    void buildDate(const string& nettingSet, Size nettingSetIndex, Size dateIndex, Real nettingSetDimScaling);
+    //! Fill the regressor columns for the specified netting set and date
+    void fillRegressors(const string& nettingSet, Size dateIndex);
+    //! Values of a regressor over all samples for the specified netting set and date
+    const Real* regressorColumn(const string& nettingSet, Size dateIndex, Size regressorIndex) const;
 
     Size regressionOrder_;
     vector<string> regressors_;
     Size localRegressionEvaluations_;
     Real localRegressionBandWidth_;
+    Size nThreads_;
 
-    // For each netting set: Array of regressor values by date and sample
-    map<string, vector<vector<Array>>> regressorArray_;
+    /* For each netting set: regressor values, column major by date and regressor, i.e. the value for date j,
+       regressor i and sample k is at index (j * #regressors + i) * #samples + k. Empty if the regression is
+       against the netting set NPV. */
+    map<string, vector<Real>> regressorData_;
     // For each netting set: local regression DIM estimate by date and sample
     map<string, vector<vector<Real>>> nettingSetLocalDIM_;
     // For each netting set: vector of values by date, aggregated over trades and samples
@@ -96,11 +109,5 @@ private:
     map<string, vector<Real>> nettingSetSimpleDIMp_;
 };
 
-inline bool lessThan(const Array& a, const Array& b) {
-    QL_REQUIRE(a.size() > 0, "array a is empty");
-    QL_REQUIRE(b.size() > 0, "array a is empty");
-    return a[0] < b[0];
-}
-
 } // namespace analytics
 } // namespace ore
@@ -23,6 +23,11 @@
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -44,7 +49,8 @@ NettedExposureCalculator::NettedExposureCalculator(
     const QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator, const bool fullInitialCollateralisation,
     const bool marginalAllocation, const Real marginalAllocationLimit,
     const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode)
+    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+    const Size nThreads)
     : portfolio_(portfolio), market_(market), cube_(cube), baseCurrency_(baseCurrency), configuration_(configuration),
       quantile_(quantile), calcType_(calcType), multiPath_(multiPath), nettingSetManager_(nettingSetManager),
       collateralBalances_(collateralBalances),
@@ -55,7 +61,7 @@ NettedExposureCalculator::NettedExposureCalculator(
       marginalAllocation_(marginalAllocation), marginalAllocationLimit_(marginalAllocationLimit),
       tradeExposureCube_(tradeExposureCube), allocatedEpeIndex_(allocatedEpeIndex),
       allocatedEneIndex_(allocatedEneIndex), flipViewXVA_(flipViewXVA), withMporStickyDate_(withMporStickyDate),
-      mporCashFlowMode_(mporCashFlowMode) {
+      mporCashFlowMode_(mporCashFlowMode), nThreads_(nThreads) {
 
     set<string> nettingSetIds;
     for (auto nettingSet : nettingSetDefaultValue) {
@@ -128,6 +134,8 @@ void NettedExposureCalculator::build() {
     vector<vector<Real>> averagePositiveAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
     vector<vector<Real>> averageNegativeAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
 
+    map<string, CollateralPaths> collateralPathsByNettingSet = collateralPaths(nettingSetValueToday, nettingSetMaturity);
+
     Size nettingSetCount = 0;
     for (auto n : nettingSetDefaultValue_) {
         string nettingSetId = n.first;
@@ -151,11 +159,7 @@ void NettedExposureCalculator::build() {
         LOG("Aggregate exposure for netting set " << nettingSetId);
         // Get the collateral account balance paths for the netting set.
         // The pointer may remain empty if there is no CSA or if it is inactive.
-        QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral =
-            collateralPaths(nettingSetId,
-                            nettingSetValueToday[nettingSetId],
-                            nettingSetDefaultValue_[nettingSetId],
-                            nettingSetMaturity[nettingSetId]);
+        CollateralPaths collateral = collateralPathsByNettingSet[nettingSetId];
 
 	// Get the CSA index for Eonia Floor calculation below
         colva_[nettingSetId] = 0.0;
@@ -430,18 +434,16 @@ void NettedExposureCalculator::build() {
     }
 }
 
-QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
+std::function<NettedExposureCalculator::CollateralPaths(Size)>
 NettedExposureCalculator::collateralPaths(
     const string& nettingSetId,
     const Real& nettingSetValueToday,
     const vector<vector<Real>>& nettingSetValue,
     const Date& nettingSetMaturity) {
 
-    QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral;
-
     if (!nettingSetManager_->has(nettingSetId) || !nettingSetManager_->get(nettingSetId)->activeCsaFlag()) {
         LOG("CSA missing or inactive for netting set " << nettingSetId);
-        return collateral;
+        return std::function<CollateralPaths(Size)>();
     }
 
     // retrieve collateral balances object, if possible
@@ -451,7 +453,7 @@ NettedExposureCalculator::collateralPaths(
         LOG("got collateral balances for netting set " << nettingSetId);
     }
     
-    LOG("Build collateral account balance paths for netting set " << nettingSetId);
+    LOG("Prepare collateral account balance paths for netting set " << nettingSetId);
     QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
     string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
     Real csaFxRateToday = 1.0;
@@ -469,9 +471,14 @@ NettedExposureCalculator::collateralPaths(
     Real csaRateToday = market_->iborIndex(csaIndexName, configuration_)->fixing(today);
     LOG("CSA compounding rate for index " << csaIndexName << " = " << setprecision(8) << csaRateToday << " as of " << today);
 
-    // Copy scenario data to keep the collateral exposure helper unchanged
-    vector<vector<Real>> csaScenFxRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
-    vector<vector<Real>> csaScenRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
+    // Copy scenario data to keep the collateral exposure helper unchanged, the matrices are shared with the job
+    // below, so that they are neither copied into the job nor into the collateral exposure helper
+    auto csaScenFxRatesPtr = QuantLib::ext::make_shared<vector<vector<Real>>>(cube_->dates().size(),
+                                                                              vector<Real>(cube_->samples(), 0.0));
+    auto csaScenRatesPtr = QuantLib::ext::make_shared<vector<vector<Real>>>(cube_->dates().size(),
+                                                                            vector<Real>(cube_->samples(), 0.0));
+    vector<vector<Real>>& csaScenFxRates = *csaScenFxRatesPtr;
+    vector<vector<Real>>& csaScenRates = *csaScenRatesPtr;
     if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
         QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::FXSpot, netting->csaDetails()->csaCurrency()),
                    "scenario data does not provide FX rates for " << csaFxPair);
@@ -494,22 +501,92 @@ NettedExposureCalculator::collateralPaths(
         }
     }
 
-    collateral = CollateralExposureHelper::collateralBalancePaths(
-        netting,              // this netting set's definition
-        nettingSetValueToday, // today's netting set NPV
-        market_->asofDate(),  // original evaluation date
-        nettingSetValue,      // matrix of netting set values by date and sample
-        nettingSetMaturity,   // netting set's maximum maturity date
-        cube_->dates(),               // vector of future evaluation dates
-        csaFxRateToday,       // today's FX rate for CSA to base currency, possibly 1
-        csaScenFxRates,       // matrix of fx rates by date and sample, possibly 1
-        csaRateToday,         // today's collateral compounding rate in CSA currency
-        csaScenRates,         // matrix of CSA ccy short rates by date and sample
-        calcType_,
-        balance);             // initial collateral balances (VM, IM, IA) for the netting set
-    LOG("Collateral account balance paths for netting set " << nettingSetId << " done");
-
-    return collateral;
+    Date asof = market_->asofDate();
+    auto dates = QuantLib::ext::make_shared<vector<Date>>(cube_->dates());
+    CollateralExposureHelper::CalculationType calcType = calcType_;
+    return [=, &nettingSetValue](const Size nThreads) {
+        LOG("Build collateral account balance paths for netting set " << nettingSetId);
+        const vector<vector<Real>>& csaScenFxRates = *csaScenFxRatesPtr;
+        const vector<vector<Real>>& csaScenRates = *csaScenRatesPtr;
+        CollateralPaths collateral = CollateralExposureHelper::collateralBalancePaths(
+            netting,              // this netting set's definition
+            nettingSetValueToday, // today's netting set NPV
+            asof,                 // original evaluation date
+            nettingSetValue,      // matrix of netting set values by date and sample
+            nettingSetMaturity,   // netting set's maximum maturity date
+            *dates,               // vector of future evaluation dates
+            csaFxRateToday,       // today's FX rate for CSA to base currency, possibly 1
+            csaScenFxRates,       // matrix of fx rates by date and sample, possibly 1
+            csaRateToday,         // today's collateral compounding rate in CSA currency
+            csaScenRates,         // matrix of CSA ccy short rates by date and sample
+            calcType,
+            balance,              // initial collateral balances (VM, IM, IA) for the netting set
+            nThreads);
+        LOG("Collateral account balance paths for netting set " << nettingSetId << " done");
+        return collateral;
+    };
+}
+
+map<string, NettedExposureCalculator::CollateralPaths>
+NettedExposureCalculator::collateralPaths(const map<string, Real>& nettingSetValueToday,
+                                          const map<string, Date>& nettingSetMaturity) {
+
+    // set up the jobs sequentially, since they access the market
+
+    vector<string> nettingSetIds;
+    vector<std::function<CollateralPaths(Size)>> jobs;
+    for (auto const& [nettingSetId, values] : nettingSetDefaultValue_) {
+        auto v = nettingSetValueToday.find(nettingSetId);
+        auto m = nettingSetMaturity.find(nettingSetId);
+        auto job = collateralPaths(nettingSetId, v == nettingSetValueToday.end() ? 0.0 : v->second, values,
+                                   m == nettingSetMaturity.end() ? Date() : m->second);
+        if (job) {
+            nettingSetIds.push_back(nettingSetId);
+            jobs.push_back(std::move(job));
+        }
+    }
+
+    map<string, CollateralPaths> result;
+    if (jobs.empty())
+        return result;
+
+    // run the jobs, the netting sets are distributed over the threads, remaining threads are used within the jobs
+
+    Size effThreads = std::max<Size>(1, std::min(nThreads_, jobs.size()));
+    Size threadsPerJob = std::max<Size>(1, nThreads_ / jobs.size());
+    vector<CollateralPaths> paths(jobs.size());
+    vector<std::exception_ptr> errors(jobs.size());
+    std::atomic<Size> next(0);
+    auto worker = [&jobs, &paths, &errors, &next, threadsPerJob]() {
+        for (Size i = next++; i < jobs.size(); i = next++) {
+            try {
+                paths[i] = jobs[i](threadsPerJob);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    if (effThreads == 1) {
+        worker();
+    } else {
+        LOG("Build collateral account balance paths for " << jobs.size() << " netting sets on " << effThreads
+                                                          << " threads");
+        vector<std::thread> workers;
+        for (Size t = 0; t < effThreads; ++t)
+            workers.emplace_back(worker);
+        for (auto& w : workers)
+            w.join();
+    }
+
+    // report the error of the first failing netting set, as in a sequential run
+    for (Size i = 0; i < jobs.size(); ++i) {
+        if (errors[i])
+            std::rethrow_exception(errors[i]);
+        result[nettingSetIds[i]] = paths[i];
+    }
+
+    return result;
 }
 
 vector<Real> NettedExposureCalculator::getMeanExposure(const string& tid, ExposureIndex index) {
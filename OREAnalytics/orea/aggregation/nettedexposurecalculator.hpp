@@ -29,6 +29,8 @@
 
 #include <ored/portfolio/nettingsetmanager.hpp>
 
+#include <functional>
+
 namespace ore {
 namespace analytics {
 using namespace QuantLib;
@@ -60,7 +62,9 @@ public:
         // Marginal Allocation
         const bool marginalAllocation, const Real marginalAllocationLimit,
         const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode);
+        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+        // Number of threads used to build the collateral balance paths
+        const Size nThreads = 1);
 
     virtual ~NettedExposureCalculator() {}
     const QuantLib::ext::shared_ptr<NPVCube>& exposureCube() { return exposureCube_; }
@@ -137,14 +141,22 @@ protected:
     map<string, Real> collateralFloor_;
     vector<Real> getMeanExposure(const string& tid, ExposureIndex index);
 
-    QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
-    collateralPaths(const string& nettingSetId,
-        const Real& nettingSetValueToday,
-        const vector<vector<Real>>& nettingSetValue,
-        const Date& nettingSetMaturity);
+    typedef QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> CollateralPaths;
+
+    /*! Returns a job building the collateral balance paths of a netting set, taking the number of threads to use.
+        The market data is retrieved when the job is set up, so that the jobs of several netting sets can be run
+        concurrently. Returns an empty function if the netting set has no active CSA. */
+    std::function<CollateralPaths(Size)> collateralPaths(const string& nettingSetId, const Real& nettingSetValueToday,
+                                                         const vector<vector<Real>>& nettingSetValue,
+                                                         const Date& nettingSetMaturity);
+
+    //! Builds the collateral balance paths for all netting sets, processing the netting sets in parallel
+    map<string, CollateralPaths> collateralPaths(const map<string, Real>& nettingSetValueToday,
+                                                 const map<string, Date>& nettingSetMaturity);
 
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    Size nThreads_;
 };
 
 } // namespace analytics
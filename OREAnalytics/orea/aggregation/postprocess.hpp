@@ -169,7 +169,9 @@ public:
         //! If set to true, cash flows in the margin period of risk are ignored in the collateral modelling
         bool withMporStickyDate = false,
         //! Treatment of cash flows over the margin period of risk
-        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified);
+        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified,
+        //! Number of threads to use in the post processing steps supporting parallel execution
+        const Size nThreads = 1);
 
     void setDimCalculator(QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator> dimCalculator) {
         dimCalculator_ = dimCalculator;
@@ -381,6 +383,7 @@ protected:
     std::vector<std::vector<Real>> creditMigrationPdf_;
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    Size nThreads_;
 };
 
 } // namespace analytics
@@ -162,6 +162,11 @@ QuantLib::ext::shared_ptr<EngineFactory> Analytic::Impl::engineFactory() {
     LOG("Analytic::engineFactory() called");
     // Note: Calling the constructor here with empty extry builders
     // Override this function in case you have got extra ones
+    return buildEngineFactory(analytic()->market());
+}
+
+QuantLib::ext::shared_ptr<EngineFactory>
+Analytic::Impl::buildEngineFactory(const QuantLib::ext::shared_ptr<Market>& market) const {
     QuantLib::ext::shared_ptr<EngineData> edCopy = QuantLib::ext::make_shared<EngineData>(*inputs_->pricingEngine());
     edCopy->globalParameters()["GenerateAdditionalResults"] = to_string(generateAdditionalResults());
     edCopy->globalParameters()["RunType"] = "NPV";
@@ -170,7 +175,7 @@ QuantLib::ext::shared_ptr<EngineFactory> Analytic::Impl::engineFactory() {
     configurations[MarketContext::fxCalibration] = inputs_->marketConfig("fxcalibration");
     configurations[MarketContext::pricing] = inputs_->marketConfig("pricing");
     LOG("MarketContext::pricing = " << inputs_->marketConfig("pricing"));
-    return QuantLib::ext::make_shared<EngineFactory>(edCopy, analytic()->market(), configurations,
+    return QuantLib::ext::make_shared<EngineFactory>(edCopy, market, configurations,
                                              inputs_->refDataManager(),
                                              *inputs_->iborFallbackConfig());
 }
@@ -183,12 +188,27 @@ void Analytic::buildMarket(const QuantLib::ext::shared_ptr<ore::data::InMemoryLo
     QL_REQUIRE(loader, "market data loader not set");
     QL_REQUIRE(configurations().curveConfig, "curve configurations not set");
     
+    // no exclusion of securities from the bond spread implication in ore, just in ore+
+    const std::string bondSpreadImplyExcludeRegex;
+
     // first build the market if we have a todaysMarketParams
-    if (configurations().todaysMarketParams) {
+    TodaysMarketCache::Key cacheKey;
+    if (configurations().todaysMarketParams && inputs_->todaysMarketCache())
+        cacheKey = TodaysMarketCache::key(configurations().asofDate, *configurations().todaysMarketParams,
+                                          *configurations().curveConfig, *loader, inputs()->continueOnError(),
+                                          inputs()->lazyMarketBuilding(), bondSpreadImplyExcludeRegex,
+                                          *inputs()->iborFallbackConfig());
+    TodaysMarketCache::Entry cached;
+    if (configurations().todaysMarketParams && inputs_->todaysMarketCache() &&
+        inputs_->todaysMarketCache()->get(cacheKey, cached)) {
+        LOG("Reuse cached market for asof " << configurations().asofDate);
+        loader_ = cached.loader;
+        market_ = cached.market;
+    } else if (configurations().todaysMarketParams) {
         try {
-            // imply bond spreads (no exclusion of securities in ore, just in ore+) and add results to loader
+            // imply bond spreads and add results to loader
             auto bondSpreads = implyBondSpreads(configurations().asofDate, inputs_, configurations_.todaysMarketParams,
-                                                loader, configurations_.curveConfig, std::string());
+                                                loader, configurations_.curveConfig, bondSpreadImplyExcludeRegex);
 
             // Join the loaders
             loader_ = QuantLib::ext::make_shared<CompositeLoader>(loader, bondSpreads);
@@ -201,6 +221,8 @@ void Analytic::buildMarket(const QuantLib::ext::shared_ptr<ore::data::InMemoryLo
                 configurations().asofDate, configurations().todaysMarketParams, loader_, configurations().curveConfig,
                 inputs()->continueOnError(), true, inputs()->lazyMarketBuilding(), inputs()->refDataManager(), false,
                 *inputs()->iborFallbackConfig());
+            if (inputs_->todaysMarketCache())
+                inputs_->todaysMarketCache()->add(cacheKey, {loader_, market_});
         } catch (const std::exception& e) {
             if (marketRequired)
                 QL_FAIL("Failed to build market: " << e.what());
@@ -234,9 +256,15 @@ void Analytic::buildPortfolio() {
     if (market_) {
         replaceTrades();
 
-        LOG("Build the portfolio");
-        QuantLib::ext::shared_ptr<EngineFactory> factory = impl()->engineFactory();
-        portfolio()->build(factory, "analytic/" + label());
+        auto engineFactoryMaker = impl()->engineFactoryMaker();
+        if (engineFactoryMaker && inputs()->nThreads() > 1) {
+            LOG("Build the portfolio using " << inputs()->nThreads() << " threads");
+            portfolio()->build(engineFactoryMaker, inputs()->nThreads(), "analytic/" + label());
+        } else {
+            LOG("Build the portfolio");
+            QuantLib::ext::shared_ptr<EngineFactory> factory = impl()->engineFactory();
+            portfolio()->build(factory, "analytic/" + label());
+        }
 
         // remove dates that will have matured
         Date maturityDate = inputs()->asof();
@@ -38,6 +38,7 @@
 #include <orea/app/marketcalibrationreport.hpp>
 
 #include <boost/any.hpp>
+#include <functional>
 #include <iostream>
 
 namespace ore {
@@ -186,6 +187,12 @@ public:
     //! build an engine factory
     virtual QuantLib::ext::shared_ptr<ore::data::EngineFactory> engineFactory();
 
+    /*! maker for the engine factories of the worker threads of a multi-threaded portfolio build, see
+        Portfolio::build(), an empty function if the analytic builds its portfolio on one thread only */
+    virtual std::function<QuantLib::ext::shared_ptr<ore::data::EngineFactory>(QuantLib::Size)> engineFactoryMaker() {
+        return {};
+    }
+
     void setLabel(const string& label) { label_ = label; }
     const std::string& label() const { return label_; };
 
@@ -213,6 +220,10 @@ public:
     virtual std::vector<QuantLib::Date> additionalMarketDates() const { return {}; }
 
 protected:
+    //! the engine factory returned by engineFactory() for a given market
+    QuantLib::ext::shared_ptr<ore::data::EngineFactory>
+    buildEngineFactory(const QuantLib::ext::shared_ptr<ore::data::Market>& market) const;
+
     QuantLib::ext::shared_ptr<InputParameters> inputs_;
 
     //! label for logging purposes primarily
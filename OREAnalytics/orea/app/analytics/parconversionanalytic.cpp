@@ -24,6 +24,8 @@
 #include <orea/scenario/deltascenariofactory.hpp>
 #include <orea/scenario/scenario.hpp>
 #include <orea/scenario/shiftscenariogenerator.hpp>
+#include <ored/marketdata/clonedloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
 #include <ored/utilities/to_string.hpp>
 
 using namespace ore::data;
@@ -95,7 +97,27 @@ void ParConversionAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore:
 
         simMarket->scenarioGenerator() = scenarioGenerator;
 
-        parAnalysis->computeParInstrumentSensitivities(simMarket);
+        ParSensitivityAnalysis::SimMarketFactory simMarketFactory;
+        if (inputs_->nThreads() > 1) {
+            // each worker thread builds its own market from a clone of the market data, the clones are created
+            // here, so that the worker threads do not read from the shared loader
+            std::vector<QuantLib::ext::shared_ptr<ore::data::Loader>> loaders;
+            for (Size i = 0; i < inputs_->nThreads(); ++i)
+                loaders.push_back(QuantLib::ext::make_shared<ClonedLoader>(inputs_->asof(), loader));
+            simMarketFactory = [this, loaders, &configs](Size id) {
+                auto market = QuantLib::ext::make_shared<TodaysMarket>(
+                    inputs_->asof(), configs.todaysMarketParams, loaders.at(id), configs.curveConfig, true, true,
+                    true, inputs_->refDataManager(), false, *inputs_->iborFallbackConfig());
+                return QuantLib::ext::make_shared<ScenarioSimMarket>(
+                    market, configs.simMarketParams, inputs_->marketConfig("pricing"),
+                    configs.curveConfig ? *configs.curveConfig : ore::data::CurveConfigurations(),
+                    configs.todaysMarketParams ? *configs.todaysMarketParams : ore::data::TodaysMarketParameters(),
+                    true, configs.sensiScenarioData->useSpreadedTermStructures(), false, false,
+                    *inputs_->iborFallbackConfig());
+            };
+        }
+
+        parAnalysis->computeParInstrumentSensitivities(simMarket, inputs_->nThreads(), simMarketFactory);
 
         QuantLib::ext::shared_ptr<ParSensitivityConverter> parConverter =
             QuantLib::ext::make_shared<ParSensitivityConverter>(parAnalysis->parSensitivities(), parAnalysis->shiftSizes());
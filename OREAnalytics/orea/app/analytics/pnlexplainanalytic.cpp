@@ -18,6 +18,7 @@
 
 #include <orea/app/analytics/pnlexplainanalytic.hpp>
 #include <orea/app/analytics/pricinganalytic.hpp>
+#include <orea/engine/compactsensitivitystream.hpp>
 #include <orea/engine/pnlexplainreport.hpp>
 #include <orea/engine/sensitivityreportstream.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
@@ -68,6 +69,7 @@ void PnlExplainAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::da
     analytic()->reports()[label_]["sensitivity"] = sensireport;
     ext::shared_ptr<SensitivityStream> ss = ext::make_shared<SensitivityReportStream>(sensiAnalytic->reports().at("SENSITIVITY").at("sensitivity"));
     ss = ext::make_shared<FilteredSensitivityStream>(ss, 1e-6);
+    ss = ext::make_shared<CompactSensitivityStream>(*ss);
 
     auto sensiReports = sensiAnalytic->reports();
 
@@ -21,6 +21,7 @@
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <orea/engine/parsensitivitycubestream.hpp>
+#include <ored/marketdata/clonedloader.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 
 using namespace ore::data;
@@ -47,6 +48,29 @@ void PricingAnalyticImpl::setUpConfigurations() {
     setGenerateAdditionalResults(true);
 }
 
+std::function<QuantLib::ext::shared_ptr<EngineFactory>(Size)> PricingAnalyticImpl::engineFactoryMaker() {
+    auto todaysMarket = QuantLib::ext::dynamic_pointer_cast<TodaysMarket>(analytic()->market());
+    if (!todaysMarket || !analytic()->loader())
+        return {};
+
+    // the loaders are cloned here, so that the worker threads do not read from the shared loader
+    std::vector<QuantLib::ext::shared_ptr<ore::data::Loader>> loaders;
+    for (Size i = 0; i < inputs_->nThreads(); ++i)
+        loaders.push_back(QuantLib::ext::make_shared<ClonedLoader>(inputs_->asof(), analytic()->loader()));
+    auto bootstrappedYieldCurveNodes = todaysMarket->bootstrappedYieldCurveNodes();
+    auto obsMode = inputs_->observationModel();
+
+    return [this, loaders, bootstrappedYieldCurveNodes, obsMode](Size id) {
+        ObservationMode::instance().setMode(obsMode);
+        auto const& configs = analytic()->configurations();
+        auto market = QuantLib::ext::make_shared<TodaysMarket>(
+            configs.asofDate, configs.todaysMarketParams, loaders.at(id), configs.curveConfig,
+            inputs_->continueOnError(), true, inputs_->lazyMarketBuilding(), inputs_->refDataManager(), false,
+            *inputs_->iborFallbackConfig(), true, true, bootstrappedYieldCurveNodes);
+        return buildEngineFactory(market);
+    };
+}
+
 void PricingAnalyticImpl::runAnalytic( 
     const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader, 
     const std::set<std::string>& runTypes) {
@@ -164,6 +188,9 @@ void PricingAnalyticImpl::runAnalytic(
                     inputs_->refDataManager(), *inputs_->iborFallbackConfig(), true, inputs_->dryRun());
                 LOG("Multi-threaded sensi analysis created");
             }
+            sensiAnalysis->useAd(inputs_->sensiUseAd());
+            sensiAnalysis->useAnalyticDeltaGamma(inputs_->sensiUseAnalyticDeltaGamma());
+            sensiAnalysis->enableProfiling(inputs_->valuationProfile());
             // FIXME: Why are these disabled?
             set<RiskFactorKey::KeyType> typesDisabled{RiskFactorKey::KeyType::OptionletVolatility};
             QuantLib::ext::shared_ptr<ParSensitivityAnalysis> parAnalysis = nullptr;
@@ -221,7 +248,29 @@ void PricingAnalyticImpl::runAnalytic(
                     parAnalysis->relevantRiskFactors() = collectRiskFactors;
                     LOG("optimiseRiskFactors active : parSensi risk factors set to zeroSensi risk factors");
                 }
-                parAnalysis->computeParInstrumentSensitivities(sensiAnalysis->simMarket());
+                ParSensitivityAnalysis::SimMarketFactory simMarketFactory;
+                if (inputs_->nThreads() > 1) {
+                    // each worker thread builds its own market from a clone of the market data, the clones are
+                    // created here, so that the worker threads do not read from the shared loader
+                    std::vector<QuantLib::ext::shared_ptr<ore::data::Loader>> loaders;
+                    for (Size i = 0; i < inputs_->nThreads(); ++i)
+                        loaders.push_back(QuantLib::ext::make_shared<ClonedLoader>(inputs_->asof(), loader));
+                    simMarketFactory = [this, loaders, &configuration](Size id) {
+                        auto const& configs = analytic()->configurations();
+                        auto market = QuantLib::ext::make_shared<TodaysMarket>(
+                            inputs_->asof(), configs.todaysMarketParams, loaders.at(id), configs.curveConfig, true,
+                            true, true, inputs_->refDataManager(), false, *inputs_->iborFallbackConfig());
+                        return QuantLib::ext::make_shared<ScenarioSimMarket>(
+                            market, configs.simMarketParams, configuration,
+                            configs.curveConfig ? *configs.curveConfig : ore::data::CurveConfigurations(),
+                            configs.todaysMarketParams ? *configs.todaysMarketParams
+                                                       : ore::data::TodaysMarketParameters(),
+                            true, configs.sensiScenarioData->useSpreadedTermStructures(), false, false,
+                            *inputs_->iborFallbackConfig());
+                    };
+                }
+                parAnalysis->computeParInstrumentSensitivities(sensiAnalysis->simMarket(), inputs_->nThreads(),
+                                                               simMarketFactory);
                 QuantLib::ext::shared_ptr<ParSensitivityConverter> parConverter =
                     QuantLib::ext::make_shared<ParSensitivityConverter>(parAnalysis->parSensitivities(), parAnalysis->shiftSizes());
                 auto parCube = QuantLib::ext::make_shared<ZeroToParCube>(sensiAnalysis->sensiCubes(), parConverter, typesDisabled, true);
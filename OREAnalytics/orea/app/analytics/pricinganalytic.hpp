@@ -39,6 +39,10 @@ public:
         const std::set<std::string>& runTypes = {}) override;
 
     void setUpConfigurations() override;
+
+    /*! each worker builds the portfolio against its own TodaysMarket, built from a clone of the analytic's loader
+        with the yield curve nodes bootstrapped for the analytic's market */
+    std::function<QuantLib::ext::shared_ptr<ore::data::EngineFactory>(QuantLib::Size)> engineFactoryMaker() override;
 };
 
 static const std::set<std::string> pricingAnalyticSubAnalytics {"NPV", "CASHFLOW", "CASHFLOWNPV", "SENSITIVITY"};
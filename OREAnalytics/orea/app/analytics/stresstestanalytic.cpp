@@ -24,6 +24,8 @@
 #include <orea/engine/stresstest.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
+#include <ored/marketdata/clonedloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
 
 using namespace ore::data;
 using namespace boost::filesystem;
@@ -88,11 +90,29 @@ void StressTestAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::da
     std::string marketConfig = inputs_->marketConfig("pricing");
     std::vector<QuantLib::ext::shared_ptr<ore::data::EngineBuilder>> extraEngineBuilders;
     std::vector<QuantLib::ext::shared_ptr<ore::data::LegBuilder>> extraLegBuilders;
+    StressTest::MarketFactory marketFactory;
+    if (inputs_->nThreads() > 1) {
+        // each worker thread builds its own market from a clone of the market data, reusing the bootstrapped yield
+        // curve nodes of the analytic's market, the loaders are cloned here, so that the worker threads do not
+        // read the shared loader concurrently
+        BootstrappedYieldCurveNodes nodes;
+        if (auto tm = QuantLib::ext::dynamic_pointer_cast<TodaysMarket>(analytic()->market()))
+            nodes = tm->bootstrappedYieldCurveNodes();
+        std::vector<QuantLib::ext::shared_ptr<Loader>> loaders;
+        for (Size i = 0; i < inputs_->nThreads(); ++i)
+            loaders.push_back(QuantLib::ext::make_shared<ClonedLoader>(inputs_->asof(), loader));
+        marketFactory = [this, loaders, nodes](Size id) -> QuantLib::ext::shared_ptr<Market> {
+            auto const& configs = analytic()->configurations();
+            return QuantLib::ext::make_shared<TodaysMarket>(
+                inputs_->asof(), configs.todaysMarketParams, loaders.at(id), configs.curveConfig, true, true, true,
+                inputs_->refDataManager(), false, *inputs_->iborFallbackConfig(), false, true, nodes);
+        };
+    }
     QuantLib::ext::shared_ptr<StressTest> stressTest = QuantLib::ext::make_shared<StressTest>(
         analytic()->portfolio(), analytic()->market(), marketConfig, inputs_->pricingEngine(),
         analytic()->configurations().simMarketParams, scenarioData, *analytic()->configurations().curveConfig,
         *analytic()->configurations().todaysMarketParams, nullptr, inputs_->refDataManager(),
-        *inputs_->iborFallbackConfig(), inputs_->continueOnError());
+        *inputs_->iborFallbackConfig(), inputs_->continueOnError(), inputs_->nThreads(), marketFactory);
     stressTest->writeReport(report, inputs_->stressThreshold());
     analytic()->reports()[label()]["stress"] = report;
     CONSOLE("OK");
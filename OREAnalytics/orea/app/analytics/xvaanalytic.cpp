@@ -364,6 +364,9 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
         ValuationEngine engine(inputs_->asof(), grid_, simMarket_);
         engine.registerProgressIndicator(progressBar);
         engine.registerProgressIndicator(progressLog);
+        if (inputs_->npvMemoisation())
+            engine.enableNpvMemoisation(inputs_->npvMemoisationExcludedTradeTypes());
+        engine.enableProfiling(inputs_->valuationProfile());
         engine.buildCube(portfolio, cube_, calculators(),
                          analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), nettingSetCube_,
                          cptyCube_, cptyCalculators());
@@ -408,6 +411,9 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
             cptyCubeFactory, "xva-simulation", offsetScenario_);
 
         engine.setAggregationScenarioData(*scenarioData_);
+        if (inputs_->npvMemoisation())
+            engine.enableNpvMemoisation(inputs_->npvMemoisationExcludedTradeTypes());
+        engine.enableProfiling(inputs_->valuationProfile());
         engine.registerProgressIndicator(progressBar);
         engine.registerProgressIndicator(progressLog);
 
@@ -626,7 +632,7 @@ void XvaAnalyticImpl::runPostProcessor() {
             dimCalculator_ = QuantLib::ext::make_shared<RegressionDynamicInitialMarginCalculator>(
                 inputs_, analytic()->portfolio(), cube_, cubeInterpreter_, *scenarioData_, dimQuantile,
                 dimHorizonCalendarDays, dimRegressionOrder, dimRegressors, dimLocalRegressionEvaluations,
-                dimLocalRegressionBandwidth, currentIM);
+                dimLocalRegressionBandwidth, currentIM, inputs_->nThreads());
         } else {
             LOG("dim calculator not set, create FlatDynamicInitialMarginCalculator");
             dimCalculator_ = QuantLib::ext::make_shared<FlatDynamicInitialMarginCalculator>(
@@ -652,7 +658,8 @@ void XvaAnalyticImpl::runPostProcessor() {
         kvaTheirPdFloor, kvaOurCvaRiskWeight, kvaTheirCvaRiskWeight, cptyCube_, flipViewBorrowingCurvePostfix,
         flipViewLendingCurvePostfix, inputs_->creditSimulationParameters(), inputs_->creditMigrationDistributionGrid(),
         inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(),
-        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode());
+        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode(),
+        inputs_->nThreads());
     LOG("post done");
 }
 
@@ -669,13 +676,16 @@ void XvaAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InM
             inputs_->amcPricingEngine(), inputs_->crossAssetModelData(), inputs_->scenarioGeneratorData(),
             inputs_->portfolio(), inputs_->marketConfig("simulation"), inputs_->marketConfig("simulation"),
             inputs_->xvaCgSensiScenarioData(), inputs_->refDataManager(), *inputs_->iborFallbackConfig(),
+            inputs_->nettingSetManager(), inputs_->dvaName(), inputs_->fvaBorrowingCurve(), inputs_->fvaLendingCurve(),
             inputs_->xvaCgBumpSensis(), inputs_->xvaCgUseExternalComputeDevice(),
             inputs_->xvaCgExternalDeviceCompatibilityMode(), inputs_->xvaCgUseDoublePrecisionForExternalCalculation(),
             inputs_->xvaCgExternalComputeDevice(), true, true);
 
         analytic()->reports()["XVA"]["xvacg-exposure"] = engine.exposureReport();
+        analytic()->reports()["XVA"]["xvacg-exposure-nettingset"] = engine.nettingSetExposureReport();
+        analytic()->reports()["XVA"]["xvacg-xva"] = engine.xvaReport();
         if (inputs_->xvaCgSensiScenarioData())
-            analytic()->reports()["XVA"]["xvacg-cva-sensi-scenario"] = engine.sensiReport();
+            analytic()->reports()["XVA"]["xvacg-xva-sensi-scenario"] = engine.sensiReport();
         return;
     }
 
@@ -171,6 +171,19 @@ void AnalyticsManager::runAnalytics(const QuantLib::ext::shared_ptr<MarketCalibr
         reports_["STATS"]["pricingstats"] = pricingStatsReport;
     }
 
+    if (auto profile = inputs_->valuationProfile()) {
+        auto tradesReport = QuantLib::ext::make_shared<InMemoryReport>();
+        auto tradeTypesReport = QuantLib::ext::make_shared<InMemoryReport>();
+        auto stepsReport = QuantLib::ext::make_shared<InMemoryReport>();
+        ReportWriter reportWriter(inputs_->reportNaString());
+        reportWriter.writeValuationProfileTrades(*tradesReport, *profile);
+        reportWriter.writeValuationProfileTradeTypes(*tradeTypesReport, *profile);
+        reportWriter.writeValuationProfileSteps(*stepsReport, *profile);
+        reports_["STATS"]["valuationprofile_trades"] = tradesReport;
+        reports_["STATS"]["valuationprofile_tradetypes"] = tradeTypesReport;
+        reports_["STATS"]["valuationprofile_steps"] = stepsReport;
+    }
+
     if (marketCalibrationReport) {
         auto report = marketCalibrationReport->outputCalibrationReport();
         if (report) {
@@ -246,7 +259,7 @@ bool endsWith(const std::string& name, const std::string& suffix) {
 void AnalyticsManager::toFile(const ore::analytics::Analytic::analytic_reports& rpts, const std::string& outputPath,
                               const std::map<std::string, std::string>& reportNames, const char sep,
                               const bool commentCharacter, char quoteChar, const string& nullString,
-                              const std::set<std::string>& lowerHeaderReportNames) {
+                              const std::set<std::string>& lowerHeaderReportNames, const bool binary) {
     std::map<std::string, Size> hits = checkReportNames(rpts);    
     for (const auto& rep : rpts) {
         string analytic = rep.first;
@@ -266,6 +279,16 @@ void AnalyticsManager::toFile(const ore::analytics::Analytic::analytic_reports&
                 fileName = analytic + "_" + reportName + "_" + to_string(hits[fileName]);
             }
 
+            if (binary) {
+                // replace a csv or txt suffix by the binary one
+                if (endsWith(fileName, ".csv") || endsWith(fileName, ".txt"))
+                    fileName = fileName.substr(0, fileName.size() - 4);
+                std::string fullFileName = outputPath + "/" + fileName + ".bin";
+                report->toBinaryFile(fullFileName);
+                LOG("report " << reportName << " written to " << fullFileName);
+                continue;
+            }
+
             // attach a suffix only if it does not have one already
             string suffix = "";
             if (!endsWith(fileName,".csv") && !endsWith(fileName, ".txt"))
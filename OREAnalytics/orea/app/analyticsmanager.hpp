@@ -61,11 +61,11 @@ public:
     Analytic::analytic_stresstests const stressTests();
     
     // Write all reports to files, reportNames map can be used to replace standard report names
-    // with custom names
+    // with custom names, if binary is true the reports are written in binary columnar format
     void toFile(const Analytic::analytic_reports& reports, const std::string& outputPath,
                 const std::map<std::string, std::string>& reportNames = {}, const char sep = ',',
                 const bool commentCharacter = false, char quoteChar = '\0', const string& nullString = "#N/A",
-                const std::set<std::string>& lowerHeaderReportNames = {});
+                const std::set<std::string>& lowerHeaderReportNames = {}, const bool binary = false);
 
 private:
     std::map<std::string, QuantLib::ext::shared_ptr<Analytic>> analytics_;
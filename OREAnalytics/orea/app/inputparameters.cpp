@@ -467,6 +467,12 @@ void InputParameters::setAmcTradeTypes(const std::string& s) {
     amcTradeTypes_ = std::set<std::string>(v.begin(), v.end());
 }
     
+void InputParameters::setNpvMemoisationExcludedTradeTypes(const std::string& s) {
+    // parse to set<string>
+    auto v = parseListOfValues(s);
+    npvMemoisationExcludedTradeTypes_ = std::set<std::string>(v.begin(), v.end());
+}
+
 void InputParameters::setCvaSensiGrid(const std::string& s) {
     // parse to vector<Period>
     cvaSensiGrid_ = parseListOfValues<Period>(s, &parsePeriod);
@@ -25,8 +25,10 @@
 #include <boost/filesystem/path.hpp>
 #include <orea/aggregation/creditsimulationparameters.hpp>
 #include <orea/app/parameters.hpp>
+#include <orea/app/todaysmarketcache.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/engine/sensitivitystream.hpp>
+#include <orea/engine/valuationprofile.hpp>
 #include <orea/scenario/scenariogenerator.hpp>
 #include <orea/scenario/scenariogeneratorbuilder.hpp>
 #include <orea/scenario/historicalscenarioreader.hpp>
@@ -95,8 +97,10 @@ public:
     void setTodaysMarketParamsFromFile(const std::string& fileName);
     void setPortfolio(const std::string& xml); 
     void setPortfolioFromFile(const std::string& fileNameString, const std::filesystem::path& inputPath); 
+    void setPortfolio(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio) { portfolio_ = portfolio; }
     void setMarketConfigs(const std::map<std::string, std::string>& m);
     void setThreads(int i) { nThreads_ = i; }
+    void setTodaysMarketCache(const QuantLib::ext::shared_ptr<TodaysMarketCache>& cache) { todaysMarketCache_ = cache; }
     void setEntireMarket(bool b) { entireMarket_ = b; }
     void setAllFixings(bool b) { allFixings_ = b; }
     void setEomInflationFixings(bool b) { eomInflationFixings_ = b; }
@@ -106,7 +110,10 @@ public:
     void setCsvQuoteChar(const char& c){ csvQuoteChar_ = c; }
     void setCsvSeparator(const char& c) { csvSeparator_ = c; }
     void setCsvCommentCharacter(const char& c) { csvCommentCharacter_ = c; }
+    void setBinaryReports(bool b) { binaryReports_ = b; }
     void setDryRun(bool b) { dryRun_ = b; }
+    // create a profile recording the timings of the valuation engine runs, or remove it
+    void setValuationProfile(bool b) { valuationProfile_ = b ? QuantLib::ext::make_shared<ValuationProfile>() : nullptr; }
     void setMporDays(Size s) { mporDays_ = s; }
     void setMporOverlappingPeriods(bool b) { mporOverlappingPeriods_ = b; }
     void setMporDate(const QuantLib::Date& d) { mporDate_ = d; }
@@ -134,6 +141,8 @@ public:
     void setUseSensiSpreadedTermStructures(bool b) { useSensiSpreadedTermStructures_ = b; }
     void setSensiThreshold(Real r) { sensiThreshold_ = r; }
     void setSensiRecalibrateModels(bool b) { sensiRecalibrateModels_ = b; }
+    void setSensiUseAd(bool b) { sensiUseAd_ = b; }
+    void setSensiUseAnalyticDeltaGamma(bool b) { sensiUseAnalyticDeltaGamma_ = b; }
     void setSensiSimMarketParams(const std::string& xml);
     void setSensiSimMarketParamsFromFile(const std::string& fileName);
     void setSensiScenarioData(const std::string& xml);
@@ -208,6 +217,8 @@ public:
     void setStoreFlows(bool b) { storeFlows_ = b; }
     void setStoreCreditStateNPVs(Size states) { storeCreditStateNPVs_ = states; }
     void setStoreSurvivalProbabilities(bool b) { storeSurvivalProbabilities_ = b; }
+    void setNpvMemoisation(bool b) { npvMemoisation_ = b; }
+    void setNpvMemoisationExcludedTradeTypes(const std::string& s); // parse to set<string>
     void setWriteCube(bool b) { writeCube_ = b; }
     void setWriteScenarios(bool b) { writeScenarios_ = b; }
     void setExposureSimMarketParams(const std::string& xml);
@@ -451,6 +462,7 @@ public:
 
     QuantLib::Size maxRetries() const { return maxRetries_; }
     QuantLib::Size nThreads() const { return nThreads_; }
+    const QuantLib::ext::shared_ptr<TodaysMarketCache>& todaysMarketCache() const { return todaysMarketCache_; }
     bool entireMarket() const { return entireMarket_; }
     bool allFixings() const { return allFixings_; }
     bool eomInflationFixings() const { return eomInflationFixings_; }
@@ -462,7 +474,9 @@ public:
     char csvQuoteChar() const { return csvQuoteChar_; }
     char csvSeparator() const { return csvSeparator_; }
     char csvEscapeChar() const { return csvEscapeChar_; }
+    bool binaryReports() const { return binaryReports_; }
     bool dryRun() const { return dryRun_; }
+    const QuantLib::ext::shared_ptr<ValuationProfile>& valuationProfile() const { return valuationProfile_; }
     QuantLib::Size mporDays() const { return mporDays_; }
     QuantLib::Date mporDate();
     const QuantLib::Calendar mporCalendar() {
@@ -505,6 +519,8 @@ public:
     bool useSensiSpreadedTermStructures() const { return useSensiSpreadedTermStructures_; }
     QuantLib::Real sensiThreshold() const { return sensiThreshold_; }
     bool sensiRecalibrateModels() const { return sensiRecalibrateModels_; }
+    bool sensiUseAd() const { return sensiUseAd_; }
+    bool sensiUseAnalyticDeltaGamma() const { return sensiUseAnalyticDeltaGamma_; }
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& sensiSimMarketParams() const { return sensiSimMarketParams_; }
     const QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData>& sensiScenarioData() const { return sensiScenarioData_; }
     const QuantLib::ext::shared_ptr<ore::data::EngineData>& sensiPricingEngine() const { return sensiPricingEngine_; }
@@ -581,6 +597,8 @@ public:
     bool storeFlows() const { return storeFlows_; }
     Size storeCreditStateNPVs() const { return storeCreditStateNPVs_; }
     bool storeSurvivalProbabilities() const { return storeSurvivalProbabilities_; }
+    bool npvMemoisation() const { return npvMemoisation_; }
+    const std::set<std::string>& npvMemoisationExcludedTradeTypes() const { return npvMemoisationExcludedTradeTypes_; }
     bool writeCube() const { return writeCube_; }
     bool writeScenarios() const { return writeScenarios_; }
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& exposureSimMarketParams() const { return exposureSimMarketParams_; }
@@ -810,6 +828,7 @@ protected:
     QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio_, useCounterpartyOriginalPortfolio_;
     QuantLib::Size maxRetries_ = 7;
     QuantLib::Size nThreads_ = 1;
+    QuantLib::ext::shared_ptr<TodaysMarketCache> todaysMarketCache_;
    
     bool entireMarket_ = false; 
     bool allFixings_ = false; 
@@ -822,7 +841,9 @@ protected:
     char csvQuoteChar_ = '\0';
     char csvEscapeChar_ = '\\';
     std::string reportNaString_ = "#N/A";
+    bool binaryReports_ = false;
     bool dryRun_ = false;
+    QuantLib::ext::shared_ptr<ValuationProfile> valuationProfile_;
     QuantLib::Date mporDate_;
     QuantLib::Size mporDays_ = 10;
     bool mporOverlappingPeriods_ = true;
@@ -857,6 +878,8 @@ protected:
     bool useSensiSpreadedTermStructures_ = true;
     QuantLib::Real sensiThreshold_ = 1e-6;
     bool sensiRecalibrateModels_ = true;
+    bool sensiUseAd_ = false;
+    bool sensiUseAnalyticDeltaGamma_ = false;
     QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters> sensiSimMarketParams_;
     QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData> sensiScenarioData_;
     QuantLib::ext::shared_ptr<ore::data::EngineData> sensiPricingEngine_;
@@ -924,6 +947,8 @@ protected:
     bool storeFlows_ = false;
     Size storeCreditStateNPVs_ = 0;
     bool storeSurvivalProbabilities_ = false;
+    bool npvMemoisation_ = false;
+    std::set<std::string> npvMemoisationExcludedTradeTypes_;
     bool writeCube_ = false;
     bool writeScenarios_ = false;
     QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters> exposureSimMarketParams_;
@@ -255,7 +255,8 @@ void OREApp::analytics() {
         analyticsManager_->toFile(reports,
                                   inputs_->resultsPath().string(), outputs_->fileNameMap(),
                                   inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
-                                  inputs_->csvQuoteChar(), inputs_->reportNaString());
+                                  inputs_->csvQuoteChar(), inputs_->reportNaString(), {},
+                                  inputs_->binaryReports());
 
         // Write npv cube(s)
         for (auto a : analyticsManager_->npvCubes()) {
@@ -625,10 +626,18 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "")
         setDryRun(parseBool(tmp));
 
+    tmp = params_->get("setup", "valuationProfile", false);
+    if (tmp != "")
+        setValuationProfile(parseBool(tmp));
+
     tmp = params_->get("setup", "reportNaString", false);
     if (tmp != "")
         setReportNaString(tmp);
 
+    tmp = params_->get("setup", "binaryReports", false);
+    if (tmp != "")
+        setBinaryReports(parseBool(tmp));
+
     tmp = params_->get("setup", "eomInflationFixings", false);
     if (tmp != "")
         setEomInflationFixings(parseBool(tmp));
@@ -902,6 +911,14 @@ void OREAppInputParameters::loadParameters() {
         tmp = params_->get("sensitivity", "recalibrateModels", false);
         if (tmp != "")
             setSensiRecalibrateModels(parseBool(tmp));
+
+        tmp = params_->get("sensitivity", "useAD", false);
+        if (tmp != "")
+            setSensiUseAd(parseBool(tmp));
+
+        tmp = params_->get("sensitivity", "useAnalyticDeltaGamma", false);
+        if (tmp != "")
+            setSensiUseAnalyticDeltaGamma(parseBool(tmp));
     }
 
     /************
@@ -1514,6 +1531,14 @@ void OREAppInputParameters::loadParameters() {
         if (tmp == "Y")
             setStoreSurvivalProbabilities(true);
 
+        tmp = params_->get("simulation", "npvMemoisation", false);
+        if (tmp != "")
+            setNpvMemoisation(parseBool(tmp));
+
+        tmp = params_->get("simulation", "npvMemoisationExcludedTradeTypes", false);
+        if (tmp != "")
+            setNpvMemoisationExcludedTradeTypes(tmp);
+
         tmp = params_->get("simulation", "nettingSetId", false);
         if (tmp != "")
             setNettingSetId(tmp);
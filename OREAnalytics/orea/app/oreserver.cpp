@@ -0,0 +1,224 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/app/cleanupsingletons.hpp>
+#include <orea/app/marketdatacsvloader.hpp>
+#include <orea/app/oreserver.hpp>
+
+#include <ored/marketdata/market.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/timer/timer.hpp>
+
+using namespace ore::data;
+using boost::timer::cpu_timer;
+using boost::timer::default_places;
+
+namespace ore {
+namespace analytics {
+
+OREServer::OREServer(QuantLib::ext::shared_ptr<Parameters> params, bool console,
+                     const boost::filesystem::path& logRootPath)
+    : OREApp(params, console, logRootPath), marketCache_(QuantLib::ext::make_shared<TodaysMarketCache>()) {}
+
+void OREServer::initialise() {
+
+    // clean start, as in OREApp::run()
+    {
+        CleanUpThreadLocalSingletons cleanupThreadLocalSingletons;
+        CleanUpThreadGlobalSingletons cleanupThreadGloablSingletons;
+        CleanUpLogSingleton cleanupLogSingleton(true, true);
+    }
+
+    initFromParams();
+
+    QuantLib::Settings::instance().evaluationDate() = inputs_->asof();
+    GlobalPseudoCurrencyMarketParameters::instance().set(inputs_->pricingEngine()->globalParameters());
+    InstrumentConventions::instance().setConventions(inputs_->conventions());
+
+    csvLoader_ = buildCsvLoader(params_);
+    marketDataLoader_ = QuantLib::ext::make_shared<MarketDataCsvLoader>(inputs_, csvLoader_);
+
+    marketCache_->clear();
+    inputs_->setTodaysMarketCache(marketCache_);
+
+    initialised_ = true;
+    LOG("OREServer initialised");
+}
+
+void OREServer::serve(std::istream& in, std::ostream& out) {
+    std::string line;
+    while (std::getline(in, line)) {
+        boost::trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+        if (boost::to_upper_copy(line) == "QUIT") {
+            out << "OK" << std::endl;
+            break;
+        }
+        out << process(line) << std::endl;
+    }
+    LOG("OREServer stopped serving");
+}
+
+std::string OREServer::process(const std::string& request) {
+    LOG("OREServer: processing request '" << request << "'");
+    try {
+        std::vector<std::string> tokens;
+        std::string r = boost::trim_copy(request);
+        boost::split(tokens, r, boost::is_space(), boost::token_compress_on);
+        QL_REQUIRE(!tokens.empty() && !tokens[0].empty(), "empty request");
+        std::string command = boost::to_upper_copy(tokens[0]);
+
+        if (!initialised_ || command == "RELOAD")
+            initialise();
+        if (structuredLogger_)
+            structuredLogger_->clear();
+
+        if (command == "RELOAD") {
+            return "OK";
+        } else if (command == "RUN") {
+            QL_REQUIRE(tokens.size() == 2 || tokens.size() == 3, "expected RUN analytics [tradeIds]");
+            return runAnalytics(tokens[1], tokens.size() == 3 ? tokens[2] : std::string());
+        } else if (command == "TRADES") {
+            QL_REQUIRE(tokens.size() == 2, "expected TRADES file");
+            return addTrades(tokens[1]);
+        } else if (command == "REMOVE") {
+            QL_REQUIRE(tokens.size() == 2, "expected REMOVE tradeIds");
+            return removeTrades(tokens[1]);
+        } else if (command == "QUOTES") {
+            QL_REQUIRE(tokens.size() == 2, "expected QUOTES file");
+            return setQuotes(tokens[1]);
+        }
+        QL_FAIL("unknown request '" << tokens[0] << "'");
+    } catch (const std::exception& e) {
+        std::string msg = e.what();
+        ALOG("OREServer: request '" << request << "' failed: " << msg);
+        boost::replace_all(msg, "\n", " ");
+        return "ERROR " + msg;
+    }
+}
+
+std::string OREServer::runAnalytics(const std::string& analytics, const std::string& tradeIds) {
+    cpu_timer timer;
+
+    QuantLib::Settings::instance().evaluationDate() = inputs_->asof();
+    inputs_->setAnalytics(analytics);
+
+    // restrict the portfolio to the requested trades for this run
+    QuantLib::ext::shared_ptr<Portfolio> portfolio = inputs_->portfolio();
+    if (!tradeIds.empty()) {
+        QL_REQUIRE(portfolio, "no portfolio loaded");
+        auto subset = QuantLib::ext::make_shared<Portfolio>(inputs_->buildFailedTrades());
+        for (auto const& id : parseListOfValues(tradeIds)) {
+            auto trade = portfolio->get(id);
+            QL_REQUIRE(trade, "trade '" << id << "' not found");
+            subset->add(trade);
+        }
+        inputs_->setPortfolio(subset);
+    }
+
+    std::set<std::string> reportNames;
+    try {
+        analyticsManager_ = QuantLib::ext::make_shared<AnalyticsManager>(inputs_, marketDataLoader_);
+        QL_REQUIRE(analyticsManager_->numberOfAnalytics() > 0,
+                   "none of the analytics '" << analytics << "' is configured");
+        analyticsManager_->runAnalytics();
+        Analytic::analytic_reports reports = analyticsManager_->reports();
+        analyticsManager_->toFile(reports, inputs_->resultsPath().string(), outputs_->fileNameMap(),
+                                  inputs_->csvSeparator(), inputs_->csvCommentCharacter(), inputs_->csvQuoteChar(),
+                                  inputs_->reportNaString(), {}, inputs_->binaryReports());
+        for (auto const& [_, rs] : reports)
+            for (auto const& [name, __] : rs)
+                reportNames.insert(name);
+    } catch (...) {
+        releaseRun(portfolio);
+        throw;
+    }
+    releaseRun(portfolio);
+
+    timer.stop();
+    LOG("OREServer: run of " << analytics << " done in " << timer.format(default_places, "%w") << " sec, "
+                             << cachedMarkets() << " markets cached");
+    return "OK " + boost::join(reportNames, ",");
+}
+
+void OREServer::releaseRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
+    // The trades and the analytics observe the cached markets. Reset the built instruments and drop the analytics,
+    // so that the observers registered by this run do not accumulate on the markets across runs.
+    analyticsManager_.reset();
+    inputs_->setPortfolio(portfolio);
+    if (portfolio)
+        portfolio->reset();
+}
+
+std::string OREServer::addTrades(const std::string& file) {
+    Portfolio trades(inputs_->buildFailedTrades());
+    trades.fromFile(file);
+    if (!inputs_->portfolio())
+        inputs_->setPortfolio(QuantLib::ext::make_shared<Portfolio>(inputs_->buildFailedTrades()));
+    QuantLib::Size added = 0, amended = 0;
+    for (auto const& [id, trade] : trades.trades()) {
+        if (inputs_->portfolio()->remove(id))
+            ++amended;
+        else
+            ++added;
+        inputs_->portfolio()->add(trade);
+    }
+    return "OK added=" + std::to_string(added) + " amended=" + std::to_string(amended);
+}
+
+std::string OREServer::removeTrades(const std::string& tradeIds) {
+    QuantLib::Size removed = 0;
+    if (inputs_->portfolio()) {
+        for (auto const& id : parseListOfValues(tradeIds))
+            removed += inputs_->portfolio()->remove(id) ? 1 : 0;
+    }
+    return "OK removed=" + std::to_string(removed);
+}
+
+std::string OREServer::setQuotes(const std::string& file) {
+    CSVLoader quotes(std::vector<std::string>{file}, std::vector<std::string>{}, false);
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> data = quotes.loadQuotes(inputs_->asof());
+    for (auto const& md : data)
+        csvLoader_->setQuote(inputs_->asof(), md->name(), md->quote()->value());
+
+    // update the cached markets in place, markets that can not be updated are rebuilt on the next run
+    QuantLib::Size updated = 0, removed = 0;
+    for (auto const& [key, entry] : marketCache_->entries()) {
+        try {
+            auto todaysMarket = QuantLib::ext::dynamic_pointer_cast<TodaysMarket>(entry.market);
+            QL_REQUIRE(todaysMarket, "market is not a TodaysMarket");
+            todaysMarket->update(data);
+            ++updated;
+        } catch (const std::exception& e) {
+            WLOG("OREServer: could not update cached market for asof " << std::get<0>(key) << " (" << e.what()
+                                                                       << "), it will be rebuilt");
+            marketCache_->remove(key);
+            ++removed;
+        }
+    }
+    return "OK quotes=" + std::to_string(data.size()) + " markets=" + std::to_string(updated) +
+           " removed=" + std::to_string(removed);
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,87 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/oreserver.hpp
+  \brief Long running ORE process serving requests on warm inputs
+  \ingroup app
+ */
+
+#pragma once
+
+#include <orea/app/marketdataloader.hpp>
+#include <orea/app/oreapp.hpp>
+#include <orea/app/todaysmarketcache.hpp>
+
+#include <iostream>
+#include <string>
+
+namespace ore {
+namespace analytics {
+
+//! ORE server mode
+/*! The server loads the inputs referenced by the ORE parameters once and keeps them in memory together with the
+    market data and the today's markets built by the analytics. Requests are read line by line, each request is
+    answered by a single line starting with OK or ERROR. The supported requests are
+
+    - RUN analytics [tradeIds]: run the given comma separated analytics, optionally on the given comma separated
+      subset of trades, and write the reports to the results path. Only analytics whose configuration is loaded by
+      the ORE parameters can be run.
+    - TRADES file: add the trades in the given portfolio file, trades with an existing id are replaced
+    - REMOVE tradeIds: remove the given comma separated trades
+    - QUOTES file: set the quotes in the given market data file for the asof date. The cached markets are updated
+      in place, only the objects depending on the changed quotes are rebuilt. Markets that can not be updated, e.g.
+      because a quote is new, are removed from the cache and rebuilt on the next run.
+    - RELOAD: reload all inputs
+    - QUIT: stop serving
+
+    The configuration is only reloaded on request. The portfolio is built by each analytics run, restricting a run to
+    a subset of the trades limits the build to this subset. After a run the built trades and the analytics are
+    released, so that they do not keep observing the cached markets.
+
+    \ingroup app
+*/
+class OREServer : public OREApp {
+public:
+    OREServer(QuantLib::ext::shared_ptr<Parameters> params, bool console = false,
+              const boost::filesystem::path& logRootPath = boost::filesystem::path());
+
+    //! Process requests from in and write the responses to out until QUIT or the end of the input
+    void serve(std::istream& in, std::ostream& out);
+
+    //! Process a single request and return the response
+    std::string process(const std::string& request);
+
+    //! The number of today's markets currently cached
+    QuantLib::Size cachedMarkets() const { return marketCache_->size(); }
+
+private:
+    void initialise();
+    std::string runAnalytics(const std::string& analytics, const std::string& tradeIds);
+    std::string addTrades(const std::string& file);
+    std::string removeTrades(const std::string& tradeIds);
+    std::string setQuotes(const std::string& file);
+    void releaseRun(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio);
+
+    bool initialised_ = false;
+    QuantLib::ext::shared_ptr<CSVLoader> csvLoader_;
+    QuantLib::ext::shared_ptr<MarketDataLoader> marketDataLoader_;
+    QuantLib::ext::shared_ptr<TodaysMarketCache> marketCache_;
+};
+
+} // namespace analytics
+} // namespace ore
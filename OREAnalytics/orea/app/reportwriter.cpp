@@ -678,11 +678,11 @@ void ReportWriter::writeCashflowNpv(ore::data::Report& report, const ore::data::
     map<string, Real> npvMap;
     Date asof = Settings::instance().evaluationDate();
     for (Size i = 0; i < cashflowReport.rows(); ++i) {
-        string tradeId = QuantLib::ext::get<string>(cashflowReport.data(tradeIdColumn).at(i));
-        string tradeType = QuantLib::ext::get<string>(cashflowReport.data(tradeTypeColumn).at(i));
-        Date payDate = QuantLib::ext::get<Date>(cashflowReport.data(payDateColumn).at(i));
-        string ccy = QuantLib::ext::get<string>(cashflowReport.data(ccyColumn).at(i));
-        Real pv = QuantLib::ext::get<Real>(cashflowReport.data(pvColumn).at(i));
+        string tradeId = QuantLib::ext::get<string>(cashflowReport.value(i, tradeIdColumn));
+        string tradeType = QuantLib::ext::get<string>(cashflowReport.value(i, tradeTypeColumn));
+        Date payDate = QuantLib::ext::get<Date>(cashflowReport.value(i, payDateColumn));
+        string ccy = QuantLib::ext::get<string>(cashflowReport.value(i, ccyColumn));
+        Real pv = QuantLib::ext::get<Real>(cashflowReport.value(i, pvColumn));
         Real fx = 1.0;
 	// There shouldn't be entries in the cf report without ccy. We assume ccy = baseCcy in this case and log an error.
         if (ccy.empty()) {
@@ -1491,6 +1491,81 @@ void ReportWriter::writePricingStats(ore::data::Report& report, const QuantLib::
     LOG("Pricing stats report written");
 }
 
+namespace {
+void addTimingColumns(ore::data::Report& report) {
+    report.addColumn("Count", Size())
+        .addColumn("CumulativeTiming", Size())
+        .addColumn("AverageTiming", double(), 2)
+        .addColumn("MaxTiming", Size());
+}
+void addTiming(ore::data::Report& report, const ValuationProfile::Timing& t) {
+    report.add(t.count)
+        .add(static_cast<Size>(t.total / 1000))
+        .add(t.average() / 1000.0)
+        .add(static_cast<Size>(t.max / 1000));
+}
+string profileDate(const Date& d) { return d == Date() ? string("All") : to_string(d); }
+} // namespace
+
+void ReportWriter::writeValuationProfileTrades(ore::data::Report& report, const ValuationProfile& profile) {
+
+    LOG("Writing valuation profile trades report");
+
+    report.addColumn("TradeId", string()).addColumn("TradeType", string());
+    addTimingColumns(report);
+    report.addColumn("NumberOfPricings", Size()).addColumn("CumulativePricingTiming", Size());
+
+    for (auto const& [tid, t] : profile.trades()) {
+        report.next().add(tid).add(t.tradeType);
+        addTiming(report, t.calculators);
+        report.add(t.pricings).add(static_cast<Size>(t.pricingTime / 1000));
+    }
+
+    report.end();
+    LOG("Valuation profile trades report written");
+}
+
+void ReportWriter::writeValuationProfileTradeTypes(ore::data::Report& report, const ValuationProfile& profile) {
+
+    LOG("Writing valuation profile trade types report");
+
+    report.addColumn("TradeType", string()).addColumn("Date", string());
+    addTimingColumns(report);
+
+    std::map<string, ValuationProfile::Timing> totals;
+    for (auto const& [k, t] : profile.tradeTypes())
+        totals[k.first].merge(t);
+
+    for (auto const& [tradeType, total] : totals) {
+        report.next().add(tradeType).add(profileDate(Date()));
+        addTiming(report, total);
+        for (auto t = profile.tradeTypes().lower_bound(std::make_pair(tradeType, Date()));
+             t != profile.tradeTypes().end() && t->first.first == tradeType; ++t) {
+            report.next().add(tradeType).add(profileDate(t->first.second));
+            addTiming(report, t->second);
+        }
+    }
+
+    report.end();
+    LOG("Valuation profile trade types report written");
+}
+
+void ReportWriter::writeValuationProfileSteps(ore::data::Report& report, const ValuationProfile& profile) {
+
+    LOG("Writing valuation profile steps report");
+
+    report.addColumn("Step", string()).addColumn("Date", string());
+    addTimingColumns(report);
+
+    for (auto const& [k, t] : profile.steps()) {
+        report.next().add(to_string(k.first)).add(profileDate(k.second));
+        addTiming(report, t);
+    }
+
+    report.end();
+    LOG("Valuation profile steps report written");
+}
+
 void ReportWriter::writeCube(ore::data::Report& report, const QuantLib::ext::shared_ptr<NPVCube>& cube,
                              const std::map<std::string, std::string>& nettingSetMap) {
     LOG("Writing cube report");
@@ -2412,14 +2487,14 @@ Real aggregateTradeFlow(const std::string& tradeId, const Date& d0, const Date&
 
     Real flow = 0.0;
     for (Size i = 0; i < cashFlowReport->rows(); ++i) {
-        string id = boost::get<string>(cashFlowReport->data(tradeIdColumn).at(i));
+        string id = boost::get<string>(cashFlowReport->value(i, tradeIdColumn));
 	if (id != tradeId)
 	    continue;
-	Date date = boost::get<Date>(cashFlowReport->data(dateColumn).at(i));
+	Date date = boost::get<Date>(cashFlowReport->value(i, dateColumn));
 	if (date <= d0 || date > d1)
 	    continue;
-	string ccy = boost::get<string>(cashFlowReport->data(ccyColumn).at(i));
-	Real amount = boost::get<Real>(cashFlowReport->data(amountColumn).at(i));
+	string ccy = boost::get<string>(cashFlowReport->value(i, ccyColumn));
+	Real amount = boost::get<Real>(cashFlowReport->value(i, amountColumn));
 	Real fx = 1.0;
 	if (ccy != baseCurrency)
 	    fx = market->fxRate(ccy + baseCurrency)->value();
@@ -2501,20 +2576,20 @@ void ReportWriter::writePnlReport(ore::data::Report& report,
 
     for (Size i = 0; i < t0NpvReport->rows(); ++i) {
         try {
-	    string tradeId = boost::get<string>(t0NpvReport->data(tradeIdColumn).at(i));
-	    string tradeId2 = boost::get<string>(t0NpvLaggedReport->data(tradeIdColumn).at(i));
-	    string tradeId3 = boost::get<string>(t1NpvLaggedReport->data(tradeIdColumn).at(i));
-	    string tradeId4 = boost::get<string>(t1NpvReport->data(tradeIdColumn).at(i));
+	    string tradeId = boost::get<string>(t0NpvReport->value(i, tradeIdColumn));
+	    string tradeId2 = boost::get<string>(t0NpvLaggedReport->value(i, tradeIdColumn));
+	    string tradeId3 = boost::get<string>(t1NpvLaggedReport->value(i, tradeIdColumn));
+	    string tradeId4 = boost::get<string>(t1NpvReport->value(i, tradeIdColumn));
 	    QL_REQUIRE(tradeId == tradeId2 && tradeId == tradeId3 && tradeId == tradeId4, "inconsistent ordering of NPV reports");
-	    string tradeType = boost::get<string>(t0NpvReport->data(tradeTypeColumn).at(i));
-	    Date maturityDate = boost::get<Date>(t0NpvReport->data(maturityDateColumn).at(i));
-            Real maturityTime = boost::get<Real>(t0NpvReport->data(maturityTimeColumn).at(i));
-	    string ccy = boost::get<string>(t0NpvReport->data(baseCcyColumn).at(i));
+	    string tradeType = boost::get<string>(t0NpvReport->value(i, tradeTypeColumn));
+	    Date maturityDate = boost::get<Date>(t0NpvReport->value(i, maturityDateColumn));
+            Real maturityTime = boost::get<Real>(t0NpvReport->value(i, maturityTimeColumn));
+	    string ccy = boost::get<string>(t0NpvReport->value(i, baseCcyColumn));
 	    QL_REQUIRE(ccy == baseCurrency, "inconsistent NPV and base currencies");
-            Real t0Npv = boost::get<Real>(t0NpvReport->data(npvBaseColumn).at(i));
-            Real t0NpvLagged = boost::get<Real>(t0NpvLaggedReport->data(npvBaseColumn).at(i));
-	    Real t1NpvLagged = boost::get<Real>(t1NpvLaggedReport->data(npvBaseColumn).at(i));
-	    Real t1Npv = boost::get<Real>(t1NpvReport->data(npvBaseColumn).at(i));
+            Real t0Npv = boost::get<Real>(t0NpvReport->value(i, npvBaseColumn));
+            Real t0NpvLagged = boost::get<Real>(t0NpvLaggedReport->value(i, npvBaseColumn));
+	    Real t1NpvLagged = boost::get<Real>(t1NpvLaggedReport->value(i, npvBaseColumn));
+	    Real t1Npv = boost::get<Real>(t1NpvReport->value(i, npvBaseColumn));
             
 	    Real hypotheticalCleanPnl = t0NpvLagged - t0Npv;
 	    Real periodFlow = aggregateTradeFlow(tradeId, startDate, endDate, t0CashFlowReport, market, baseCurrency);
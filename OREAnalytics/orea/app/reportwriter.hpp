@@ -30,6 +30,7 @@
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/sensitivitycube.hpp>
 #include <orea/engine/sensitivitystream.hpp>
+#include <orea/engine/valuationprofile.hpp>
 #include <orea/simm/crifrecord.hpp>
 #include <orea/simm/simmresults.hpp>
 #include <orea/simm/crif.hpp>
@@ -126,6 +127,12 @@ public:
 
     virtual void writePricingStats(ore::data::Report& report, const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
 
+    /*! Valuation engine timings per trade, per trade type and date and per engine step and date, see
+        ValuationProfile. Timings are in microseconds, the date "All" denotes the total over all dates. */
+    virtual void writeValuationProfileTrades(ore::data::Report& report, const ValuationProfile& profile);
+    virtual void writeValuationProfileTradeTypes(ore::data::Report& report, const ValuationProfile& profile);
+    virtual void writeValuationProfileSteps(ore::data::Report& report, const ValuationProfile& profile);
+
     virtual void writeCube(ore::data::Report& report, const QuantLib::ext::shared_ptr<NPVCube>& cube,
                            const std::map<std::string, std::string>& nettingSetMap = std::map<std::string, std::string>());
 
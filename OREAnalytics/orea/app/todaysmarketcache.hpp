@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/todaysmarketcache.hpp
+    \brief cache of today's markets shared between analytics runs
+    \ingroup app
+*/
+
+#pragma once
+
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/configuration/iborfallbackconfig.hpp>
+#include <ored/marketdata/loader.hpp>
+#include <ored/marketdata/market.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+
+#include <ql/shared_ptr.hpp>
+#include <ql/time/date.hpp>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace ore {
+namespace analytics {
+
+//! Cache of built today's markets
+/*! Analytics look up their market here before building it, so that the market is built only once across analytics
+    and across repeated runs on the same inputs. The key consists of
+
+    - the asof date and the XML representations of the today's market parameters and the curve configurations, so
+      that equal configurations loaded into different objects share a market,
+    - the identity of the market data loader, the cache entry keeps the loader alive, so its address is not reused,
+    - the market build flags, i.e. continue on error and lazy build, the regex of the securities excluded from the
+      bond spread implication and the XML representation of the ibor fallback config.
+
+    The cache does not track changes of the market data held by a loader, the owner has to update the cached markets
+    or remove them when the market data changes.
+
+    \ingroup app
+*/
+class TodaysMarketCache {
+public:
+    using Key = std::tuple<QuantLib::Date, std::string, std::string, const ore::data::Loader*, bool, bool, std::string,
+                           std::string>;
+
+    struct Entry {
+        //! the loader the market was built from
+        QuantLib::ext::shared_ptr<ore::data::Loader> loader;
+        QuantLib::ext::shared_ptr<ore::data::Market> market;
+    };
+
+    static Key key(const QuantLib::Date& asof, const ore::data::TodaysMarketParameters& todaysMarketParams,
+                   const ore::data::CurveConfigurations& curveConfigs, const ore::data::Loader& loader,
+                   const bool continueOnError, const bool lazyBuild, const std::string& bondSpreadImplyExcludeRegex,
+                   const ore::data::IborFallbackConfig& iborFallbackConfig) {
+        return Key(asof, todaysMarketParams.toXMLString(), curveConfigs.toXMLString(), &loader, continueOnError,
+                   lazyBuild, bondSpreadImplyExcludeRegex, iborFallbackConfig.toXMLString());
+    }
+
+    //! Returns true and sets the entry if the key is cached
+    bool get(const Key& key, Entry& entry) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto e = entries_.find(key);
+        if (e == entries_.end())
+            return false;
+        entry = e->second;
+        return true;
+    }
+
+    void add(const Key& key, const Entry& entry) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[key] = entry;
+    }
+
+    void remove(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(key);
+    }
+
+    //! Returns a copy of the cached entries
+    std::map<Key, Entry> entries() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    QuantLib::Size size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<Key, Entry> entries_;
+};
+
+} // namespace analytics
+} // namespace ore
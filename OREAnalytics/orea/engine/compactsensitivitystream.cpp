@@ -0,0 +1,234 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/compactsensitivitystream.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <ql/errors.hpp>
+
+#include <cstring>
+#include <fstream>
+
+using QuantLib::Real;
+using QuantLib::Size;
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+const char magic[8] = {'O', 'R', 'E', 'S', 'E', 'N', 'S', '1'};
+
+template <class T> void writeValue(std::ostream& os, const T& v) { os.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+
+template <class T> T readValue(std::istream& is) {
+    T v;
+    is.read(reinterpret_cast<char*>(&v), sizeof(T));
+    QL_REQUIRE(is, "CompactSensitivityStream: unexpected end of input");
+    return v;
+}
+
+void writeString(std::ostream& os, const string& s) {
+    writeValue<uint64_t>(os, s.size());
+    os.write(s.data(), s.size());
+}
+
+string readString(std::istream& is) {
+    string s(readValue<uint64_t>(is), '\0');
+    is.read(&s[0], s.size());
+    QL_REQUIRE(is, "CompactSensitivityStream: unexpected end of input");
+    return s;
+}
+
+template <class T> void writeColumn(std::ostream& os, const vector<T>& v) {
+    os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+template <class T> void readColumn(std::istream& is, vector<T>& v, Size n) {
+    v.resize(n);
+    is.read(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+    QL_REQUIRE(is, "CompactSensitivityStream: unexpected end of input");
+}
+
+} // namespace
+
+CompactSensitivityStream::CompactSensitivityStream() {
+    // id 0 refers to the empty values, i.e. to a default SensitivityRecord
+    tradeIdDictionary_.id(string());
+    keyDictionary_.id(RiskFactorKey());
+    stringDictionary_.id(string());
+}
+
+CompactSensitivityStream::CompactSensitivityStream(SensitivityStream& ss) : CompactSensitivityStream() { add(ss); }
+
+SensitivityRecord CompactSensitivityStream::next() {
+    // If there are no more records, return the empty record
+    if (current_ >= size())
+        return SensitivityRecord();
+    return record(current_++);
+}
+
+void CompactSensitivityStream::add(const SensitivityRecord& sr) {
+    tradeIds_.push_back(tradeIdDictionary_.id(sr.tradeId));
+    isPar_.push_back(sr.isPar);
+    keys1_.push_back(keyDictionary_.id(sr.key_1));
+    descs1_.push_back(stringDictionary_.id(sr.desc_1));
+    shifts1_.push_back(sr.shift_1);
+    keys2_.push_back(keyDictionary_.id(sr.key_2));
+    descs2_.push_back(stringDictionary_.id(sr.desc_2));
+    shifts2_.push_back(sr.shift_2);
+    currencies_.push_back(stringDictionary_.id(sr.currency));
+    baseNpvs_.push_back(sr.baseNpv);
+    deltas_.push_back(sr.delta);
+    gammas_.push_back(sr.gamma);
+}
+
+void CompactSensitivityStream::add(SensitivityStream& ss) {
+    ss.reset();
+    while (SensitivityRecord sr = ss.next())
+        add(sr);
+    DLOG("CompactSensitivityStream: holding " << size() << " records, " << tradeIdDictionary().size()
+                                              << " trade ids, " << keyDictionary().size() << " risk factor keys");
+}
+
+void CompactSensitivityStream::clear() {
+    for (auto c : {&tradeIds_, &keys1_, &descs1_, &keys2_, &descs2_, &currencies_})
+        c->clear();
+    for (auto c : {&shifts1_, &shifts2_, &baseNpvs_, &deltas_, &gammas_})
+        c->clear();
+    isPar_.clear();
+    reset();
+}
+
+SensitivityRecord CompactSensitivityStream::record(Size i) const {
+    QL_REQUIRE(i < size(), "CompactSensitivityStream: record index " << i << " out of range, size is " << size());
+    const auto& strings = stringDictionary_.values();
+    const auto& keys = keyDictionary_.values();
+    return SensitivityRecord(tradeIdDictionary_.values()[tradeIds_[i]], isPar_[i] != 0, keys[keys1_[i]],
+                             strings[descs1_[i]], shifts1_[i], keys[keys2_[i]], strings[descs2_[i]], shifts2_[i],
+                             strings[currencies_[i]], baseNpvs_[i], deltas_[i], gammas_[i]);
+}
+
+CompactSensitivityRecord CompactSensitivityStream::compactRecord(Size i) const {
+    QL_REQUIRE(i < size(), "CompactSensitivityStream: record index " << i << " out of range, size is " << size());
+    CompactSensitivityRecord r;
+    r.tradeId = tradeIds_[i];
+    r.isPar = isPar_[i] != 0;
+    r.key_1 = keys1_[i];
+    r.desc_1 = descs1_[i];
+    r.shift_1 = shifts1_[i];
+    r.key_2 = keys2_[i];
+    r.desc_2 = descs2_[i];
+    r.shift_2 = shifts2_[i];
+    r.currency = currencies_[i];
+    r.baseNpv = baseNpvs_[i];
+    r.delta = deltas_[i];
+    r.gamma = gammas_[i];
+    return r;
+}
+
+void CompactSensitivityStream::toBinary(std::ostream& os) const {
+    os.write(magic, sizeof(magic));
+    writeValue<uint64_t>(os, size());
+    writeValue<uint64_t>(os, tradeIdDictionary().size());
+    for (auto const& t : tradeIdDictionary())
+        writeString(os, t);
+    writeValue<uint64_t>(os, stringDictionary().size());
+    for (auto const& s : stringDictionary())
+        writeString(os, s);
+    writeValue<uint64_t>(os, keyDictionary().size());
+    for (auto const& k : keyDictionary()) {
+        writeValue<uint32_t>(os, static_cast<uint32_t>(k.keytype));
+        writeString(os, k.name);
+        writeValue<uint64_t>(os, k.index);
+    }
+    for (auto c : {&tradeIds_, &keys1_, &descs1_, &keys2_, &descs2_, &currencies_})
+        writeColumn(os, *c);
+    writeColumn(os, isPar_);
+    for (auto c : {&shifts1_, &shifts2_, &baseNpvs_, &deltas_, &gammas_})
+        writeColumn(os, *c);
+    QL_REQUIRE(os, "CompactSensitivityStream: error writing binary output");
+}
+
+void CompactSensitivityStream::toBinaryFile(const string& fileName) const {
+    std::ofstream os(fileName, std::ios::binary);
+    QL_REQUIRE(os, "CompactSensitivityStream: error opening file " << fileName);
+    toBinary(os);
+    LOG("Wrote " << size() << " sensitivity records to binary file " << fileName);
+}
+
+QuantLib::ext::shared_ptr<CompactSensitivityStream> CompactSensitivityStream::fromBinary(std::istream& is) {
+    char m[sizeof(magic)];
+    is.read(m, sizeof(m));
+    QL_REQUIRE(is && std::memcmp(m, magic, sizeof(magic)) == 0,
+               "CompactSensitivityStream: input is not a binary sensitivity file");
+
+    auto result = QuantLib::ext::make_shared<CompactSensitivityStream>();
+    Size n = readValue<uint64_t>(is);
+    Size nTradeIds = readValue<uint64_t>(is);
+    for (Size i = 0; i < nTradeIds; ++i)
+        QL_REQUIRE(result->tradeIdDictionary_.id(readString(is)) == i,
+                   "CompactSensitivityStream: duplicate trade id in binary input");
+    Size nStrings = readValue<uint64_t>(is);
+    for (Size i = 0; i < nStrings; ++i)
+        QL_REQUIRE(result->stringDictionary_.id(readString(is)) == i,
+                   "CompactSensitivityStream: duplicate string in binary input");
+    Size nKeys = readValue<uint64_t>(is);
+    for (Size i = 0; i < nKeys; ++i) {
+        auto keyType = static_cast<RiskFactorKey::KeyType>(readValue<uint32_t>(is));
+        string name = readString(is);
+        Size index = readValue<uint64_t>(is);
+        QL_REQUIRE(result->keyDictionary_.id(RiskFactorKey(keyType, name, index)) == i,
+                   "CompactSensitivityStream: duplicate risk factor key in binary input");
+    }
+    for (auto c : {&result->tradeIds_, &result->keys1_, &result->descs1_, &result->keys2_, &result->descs2_,
+                   &result->currencies_})
+        readColumn(is, *c, n);
+    readColumn(is, result->isPar_, n);
+    for (auto c : {&result->shifts1_, &result->shifts2_, &result->baseNpvs_, &result->deltas_, &result->gammas_})
+        readColumn(is, *c, n);
+
+    // check the ids, so that record() can not access the dictionaries out of range
+    auto checkIds = [n](const vector<uint32_t>& ids, Size dictionarySize) {
+        for (Size i = 0; i < n; ++i)
+            QL_REQUIRE(ids[i] < dictionarySize, "CompactSensitivityStream: invalid id in binary input");
+    };
+    checkIds(result->tradeIds_, nTradeIds);
+    checkIds(result->keys1_, nKeys);
+    checkIds(result->keys2_, nKeys);
+    checkIds(result->descs1_, nStrings);
+    checkIds(result->descs2_, nStrings);
+    checkIds(result->currencies_, nStrings);
+
+    return result;
+}
+
+QuantLib::ext::shared_ptr<CompactSensitivityStream> CompactSensitivityStream::fromBinaryFile(const string& fileName) {
+    std::ifstream is(fileName, std::ios::binary);
+    QL_REQUIRE(is, "CompactSensitivityStream: error opening file " << fileName);
+    auto result = fromBinary(is);
+    LOG("Read " << result->size() << " sensitivity records from binary file " << fileName);
+    return result;
+}
+
+} // namespace analytics
+} // namespace ore
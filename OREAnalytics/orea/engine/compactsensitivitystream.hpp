@@ -0,0 +1,157 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/compactsensitivitystream.hpp
+    \brief Class for streaming SensitivityRecords from a compact columnar container
+ */
+
+#pragma once
+
+#include <orea/engine/sensitivitystream.hpp>
+
+#include <ql/errors.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+/*! Compact representation of a SensitivityRecord, the trade id, the risk factor keys, the descriptions and the
+    currency are ids into the dictionaries of a CompactSensitivityStream
+*/
+struct CompactSensitivityRecord {
+    std::uint32_t tradeId = 0;
+    bool isPar = false;
+    std::uint32_t key_1 = 0;
+    std::uint32_t desc_1 = 0;
+    QuantLib::Real shift_1 = 0.0;
+    std::uint32_t key_2 = 0;
+    std::uint32_t desc_2 = 0;
+    QuantLib::Real shift_2 = 0.0;
+    std::uint32_t currency = 0;
+    QuantLib::Real baseNpv = 0.0;
+    QuantLib::Real delta = 0.0;
+    QuantLib::Real gamma = 0.0;
+};
+
+/*! Class for streaming SensitivityRecords from a compact in-memory container
+
+    The records are stored column by column. Each distinct trade id, risk factor key and string (descriptions and
+    currencies) is stored once in a dictionary, the records hold 32 bit ids into these dictionaries. The id 0 always
+    refers to the empty trade id, the default RiskFactorKey and the empty string respectively.
+
+    The container can be written to a binary file and read back. The layout (native byte order) is
+
+    <pre>
+     char[8]   magic "ORESENS1"
+     uint64    number of records
+     uint64    number of trade ids, trade ids (uint64 + char[])
+     uint64    number of strings, strings (uint64 + char[])
+     uint64    number of keys, keys (uint32 key type, uint64 + char[] name, uint64 index)
+     uint32[n] trade ids, key_1, desc_1, key_2, desc_2, currency
+     uint8[n]  isPar
+     double[n] shift_1, shift_2, baseNpv, delta, gamma
+    </pre>
+*/
+class CompactSensitivityStream : public SensitivityStream {
+public:
+    //! Default constructor
+    CompactSensitivityStream();
+    //! Constructor consuming all records of the given stream
+    explicit CompactSensitivityStream(SensitivityStream& ss);
+
+    //! Returns the next SensitivityRecord in the stream
+    SensitivityRecord next() override;
+    //! Resets the stream so that SensitivityRecords can be streamed again
+    void reset() override { current_ = 0; }
+
+    //! Add a record to the container, this does not reset the stream
+    void add(const SensitivityRecord& sr);
+    //! Add all records from the given stream to the container
+    void add(SensitivityStream& ss);
+    //! Remove all records, the dictionaries are kept
+    void clear();
+
+    //! \name Inspectors
+    //@{
+    QuantLib::Size size() const { return tradeIds_.size(); }
+    SensitivityRecord record(QuantLib::Size i) const;
+    CompactSensitivityRecord compactRecord(QuantLib::Size i) const;
+    //@}
+
+    //! \name Dictionaries
+    //@{
+    const std::vector<std::string>& tradeIdDictionary() const { return tradeIdDictionary_.values(); }
+    const std::vector<RiskFactorKey>& keyDictionary() const { return keyDictionary_.values(); }
+    const std::vector<std::string>& stringDictionary() const { return stringDictionary_.values(); }
+    //@}
+
+    //! \name Columns
+    //@{
+    const std::vector<std::uint32_t>& tradeIds() const { return tradeIds_; }
+    const std::vector<std::uint32_t>& keys1() const { return keys1_; }
+    const std::vector<std::uint32_t>& keys2() const { return keys2_; }
+    const std::vector<QuantLib::Real>& baseNpvs() const { return baseNpvs_; }
+    const std::vector<QuantLib::Real>& deltas() const { return deltas_; }
+    const std::vector<QuantLib::Real>& gammas() const { return gammas_; }
+    //@}
+
+    //! \name Binary format
+    //@{
+    void toBinary(std::ostream& os) const;
+    void toBinaryFile(const std::string& fileName) const;
+    static QuantLib::ext::shared_ptr<CompactSensitivityStream> fromBinary(std::istream& is);
+    static QuantLib::ext::shared_ptr<CompactSensitivityStream> fromBinaryFile(const std::string& fileName);
+    //@}
+
+private:
+    template <class T> class Dictionary {
+    public:
+        std::uint32_t id(const T& v) {
+            QL_REQUIRE(values_.size() < std::numeric_limits<std::uint32_t>::max(),
+                       "CompactSensitivityStream: dictionary size exceeds the 32 bit id range");
+            auto [it, inserted] = index_.try_emplace(v, static_cast<std::uint32_t>(values_.size()));
+            if (inserted)
+                values_.push_back(v);
+            return it->second;
+        }
+        const std::vector<T>& values() const { return values_; }
+
+    private:
+        std::vector<T> values_;
+        std::unordered_map<T, std::uint32_t> index_;
+    };
+
+    Dictionary<std::string> tradeIdDictionary_;
+    Dictionary<RiskFactorKey> keyDictionary_;
+    Dictionary<std::string> stringDictionary_;
+
+    std::vector<std::uint32_t> tradeIds_, keys1_, descs1_, keys2_, descs2_, currencies_;
+    std::vector<char> isPar_;
+    std::vector<QuantLib::Real> shifts1_, shifts2_, baseNpvs_, deltas_, gammas_;
+
+    QuantLib::Size current_ = 0;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,275 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/deltagammanpvcalculator.hpp>
+
+#include <ored/portfolio/instrumentwrapper.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <qle/cashflows/overnightindexedcoupon.hpp>
+#include <qle/currencies/currencycomparator.hpp>
+#include <qle/instruments/fxforward.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
+#include <ql/instruments/swap.hpp>
+#include <ql/math/comparison.hpp>
+
+#include <boost/any.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+// the cashflow types for which the DiscountingSwapEngineDeltaGamma provides complete deltas and gammas
+bool isSupportedCashflow(const QuantLib::ext::shared_ptr<CashFlow>& c) {
+    if (auto ibor = QuantLib::ext::dynamic_pointer_cast<IborCoupon>(c))
+        return !ibor->isInArrears();
+    return QuantLib::ext::dynamic_pointer_cast<FixedRateCoupon>(c) != nullptr ||
+           QuantLib::ext::dynamic_pointer_cast<QuantExt::OvernightIndexedCoupon>(c) != nullptr ||
+           QuantLib::ext::dynamic_pointer_cast<SimpleCashFlow>(c) != nullptr;
+}
+
+// returns nullptr if the result is not present or has a different type
+template <class T> const T* additionalResult(const std::map<std::string, boost::any>& results, const std::string& key) {
+    auto r = results.find(key);
+    return r == results.end() ? nullptr : boost::any_cast<T>(&r->second);
+}
+
+} // namespace
+
+void DeltaGammaNPVCalculator::init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                   const QuantLib::ext::shared_ptr<SimMarket>& simMarket) {
+    DLOG("init DeltaGammaNPVCalculator");
+    NPVCalculator::init(portfolio, simMarket);
+    tradeData_ = std::vector<QuantLib::ext::shared_ptr<TradeData>>(portfolio->size());
+    baseZeroRates_.clear();
+}
+
+void DeltaGammaNPVCalculator::initScenario() {
+    NPVCalculator::initScenario();
+    zeroRates_.clear();
+}
+
+void DeltaGammaNPVCalculator::calculateT0(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
+                                          const QuantLib::ext::shared_ptr<SimMarket>& simMarket,
+                                          QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                                          QuantLib::ext::shared_ptr<NPVCube>& outputCubeNettingSet) {
+    // the T0 call is made in the base scenario, so this is where we collect the deltas and gammas
+    tradeData_[tradeIndex] = nullptr;
+    auto data = tradeData(trade, simMarket);
+    if (data != nullptr) {
+        Real expected = trade->instrument()->NPV();
+        Real analytic = value(*data, true);
+        if (std::abs(expected - analytic) <= 1.0E-8 * std::max(1.0, std::abs(expected))) {
+            tradeData_[tradeIndex] = data;
+            TLOG("DeltaGammaNPVCalculator: use analytic deltas and gammas for trade " << trade->id());
+        } else {
+            DLOG("DeltaGammaNPVCalculator: analytic npv " << analytic << " does not match trade npv " << expected
+                                                          << " for trade " << trade->id() << ", trade is repriced");
+        }
+    }
+    NPVCalculator::calculateT0(trade, tradeIndex, simMarket, outputCube, outputCubeNettingSet);
+}
+
+Real DeltaGammaNPVCalculator::npv(Size tradeIndex, const QuantLib::ext::shared_ptr<Trade>& trade,
+                                  const QuantLib::ext::shared_ptr<SimMarket>& simMarket) {
+    if (tradeIndex >= tradeData_.size() || tradeData_[tradeIndex] == nullptr)
+        return NPVCalculator::npv(tradeIndex, trade, simMarket);
+    Real npv = value(*tradeData_[tradeIndex], false);
+    if (close_enough(npv, 0.0))
+        return npv;
+    Real fx = fxRates_[tradeCcyIndex_[tradeIndex]];
+    Real numeraire = simMarket->numeraire();
+    return npv * fx / numeraire;
+}
+
+Size DeltaGammaNPVCalculator::numberOfAnalyticTrades() const {
+    return std::count_if(tradeData_.begin(), tradeData_.end(),
+                         [](const QuantLib::ext::shared_ptr<TradeData>& d) { return d != nullptr; });
+}
+
+QuantLib::ext::shared_ptr<DeltaGammaNPVCalculator::TradeData>
+DeltaGammaNPVCalculator::tradeData(const QuantLib::ext::shared_ptr<Trade>& trade,
+                                   const QuantLib::ext::shared_ptr<SimMarket>& simMarket) const {
+
+    // we can only handle the case where the trade npv is a multiple of the main instrument's npv
+
+    auto wrapper = QuantLib::ext::dynamic_pointer_cast<ore::data::VanillaInstrument>(trade->instrument());
+    if (wrapper == nullptr || !wrapper->additionalInstruments().empty() || wrapper->qlInstrument() == nullptr)
+        return nullptr;
+
+    auto data = QuantLib::ext::make_shared<TradeData>();
+    data->multiplier = wrapper->multiplier();
+
+    if (auto swap = QuantLib::ext::dynamic_pointer_cast<QuantLib::Swap>(wrapper->qlInstrument())) {
+
+        // the engine discounts on the npv currency discount curve unless a curve is set in the envelope
+
+        if (!trade->envelope().additionalField("discount_curve", false).empty() ||
+            !trade->envelope().additionalField("security_spread", false).empty())
+            return nullptr;
+
+        // the deltas on the forward curve are aggregated over all indices, so we need a unique forwarding curve
+
+        Handle<YieldTermStructure> forwardCurve;
+        for (auto const& leg : swap->legs()) {
+            for (auto const& c : leg) {
+                if (!isSupportedCashflow(c))
+                    return nullptr;
+                if (auto frc = QuantLib::ext::dynamic_pointer_cast<FloatingRateCoupon>(c)) {
+                    auto index = QuantLib::ext::dynamic_pointer_cast<IborIndex>(frc->index());
+                    if (index == nullptr)
+                        return nullptr;
+                    if (forwardCurve.empty())
+                        forwardCurve = index->forwardingTermStructure();
+                    else if (forwardCurve.currentLink() != index->forwardingTermStructure().currentLink())
+                        return nullptr;
+                }
+            }
+        }
+
+        const auto& results = swap->additionalResults();
+        auto times = additionalResult<std::vector<Real>>(results, "bucketTimes");
+        auto deltaDiscount = additionalResult<std::vector<Real>>(results, "deltaDiscount");
+        auto deltaForward = additionalResult<std::vector<Real>>(results, "deltaForward");
+        auto gamma = additionalResult<Matrix>(results, "gamma");
+        if (times == nullptr || *times != bucketTimes_ || deltaDiscount == nullptr || deltaForward == nullptr)
+            return nullptr;
+
+        Component c;
+        c.npv = swap->NPV();
+        c.curves.push_back(simMarket->discountCurve(trade->npvCurrency()));
+        c.curves.push_back(forwardCurve.empty() ? c.curves.front() : forwardCurve);
+        c.deltas = {*deltaDiscount, *deltaForward};
+        if (gamma != nullptr)
+            c.gamma = *gamma;
+        data->components.push_back(c);
+
+    } else if (auto fxForward = QuantLib::ext::dynamic_pointer_cast<QuantExt::FxForward>(wrapper->qlInstrument())) {
+
+        typedef std::map<Currency, std::vector<Real>, QuantExt::CurrencyComparator> CcyDeltas;
+        typedef std::map<Currency, Matrix, QuantExt::CurrencyComparator> CcyGammas;
+        typedef std::map<Currency, Real, QuantExt::CurrencyComparator> CcyReals;
+
+        const auto& results = fxForward->additionalResults();
+        auto times = additionalResult<std::vector<Real>>(results, "bucketTimes");
+        auto deltaDiscount = additionalResult<CcyDeltas>(results, "deltaDiscount");
+        auto gamma = additionalResult<CcyGammas>(results, "gamma");
+        auto fxSpot = additionalResult<CcyReals>(results, "fxSpot");
+        auto npvDom = additionalResult<Real>(results, "npvDom");
+        auto npvFor = additionalResult<Real>(results, "npvFor");
+        if (times == nullptr || *times != bucketTimes_ || deltaDiscount == nullptr || deltaDiscount->size() != 2 ||
+            fxSpot == nullptr || fxSpot->size() != 1 || npvDom == nullptr || npvFor == nullptr)
+            return nullptr;
+
+        // the fx spot is only reported for the foreign currency, the foreign npv is converted with this spot
+
+        Currency forCcy = fxSpot->begin()->first;
+        Currency domCcy = deltaDiscount->begin()->first == forCcy ? deltaDiscount->rbegin()->first
+                                                                   : deltaDiscount->begin()->first;
+        if (gamma != nullptr && (gamma->count(domCcy) == 0 || gamma->count(forCcy) == 0))
+            return nullptr;
+        for (auto const& ccy : {domCcy, forCcy}) {
+            Component c;
+            c.npv = ccy == forCcy ? *npvFor : *npvDom;
+            c.curves.push_back(simMarket->discountCurve(ccy.code()));
+            c.deltas.push_back(deltaDiscount->at(ccy));
+            if (gamma != nullptr)
+                c.gamma = gamma->at(ccy);
+            if (ccy == forCcy)
+                c.fx = simMarket->fxRate(forCcy.code() + domCcy.code());
+            data->components.push_back(c);
+        }
+
+    } else {
+        return nullptr;
+    }
+
+    // check the dimensions of the deltas and gammas
+
+    for (auto const& c : data->components) {
+        Size n = 0;
+        for (auto const& d : c.deltas) {
+            if (d.size() != bucketTimes_.size())
+                return nullptr;
+            n += d.size();
+        }
+        if (!c.gamma.empty() && (c.gamma.rows() != n || c.gamma.columns() != n))
+            return nullptr;
+    }
+
+    return data;
+}
+
+Real DeltaGammaNPVCalculator::value(const TradeData& data, const bool base) {
+    Real result = 0.0;
+    std::vector<Real> dz;
+    for (auto const& c : data.components) {
+        dz.clear();
+        for (auto const& curve : c.curves) {
+            const std::vector<Real>& z0 = zeroRates(curve, baseZeroRates_);
+            if (base) {
+                dz.insert(dz.end(), z0.size(), 0.0);
+            } else {
+                const std::vector<Real>& z = zeroRates(curve, zeroRates_);
+                for (Size i = 0; i < z.size(); ++i)
+                    dz.push_back(z[i] - z0[i]);
+            }
+        }
+        Real npv = c.npv;
+        Size offset = 0;
+        for (auto const& d : c.deltas) {
+            for (Size i = 0; i < d.size(); ++i)
+                npv += d[i] * dz[offset + i];
+            offset += d.size();
+        }
+        if (!c.gamma.empty()) {
+            for (Size i = 0; i < dz.size(); ++i) {
+                if (dz[i] == 0.0)
+                    continue;
+                for (Size j = 0; j < dz.size(); ++j)
+                    npv += 0.5 * c.gamma[i][j] * dz[i] * dz[j];
+            }
+        }
+        result += c.fx.empty() ? npv : npv * c.fx->value();
+    }
+    return data.multiplier * result;
+}
+
+const std::vector<Real>&
+DeltaGammaNPVCalculator::zeroRates(const Handle<YieldTermStructure>& curve,
+                                   std::map<const YieldTermStructure*, std::vector<Real>>& cache) const {
+    auto [z, inserted] = cache.try_emplace(curve.currentLink().get());
+    if (inserted) {
+        z->second.resize(bucketTimes_.size());
+        for (Size i = 0; i < bucketTimes_.size(); ++i)
+            z->second[i] = curve->zeroRate(bucketTimes_[i], Continuous, NoFrequency, true).rate();
+    }
+    return z->second;
+}
+
+} // namespace analytics
+} // namespace ore
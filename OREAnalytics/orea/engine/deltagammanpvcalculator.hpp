@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/deltagammanpvcalculator.hpp
+    \brief a calculator that computes scenario npvs from analytic deltas and gammas
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/engine/valuationcalculator.hpp>
+
+#include <ql/handle.hpp>
+#include <ql/math/matrix.hpp>
+#include <ql/quote.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+
+#include <map>
+
+namespace ore {
+namespace analytics {
+
+//! DeltaGammaNPVCalculator
+/*! Calculates the T0 npv of swaps priced with the DiscountingSwapEngineDeltaGamma and fx forwards priced with the
+    DiscountingFxForwardEngineDeltaGamma and stores the bucketed zero rate deltas and gammas returned by the engines.
+    The scenario npvs of these trades are then given by the second order Taylor expansion in the changes of the
+    continuously compounded zero rates of the relevant curves at the bucket times (and exactly in the fx spot for
+    fx forwards), i.e. the trades are not repriced. All other trades are repriced as in the NPVCalculator.
+
+    The bucket times must be the ones configured in the pricing engines. Swaps are only handled if they consist of
+    fixed, Ibor (not in arrears) and overnight coupons and simple cashflows only and use at most one forwarding curve.
+    See NPVCalculator for more conventions of the stored NPVs. */
+class DeltaGammaNPVCalculator : public NPVCalculator {
+public:
+    //! base ccy, bucket times of the pricing engines and index to write to
+    DeltaGammaNPVCalculator(const std::string& baseCcyCode, const std::vector<Real>& bucketTimes, Size index = 0)
+        : NPVCalculator(baseCcyCode, index), bucketTimes_(bucketTimes) {}
+
+    void calculateT0(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
+                     const QuantLib::ext::shared_ptr<SimMarket>& simMarket, QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                     QuantLib::ext::shared_ptr<NPVCube>& outputCubeNettingSet) override;
+
+    Real npv(Size tradeIndex, const QuantLib::ext::shared_ptr<Trade>& trade,
+             const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
+
+    void init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
+    void initScenario() override;
+
+    //! number of trades for which the scenario npvs are computed from the analytic deltas and gammas
+    Size numberOfAnalyticTrades() const;
+
+private:
+    // npv contribution discounted on a set of curves, optionally converted with an fx quote
+    struct Component {
+        Real npv = 0.0;
+        std::vector<QuantLib::Handle<QuantLib::YieldTermStructure>> curves;
+        std::vector<std::vector<Real>> deltas;
+        QuantLib::Matrix gamma;
+        QuantLib::Handle<QuantLib::Quote> fx;
+    };
+    struct TradeData {
+        Real multiplier = 1.0;
+        std::vector<Component> components;
+    };
+
+    QuantLib::ext::shared_ptr<TradeData> tradeData(const QuantLib::ext::shared_ptr<Trade>& trade,
+                                                   const QuantLib::ext::shared_ptr<SimMarket>& simMarket) const;
+    Real value(const TradeData& data, const bool base);
+    const std::vector<Real>& zeroRates(const QuantLib::Handle<QuantLib::YieldTermStructure>& curve,
+                                       std::map<const QuantLib::YieldTermStructure*, std::vector<Real>>& cache) const;
+
+    std::vector<Real> bucketTimes_;
+    std::vector<QuantLib::ext::shared_ptr<TradeData>> tradeData_;
+    std::map<const QuantLib::YieldTermStructure*, std::vector<Real>> baseZeroRates_, zeroRates_;
+};
+
+} // namespace analytics
+} // namespace ore
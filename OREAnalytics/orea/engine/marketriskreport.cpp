@@ -22,6 +22,7 @@
 #include <orea/cube/cubewriter.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/cube/npvcube.hpp>
+#include <orea/engine/compactsensitivitystream.hpp>
 #include <orea/engine/marketriskreport.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
@@ -257,9 +258,15 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
     // Cube to store Sensi Shifts and vector of keys used in cube, per portfolio
     map<string, QuantLib::ext::shared_ptr<NPVCube>> sensiShiftCube;
     ext::shared_ptr<SensitivityAggregator> sensiAgg;
-    if (sensiBased_)
+    ext::shared_ptr<CompactSensitivityStream> sensiStream;
+    if (sensiBased_) {
         // Create a sensitivity aggregator. Will be used if running sensi-based backtest.
         sensiAgg = ext::make_shared<SensitivityAggregator>(tradeIdGroups_);
+        // The sensitivities are aggregated once per risk group, read the input stream once into a compact container
+        sensiStream = ext::dynamic_pointer_cast<CompactSensitivityStream>(sensiArgs_->sensitivityStream_);
+        if (!sensiStream)
+            sensiStream = ext::make_shared<CompactSensitivityStream>(*sensiArgs_->sensitivityStream_);
+    }
     
     bool runDetailTrd = runTradeDetail(reports);
     addPnlCalculators(reports);
@@ -280,7 +287,7 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
         updateFilter(riskGroup, filter);
 
         if (sensiBased_)
-            sensiAgg->aggregate(*sensiArgs_->sensitivityStream_, filter);
+            sensiAgg->aggregate(*sensiStream, filter);
 
         // If doing a full revaluation backtest, generate the cube under this filter
         if (fullReval_) {
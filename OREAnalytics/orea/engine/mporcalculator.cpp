@@ -52,5 +52,13 @@ void MPORCalculator::calculateT0(const QuantLib::ext::shared_ptr<Trade>& trade,
     // the closeOutIndex_ is not utilised for t=0 and has no meaning
     outputCube->setT0(npv, tradeIndex, defaultIndex_);
 }
+
+void MPORCalculator::calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor,
+                                     QuantLib::ext::shared_ptr<NPVCube>& outputCube, Size dateIndex, Size sample,
+                                     bool isCloseOut) {
+    Size index = isCloseOut ? closeOutIndex_ : defaultIndex_;
+    outputCube->set(factor * outputCube->get(fromTradeIndex, dateIndex, sample, index), tradeIndex, dateIndex, sample,
+                    index);
+}
 } // namespace analytics
 } // namespace ore
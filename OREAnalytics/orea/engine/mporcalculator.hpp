@@ -52,6 +52,10 @@ public:
     void init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
     void initScenario() override;
 
+    void calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor, QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                         Size dateIndex, Size sample, bool isCloseOut = false) override;
+    bool supportsScaledResults() const override { return true; }
+
 private:
     QuantLib::ext::shared_ptr<NPVCalculator> npvCalc_;
     Size defaultIndex_, closeOutIndex_;
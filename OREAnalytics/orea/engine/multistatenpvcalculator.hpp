@@ -46,6 +46,9 @@ public:
                      const QuantLib::ext::shared_ptr<SimMarket>& simMarket, QuantLib::ext::shared_ptr<NPVCube>& outputCube,
                      QuantLib::ext::shared_ptr<NPVCube>& outputCubeNettingSet) override;
 
+    //! state npvs are not necessarily linear in the trade size
+    bool supportsScaledResults() const override { return false; }
+
     std::vector<Real> multiStateNpv(Size tradeIndex, const QuantLib::ext::shared_ptr<Trade>& trade,
                                     const QuantLib::ext::shared_ptr<SimMarket>& simMarket);
 
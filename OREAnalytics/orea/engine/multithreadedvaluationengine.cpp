@@ -25,9 +25,13 @@
 #include <ored/marketdata/clonedloader.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/portfoliosnapshot.hpp>
 #include <ored/portfolio/trade.hpp>
 #include <ored/utilities/dategrid.hpp>
 
+#include <ql/utilities/null.hpp>
+
 #include <boost/timer/timer.hpp>
 
 #include <future>
@@ -39,6 +43,62 @@ namespace analytics {
 
 using QuantLib::Size;
 
+std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>>
+splitPortfolio(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio, const Size nParts,
+               const QuantLib::ext::shared_ptr<ValuationProfile>& profile) {
+
+    QL_REQUIRE(nParts > 0, "splitPortfolio(): number of parts must be positive");
+
+    std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>> portfolios;
+    for (Size i = 0; i < nParts; ++i)
+        portfolios.push_back(QuantLib::ext::make_shared<ore::data::Portfolio>());
+
+    double totalAvgPricingTime = 0.0;
+    std::vector<std::pair<std::string, double>> timings;
+    for (auto const& [tid, t] : portfolio->trades()) {
+        double measured = profile ? profile->averageTradeTime(tid) : QuantLib::Null<QuantLib::Real>();
+        if (measured != QuantLib::Null<QuantLib::Real>()) {
+            // measured valuation time from a previous run, this includes the instrument updates
+            timings.push_back(std::make_pair(tid, measured));
+            totalAvgPricingTime += measured;
+        } else if (t->getNumberOfPricings() != 0) {
+            double dt = t->getCumulativePricingTime() / static_cast<double>(t->getNumberOfPricings());
+            timings.push_back(std::make_pair(tid, dt));
+            totalAvgPricingTime += dt;
+        } else {
+            // trade might be a failed trade
+            timings.push_back(std::make_pair(tid, 0.0));
+        }
+    }
+
+    std::sort(timings.begin(), timings.end(),
+              [](const std::pair<std::string, double>& p1, const std::pair<std::string, double> p2) {
+                  if (p1.second == p2.second)
+                      return p1.first < p2.first;
+                  else
+                      return p1.second > p2.second;
+              });
+
+    std::vector<double> portfolioTotalAvgPricingTime(portfolios.size());
+    Size portfolioIndex = 0;
+    for (auto const& t : timings) {
+        portfolios[portfolioIndex]->add(portfolio->get(t.first));
+        portfolioTotalAvgPricingTime[portfolioIndex] += t.second;
+        if (++portfolioIndex >= nParts)
+            portfolioIndex = 0;
+    }
+
+    // log info on the portfolio split
+
+    LOG("Total avg pricing time     : " << totalAvgPricingTime / 1E6 << " ms");
+    for (Size i = 0; i < nParts; ++i) {
+        LOG("Portfolio #" << i << " number of trades       : " << portfolios[i]->size());
+        LOG("Portfolio #" << i << " total avg pricing time : " << portfolioTotalAvgPricingTime[i] / 1E6 << " ms");
+    }
+
+    return portfolios;
+}
+
 MultiThreadedValuationEngine::MultiThreadedValuationEngine(
     const Size nThreads, const QuantLib::Date& today, const QuantLib::ext::shared_ptr<ore::data::DateGrid>& dateGrid,
     const Size nSamples, const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
@@ -101,6 +161,11 @@ void MultiThreadedValuationEngine::setAggregationScenarioData(
     aggregationScenarioData_ = aggregationScenarioData;
 }
 
+void MultiThreadedValuationEngine::enableNpvMemoisation(const std::set<std::string>& excludedTradeTypes) {
+    npvMemoisation_ = true;
+    npvMemoisationExcludedTradeTypes_ = excludedTradeTypes;
+}
+
 void MultiThreadedValuationEngine::buildCube(
     const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
     const std::function<std::vector<QuantLib::ext::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
@@ -125,7 +190,7 @@ void MultiThreadedValuationEngine::buildCube(
         "configuration '"
         << configuration_ << "'.");
 
-    QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
+    auto initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
         today_, todaysMarketParams_, loader_, curveConfigs_, true, true, true, referenceData_, false,
         iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
 
@@ -141,6 +206,12 @@ void MultiThreadedValuationEngine::buildCube(
                             << t->npvCurrency());
     }
 
+    /* collect the nodes of the yield curves bootstrapped for the init market, the workers rebuild these curves from
+       the nodes instead of repeating the bootstrap on their own copy of the market data */
+
+    auto bootstrappedYieldCurveNodes = initMarket->bootstrappedYieldCurveNodes();
+    LOG("Sharing nodes of " << bootstrappedYieldCurveNodes.size() << " bootstrapped yield curves with the workers");
+
     // split portfolio into nThreads parts such that each part has an approximately similar total avg pricing time
 
     Size eff_nThreads = std::min(portfolio->size(), nThreads_);
@@ -153,53 +224,14 @@ void MultiThreadedValuationEngine::buildCube(
 
     QL_REQUIRE(eff_nThreads > 0, "effective threads are zero, this is not allowed.");
 
-    std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>> portfolios;
-    for (Size i = 0; i < eff_nThreads; ++i)
-        portfolios.push_back(QuantLib::ext::make_shared<ore::data::Portfolio>());
+    auto portfolios = splitPortfolio(portfolio, eff_nThreads, profile_);
 
-    double totalAvgPricingTime = 0.0;
-    std::vector<std::pair<std::string, double>> timings;
-    for (auto const& [tid, t] : portfolio->trades()) {
-        if (t->getNumberOfPricings() != 0) {
-            double dt = t->getCumulativePricingTime() / static_cast<double>(t->getNumberOfPricings());
-            timings.push_back(std::make_pair(tid, dt));
-            totalAvgPricingTime += dt;
-        } else {
-            // trade might be a failed trade
-            timings.push_back(std::make_pair(tid, 0.0));
-        }
-    }
-
-    std::sort(timings.begin(), timings.end(),
-              [](const std::pair<std::string, double>& p1, const std::pair<std::string, double> p2) {
-                  if (p1.second == p2.second)
-                      return p1.first < p2.first;
-                  else
-                      return p1.second > p2.second;
-              });
+    // snapshot the trade data once, the worker threads load their trades from the snapshot
 
-    std::vector<double> portfolioTotalAvgPricingTime(portfolios.size());
-    Size portfolioIndex = 0;
-    for (auto const& t : timings) {
-        portfolios[portfolioIndex]->add(portfolio->get(t.first));
-        portfolioTotalAvgPricingTime[portfolioIndex] += t.second;
-        if (++portfolioIndex >= eff_nThreads)
-            portfolioIndex = 0;
-    }
-
-    // output the portfolios into strings so that the worker threads can load them from there
-
-    std::vector<std::string> portfoliosAsString;
+    ore::data::PortfolioSnapshot portfolioSnapshot(*portfolio);
+    std::vector<std::set<std::string>> portfolioTradeIds;
     for (auto const& p : portfolios) {
-        portfoliosAsString.emplace_back(p->toXMLString());
-    }
-
-    // log info on the portfolio split
-
-    LOG("Total avg pricing time     : " << totalAvgPricingTime / 1E6 << " ms");
-    for (Size i = 0; i < eff_nThreads; ++i) {
-        LOG("Portfolio #" << i << " number of trades       : " << portfolios[i]->size());
-        LOG("Portfolio #" << i << " total avg pricing time : " << portfolioTotalAvgPricingTime[i] / 1E6 << " ms");
+        portfolioTradeIds.push_back(p->ids());
     }
 
     // build scenario generators for each thread as clones of the original one
@@ -256,13 +288,21 @@ void MultiThreadedValuationEngine::buildCube(
     std::vector<std::map<std::string, std::pair<std::size_t, boost::timer::nanosecond_type>>> workerPricingStats(
         eff_nThreads);
 
+    // timing profiles recorded in worker threads
+    std::vector<QuantLib::ext::shared_ptr<ValuationProfile>> workerProfiles(eff_nThreads);
+    if (profile_) {
+        for (auto& p : workerProfiles)
+            p = QuantLib::ext::make_shared<ValuationProfile>();
+    }
+
     // get obs mode of main thread, so that we can set this mode in the worker threads below
     ore::analytics::ObservationMode::Mode obsMode = ore::analytics::ObservationMode::instance().mode();
 
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfoliosAsString,
-                    &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator](int id) -> resultType {
+        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfolioSnapshot,
+                    &portfolioTradeIds, &scenarioGenerators, &loaders, &workerPricingStats, &workerProfiles,
+                    &progressIndicator, &bootstrappedYieldCurveNodes](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
@@ -274,11 +314,11 @@ void MultiThreadedValuationEngine::buildCube(
 
             try {
 
-                // build todays market using cloned market data
+                // build todays market using cloned market data and the yield curve nodes from the main thread
 
                 QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
                     today_, todaysMarketParams_, loaders[id], curveConfigs_, true, true, true, referenceData_, false,
-                    iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
+                    iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_, bootstrappedYieldCurveNodes);
 
                 // build sim market
 
@@ -304,8 +344,7 @@ void MultiThreadedValuationEngine::buildCube(
 
                 // build portfolio against sim market
 
-                auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
-                portfolio->fromXMLString(portfoliosAsString[id]);
+                auto portfolio = portfolioSnapshot.portfolio(true, false, portfolioTradeIds[id]);
                 auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
                     engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_,
                     iborFallbackConfig_);
@@ -319,6 +358,9 @@ void MultiThreadedValuationEngine::buildCube(
                     recalibrateModels_ ? engineFactory->modelBuilders()
                                        : std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>());
                 valEngine->registerProgressIndicator(progressIndicator);
+                if (npvMemoisation_)
+                    valEngine->enableNpvMemoisation(npvMemoisationExcludedTradeTypes_);
+                valEngine->enableProfiling(workerProfiles[id]);
 
                 // build mini-cube
 
@@ -402,6 +444,13 @@ void MultiThreadedValuationEngine::buildCube(
         t->resetPricingStats(n, d);
     }
 
+    // merge the profiles of the workers
+
+    if (profile_) {
+        for (auto const& p : workerProfiles)
+            profile_->merge(*p);
+    }
+
     // log timings and return the result mini-cubes
 
     LOG("MultiThreadedValuationEngine::buildCube() successfully finished, timings: "
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <orea/engine/valuationengine.hpp>
+#include <orea/engine/valuationprofile.hpp>
 #include <orea/scenario/scenariogenerator.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
@@ -34,6 +35,13 @@
 namespace ore {
 namespace analytics {
 
+/*! Split the portfolio into nParts portfolios with approximately equal total average valuation times. The trades are
+    assigned round robin in the order of decreasing average valuation time. The average valuation time of a trade is
+    taken from the profile, if it holds timings of the trade, and from the pricing stats of the trade otherwise. */
+std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>>
+splitPortfolio(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio, const QuantLib::Size nParts,
+               const QuantLib::ext::shared_ptr<ValuationProfile>& profile = nullptr);
+
 class MultiThreadedValuationEngine : public ore::data::ProgressReporter {
 public:
     /* if no cube factories are given, we create default ones as follows
@@ -72,6 +80,14 @@ public:
     // can be optionally called to set the agg scen data (which is done in the ssm for single-threaded runs)
     void setAggregationScenarioData(const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
 
+    // can be optionally called to enable the npv memoisation in the worker engines, see ValuationEngine
+    void enableNpvMemoisation(const std::set<std::string>& excludedTradeTypes = {});
+
+    /* can be optionally called to record timings in the given profile, each worker engine records its own profile,
+       these are merged into the given one after the workers have finished. If the profile holds timings of previous
+       runs, these are used instead of the pricing stats to split the portfolio between the workers. */
+    void enableProfiling(const QuantLib::ext::shared_ptr<ValuationProfile>& profile) { profile_ = profile; }
+
     /* analoguous to buildCube() in the single-threaded engine, results are retrieved using below constructors
        if no cptyCalculators is given a function returning an empty vector of calculators will be returned */
     void
@@ -125,6 +141,9 @@ private:
     QuantLib::ext::shared_ptr<ore::analytics::Scenario> offsetScenario_;
     QuantLib::ext::shared_ptr<AggregationScenarioData>
             aggregationScenarioData_;
+    bool npvMemoisation_ = false;
+    std::set<std::string> npvMemoisationExcludedTradeTypes_;
+    QuantLib::ext::shared_ptr<ValuationProfile> profile_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniCubes_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniNettingSetCubes_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniCptyCubes_;
@@ -0,0 +1,182 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/npvmemoisation.hpp>
+
+#include <ored/portfolio/instrumentwrapper.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <qle/cashflows/overnightindexedcoupon.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
+#include <ql/math/comparison.hpp>
+
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <typeinfo>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+// write the cash flow's structure relative to the given scale, returns false for unsupported cash flow types
+bool writeCashflow(std::ostream& key, const QuantLib::ext::shared_ptr<CashFlow>& cf, const Real scale) {
+    const CashFlow& c = *cf;
+    key << "|" << cf->date().serialNumber();
+    if (typeid(c) == typeid(SimpleCashFlow)) {
+        key << ",S," << cf->amount() / scale;
+        return true;
+    }
+    auto cpn = QuantLib::ext::dynamic_pointer_cast<Coupon>(cf);
+    if (cpn == nullptr)
+        return false;
+    key << "," << cpn->nominal() / scale << "," << cpn->accrualStartDate().serialNumber() << ","
+        << cpn->accrualEndDate().serialNumber() << "," << cpn->dayCounter().name();
+    if (typeid(c) == typeid(FixedRateCoupon)) {
+        key << ",F," << QuantLib::ext::static_pointer_cast<FixedRateCoupon>(cf)->rate();
+        return true;
+    }
+    auto frc = QuantLib::ext::dynamic_pointer_cast<FloatingRateCoupon>(cf);
+    if (frc == nullptr)
+        return false;
+    key << "," << frc->index()->name() << "," << frc->fixingDate().serialNumber() << "," << frc->gearing() << ","
+        << frc->spread() << "," << frc->isInArrears();
+    if (typeid(c) == typeid(IborCoupon)) {
+        key << ",I";
+        return true;
+    }
+    if (typeid(c) == typeid(QuantExt::OvernightIndexedCoupon)) {
+        auto on = QuantLib::ext::static_pointer_cast<QuantExt::OvernightIndexedCoupon>(cf);
+        key << ",O," << on->valueDates().size() << "," << on->valueDates().front().serialNumber() << ","
+            << on->valueDates().back().serialNumber() << "," << on->fixingDates().front().serialNumber() << ","
+            << on->includeSpread() << "," << on->lookback() << "," << on->rateCutoff();
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool NpvMemoisation::structureKey(const QuantLib::ext::shared_ptr<ore::data::Trade>& trade, std::string& key,
+                                  Real& scale) {
+    auto wrapper = QuantLib::ext::dynamic_pointer_cast<ore::data::VanillaInstrument>(trade->instrument());
+    if (wrapper == nullptr || wrapper->qlInstrument() == nullptr || !wrapper->additionalInstruments().empty())
+        return false;
+    const auto& legs = trade->legs();
+    if (legs.empty() || legs.size() != trade->legPayers().size() || legs.size() != trade->legCurrencies().size())
+        return false;
+
+    // the scale is the size of the first cash flow, the sign is chosen such that the first leg is received
+    scale = Null<Real>();
+    for (auto const& l : legs) {
+        for (auto const& cf : l) {
+            if (auto cpn = QuantLib::ext::dynamic_pointer_cast<Coupon>(cf))
+                scale = cpn->nominal();
+            else
+                scale = cf->amount();
+            break;
+        }
+        if (scale != Null<Real>())
+            break;
+    }
+    if (scale == Null<Real>() || QuantLib::close_enough(scale, 0.0))
+        return false;
+    bool flip = trade->legPayers().front();
+
+    const auto& inst = *wrapper->qlInstrument();
+    std::ostringstream os;
+    os << std::setprecision(15) << trade->tradeType() << "|" << typeid(inst).name() << "|" << trade->npvCurrency()
+       << "|" << wrapper->multiplier();
+    for (Size i = 0; i < legs.size(); ++i) {
+        os << "#" << trade->legCurrencies()[i] << "," << (trade->legPayers()[i] != flip) << "," << legs[i].size();
+        for (auto const& cf : legs[i]) {
+            if (!writeCashflow(os, cf, scale))
+                return false;
+        }
+    }
+    key = os.str();
+    if (flip)
+        scale = -scale;
+    return true;
+}
+
+void NpvMemoisation::build(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                           const std::vector<bool>& tradeHasError) {
+    Size n = portfolio->size();
+    representative_.resize(n);
+    scale_.assign(n, 1.0);
+    nMemoised_ = nClasses_ = 0;
+
+    struct Representative {
+        Size index;
+        Real scale, npv;
+        bool hasFollowers;
+    };
+    std::map<std::string, Representative> representatives;
+
+    Size i = 0;
+    for (auto const& [tradeId, trade] : portfolio->trades()) {
+        representative_[i] = i;
+        std::string key;
+        Real scale;
+        if ((tradeHasError.empty() || !tradeHasError[i]) &&
+            excludedTradeTypes_.find(trade->tradeType()) == excludedTradeTypes_.end() &&
+            structureKey(trade, key, scale)) {
+            try {
+                Real npv = trade->instrument()->NPV();
+                auto r = representatives.find(key);
+                if (r == representatives.end()) {
+                    representatives[key] = {i, scale, npv, false};
+                } else {
+                    // verify the classification against the current npvs
+                    Real factor = scale / r->second.scale;
+                    Real expected = factor * r->second.npv;
+                    if (std::abs(npv - expected) <= 1.0E-8 * std::max(std::abs(npv), std::abs(expected)) + 1.0E-6) {
+                        representative_[i] = r->second.index;
+                        scale_[i] = factor;
+                        ++nMemoised_;
+                        if (!r->second.hasFollowers) {
+                            r->second.hasFollowers = true;
+                            ++nClasses_;
+                        }
+                    } else {
+                        DLOG("NpvMemoisation: trade " << tradeId << " has the same structure key as trade index "
+                                                      << r->second.index << ", but npv " << npv << " does not match "
+                                                      << expected << ", trade is not memoised");
+                    }
+                }
+            } catch (const std::exception& e) {
+                DLOG("NpvMemoisation: trade " << tradeId << " is not memoised, npv failed: " << e.what());
+            }
+        }
+        ++i;
+    }
+
+    LOG("NpvMemoisation: " << nMemoised_ << " out of " << n << " trades are valued via " << nClasses_
+                           << " representative trades");
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/npvmemoisation.hpp
+    \brief groups trades that are linear multiples of each other
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+#include <ql/shared_ptr.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+class Portfolio;
+class Trade;
+} // namespace data
+
+namespace analytics {
+
+//! NPV memoisation across economically identical trades
+/*! The trades of a built portfolio are canonicalised into classes of trades sharing the same instrument structure
+    key. Within a class all trades are linear multiples of a representative trade, i.e.
+
+        npv(trade) = scale(trade) * npv(representative(trade))
+
+    and only the representative has to be priced in a scenario. The structure key is derived from the built legs
+    and is only available for trades with a vanilla instrument wrapper without additional instruments whose legs
+    consist of fixed, ibor, overnight and simple cashflows. The classification is verified against the current
+    npvs of the trades, trades that do not match within a relative tolerance are kept as their own class.
+
+    Trade types can be excluded from the memoisation explicitly.
+
+    \ingroup simulation
+*/
+class NpvMemoisation {
+public:
+    explicit NpvMemoisation(const std::set<std::string>& excludedTradeTypes = {}) : excludedTradeTypes_(excludedTradeTypes) {}
+
+    /*! Classify the trades of the given portfolio, the trade indices are the positions in Portfolio::trades().
+        Trades flagged in tradeHasError (if not empty) are not classified. Requires the portfolio to be built
+        and priceable, the current npvs are used to verify the classification. */
+    void build(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+               const std::vector<bool>& tradeHasError = {});
+
+    //! Index of the trade that has to be priced to value trade i, this is i itself for representatives
+    QuantLib::Size representative(const QuantLib::Size i) const { return representative_[i]; }
+
+    //! Factor to apply to the representative's results to get the results of trade i
+    QuantLib::Real scale(const QuantLib::Size i) const { return scale_[i]; }
+
+    //! True if trade i is not priced itself
+    bool isMemoised(const QuantLib::Size i) const { return representative_[i] != i; }
+
+    //! Number of trades valued via their representative
+    QuantLib::Size numberOfMemoisedTrades() const { return nMemoised_; }
+
+    //! Number of classes with more than one trade
+    QuantLib::Size numberOfClasses() const { return nClasses_; }
+
+    /*! Instrument structure key of a trade and the scale of the trade relative to the canonical instrument. Returns
+        false if no key can be derived for the trade. */
+    static bool structureKey(const QuantLib::ext::shared_ptr<ore::data::Trade>& trade, std::string& key,
+                             QuantLib::Real& scale);
+
+private:
+    std::set<std::string> excludedTradeTypes_;
+    std::vector<QuantLib::Size> representative_;
+    std::vector<QuantLib::Real> scale_;
+    QuantLib::Size nMemoised_ = 0, nClasses_ = 0;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -41,7 +41,7 @@ private:
 
 public:
     //! Allowable mode mode
-    enum class Mode { None, Disable, Defer, Unregister };
+    enum class Mode { None, Disable, Defer, Unregister, Track };
 
     Mode mode() { return mode_; }
 
@@ -56,6 +56,8 @@ public:
             mode_ = Mode::Defer;
         else if (s == "Unregister")
             mode_ = Mode::Unregister;
+        else if (s == "Track")
+            mode_ = Mode::Track;
         else {
             QL_FAIL("Invalid ObserverMode string " << s);
         }
@@ -39,8 +39,8 @@ using namespace std;
 namespace ore {
 namespace analytics {   
 
-ParametricVarCalculator::ParametricVarParams::ParametricVarParams(const string& m, Size samp, Size sd)
-    : method(parseParametricVarMethod(m)), samples(samp), seed(sd) {}
+ParametricVarCalculator::ParametricVarParams::ParametricVarParams(const string& m, Size samp, Size sd, Size thr)
+    : method(parseParametricVarMethod(m)), samples(samp), seed(sd), threads(thr) {}
 
 ParametricVarCalculator::ParametricVarParams::Method parseParametricVarMethod(const string& s) {
     static map<string, ParametricVarCalculator::ParametricVarParams::Method> m = {
@@ -117,7 +117,8 @@ Real ParametricVarCalculator::var(Real confidence, const bool isCall,
         QL_REQUIRE(parametricVarParams_.seed != Null<Size>(),
                     "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
         return QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence, parametricVarParams_.samples,
-                                                        parametricVarParams_.seed, *covarianceSalvage_);
+                                                        parametricVarParams_.seed, *covarianceSalvage_,
+                                                        parametricVarParams_.threads);
     } else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::CornishFisher)
         return QuantExt::deltaGammaVarCornishFisher(omega_, delta, gamma, confidence, *covarianceSalvage_);
     else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Saddlepoint) {
@@ -128,7 +129,8 @@ Real ParametricVarCalculator::var(Real confidence, const bool isCall,
             ALOG("Saddlepoint VaR computation exited with an error: " << e.what()
                                                                         << ", falling back on Monte-Carlo");
             res = QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence,
-                parametricVarParams_.samples, parametricVarParams_.seed, *covarianceSalvage_);
+                parametricVarParams_.samples, parametricVarParams_.seed, *covarianceSalvage_,
+                parametricVarParams_.threads);
         }        
         return res;
     } else
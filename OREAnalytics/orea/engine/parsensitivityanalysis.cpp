@@ -23,6 +23,7 @@
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/scenariogenerator.hpp>
 #include <orea/scenario/sensitivityscenariodata.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
 
@@ -73,6 +74,9 @@
 #include <boost/numeric/ublas/operation.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
+#include <numeric>
+#include <thread>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -149,9 +153,50 @@ void writeSensitivity(const RiskFactorKey& a, const RiskFactorKey& b, const Real
     parSensi[std::make_pair(a, b)] = value;
     DLOG("ParInstrument Sensi " << a << " w.r.t. " << b << " " << setprecision(6) << value);
 }
+
+// remove todays fixings from relevant indices for the lifetime of the instance
+struct TodaysFixingsRemover {
+    TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
+        Date today = Settings::instance().evaluationDate();
+        for (auto const& n : names) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(n);
+            if (t[today] != Null<Real>()) {
+                DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
+                savedFixings_.insert(std::make_pair(n, t[today]));
+                t[today] = Null<Real>();
+                IndexManager::instance().setHistory(n, t);
+            }
+        }
+    }
+    ~TodaysFixingsRemover() {
+        for (auto const& p : savedFixings_) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
+            t[today_] = p.second;
+            IndexManager::instance().setHistory(p.first, t);
+            DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
+        }
+    }
+    const Date today_;
+    std::set<std::pair<std::string, Real>> savedFixings_;
+};
+
+// restore the scenario generator of the sim market and reset the sim market on destruction
+struct SimMarketResetter {
+    SimMarketResetter(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket)
+        : simMarket_(simMarket), scenarioGenerator_(simMarket->scenarioGenerator()) {}
+    ~SimMarketResetter() {
+        simMarket_->scenarioGenerator() = scenarioGenerator_;
+        simMarket_->reset();
+    }
+    QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket_;
+    QuantLib::ext::shared_ptr<ScenarioGenerator> scenarioGenerator_;
+};
+
 } // namespace
 
-void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket) {
+void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+                                                               const Size nThreads,
+                                                               const SimMarketFactory& simMarketFactory) {
 
     LOG("Cache base scenario par rates and flat vols");
 
@@ -164,42 +209,16 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
     }
 
     // remove todays fixings from relevant indices for the scope of this method
-    struct TodaysFixingsRemover {
-        TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
-            Date today = Settings::instance().evaluationDate();
-            for (auto const& n : names) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(n);
-                if (t[today] != Null<Real>()) {
-                    DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
-                    savedFixings_.insert(std::make_pair(n, t[today]));
-                    t[today] = Null<Real>();
-                    IndexManager::instance().setHistory(n, t);
-                }
-            }
-        }
-        ~TodaysFixingsRemover() {
-            for (auto const& p : savedFixings_) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
-                t[today_] = p.second;
-                IndexManager::instance().setHistory(p.first, t);
-                DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
-            }
-        }
-        const Date today_;
-        std::set<std::pair<std::string, Real>> savedFixings_;
-    };
     TodaysFixingsRemover fixingRemover(instruments_.removeTodaysFixingIndices_);
 
     // We must have a ShiftScenarioGenerator
     QuantLib::ext::shared_ptr<ScenarioGenerator> simMarketScenGen = simMarket->scenarioGenerator();
     QuantLib::ext::shared_ptr<ShiftScenarioGenerator> scenarioGenerator =
         QuantLib::ext::dynamic_pointer_cast<ShiftScenarioGenerator>(simMarketScenGen);
+    QL_REQUIRE(scenarioGenerator != nullptr,
+               "computeParInstrumentSensitivities(): sim market scenario generator must be a ShiftScenarioGenerator");
 
-    struct SimMarketResetter {
-        SimMarketResetter(QuantLib::ext::shared_ptr<SimMarket> simMarket) : simMarket_(simMarket) {}
-        ~SimMarketResetter() { simMarket_->reset(); }
-        QuantLib::ext::shared_ptr<SimMarket> simMarket_;
-    } simMarketResetter(simMarket);
+    SimMarketResetter simMarketResetter(simMarket);
 
     simMarket->reset();
     scenarioGenerator->reset();
@@ -300,53 +319,129 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
         parKeysCheck.insert(p.first);
     }
 
-    for (Size i = 1; i < scenarioGenerator->samples(); ++i) {
+    // collect the single "UP" shift scenarios relevant for par instruments, use relevant scenarios only, if
+    // specified, ignore risk factor types that have been disabled. The scenarios are grouped into blocks of risk
+    // factors with the same key type and name, which are the units of work for the multi-threaded computation.
 
-        simMarket->update(asof_);
+    const std::vector<QuantLib::ext::shared_ptr<Scenario>>& scenarios = scenarioGenerator->scenarios();
+    std::vector<ParShiftScenario> relevantScenarios;
+    std::map<std::pair<RiskFactorKey::KeyType, std::string>, std::vector<ParShiftScenario>> blocks;
 
-        // use single "UP" shift scenarios only, use only scenarios relevant for par instruments,
-        // use relevant scenarios only, if specified
-        // ignore risk factor types that have been disabled
+    for (Size i = 1; i < scenarioGenerator->samples(); ++i) {
         if (desc[i].type() != ShiftScenarioGenerator::ScenarioDescription::Type::Up ||
             !isParType(desc[i].key1().keytype) || typesDisabled_.count(desc[i].key1().keytype) == 1 ||
             !(relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc[i].key1()) != relevantRiskFactors_.end()))
             continue;
+        rawKeysCheck.insert(desc[i].key1());
+        relevantScenarios.push_back(std::make_pair(desc[i].key1(), scenarios[i]));
+        blocks[std::make_pair(desc[i].key1().keytype, desc[i].key1().name)].push_back(relevantScenarios.back());
+    }
+
+    std::vector<ParSensiEntry> sensis;
+    if (nThreads > 1 && simMarketFactory && blocks.size() > 1) {
+        std::vector<std::vector<ParShiftScenario>> blockScenarios;
+        for (auto& b : blocks)
+            blockScenarios.push_back(std::move(b.second));
+        sensis = computeParSensitivities(blockScenarios, nThreads, simMarketFactory, parRatesBase, parCapVols);
+    } else {
+        sensis = computeParSensitivities(simMarket, instruments_, relevantScenarios, parRatesBase, parCapVols);
+    }
+
+    for (auto const& [parKey, rawKey, value] : sensis)
+        writeSensitivity(parKey, rawKey, value, parSensi_, parKeysNonZero, rawKeysNonZero);
+
+    // check for
+    // a) par instruments which have no sensitivity to any of the risk factors
+    // b) risk factors w.r.t. which no par instrument has a sensitivity
+    std::set<RiskFactorKey> parKeysZero, rawKeysZero;
+    std::set_difference(parKeysCheck.begin(), parKeysCheck.end(), parKeysNonZero.begin(), parKeysNonZero.end(),
+                        std::inserter(parKeysZero, parKeysZero.begin()));
+    std::set_difference(rawKeysCheck.begin(), rawKeysCheck.end(), rawKeysNonZero.begin(), rawKeysNonZero.end(),
+                        std::inserter(rawKeysZero, rawKeysZero.begin()));
+    std::set<RiskFactorKey> problematicKeys;
+    problematicKeys.insert(parKeysZero.begin(), parKeysZero.end());
+    problematicKeys.insert(rawKeysZero.begin(), rawKeysZero.end());
+    for (auto const& k : problematicKeys) {
+        std::string type;
+        if (parKeysZero.find(k) != parKeysZero.end())
+            type = "par instrument is insensitive to all zero risk factors";
+        else if (rawKeysZero.find(k) != rawKeysZero.end())
+            type = "zero risk factor that does not affect an par instrument";
+        else
+            type = "unknown";
+        Real parHelperValue = Null<Real>();
+        if (auto tmp = instruments_.parHelpers_.find(k); tmp != instruments_.parHelpers_.end())
+            parHelperValue = impliedQuote(tmp->second);
+        else if (auto tmp = instruments_.parCaps_.find(k); tmp != instruments_.parCaps_.end())
+            parHelperValue = tmp->second->NPV();
+        else if (auto tmp = instruments_.parYoYCaps_.find(k); tmp != instruments_.parYoYCaps_.end())
+            parHelperValue = tmp->second->NPV();
+        Real zeroFactorValue = Null<Real>();
+        if (simMarket->baseScenarioAbsolute()->has(k))
+            zeroFactorValue = simMarket->baseScenarioAbsolute()->get(k);
+        WLOG("zero/par relation problem for key '"
+             << k << "', type " + type + ", par value = "
+             << (parHelperValue == Null<Real>() ? "na" : std::to_string(parHelperValue))
+             << ", zero value = " << (zeroFactorValue == Null<Real>() ? "na" : std::to_string(zeroFactorValue)));
+    }
+
+    LOG("Computing par rate and flat vol sensitivities done");
+} // compute par instrument sensis
+
+std::vector<ParSensitivityAnalysis::ParSensiEntry>
+ParSensitivityAnalysis::computeParSensitivities(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+                                                const ParSensitivityInstrumentBuilder::Instruments& instruments,
+                                                const std::vector<ParShiftScenario>& scenarios,
+                                                const map<RiskFactorKey, Real>& parRatesBase,
+                                                const map<RiskFactorKey, Real>& parCapVols) const {
+
+    // the scenarios are applied one by one, the scenario generator of the sim market is restored by the caller
+
+    auto scenarioGenerator = QuantLib::ext::make_shared<StaticScenarioGenerator>();
+    simMarket->scenarioGenerator() = scenarioGenerator;
+
+    std::set<RiskFactorKey::KeyType> survivalAndRateCurveTypes = {
+        RiskFactorKey::KeyType::SurvivalProbability, RiskFactorKey::KeyType::DiscountCurve,
+        RiskFactorKey::KeyType::YieldCurve, RiskFactorKey::KeyType::IndexCurve};
+
+    std::vector<ParSensiEntry> result;
+
+    for (auto const& s : scenarios) {
+
+        const RiskFactorKey& key = s.first;
+        scenarioGenerator->setScenario(s.second);
+        simMarket->update(asof_);
 
         // Since we are not using ValuationEngine we need to manually perform the trade updates here
         // TODO - explore means of utilising valuation engine
-        if (ObservationMode::instance().mode() == ObservationMode::Mode::Disable) {
-            for (auto it : instruments_.parHelpers_)
+        if (ObservationMode::instance().mode() == ObservationMode::Mode::Disable ||
+            ObservationMode::instance().mode() == ObservationMode::Mode::Track) {
+            for (auto it : instruments.parHelpers_)
                 it.second->deepUpdate();
-            for (auto it : instruments_.parCaps_)
+            for (auto it : instruments.parCaps_)
                 it.second->deepUpdate();
-            for (auto it : instruments_.parYoYCaps_)
+            for (auto it : instruments.parYoYCaps_)
                 it.second->deepUpdate();
         }
 
-        rawKeysCheck.insert(desc[i].key1());
-
         // Get the absolute shift size and skip if close to zero
 
-        Real shiftSize = getShiftSize(desc[i].key1(), sensitivityData_, simMarket);
+        Real shiftSize = getShiftSize(key, sensitivityData_, simMarket);
 
         if (close_enough(shiftSize, 0.0)) {
-            ALOG("Shift size for " << desc[i].key1() << " is zero, skipping");
+            ALOG("Shift size for " << key << " is zero, skipping");
             continue;
         }
 
         // process par helpers
 
-        std::set<RiskFactorKey::KeyType> survivalAndRateCurveTypes = {
-            RiskFactorKey::KeyType::SurvivalProbability, RiskFactorKey::KeyType::DiscountCurve,
-            RiskFactorKey::KeyType::YieldCurve, RiskFactorKey::KeyType::IndexCurve};
-
-        for (auto const& p : instruments_.parHelpers_) {
+        for (auto const& p : instruments.parHelpers_) {
 
             // skip if par helper has no sensi to zero risk factor (except the special treatment below kicks in)
 
             if (p.second->isCalculated() &&
                 (survivalAndRateCurveTypes.find(p.first.keytype) == survivalAndRateCurveTypes.end() ||
-                 p.first != desc[i].key1())) {
+                 p.first != key)) {
                 continue;
             }
 
@@ -365,119 +460,148 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
             // getting ill-conditioned or even singular
 
             if (survivalAndRateCurveTypes.find(p.first.keytype) != survivalAndRateCurveTypes.end() &&
-                p.first == desc[i].key1() && std::abs(tmp) < 0.01) {
-                WLOG("Setting Diagonal Sensi " << p.first << " w.r.t. " << desc[i].key1() << " to 0.01 (got " << tmp
-                                               << ")");
+                p.first == key && std::abs(tmp) < 0.01) {
+                WLOG("Setting Diagonal Sensi " << p.first << " w.r.t. " << key << " to 0.01 (got " << tmp << ")");
                 tmp = 0.01;
             }
 
             // YoY diagnoal entries are 1.0
 
-            if (p.first.keytype == RiskFactorKey::KeyType::YoYInflationCurve && p.first == desc[i].key1() &&
+            if (p.first.keytype == RiskFactorKey::KeyType::YoYInflationCurve && p.first == key &&
                 close_enough(tmp, 0.0)) {
                 tmp = 1.0;
             }
 
-            // write sensitivity
-
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
+            result.push_back(std::make_tuple(p.first, key, tmp));
         }
 
-        // process par caps
+        // process par caps and par yoy caps
 
-        for (auto const& p : instruments_.parCaps_) {
+        auto processCaps = [&](const auto& caps) {
+            for (auto const& p : caps) {
 
-            if (p.second->isCalculated() && p.first != desc[i].key1())
-                continue;
+                if (p.second->isCalculated() && p.first != key)
+                    continue;
 
-            auto fair = impliedVolatility(p.first, instruments_);
-            auto base = parCapVols.find(p.first);
-            QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
+                auto fair = impliedVolatility(p.first, instruments);
+                auto base = parCapVols.find(p.first);
+                QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
 
-            Real tmp = (fair - base->second) / shiftSize;
+                Real tmp = (fair - base->second) / shiftSize;
 
-            // ensure Jacobi matrix is regular and not (too) ill-conditioned, this is necessary because
-            // a) the shift size used to compute dpar / dzero might be close to zero and / or
-            // b) the implied vol calculation has numerical inaccuracies
+                // ensure Jacobi matrix is regular and not (too) ill-conditioned, this is necessary because
+                // a) the shift size used to compute dpar / dzero might be close to zero and / or
+                // b) the implied vol calculation has numerical inaccuracies
 
-            if (p.first == desc[i].key1() && std::abs(tmp) < 0.01) {
-                WLOG("Setting Diagonal CapFloorVol Sensi " << p.first << " w.r.t. " << desc[i].key1()
-                                                           << " to 0.01 (got " << tmp << ")");
-                tmp = 0.01;
+                if (p.first == key && std::abs(tmp) < 0.01) {
+                    WLOG("Setting Diagonal CapFloorVol Sensi " << p.first << " w.r.t. " << key << " to 0.01 (got "
+                                                               << tmp << ")");
+                    tmp = 0.01;
+                }
+
+                result.push_back(std::make_tuple(p.first, key, tmp));
             }
+        };
 
-            // write sensitivity
+        processCaps(instruments.parCaps_);
+        processCaps(instruments.parYoYCaps_);
 
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
-        }
+    } // end of loop over scenarios
 
-        // process par yoy caps
+    return result;
+}
 
-        for (auto const& p : instruments_.parYoYCaps_) {
+std::vector<ParSensitivityAnalysis::ParSensiEntry>
+ParSensitivityAnalysis::computeParSensitivities(const std::vector<std::vector<ParShiftScenario>>& blocks,
+                                                const Size nThreads, const SimMarketFactory& simMarketFactory,
+                                                const map<RiskFactorKey, Real>& parRatesBase,
+                                                const map<RiskFactorKey, Real>& parCapVols) const {
+
+#ifndef QL_ENABLE_SESSIONS
+    QL_FAIL("ParSensitivityAnalysis: multi-threaded computation requires a build with QL_ENABLE_SESSIONS = ON.");
+#endif
+
+    // distribute the blocks on the threads, largest blocks first, each to the thread with the fewest scenarios so
+    // far, the scenarios are cloned here, so that the worker threads do not share them
+
+    Size effThreads = std::min(nThreads, blocks.size());
+    std::vector<Size> blockOrder(blocks.size());
+    std::iota(blockOrder.begin(), blockOrder.end(), 0);
+    std::stable_sort(blockOrder.begin(), blockOrder.end(),
+                     [&blocks](Size a, Size b) { return blocks[a].size() > blocks[b].size(); });
+
+    std::vector<std::vector<ParShiftScenario>> threadScenarios(effThreads);
+    for (auto b : blockOrder) {
+        auto t = std::min_element(threadScenarios.begin(), threadScenarios.end(),
+                                  [](const std::vector<ParShiftScenario>& x, const std::vector<ParShiftScenario>& y) {
+                                      return x.size() < y.size();
+                                  });
+        for (auto const& [key, scenario] : blocks[b])
+            t->push_back(std::make_pair(key, scenario->clone()));
+    }
 
-            if (p.second->isCalculated() && p.first != desc[i].key1())
-                continue;
+    LOG("Compute par sensitivities for " << blocks.size() << " risk factor blocks using " << effThreads
+                                         << " threads");
 
-            auto fair = impliedVolatility(p.first, instruments_);
-            auto base = parCapVols.find(p.first);
-            QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
+    // get obs mode of main thread, so that we can set this mode in the worker threads below
+    ObservationMode::Mode obsMode = ObservationMode::instance().mode();
 
-            Real tmp = (fair - base->second) / shiftSize;
+    std::vector<std::vector<ParSensiEntry>> results(effThreads);
+    std::vector<int> rc(effThreads, 1);
+    std::vector<std::thread> jobs;
 
-            // ensure Jacobi matrix is regular and not (too) ill-conditioned, this is necessary because
-            // a) the shift size used to compute dpar / dzero might be close to zero and / or
-            // b) the implied vol calculation has numerical inaccuracies
+    for (Size id = 0; id < effThreads; ++id) {
+        jobs.emplace_back([this, id, obsMode, &simMarketFactory, &threadScenarios, &parRatesBase, &parCapVols,
+                           &results, &rc]() {
+            // set thread local singletons
 
-            if (p.first == desc[i].key1() && std::abs(tmp) < 0.01) {
-                WLOG("Setting Diagonal CapFloorVol Sensi " << p.first << " w.r.t. " << desc[i].key1()
-                                                           << " to 0.01 (got " << tmp << ")");
-                tmp = 0.01;
-            }
+            Settings::instance().evaluationDate() = asof_;
+            ObservationMode::instance().setMode(obsMode);
 
-            // write sensitivity
+            try {
+                auto simMarket = simMarketFactory(id);
+                QL_REQUIRE(simMarket != nullptr, "sim market factory returned null");
 
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
-        }
+                // the fixings are thread local as well
 
-    } // end of loop over samples
+                TodaysFixingsRemover fixingRemover(instruments_.removeTodaysFixingIndices_);
 
-    // check for
-    // a) par instruments which have no sensitivity to any of the risk factors
-    // b) risk factors w.r.t. which no par instrument has a sensitivity
-    std::set<RiskFactorKey> parKeysZero, rawKeysZero;
-    std::set_difference(parKeysCheck.begin(), parKeysCheck.end(), parKeysNonZero.begin(), parKeysNonZero.end(),
-                        std::inserter(parKeysZero, parKeysZero.begin()));
-    std::set_difference(rawKeysCheck.begin(), rawKeysCheck.end(), rawKeysNonZero.begin(), rawKeysNonZero.end(),
-                        std::inserter(rawKeysZero, rawKeysZero.begin()));
-    std::set<RiskFactorKey> problematicKeys;
-    problematicKeys.insert(parKeysZero.begin(), parKeysZero.end());
-    problematicKeys.insert(rawKeysZero.begin(), rawKeysZero.end());
-    for (auto const& k : problematicKeys) {
-        std::string type;
-        if (parKeysZero.find(k) != parKeysZero.end())
-            type = "par instrument is insensitive to all zero risk factors";
-        else if (rawKeysZero.find(k) != rawKeysZero.end())
-            type = "zero risk factor that does not affect an par instrument";
-        else
-            type = "unknown";
-        Real parHelperValue = Null<Real>();
-        if (auto tmp = instruments_.parHelpers_.find(k); tmp != instruments_.parHelpers_.end())
-            parHelperValue = impliedQuote(tmp->second);
-        else if (auto tmp = instruments_.parCaps_.find(k); tmp != instruments_.parCaps_.end())
-            parHelperValue = tmp->second->NPV();
-        else if (auto tmp = instruments_.parYoYCaps_.find(k); tmp != instruments_.parYoYCaps_.end())
-            parHelperValue = tmp->second->NPV();
-        Real zeroFactorValue = Null<Real>();
-        if (simMarket->baseScenarioAbsolute()->has(k))
-            zeroFactorValue = simMarket->baseScenarioAbsolute()->get(k);
-        WLOG("zero/par relation problem for key '"
-             << k << "', type " + type + ", par value = "
-             << (parHelperValue == Null<Real>() ? "na" : std::to_string(parHelperValue))
-             << ", zero value = " << (zeroFactorValue == Null<Real>() ? "na" : std::to_string(zeroFactorValue)));
+                ParSensitivityInstrumentBuilder::Instruments instruments;
+                ParSensitivityInstrumentBuilder().createParInstruments(
+                    instruments, asof_, simMarketParams_, sensitivityData_, typesDisabled_, parTypes_,
+                    relevantRiskFactors_, continueOnError_, marketConfiguration_, simMarket);
+
+                // price in the base scenario, so that only the instruments affected by a shift are repriced
+
+                for (auto const& p : instruments.parHelpers_)
+                    impliedQuote(p.second);
+                for (auto const& p : instruments.parCaps_)
+                    p.second->NPV();
+                for (auto const& p : instruments.parYoYCaps_)
+                    p.second->NPV();
+
+                results[id] = computeParSensitivities(simMarket, instruments, threadScenarios[id], parRatesBase,
+                                                      parCapVols);
+                rc[id] = 0;
+
+            } catch (const std::exception& e) {
+                StructuredAnalyticsErrorMessage("Par Sensitivity Analysis", "", e.what()).log();
+            }
+        });
     }
 
-    LOG("Computing par rate and flat vol sensitivities done");
-} // compute par instrument sensis
+    for (auto& t : jobs)
+        t.join();
+
+    std::vector<ParSensiEntry> result;
+    for (Size id = 0; id < effThreads; ++id) {
+        QL_REQUIRE(rc[id] == 0, "error: thread " << id << " failed in par sensitivity computation. Check for "
+                                                 << "structured errors from 'Par Sensitivity Analysis'.");
+        result.insert(result.end(), results[id].begin(), results[id].end());
+    }
+
+    return result;
+}
 
 void ParSensitivityAnalysis::alignPillars() {
     LOG("Align simulation market pillars to actual latest relevant dates of par instruments");
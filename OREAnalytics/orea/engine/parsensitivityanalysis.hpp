@@ -39,6 +39,7 @@
 
 #include <boost/numeric/ublas/vector.hpp>
 
+#include <functional>
 #include <map>
 #include <set>
 #include <tuple>
@@ -58,6 +59,13 @@ class ParSensitivityAnalysis {
 public:
     typedef std::map<std::pair<ore::analytics::RiskFactorKey, ore::analytics::RiskFactorKey>, Real> ParContainer;
 
+    /*! Factory building a new sim market with the same composition as the one passed to
+        computeParInstrumentSensitivities(), it is called once in each worker thread with the thread id 0, 1, ...,
+        nThreads - 1 and must build the sim market from objects not shared with other threads, e.g. from a todays
+        market built on a loader cloned for this thread id before computeParInstrumentSensitivities() is called */
+    typedef std::function<QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>(QuantLib::Size)>
+        SimMarketFactory;
+
     //! Constructor
     ParSensitivityAnalysis(const QuantLib::Date& asof,
                            const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& simMarketParams,
@@ -68,8 +76,14 @@ public:
 
     virtual ~ParSensitivityAnalysis() {}
 
-    //! Compute par instrument sensitivities
-    void computeParInstrumentSensitivities(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
+    /*! Compute par instrument sensitivities
+
+        If nThreads > 1 and a sim market factory is given, the shift scenarios are split into blocks of risk factors
+        sharing the key type and name (i.e. curves, surfaces) and the blocks are processed in parallel, each worker
+        thread using its own sim market and par instruments. This requires a build with QL_ENABLE_SESSIONS = ON. */
+    void computeParInstrumentSensitivities(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket,
+                                           const QuantLib::Size nThreads = 1,
+                                           const SimMarketFactory& simMarketFactory = SimMarketFactory());
 
     //! Return computed par sensitivities. Empty if they have not been computed yet.
     const ParContainer& parSensitivities() const { return parSensi_; }
@@ -100,9 +114,28 @@ public:
     const ParSensitivityInstrumentBuilder::Instruments& parInstruments() const { return instruments_; }
 
 private:
+    typedef std::pair<ore::analytics::RiskFactorKey, QuantLib::ext::shared_ptr<ore::analytics::Scenario>>
+        ParShiftScenario;
+    typedef std::tuple<ore::analytics::RiskFactorKey, ore::analytics::RiskFactorKey, QuantLib::Real> ParSensiEntry;
+
     //! Augment relevant risk factors
     void augmentRelevantRiskFactors();
 
+    //! Par instrument sensitivities to the given shift scenarios, the instruments must be linked to the sim market
+    std::vector<ParSensiEntry>
+    computeParSensitivities(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket,
+                            const ParSensitivityInstrumentBuilder::Instruments& instruments,
+                            const std::vector<ParShiftScenario>& scenarios,
+                            const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parRatesBase,
+                            const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parCapVols) const;
+
+    //! Par instrument sensitivities to the given blocks of shift scenarios, computed on thread local sim markets
+    std::vector<ParSensiEntry>
+    computeParSensitivities(const std::vector<std::vector<ParShiftScenario>>& blocks, const QuantLib::Size nThreads,
+                            const SimMarketFactory& simMarketFactory,
+                            const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parRatesBase,
+                            const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parCapVols) const;
+
     //! Populate `shiftSizes_` for \p key given the implied fair par rate \p parRate
     void populateShiftSizes(const ore::analytics::RiskFactorKey& key, QuantLib::Real parRate,
                             const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
@@ -21,11 +21,14 @@
 #include <ored/utilities/log.hpp>
 #include <ql/errors.hpp>
 
+#include <unordered_map>
+
 using ore::analytics::ScenarioFilter;
 using std::function;
 using std::map;
 using std::set;
 using std::string;
+using std::vector;
 
 namespace ore {
 namespace analytics {
@@ -50,6 +53,12 @@ SensitivityAggregator::SensitivityAggregator(const map<string, function<bool(str
 }
 
 void SensitivityAggregator::aggregate(SensitivityStream& ss, const QuantLib::ext::shared_ptr<ScenarioFilter>& filter) {
+    // Use the group by on ids for compact streams
+    if (auto cs = dynamic_cast<CompactSensitivityStream*>(&ss)) {
+        aggregate(*cs, filter);
+        return;
+    }
+
     // Ensure at start of stream
     ss.reset();
 
@@ -76,6 +85,67 @@ void SensitivityAggregator::aggregate(SensitivityStream& ss, const QuantLib::ext
     }
 }
 
+void SensitivityAggregator::aggregate(const CompactSensitivityStream& ss,
+                                      const QuantLib::ext::shared_ptr<ScenarioFilter>& filter) {
+
+    // Evaluate the filter once per risk factor key, id 0 is the empty key
+    const auto& keys = ss.keyDictionary();
+    vector<char> allowed(keys.size());
+    for (Size k = 0; k < keys.size(); ++k)
+        allowed[k] = k == 0 || filter->allow(keys[k]);
+
+    // Evaluate the categories once per trade id
+    vector<string> categoryNames;
+    for (const auto& kv : categories_)
+        categoryNames.push_back(kv.first);
+    const auto& tradeIds = ss.tradeIdDictionary();
+    vector<vector<Size>> tradeCategories(tradeIds.size());
+    for (Size t = 0; t < tradeIds.size(); ++t) {
+        Size c = 0;
+        for (const auto& kv : categories_) {
+            if (kv.second(tradeIds[t]))
+                tradeCategories[t].push_back(c);
+            ++c;
+        }
+    }
+
+    // Group the records by (key_1, key_2) for each category, keeping the first record of each group for the
+    // descriptions, shifts and currency, as add() does
+    struct Group {
+        Size first;
+        Real baseNpv, delta, gamma;
+    };
+    vector<std::unordered_map<std::uint64_t, Group>> groups(categoryNames.size());
+    const auto &t = ss.tradeIds(), &k1 = ss.keys1(), &k2 = ss.keys2();
+    const auto &baseNpv = ss.baseNpvs(), &delta = ss.deltas(), &gamma = ss.gammas();
+    for (Size i = 0; i < ss.size(); ++i) {
+        if (tradeCategories[t[i]].empty() || !allowed[k1[i]] || !allowed[k2[i]])
+            continue;
+        std::uint64_t key = (static_cast<std::uint64_t>(k1[i]) << 32) | k2[i];
+        for (Size c : tradeCategories[t[i]]) {
+            auto& g = groups[c].try_emplace(key, Group{i, 0.0, 0.0, 0.0}).first->second;
+            g.baseNpv += baseNpv[i];
+            g.delta += delta[i];
+            g.gamma += gamma[i];
+        }
+    }
+
+    // Update aggRecords_ for each category
+    for (Size c = 0; c < categoryNames.size(); ++c) {
+        auto& records = aggRecords_[categoryNames[c]];
+        for (const auto& kv : groups[c]) {
+            SensitivityRecord sr = ss.record(kv.second.first);
+            sr.tradeId = "";
+            sr.baseNpv = kv.second.baseNpv;
+            sr.delta = kv.second.delta;
+            sr.gamma = kv.second.gamma;
+            add(sr, records);
+        }
+        DLOG("Updated aggregated sensitivities for category " << categoryNames[c] << " with " << groups[c].size()
+                                                               << " risk factor groups");
+    }
+}
+
 void SensitivityAggregator::reset() {
     // Clear the aggregated sensitivities
     aggRecords_.clear();
@@ -141,7 +211,7 @@ void SensitivityAggregator::add(SensitivityRecord& sr, set<SensitivityRecord>& r
 
 bool SensitivityAggregator::inCategory(const string& tradeId, const string& category) const {
     QL_REQUIRE(setCategories_.count(category), "The category " << category << " is not valid");
-    auto tradeIds = setCategories_.at(category);
+    const auto& tradeIds = setCategories_.at(category);
     for (auto it = tradeIds.begin(); it != tradeIds.end(); ++it) {
         if (it->first == tradeId)
             return true;
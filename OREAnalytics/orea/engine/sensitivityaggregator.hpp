@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <orea/engine/compactsensitivitystream.hpp>
 #include <orea/engine/sensitivitystream.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 
@@ -63,6 +64,13 @@ public:
     void aggregate(SensitivityStream& ss, const QuantLib::ext::shared_ptr<ScenarioFilter>& filter =
                                               QuantLib::ext::make_shared<ScenarioFilter>());
 
+    /*! Update the aggregator with the records of a compact stream. The filter is evaluated once per risk factor
+        key and the categories once per trade id, the records are grouped by their risk factor key ids. This is
+        used by the general aggregate() method if the stream is a CompactSensitivityStream.
+    */
+    void aggregate(const CompactSensitivityStream& ss, const QuantLib::ext::shared_ptr<ScenarioFilter>& filter =
+                                                           QuantLib::ext::make_shared<ScenarioFilter>());
+
     //! Reset the aggregator to it's initial state by clearing all aggregations
     void reset();
 
@@ -18,6 +18,7 @@
 
 #include <orea/cube/jointnpvsensicube.hpp>
 #include <orea/cube/sensicube.hpp>
+#include <orea/engine/deltagammanpvcalculator.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
 #include <orea/engine/valuationcalculator.hpp>
@@ -26,14 +27,25 @@
 #include <orea/scenario/deltascenariofactory.hpp>
 
 #include <ored/marketdata/todaysmarket.hpp>
+#include <ored/portfolio/enginefactory.hpp>
 #include <ored/portfolio/fxoption.hpp>
+#include <ored/scripting/engines/scriptedinstrumentpricingenginecg.hpp>
+#include <ored/scripting/scriptedinstrument.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <ql/errors.hpp>
 #include <ql/math/comparison.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -53,7 +65,7 @@ SensitivityAnalysis::SensitivityAnalysis(
     const IborFallbackConfig& iborFallbackConfig, const bool continueOnError, bool dryRun)
     : market_(market), marketConfiguration_(marketConfiguration), asof_(market ? market->asofDate() : Date()),
       simMarketData_(simMarketData), sensitivityData_(sensitivityData), recalibrateModels_(recalibrateModels),
-      curveConfigs_(curveConfigs), todaysMarketParams_(todaysMarketParams), overrideTenors_(false),
+      curveConfigs_(curveConfigs), todaysMarketParams_(todaysMarketParams), overrideTenors_(false), useAd_(false),
       nonShiftedBaseCurrencyConversion_(nonShiftedBaseCurrencyConversion), referenceData_(referenceData),
       iborFallbackConfig_(iborFallbackConfig), continueOnError_(continueOnError), engineData_(engineData),
       portfolio_(portfolio), dryRun_(dryRun), useSingleThreadedEngine_(true) {}
@@ -70,7 +82,7 @@ SensitivityAnalysis::SensitivityAnalysis(
     const IborFallbackConfig& iborFallbackConfig, const bool continueOnError, bool dryRun, const std::string& context)
     : marketConfiguration_(marketConfiguration), asof_(asof), simMarketData_(simMarketData),
       sensitivityData_(sensitivityData), recalibrateModels_(recalibrateModels), curveConfigs_(curveConfigs),
-      todaysMarketParams_(todaysMarketParams), overrideTenors_(false),
+      todaysMarketParams_(todaysMarketParams), overrideTenors_(false), useAd_(false),
       nonShiftedBaseCurrencyConversion_(nonShiftedBaseCurrencyConversion), referenceData_(referenceData),
       iborFallbackConfig_(iborFallbackConfig), continueOnError_(continueOnError), engineData_(engineData),
       portfolio_(portfolio), dryRun_(dryRun), useSingleThreadedEngine_(false), nThreads_(nThreads), loader_(loader),
@@ -100,12 +112,164 @@ splitPortfolioByScenarioGenerators(
     }
     return result;
 }
+
+// number of trades in a portfolio for which the npv was computed from cached AD sensitivities
+Size numberOfTradesUsingAd(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
+    Size n = 0;
+    for (auto const& [_, t] : portfolio->trades()) {
+        if (t->instrument() == nullptr)
+            continue;
+        auto qlInstr = QuantLib::ext::dynamic_pointer_cast<ScriptedInstrument>(t->instrument()->qlInstrument());
+        if (qlInstr == nullptr)
+            continue;
+        if (auto e = QuantLib::ext::dynamic_pointer_cast<ScriptedInstrumentPricingEngineCG>(qlInstr->pricingEngine());
+            e != nullptr && e->haveCachedSensis())
+            ++n;
+    }
+    return n;
+}
+
+// union of the sim market yield curve pillar times, these are used as bucket times for analytic deltas and gammas
+std::string deltaGammaBucketTimes(const ScenarioSimMarketParameters& simMarketData, const ScenarioSimMarket& simMarket) {
+    std::set<Real> times;
+    auto addTimes = [&times, &simMarket](const Handle<YieldTermStructure>& yts, const std::vector<Period>& tenors) {
+        for (auto const& p : tenors)
+            times.insert(yts->timeFromReference(simMarket.asofDate() + p));
+    };
+    for (auto const& ccy : simMarketData.discountCurveNames())
+        addTimes(simMarket.discountCurve(ccy), simMarketData.yieldCurveTenors(ccy));
+    for (auto const& idx : simMarketData.indices())
+        addTimes(simMarket.iborIndex(idx)->forwardingTermStructure(), simMarketData.yieldCurveTenors(idx));
+    std::ostringstream os;
+    os << std::setprecision(12);
+    Real last = 0.0;
+    for (auto t : times) {
+        if (t <= 0.0 || close_enough(t, last))
+            continue;
+        os << (last > 0.0 ? "," : "") << t;
+        last = t;
+    }
+    return os.str();
+}
+
+// switch swaps and fx forwards priced with discounting engines to the engines providing analytic deltas and gammas,
+// provided that a builder for the delta gamma engine is registered and that the configured engine parameters, which
+// the delta gamma engines do not read, are not set
+void enableAnalyticDeltaGamma(EngineData& ed, const std::string& bucketTimes, const bool computeGamma,
+                              const bool linearInZero) {
+    struct DeltaGammaEngine {
+        std::set<std::string> engines;
+        std::string deltaGammaEngine;
+    };
+    static const std::map<std::string, DeltaGammaEngine> engines = {
+        {"Swap", {{"DiscountingSwapEngine", "DiscountingSwapEngineOptimised"}, "DiscountingSwapEngineDeltaGamma"}},
+        {"FxForward", {{"DiscountingFxForwardEngine"}, "DiscountingFxForwardEngineDeltaGamma"}}};
+    static const std::set<std::string> deltaGammaParameters = {"BucketTimes", "ComputeDelta", "ComputeGamma",
+                                                               "LinearInZero"};
+    std::vector<QuantLib::ext::shared_ptr<EngineBuilder>> builders;
+    for (auto const& [product, e] : engines) {
+        if (!ed.hasProduct(product) || ed.model(product) != "DiscountedCashflows" ||
+            e.engines.find(ed.engine(product)) == e.engines.end())
+            continue;
+        if (builders.empty())
+            builders = EngineBuilderFactory::instance().generateEngineBuilders();
+        if (std::none_of(builders.begin(), builders.end(), [&product, &e](const auto& b) {
+                return b->model() == "DiscountedCashflows" && b->engine() == e.deltaGammaEngine &&
+                       b->tradeTypes().count(product) == 1;
+            })) {
+            DLOG("No engine builder " << e.deltaGammaEngine << " registered for product " << product
+                                      << ", analytic deltas and gammas are not used");
+            continue;
+        }
+        auto& engineParams = ed.engineParameters(product);
+        auto unsupported = std::find_if(engineParams.begin(), engineParams.end(), [](const auto& p) {
+            return deltaGammaParameters.find(p.first) == deltaGammaParameters.end();
+        });
+        if (unsupported != engineParams.end()) {
+            DLOG("Engine parameter " << unsupported->first << " for product " << product << " is not supported by "
+                                     << e.deltaGammaEngine << ", analytic deltas and gammas are not used");
+            continue;
+        }
+        ed.engine(product) = e.deltaGammaEngine;
+        engineParams["BucketTimes"] = bucketTimes;
+        engineParams["ComputeDelta"] = "true";
+        engineParams["ComputeGamma"] = computeGamma ? "true" : "false";
+        engineParams["LinearInZero"] = linearInZero ? "true" : "false";
+        DLOG("Enable analytic deltas and gammas for product " << product << " (engine " << e.deltaGammaEngine
+                                                              << ")");
+    }
+}
+
 } // namespace
 
+void enableScriptedTradeAd(EngineData& ed) {
+    static const std::vector<std::string> qualifiedParams = {"Model_", "Engine_", "UseAD_"};
+    auto adCapable = [](const boost::optional<std::string>& model, const boost::optional<std::string>& engine) {
+        return model && engine && *engine == "MC" && (*model == "BlackScholes" || *model == "GaussianCam");
+    };
+    // same lookup as in EngineBuilder: the tag qualified parameter takes precedence over the unqualified one
+    auto resolve = [](const std::map<std::string, std::string>& params, const std::string& name,
+                      const std::string& tag) -> boost::optional<std::string> {
+        if (!tag.empty()) {
+            if (auto p = params.find(name + "_" + tag); p != params.end())
+                return p->second;
+        }
+        if (auto p = params.find(name); p != params.end())
+            return p->second;
+        return boost::none;
+    };
+    for (auto const& p : ed.products()) {
+        if (ed.model(p) != "Generic" || ed.engine(p) != "Generic")
+            continue;
+        auto& engineParams = ed.engineParameters(p);
+        auto const& modelParams = ed.modelParameters(p);
+        // product tags with qualified parameters, the other tags use the unqualified parameters
+        std::set<std::string> tags;
+        for (auto const* params : {&modelParams, &engineParams}) {
+            for (auto const& [k, _] : *params) {
+                for (auto const& q : qualifiedParams) {
+                    if (boost::starts_with(k, q) && k.size() > q.size())
+                        tags.insert(k.substr(q.size()));
+                }
+            }
+        }
+        // an explicit unqualified UseAD applies to all tags without a qualified UseAD
+        bool explicitDefault = engineParams.find("UseAD") != engineParams.end();
+        bool defaultAd = adCapable(resolve(modelParams, "Model", ""), resolve(engineParams, "Engine", ""));
+        if (!explicitDefault && defaultAd) {
+            engineParams["UseAD"] = "true";
+            DLOG("Enable AD for product " << p << " (model " << *resolve(modelParams, "Model", "") << ")");
+        }
+        for (auto const& tag : tags) {
+            if (explicitDefault || engineParams.find("UseAD_" + tag) != engineParams.end())
+                continue;
+            bool tagAd = adCapable(resolve(modelParams, "Model", tag), resolve(engineParams, "Engine", tag));
+            if (tagAd != defaultAd) {
+                engineParams["UseAD_" + tag] = tagAd ? "true" : "false";
+                DLOG((tagAd ? "Enable" : "Disable") << " AD for product " << p << ", tag " << tag);
+            }
+        }
+    }
+}
+
 void SensitivityAnalysis::generateSensitivities() {
 
     LOG("Sensitivity analysis started...");
 
+    bool useAd = useAd_;
+    if (useAd && sensitivityData_->computeGamma()) {
+        WLOG("SensitivityAnalysis::generateSensitivities(): AD is only used for first order sensitivities, trades will "
+             "be repriced under each scenario since gamma computation is enabled.");
+        useAd = false;
+    }
+
+    bool useAnalyticDeltaGamma = useAnalyticDeltaGamma_;
+    if (useAnalyticDeltaGamma && nonShiftedBaseCurrencyConversion_) {
+        WLOG("SensitivityAnalysis::generateSensitivities(): analytic deltas and gammas are not supported in "
+             "combination with non-shifted base ccy conversion, all trades will be repriced under each scenario.");
+        useAnalyticDeltaGamma = false;
+    }
+
     QL_REQUIRE(useSingleThreadedEngine_ || !nonShiftedBaseCurrencyConversion_,
                "SensitivityAnalysis::generateSensitivities(): multi-threaded engine does not support non-shifted base "
                "ccy conversion currently. This requires a small code extension. Contact Dev.");
@@ -161,12 +325,25 @@ void SensitivityAnalysis::generateSensitivities() {
         auto ed = QuantLib::ext::make_shared<EngineData>(*engineData_);
         ed->globalParameters()["RunType"] =
             std::string("Sensitivity") + (sensitivityData_->computeGamma() ? "DeltaGamma" : "Delta");
+        if (useAd)
+            enableScriptedTradeAd(*ed);
 
         QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
         vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+        QuantLib::ext::shared_ptr<DeltaGammaNPVCalculator> deltaGammaCalculator;
+        if (useAnalyticDeltaGamma) {
+            std::string bucketTimes = deltaGammaBucketTimes(*simMarketData_, *simMarket_);
+            enableAnalyticDeltaGamma(*ed, bucketTimes, sensitivityData_->computeGamma(),
+                                     simMarketData_->interpolation() == "LinearZero");
+            deltaGammaCalculator = QuantLib::ext::make_shared<DeltaGammaNPVCalculator>(
+                simMarketData_->baseCcy(), parseListOfValues<Real>(bucketTimes, &parseReal));
+        }
         if (nonShiftedBaseCurrencyConversion_)
             // use "original" FX rates to convert sensi to base currency
             calculators.push_back(QuantLib::ext::make_shared<NPVCalculatorFXT0>(simMarketData_->baseCcy(), market_));
+        else if (deltaGammaCalculator)
+            // use analytic deltas and gammas where available, the scenario FX rate is used for the conversion
+            calculators.push_back(deltaGammaCalculator);
         else
             // use the scenario FX rate when converting sensi to base currency
             calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData_->baseCcy()));
@@ -189,9 +366,17 @@ void SensitivityAnalysis::generateSensitivities() {
             else
                 modelBuilders_.clear();
             ValuationEngine engine(asof_, dg, simMarket_, modelBuilders_);
+            engine.enableProfiling(profile_);
             for (auto const& i : this->progressIndicators())
                 engine.registerProgressIndicator(i);
             engine.buildCube(pf, cube, calculators, true, nullptr, nullptr, {}, dryRun_);
+            if (useAd)
+                LOG("Sensitivity scenario npvs for " << numberOfTradesUsingAd(pf) << " out of " << pf->size()
+                                                     << " trades computed from AD sensitivities.");
+            if (deltaGammaCalculator)
+                LOG("Sensitivity scenario npvs for " << deltaGammaCalculator->numberOfAnalyticTrades() << " out of "
+                                                     << pf->size()
+                                                     << " trades computed from analytic deltas and gammas.");
 
             sensiCubes_.push_back(QuantLib::ext::make_shared<SensitivityCube>(cube, scenGen->scenarioDescriptions(),
                                                                       scenarioGenerator_->shiftSizes(),
@@ -227,6 +412,16 @@ void SensitivityAnalysis::generateSensitivities() {
         auto ed = QuantLib::ext::make_shared<EngineData>(*engineData_);
         ed->globalParameters()["RunType"] =
             std::string("Sensitivity") + (sensitivityData_->computeGamma() ? "DeltaGamma" : "Delta");
+        if (useAd)
+            enableScriptedTradeAd(*ed);
+
+        std::vector<Real> deltaGammaBucketTimeValues;
+        if (useAnalyticDeltaGamma) {
+            std::string bucketTimes = deltaGammaBucketTimes(*simMarketData_, *simMarket_);
+            enableAnalyticDeltaGamma(*ed, bucketTimes, sensitivityData_->computeGamma(),
+                                     simMarketData_->interpolation() == "LinearZero");
+            deltaGammaBucketTimeValues = parseListOfValues<Real>(bucketTimes, &parseReal);
+        }
 
         sensiCubes_.clear();
         for (auto const& [pf, scenGen] :
@@ -245,13 +440,18 @@ void SensitivityAnalysis::generateSensitivities() {
                     return QuantLib::ext::make_shared<ore::analytics::DoublePrecisionSensiCube>(ids, asof, samples);
                 },
                 {}, {}, context_);
+            engine.enableProfiling(profile_);
             for (auto const& i : this->progressIndicators())
                 engine.registerProgressIndicator(i);
 
             auto baseCcy = simMarketData_->baseCcy();
             engine.buildCube(
                 pf,
-                [&baseCcy]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
+                [&baseCcy, useAnalyticDeltaGamma,
+                 &deltaGammaBucketTimeValues]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
+                    if (useAnalyticDeltaGamma)
+                        return {QuantLib::ext::make_shared<DeltaGammaNPVCalculator>(baseCcy,
+                                                                                    deltaGammaBucketTimeValues)};
                     return {QuantLib::ext::make_shared<NPVCalculator>(baseCcy)};
                 },
                 {}, true, dryRun_);
@@ -25,6 +25,7 @@
 
 #include <orea/cube/npvsensicube.hpp>
 #include <orea/cube/sensitivitycube.hpp>
+#include <orea/engine/valuationprofile.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/sensitivityscenariodata.hpp>
@@ -117,6 +118,24 @@ public:
     //! override shift tenors with sim market tenors
     void overrideTenors(const bool b) { overrideTenors_ = b; }
 
+    /*! Compute first order sensitivities of scripted trades priced with a model that supports computation graphs
+        (BlackScholes / GaussianCam with MC engine) using AD. The sensitivities w.r.t. the model parameters are
+        computed once in the base scenario by a backward sweep, the scenario npvs are then obtained from these without
+        repricing. Explicit UseAD settings in the pricing engine config take precedence. Gamma runs are not
+        supported by this mode, the engine config is then used as is and the trades are repriced. */
+    void useAd(const bool b) { useAd_ = b; }
+
+    /*! Price swaps and fx forwards configured with the DiscountingSwapEngine(Optimised) resp.
+        DiscountingFxForwardEngine with the corresponding engines providing analytic deltas and gammas. The bucket
+        times are the union of the simulation market yield curve pillars. The scenario npvs of the supported trades
+        are then computed from the analytic deltas and gammas of the base scenario without repricing, see
+        DeltaGammaNPVCalculator, all other trades are repriced under each scenario. Not supported in combination with
+        the non-shifted base currency conversion. */
+    void useAnalyticDeltaGamma(const bool b) { useAnalyticDeltaGamma_ = b; }
+
+    //! record the timings of the valuation engine runs in the given profile, see ValuationProfile
+    void enableProfiling(const QuantLib::ext::shared_ptr<ValuationProfile>& profile) { profile_ = profile; }
+
     //! the portfolio of trades
     QuantLib::ext::shared_ptr<Portfolio> portfolio() const { return portfolio_; }
 
@@ -144,6 +163,9 @@ private:
     //! Optional todays market parameters. Used in building the scenario sim market.
     QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams_;
     bool overrideTenors_;
+    bool useAd_;
+    bool useAnalyticDeltaGamma_ = false;
+    QuantLib::ext::shared_ptr<ValuationProfile> profile_;
 
     // if true, convert sensis to base currency using the original (non-shifted) FX rate
     bool nonShiftedBaseCurrencyConversion_;
@@ -176,5 +198,11 @@ private:
 Real getShiftSize(const RiskFactorKey& key, const SensitivityScenarioData& sensiParams,
                   const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket, const std::string& marketConfiguration = "");
 
+/*! Sets UseAD to true in the engine data for scripted trade products and product tags priced with a model / engine
+    combination supporting AD (BlackScholes / GaussianCam with MC engine). The model, engine and UseAD parameters are
+    resolved per product tag as in the engine builder, i.e. Model_<tag>, Engine_<tag>, UseAD_<tag> take precedence over
+    the unqualified parameters. Explicit UseAD settings are kept. */
+void enableScriptedTradeAd(ore::data::EngineData& engineData);
+
 } // namespace analytics
 } // namespace ore
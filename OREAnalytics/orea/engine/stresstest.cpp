@@ -16,18 +16,24 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <orea/app/structuredanalyticserror.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/observationmode.hpp>
 #include <orea/engine/stresstest.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
 #include <orea/scenario/clonescenariofactory.hpp>
 
+#include <ored/portfolio/portfoliosnapshot.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/progressbar.hpp>
 
 #include <ql/errors.hpp>
 
 #include <boost/lexical_cast.hpp>
 
+#include <thread>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -36,6 +42,26 @@ using namespace ore::data;
 namespace ore {
 namespace analytics {
 
+namespace {
+
+// scenario generator returning a given list of scenarios, used to feed the slices of the worker threads
+class ScenarioListGenerator : public ScenarioGenerator {
+public:
+    explicit ScenarioListGenerator(const std::vector<QuantLib::ext::shared_ptr<Scenario>>& scenarios)
+        : scenarios_(scenarios) {}
+    QuantLib::ext::shared_ptr<Scenario> next(const Date&) override {
+        QL_REQUIRE(counter_ < scenarios_.size(), "scenario vector size " << scenarios_.size() << " exceeded");
+        return scenarios_[counter_++];
+    }
+    void reset() override { counter_ = 0; }
+
+private:
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios_;
+    Size counter_ = 0;
+};
+
+} // namespace
+
 StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
                        const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
                        const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData,
@@ -44,7 +70,8 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
                        const CurveConfigurations& curveConfigs, const TodaysMarketParameters& todaysMarketParams,
                        QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory,
                        const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
-                       const IborFallbackConfig& iborFallbackConfig, bool continueOnError) {
+                       const IborFallbackConfig& iborFallbackConfig, bool continueOnError, const Size nThreads,
+                       const MarketFactory& marketFactory) {
 
     LOG("Run Stress Test");
     DLOG("Build Simulation Market");
@@ -65,25 +92,123 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
     configurations[MarketContext::pricing] = marketConfiguration;
     auto ed = QuantLib::ext::make_shared<EngineData>(*engineData);
     ed->globalParameters()["RunType"] = "Stress";
-    QuantLib::ext::shared_ptr<EngineFactory> factory =
-    QuantLib::ext::make_shared<EngineFactory>(ed, simMarket, configurations, referenceData, iborFallbackConfig);
 
-    DLOG("Reset and Build Portfolio");
-    portfolio->reset();
-    portfolio->build(factory, "stress analysis");
+    QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
+    auto progressLog = QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice);
 
-    DLOG("Build the cube object to store sensitivities");
-    QuantLib::ext::shared_ptr<NPVCube> cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
-        asof, portfolio->ids(), vector<Date>(1, asof), scenarioGenerator->samples());
+    // the result cubes and the index of the first scenario of each cube
+    std::vector<QuantLib::ext::shared_ptr<NPVCube>> cubes;
+    std::vector<Size> offsets;
 
-    DLOG("Run Stress Scenarios");
-    QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
-    vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
-    calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData->baseCcy()));
-    ValuationEngine engine(asof, dg, simMarket, factory->modelBuilders());
+    Size samples = scenarioGenerator->samples();
+    Size effThreads = marketFactory ? std::min(nThreads, samples) : 1;
+
+    if (effThreads <= 1) {
+
+        QuantLib::ext::shared_ptr<EngineFactory> factory =
+            QuantLib::ext::make_shared<EngineFactory>(ed, simMarket, configurations, referenceData, iborFallbackConfig);
 
-    engine.registerProgressIndicator(QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
-    engine.buildCube(portfolio, cube, calculators);
+        DLOG("Reset and Build Portfolio");
+        portfolio->reset();
+        portfolio->build(factory, "stress analysis");
+
+        DLOG("Build the cube object to store sensitivities");
+        QuantLib::ext::shared_ptr<NPVCube> cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
+            asof, portfolio->ids(), vector<Date>(1, asof), samples);
+
+        DLOG("Run Stress Scenarios");
+        vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+        calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData->baseCcy()));
+        ValuationEngine engine(asof, dg, simMarket, factory->modelBuilders());
+
+        engine.registerProgressIndicator(progressLog);
+        engine.buildCube(portfolio, cube, calculators);
+
+        cubes.push_back(cube);
+        offsets.push_back(0);
+
+    } else {
+
+#ifndef QL_ENABLE_SESSIONS
+        QL_FAIL("StressTest: multi-threaded computation requires a build with QL_ENABLE_SESSIONS = ON.");
+#endif
+
+        LOG("Run " << samples << " stress scenarios using " << effThreads << " threads");
+
+        // split the scenarios into contiguous slices, the scenarios are cloned here, so that the worker threads do
+        // not share them
+
+        std::vector<std::vector<QuantLib::ext::shared_ptr<Scenario>>> threadScenarios(effThreads);
+        for (Size id = 0; id < effThreads; ++id) {
+            offsets.push_back(id * samples / effThreads);
+            for (Size j = offsets.back(); j < (id + 1) * samples / effThreads; ++j)
+                threadScenarios[id].push_back(scenarioGenerator->scenarios()[j]->clone());
+        }
+
+        // the worker threads load their portfolio copies from a snapshot of the trade data
+
+        PortfolioSnapshot portfolioSnapshot(*portfolio);
+        bool buildFailedTrades = portfolio->buildFailedTrades();
+        bool ignoreTradeBuildFail = portfolio->ignoreTradeBuildFail();
+
+        auto progressIndicator = QuantLib::ext::make_shared<MultiThreadedProgressIndicator>(
+            std::set<QuantLib::ext::shared_ptr<ProgressIndicator>>{progressLog});
+
+        // get obs mode of main thread, so that we can set this mode in the worker threads below
+        ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+
+        cubes.resize(effThreads);
+        std::vector<int> rc(effThreads, 1);
+        std::vector<std::thread> jobs;
+
+        for (Size id = 0; id < effThreads; ++id) {
+            jobs.emplace_back([id, obsMode, asof, &marketFactory, &simMarketData, &marketConfiguration, &curveConfigs,
+                               &todaysMarketParams, continueOnError, &stressData, &iborFallbackConfig, &ed,
+                               &configurations, &referenceData, &portfolioSnapshot, buildFailedTrades,
+                               ignoreTradeBuildFail, &threadScenarios, &dg, &progressIndicator, &cubes, &rc]() {
+                // set thread local singletons
+
+                Settings::instance().evaluationDate() = asof;
+                ObservationMode::instance().setMode(obsMode);
+
+                try {
+                    auto market = marketFactory(id);
+                    QL_REQUIRE(market != nullptr, "market factory returned null");
+
+                    auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(
+                        market, simMarketData, marketConfiguration, curveConfigs, todaysMarketParams, continueOnError,
+                        stressData->useSpreadedTermStructures(), false, false, iborFallbackConfig, true);
+                    simMarket->scenarioGenerator() = QuantLib::ext::make_shared<ScenarioListGenerator>(threadScenarios[id]);
+
+                    auto factory = QuantLib::ext::make_shared<EngineFactory>(ed, simMarket, configurations, referenceData,
+                                                                             iborFallbackConfig);
+                    auto portfolio = portfolioSnapshot.portfolio(buildFailedTrades, ignoreTradeBuildFail);
+                    portfolio->build(factory, "stress analysis");
+
+                    cubes[id] = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
+                        asof, portfolio->ids(), vector<Date>(1, asof), threadScenarios[id].size());
+
+                    vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+                    calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData->baseCcy()));
+                    ValuationEngine engine(asof, dg, simMarket, factory->modelBuilders());
+                    engine.registerProgressIndicator(progressIndicator);
+                    engine.buildCube(portfolio, cubes[id], calculators);
+
+                    rc[id] = 0;
+
+                } catch (const std::exception& e) {
+                    StructuredAnalyticsErrorMessage("Stress Test", "", e.what()).log();
+                }
+            });
+        }
+
+        for (auto& t : jobs)
+            t.join();
+
+        for (Size id = 0; id < effThreads; ++id)
+            QL_REQUIRE(rc[id] == 0, "error: thread " << id << " failed in stress test. Check for structured errors "
+                                                     << "from 'Stress Test'.");
+    }
 
     /*****************
      * Collect results
@@ -94,22 +219,32 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
     labels_.clear();
     trades_.clear();
     for (auto const& [tradeId, trade] : portfolio->trades()) {
-        auto index = cube->idsAndIndexes().find(tradeId);
-        if (index == cube->idsAndIndexes().end()) {
+        std::vector<Size> indices;
+        for (auto const& c : cubes) {
+            auto index = c->idsAndIndexes().find(tradeId);
+            if (index == c->idsAndIndexes().end())
+                break;
+            indices.push_back(index->second);
+        }
+        if (indices.size() < cubes.size()) {
             ALOG("cube does not contain tradeId '" << tradeId << "'");
             continue;
         }
-        Real npv0 = cube->getT0(index->second, 0);
+        Real npv0 = cubes.front()->getT0(indices.front(), 0);
         trades_.insert(tradeId);
         baseNPV_[tradeId] = npv0;
-        for (Size j = 0; j < scenarioGenerator->samples(); ++j) {
-            const string& label = scenarioGenerator->scenarios()[j]->label();
-            TLOG("Adding stress test result for trade '" << tradeId << "' and scenario #" << j << " '" << label << "'");
-            Real npv = cube->get(index->second, 0, j, 0);
-            pair<string, string> p(tradeId, label);
-            shiftedNPV_[p] = npv;
-            delta_[p] = npv - npv0;
-            labels_.insert(label);
+        for (Size c = 0; c < cubes.size(); ++c) {
+            for (Size k = 0; k < cubes[c]->samples(); ++k) {
+                Size j = offsets[c] + k;
+                const string& label = scenarioGenerator->scenarios()[j]->label();
+                TLOG("Adding stress test result for trade '" << tradeId << "' and scenario #" << j << " '" << label
+                                                             << "'");
+                Real npv = cubes[c]->get(indices[c], 0, k, 0);
+                pair<string, string> p(tradeId, label);
+                shiftedNPV_[p] = npv;
+                delta_[p] = npv - npv0;
+                labels_.insert(label);
+            }
         }
     }
     LOG("Stress testing done");
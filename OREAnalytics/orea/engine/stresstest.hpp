@@ -32,6 +32,7 @@
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/report/report.hpp>
 
+#include <functional>
 #include <map>
 #include <set>
 #include <tuple>
@@ -50,10 +51,21 @@ namespace analytics {
   - fill result structures that can be queried
   - write stress test report to a file
 
+  If nThreads > 1 and a market factory is given, the stress scenarios are split into contiguous slices which are
+  processed in parallel. Each worker thread builds its own simulation market from the market returned by the factory
+  and its own copy of the portfolio. The results are merged in scenario order, so that they do not depend on the
+  number of threads. This requires a build with QL_ENABLE_SESSIONS = ON.
+
   \ingroup simulation
 */
 class StressTest {
 public:
+    /*! Factory building a new market with the same composition as the one passed to the constructor, it is called
+        once per worker thread with the thread id 0, ..., nThreads - 1 and must build the market from objects that
+        are not shared with other threads, e.g. a todays market built from a loader cloned per thread id before the
+        stress test is run */
+    typedef std::function<QuantLib::ext::shared_ptr<ore::data::Market>(QuantLib::Size)> MarketFactory;
+
     //! Constructor
     StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
                const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
@@ -65,7 +77,8 @@ public:
                QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory = {},
                const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData = nullptr,
                const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
-               bool continueOnError = false);
+               bool continueOnError = false, const QuantLib::Size nThreads = 1,
+               const MarketFactory& marketFactory = MarketFactory());
 
     //! Return set of trades analysed
     const std::set<std::string>& trades() { return trades_; }
@@ -66,6 +66,14 @@ void NPVCalculator::calculateT0(const QuantLib::ext::shared_ptr<Trade>& trade, S
     outputCube->setT0(npv(tradeIndex, trade, simMarket), tradeIndex, index_);
 }
 
+void NPVCalculator::calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor,
+                                    QuantLib::ext::shared_ptr<NPVCube>& outputCube, Size dateIndex, Size sample,
+                                    bool isCloseOut) {
+    if (!isCloseOut)
+        outputCube->set(factor * outputCube->get(fromTradeIndex, dateIndex, sample, index_), tradeIndex, dateIndex,
+                        sample, index_);
+}
+
 Real NPVCalculator::npv(Size tradeIndex, const QuantLib::ext::shared_ptr<Trade>& trade,
                         const QuantLib::ext::shared_ptr<SimMarket>& simMarket) {
     Real npv = trade->instrument()->NPV();
@@ -174,6 +182,20 @@ void CashflowCalculator::calculate(const QuantLib::ext::shared_ptr<Trade>& trade
     outputCube->set(netNegativeFlow / numeraire, tradeIndex, dateIndex, sample, index_+1);
 }
 
+void CashflowCalculator::calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor,
+                                         QuantLib::ext::shared_ptr<NPVCube>& outputCube, Size dateIndex, Size sample,
+                                         bool isCloseOut) {
+    if (isCloseOut)
+        return;
+    Real positiveFlow = factor * outputCube->get(fromTradeIndex, dateIndex, sample, index_);
+    Real negativeFlow = factor * outputCube->get(fromTradeIndex, dateIndex, sample, index_ + 1);
+    // a negative factor turns received into paid flows
+    if (factor < 0.0)
+        std::swap(positiveFlow, negativeFlow);
+    outputCube->set(positiveFlow, tradeIndex, dateIndex, sample, index_);
+    outputCube->set(negativeFlow, tradeIndex, dateIndex, sample, index_ + 1);
+}
+
 void NPVCalculatorFXT0::init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
                              const QuantLib::ext::shared_ptr<SimMarket>& simMarket) {
     DLOG("init NPVCalculatorFXT0");
@@ -206,6 +228,14 @@ void NPVCalculatorFXT0::calculateT0(const QuantLib::ext::shared_ptr<Trade>& trad
     outputCube->setT0(npv(tradeIndex, trade, simMarket), tradeIndex, index_);
 }
 
+void NPVCalculatorFXT0::calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor,
+                                        QuantLib::ext::shared_ptr<NPVCube>& outputCube, Size dateIndex, Size sample,
+                                        bool isCloseOut) {
+    if (!isCloseOut)
+        outputCube->set(factor * outputCube->get(fromTradeIndex, dateIndex, sample, index_), tradeIndex, dateIndex,
+                        sample, index_);
+}
+
 Real NPVCalculatorFXT0::npv(Size tradeIndex, const QuantLib::ext::shared_ptr<Trade>& trade,
                             const QuantLib::ext::shared_ptr<SimMarket>& simMarket) {
     Real npv = trade->instrument()->NPV();
@@ -77,6 +77,18 @@ public:
 
     // called after each scenario update before the calculators are run
     virtual void initScenario() = 0;
+
+    /*! Set the results of trade \p tradeIndex to the results of trade \p fromTradeIndex for the same date and sample,
+        scaled by \p factor. This is used for trades that are linear multiples of another trade, see NpvMemoisation.
+        Only called if supportsScaledResults() returns true. */
+    virtual void calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor,
+                                 QuantLib::ext::shared_ptr<NPVCube>& outputCube, Size dateIndex, Size sample,
+                                 bool isCloseOut = false) {
+        QL_FAIL("ValuationCalculator::calculateScaled() not supported");
+    }
+
+    //! Are the results of this calculator linear in the trade size?
+    virtual bool supportsScaledResults() const { return false; }
 };
 
 //! NPVCalculator
@@ -104,6 +116,10 @@ public:
     void init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
     void initScenario() override;
 
+    void calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor, QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                         Size dateIndex, Size sample, bool isCloseOut = false) override;
+    bool supportsScaledResults() const override { return true; }
+
 protected:
     std::string baseCcyCode_;
     Size index_;
@@ -137,6 +153,10 @@ public:
     void init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
     void initScenario() override;
 
+    void calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor, QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                         Size dateIndex, Size sample, bool isCloseOut = false) override;
+    bool supportsScaledResults() const override { return true; }
+
 private:
     std::string baseCcyCode_;
     Date t0Date_;
@@ -175,6 +195,10 @@ public:
     void init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
     void initScenario() override {}
 
+    void calculateScaled(Size fromTradeIndex, Size tradeIndex, Real factor, QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                         Size dateIndex, Size sample, bool isCloseOut = false) override;
+    bool supportsScaledResults() const override { return true; }
+
 private:
     std::string baseCcyCode_;
     QuantLib::ext::shared_ptr<Market> t0Market_;
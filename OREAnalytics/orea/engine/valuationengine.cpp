@@ -18,9 +18,12 @@
 
 #include <orea/cube/npvcube.hpp>
 #include <orea/engine/cptycalculator.hpp>
+#include <orea/engine/npvmemoisation.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/engine/valuationprofile.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/simulation/simmarket.hpp>
 
 #include <ored/portfolio/optionwrapper.hpp>
@@ -33,9 +36,12 @@
 #include <ored/utilities/to_string.hpp>
 
 #include <ql/errors.hpp>
+#include <ql/patterns/observable.hpp>
 
 #include <boost/timer/timer.hpp>
 
+#include <algorithm>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -46,6 +52,23 @@ using boost::timer::default_places;
 namespace ore {
 namespace analytics {
 
+//! Observer recording whether any of the QuantLib instruments of a trade was notified since the last reset
+class ValuationEngine::TradeDirtyFlag : public QuantLib::Observer {
+public:
+    explicit TradeDirtyFlag(const QuantLib::ext::shared_ptr<InstrumentWrapper>& wrapper) {
+        if (wrapper->qlInstrument())
+            registerWith(wrapper->qlInstrument());
+        for (auto const& i : wrapper->additionalInstruments())
+            registerWith(i);
+    }
+    void update() override { dirty_ = true; }
+    bool dirty() const { return dirty_; }
+    void reset() { dirty_ = false; }
+
+private:
+    bool dirty_ = true;
+};
+
 ValuationEngine::ValuationEngine(const Date& today, const QuantLib::ext::shared_ptr<DateGrid>& dg,
                                  const QuantLib::ext::shared_ptr<SimMarket>& simMarket,
                                  const set<std::pair<string, QuantLib::ext::shared_ptr<ModelBuilder>>>& modelBuilders)
@@ -58,15 +81,106 @@ ValuationEngine::ValuationEngine(const Date& today, const QuantLib::ext::shared_
     QL_REQUIRE(simMarket_, "ValuationEngine: Error, Null SimMarket");
 }
 
+void ValuationEngine::enableNpvMemoisation(const std::set<std::string>& excludedTradeTypes) {
+    npvMemoisation_ = QuantLib::ext::make_shared<NpvMemoisation>(excludedTradeTypes);
+}
+
 void ValuationEngine::recalibrateModels() {
     ObservationMode::Mode om = ObservationMode::instance().mode();
     for (auto const& b : modelBuilders_) {
-        if (om == ObservationMode::Mode::Disable)
+        if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Track)
             b.second->forceRecalculate();
         b.second->recalibrate();
     }
 }
 
+void ValuationEngine::buildTradeDependencies(const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades,
+                                             const std::vector<bool>& tradeHasError) {
+    trackedQuotes_.clear();
+    tradesByQuoteGroup_.clear();
+    tradeAlwaysUpdated_ = tradeHasError;
+    tradeAffected_.assign(trades.size(), true);
+    trackedDate_ = Date();
+
+    auto ssm = QuantLib::ext::dynamic_pointer_cast<ScenarioSimMarket>(simMarket_);
+    if (ssm == nullptr) {
+        WLOG("ValuationEngine: observation mode Track requires a ScenarioSimMarket, all trades will be updated.");
+        tradeAlwaysUpdated_.assign(trades.size(), true);
+        return;
+    }
+
+    // the probe below relies on lazy objects forwarding notifications, which they only do when calculated, so
+    // we recalculate every trade notified by a probe before moving on to the next risk factor group
+    std::vector<QuantLib::ext::shared_ptr<Trade>> tradeList;
+    std::vector<QuantLib::ext::shared_ptr<TradeDirtyFlag>> flags;
+    for (auto const& [tradeId, trade] : trades) {
+        tradeList.push_back(trade);
+        flags.push_back(QuantLib::ext::make_shared<TradeDirtyFlag>(trade->instrument()));
+    }
+    auto recalculate = [this, &tradeList, &flags](const Size j) {
+        flags[j]->reset();
+        if (tradeAlwaysUpdated_[j])
+            return;
+        try {
+            tradeList[j]->instrument()->NPV();
+        } catch (const std::exception& e) {
+            // we can not tell which notifications the trade's instruments will forward, so it is always updated
+            DLOG("ValuationEngine: trade " << tradeList[j]->id() << " will always be updated in observation mode "
+                                           << "Track, since it can not be priced: " << e.what());
+            tradeAlwaysUpdated_[j] = true;
+        }
+    };
+    for (Size j = 0; j < tradeList.size(); ++j)
+        recalculate(j);
+
+    // one probe per risk factor group, since the quotes of a group feed into the same term structure
+    std::map<std::pair<RiskFactorKey::KeyType, std::string>, std::vector<QuantLib::ext::shared_ptr<SimpleQuote>>>
+        groups;
+    for (auto const& [key, quote] : ssm->simData())
+        groups[std::make_pair(key.keytype, key.name)].push_back(quote);
+
+    for (auto const& [group, quotes] : groups) {
+        Size g = tradesByQuoteGroup_.size();
+        tradesByQuoteGroup_.push_back(std::vector<Size>());
+        for (auto const& q : quotes) {
+            q->notifyObservers();
+            trackedQuotes_.push_back({q, q->isValid() ? q->value() : Null<Real>(), g});
+        }
+        for (Size j = 0; j < flags.size(); ++j) {
+            if (flags[j]->dirty()) {
+                tradesByQuoteGroup_[g].push_back(j);
+                recalculate(j);
+            }
+        }
+        TLOG("ValuationEngine: " << tradesByQuoteGroup_[g].size() << " trades depend on " << group.first << "/"
+                                 << group.second);
+    }
+
+    LOG("ValuationEngine: built dependencies of " << trades.size() << " trades on " << groups.size()
+                                                  << " risk factor groups, "
+                                                  << std::count(tradeAlwaysUpdated_.begin(), tradeAlwaysUpdated_.end(),
+                                                                true)
+                                                  << " trades are always updated");
+}
+
+void ValuationEngine::updateAffectedTrades(const Date& d) {
+    // a new valuation date affects all trades
+    bool newDate = d != trackedDate_;
+    trackedDate_ = d;
+    tradeAffected_.assign(tradeAlwaysUpdated_.size(), newDate);
+    for (Size j = 0; j < tradeAlwaysUpdated_.size(); ++j)
+        if (tradeAlwaysUpdated_[j])
+            tradeAffected_[j] = true;
+    for (auto& q : trackedQuotes_) {
+        Real v = q.quote->isValid() ? q.quote->value() : Null<Real>();
+        if (v != q.value) {
+            q.value = v;
+            for (auto j : tradesByQuoteGroup_[q.group])
+                tradeAffected_[j] = true;
+        }
+    }
+}
+
 void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>& portfolio,
                                 QuantLib::ext::shared_ptr<analytics::NPVCube> outputCube,
                                 vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators, bool mporStickyDate,
@@ -164,6 +278,23 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
     }
     LOG("Total number of trades = " << portfolio->size());
 
+    useNpvMemoisation_ = false;
+    if (npvMemoisation_) {
+        if (std::all_of(calculators.begin(), calculators.end(),
+                        [](const QuantLib::ext::shared_ptr<ValuationCalculator>& c) {
+                            return c->supportsScaledResults();
+                        })) {
+            npvMemoisation_->build(portfolio, tradeHasError);
+            useNpvMemoisation_ = npvMemoisation_->numberOfMemoisedTrades() > 0;
+        } else {
+            WLOG("NPV memoisation is disabled, since not all valuation calculators support scaled results");
+        }
+    }
+
+    tradeUpdates_ = tradeUpdatesSkipped_ = 0;
+    if (om == ObservationMode::Mode::Track)
+        buildTradeDependencies(trades, tradeHasError);
+
     if (!dates.empty() && dates.front() > simMarket_->asofDate()) {
         // the fixing manager is only required if sim dates contain future dates
         simMarket_->fixingManager()->initialise(portfolio, simMarket_);
@@ -254,7 +385,10 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
 
         timer.start();
         simMarket_->fixingManager()->reset();
+        timer.stop();
         fixingTime += timer.elapsed().wall * 1e-9;
+        if (profile_)
+            profile_->addStep(ValuationProfile::Step::Fixings, simMarket_->asofDate(), timer.elapsed().wall);
     }
 
     if (dryRun) {
@@ -282,6 +416,15 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                                            << "pricing " << pricingTime << " sec, "
                                            << "update " << updateTime << " sec "
                                            << "fixing " << fixingTime);
+    if (om == ObservationMode::Mode::Track && tradeUpdates_ + tradeUpdatesSkipped_ > 0) {
+        LOG("ValuationEngine: " << tradeUpdatesSkipped_ << " out of " << tradeUpdates_ + tradeUpdatesSkipped_
+                                << " trade updates skipped ("
+                                << setprecision(4) << 100.0 * static_cast<Real>(tradeUpdatesSkipped_) /
+                                                          static_cast<Real>(tradeUpdates_ + tradeUpdatesSkipped_)
+                                << "%), instruments not affected by scenario");
+    }
+    trackedQuotes_.clear();
+    tradesByQuoteGroup_.clear();
 
     // for trades with errors set all output cube values to zero
     i = 0;
@@ -302,6 +445,8 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
                                      QuantLib::ext::shared_ptr<analytics::NPVCube>& outputCubeNettingSet, const Date& d,
                                      const Size cubeDateIndex, const Size sample, const string& label) {
     ObservationMode::Mode om = ObservationMode::instance().mode();
+    if (om == ObservationMode::Mode::Track)
+        updateAffectedTrades(d);
     for (auto& calc : calculators)
         calc->initScenario();
     // loop over trades
@@ -312,9 +457,39 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
             continue;
         }
 
+        if (useNpvMemoisation_ && npvMemoisation_->isMemoised(j)) {
+            // the representative has a lower index and was valued already
+            Size r = npvMemoisation_->representative(j);
+            if (tradeHasError[r]) {
+                StructuredTradeErrorMessage(trade->id(), trade->tradeType(), "ScenarioValuation",
+                                            "valuation of representative trade failed")
+                    .log();
+                tradeHasError[j] = true;
+                continue;
+            }
+            for (auto& calc : calculators)
+                calc->calculateScaled(r, j, npvMemoisation_->scale(j), outputCube, cubeDateIndex, sample,
+                                      isCloseOutDate);
+            continue;
+        }
+
+        ValuationProfile::StopWatch stopWatch;
+        std::size_t pricings = profile_ ? trade->getNumberOfPricings() : 0;
+        boost::timer::nanosecond_type pricingTime = profile_ ? trade->getCumulativePricingTime() : 0;
+
         // We can avoid checking mode here and always call updateQlInstruments()
         if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister)
             trade->instrument()->updateQlInstruments();
+        else if (om == ObservationMode::Mode::Track) {
+            // only trades depending on a changed quote are updated, the calculators below read the cached results
+            // of all other trades
+            if (tradeAffected_[j]) {
+                trade->instrument()->updateQlInstruments();
+                ++tradeUpdates_;
+            } else {
+                ++tradeUpdatesSkipped_;
+            }
+        }
         try {
             for (auto& calc : calculators)
                 calc->calculate(trade, j, simMarket_, outputCube, outputCubeNettingSet, d, cubeDateIndex, sample,
@@ -325,6 +500,11 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
             StructuredTradeErrorMessage(trade->id(), trade->tradeType(), "ScenarioValuation", expMsg.c_str()).log();
             tradeHasError[j] = true;
         }
+
+        if (profile_)
+            profile_->addTrade(trade->id(), trade->tradeType(), d, stopWatch.elapsed(),
+                               trade->getNumberOfPricings() - pricings,
+                               trade->getCumulativePricingTime() - pricingTime);
     }
 }
 
@@ -365,6 +545,7 @@ std::pair<double, double> ValuationEngine::populateCube(
     QL_REQUIRE(cubeDateIndex >= 0, "first date should be a valuation date");
     cpu_timer timer;
     timer.start();
+    ValuationProfile::StopWatch stopWatch;
     simMarket_->preUpdate();
     if (isValueDate || !isStickyDate) {
         simMarket_->updateDate(d);
@@ -373,13 +554,19 @@ std::pair<double, double> ValuationEngine::populateCube(
     if (!scenarioUpdated) {
         simMarket_->updateScenario(d);
     }
+    if (profile_)
+        profile_->addStep(ValuationProfile::Step::ApplyScenario, d, stopWatch.lap());
     // Always with fixing update here, in contrast to the close-out date section
     simMarket_->postUpdate(d, !isStickyDate || isValueDate);
     // Aggregation scenario data update on valuation dates only
     if (isValueDate) {
         simMarket_->updateAsd(d);
     }
+    if (profile_)
+        profile_->addStep(ValuationProfile::Step::MarketUpdate, d, stopWatch.lap());
     recalibrateModels();
+    if (profile_)
+        profile_->addStep(ValuationProfile::Step::ModelRecalibration, d, stopWatch.lap());
 
     timer.stop();
     updateTime += timer.elapsed().wall * 1e-9;
@@ -392,9 +579,13 @@ std::pair<double, double> ValuationEngine::populateCube(
                    sample, simMarket_->label());
     if (isStickyDate && !isValueDate) // switch on again, if sticky
         tradeExercisable(true, trades);
+    if (profile_)
+        profile_->addStep(ValuationProfile::Step::TradeCalculators, d, stopWatch.lap());
     // loop over counterparty names
     if (isValueDate) {
         runCalculators(false, counterparties, cptyCalculators, outputCptyCube, d, cubeDateIndex, sample);
+        if (profile_ && !cptyCalculators.empty())
+            profile_->addStep(ValuationProfile::Step::CounterpartyCalculators, d, stopWatch.lap());
     }
     timer.stop();
     pricingTime += timer.elapsed().wall * 1e-9;
@@ -25,10 +25,12 @@
 
 #include <ored/utilities/progressbar.hpp>
 
+#include <ql/quotes/simplequote.hpp>
 #include <ql/time/date.hpp>
 
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ore::data {
 class DateGrid;
@@ -44,7 +46,9 @@ namespace ore {
 namespace analytics {
 
 class NPVCube;
+class NpvMemoisation;
 class CounterpartyCalculator;
+class ValuationProfile;
 class ValuationCalculator;
 class SimMarket;
 
@@ -64,6 +68,13 @@ using std::set;
   In addition to storing the resulting NPVs it can be given any number of calculators
   that can store additional values in the cube.
 
+  In ObservationMode::Mode::Track the market is updated as in ObservationMode::Mode::Disable, but instead of
+  updating all trades the engine only updates the trades depending on a sim market quote that changed since the
+  previous valuation. The quote to trade dependencies are determined once per buildCube() call by notifying the
+  quotes of each risk factor group (key type and name) and recording which trades' instruments receive the
+  notification. All trades are updated when the valuation date changes. The number of updated and skipped trades
+  is logged at the end of buildCube() and available via tradeUpdates() and tradeUpdatesSkipped().
+
   \ingroup simulation
 */
 class ValuationEngine : public ore::data::ProgressReporter {
@@ -99,8 +110,26 @@ public:
         //! Limit samples to one and fill the rest of the cube with random values
         bool dryRun = false);
 
+    /*! Price only one representative of each class of trades that are linear multiples of each other and scale
+        its results into the cube for the other trades of the class, see NpvMemoisation. Trades of the given types
+        are always priced individually. */
+    void enableNpvMemoisation(const std::set<std::string>& excludedTradeTypes = {});
+
+    /*! Record the timings of the trade valuations and engine steps in the given profile, see ValuationProfile.
+        A null profile disables the recording. */
+    void enableProfiling(const QuantLib::ext::shared_ptr<ValuationProfile>& profile) { profile_ = profile; }
+
+    /*! Number of trade updates and skipped trade updates in the last buildCube() call, only populated in
+        ObservationMode::Mode::Track */
+    QuantLib::Size tradeUpdates() const { return tradeUpdates_; }
+    QuantLib::Size tradeUpdatesSkipped() const { return tradeUpdatesSkipped_; }
+
 private:
+    class TradeDirtyFlag;
     void recalibrateModels();
+    void buildTradeDependencies(const std::map<std::string, QuantLib::ext::shared_ptr<ore::data::Trade>>& trades,
+                                const std::vector<bool>& tradeHasError);
+    void updateAffectedTrades(const QuantLib::Date& d);
     std::pair<double, double> populateCube(const QuantLib::Date& d, size_t cubeDateIndex, size_t sample,
                                            bool isValueDate, bool isStickyDate, bool scenarioUpdated,
                                            const std::map<std::string, QuantLib::ext::shared_ptr<ore::data::Trade>>& trades,
@@ -126,6 +155,20 @@ private:
     QuantLib::ext::shared_ptr<ore::data::DateGrid> dg_;
     QuantLib::ext::shared_ptr<ore::analytics::SimMarket> simMarket_;
     set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+    QuantLib::ext::shared_ptr<NpvMemoisation> npvMemoisation_;
+    bool useNpvMemoisation_ = false;
+    QuantLib::ext::shared_ptr<ValuationProfile> profile_;
+    // quote to trade dependencies and update statistics, only used in ObservationMode::Mode::Track
+    struct TrackedQuote {
+        QuantLib::ext::shared_ptr<QuantLib::SimpleQuote> quote;
+        QuantLib::Real value;
+        QuantLib::Size group;
+    };
+    std::vector<TrackedQuote> trackedQuotes_;
+    std::vector<std::vector<QuantLib::Size>> tradesByQuoteGroup_;
+    std::vector<bool> tradeAlwaysUpdated_, tradeAffected_;
+    QuantLib::Date trackedDate_;
+    QuantLib::Size tradeUpdates_ = 0, tradeUpdatesSkipped_ = 0;
 };
 } // namespace analytics
 } // namespace ore
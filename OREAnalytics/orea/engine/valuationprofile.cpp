@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/valuationprofile.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <algorithm>
+
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+namespace ore {
+namespace analytics {
+
+void ValuationProfile::Timing::add(const nanosecond_type t) {
+    ++count;
+    total += t;
+    max = std::max(max, t);
+}
+
+void ValuationProfile::Timing::merge(const Timing& t) {
+    count += t.count;
+    total += t.total;
+    max = std::max(max, t.max);
+}
+
+void ValuationProfile::addTrade(const std::string& tradeId, const std::string& tradeType, const Date& date,
+                                const nanosecond_type calculatorTime, const Size pricings,
+                                const nanosecond_type pricingTime) {
+    auto& t = trades_[tradeId];
+    t.tradeType = tradeType;
+    t.calculators.add(calculatorTime);
+    t.pricings += pricings;
+    t.pricingTime += pricingTime;
+    tradeTypes_[std::make_pair(tradeType, date)].add(calculatorTime);
+}
+
+void ValuationProfile::addStep(const Step step, const Date& date, const nanosecond_type time) {
+    steps_[std::make_pair(step, date)].add(time);
+}
+
+void ValuationProfile::merge(const ValuationProfile& p) {
+    for (auto const& [id, t] : p.trades_) {
+        auto& r = trades_[id];
+        r.tradeType = t.tradeType;
+        r.calculators.merge(t.calculators);
+        r.pricings += t.pricings;
+        r.pricingTime += t.pricingTime;
+    }
+    for (auto const& [k, t] : p.tradeTypes_)
+        tradeTypes_[k].merge(t);
+    for (auto const& [k, t] : p.steps_)
+        steps_[k].merge(t);
+}
+
+void ValuationProfile::clear() {
+    trades_.clear();
+    tradeTypes_.clear();
+    steps_.clear();
+}
+
+Real ValuationProfile::averageTradeTime(const std::string& tradeId) const {
+    auto t = trades_.find(tradeId);
+    if (t == trades_.end() || t->second.calculators.count == 0)
+        return QuantLib::Null<Real>();
+    return t->second.calculators.average();
+}
+
+std::ostream& operator<<(std::ostream& out, const ValuationProfile::Step step) {
+    switch (step) {
+    case ValuationProfile::Step::ApplyScenario:
+        return out << "ApplyScenario";
+    case ValuationProfile::Step::MarketUpdate:
+        return out << "MarketUpdate";
+    case ValuationProfile::Step::ModelRecalibration:
+        return out << "ModelRecalibration";
+    case ValuationProfile::Step::TradeCalculators:
+        return out << "TradeCalculators";
+    case ValuationProfile::Step::CounterpartyCalculators:
+        return out << "CounterpartyCalculators";
+    case ValuationProfile::Step::Fixings:
+        return out << "Fixings";
+    default:
+        QL_FAIL("unknown ValuationProfile::Step (" << static_cast<int>(step) << ")");
+    }
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/valuationprofile.hpp
+    \brief timing profile of valuation engine runs
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <ql/time/date.hpp>
+#include <ql/types.hpp>
+
+#include <boost/timer/timer.hpp>
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace ore {
+namespace analytics {
+
+//! Timing profile of valuation engine runs
+/*! A profile can be attached to a ValuationEngine, a MultiThreadedValuationEngine or a SensitivityAnalysis. The
+    engines then record
+
+    - per trade: the wall time spent in the valuation calculators and the number of pricings and the pricing time
+      reported by the trade's instrument wrapper
+    - per trade type and simulation date: the wall time spent in the valuation calculators
+    - per engine step and simulation date: the wall time spent in applying the scenario, updating the market
+      (including the notifications of the observers), recalibrating the models, running the trade and counterparty
+      calculators and resetting the fixings
+
+    The timings of several engine runs are accumulated. A profile is not thread safe, the multi-threaded engine
+    records one profile per worker and merges them after the workers have finished.
+
+    \ingroup simulation
+*/
+class ValuationProfile {
+public:
+    using nanosecond_type = boost::timer::nanosecond_type;
+
+    /*! ApplyScenario covers the update of the simulation market quotes including the notifications of the observers,
+        unless these are deferred (ObservationMode::Mode::Track), in which case they are part of MarketUpdate */
+    enum class Step {
+        ApplyScenario,
+        MarketUpdate,
+        ModelRecalibration,
+        TradeCalculators,
+        CounterpartyCalculators,
+        Fixings
+    };
+
+    //! number, total and maximum of a series of timings
+    struct Timing {
+        QuantLib::Size count = 0;
+        nanosecond_type total = 0;
+        nanosecond_type max = 0;
+        void add(const nanosecond_type t);
+        void merge(const Timing& t);
+        QuantLib::Real average() const { return count == 0 ? 0.0 : static_cast<QuantLib::Real>(total) / count; }
+    };
+
+    struct TradeTiming {
+        std::string tradeType;
+        //! time spent in the valuation calculators
+        Timing calculators;
+        //! number of pricings and pricing time as reported by the instrument wrapper
+        QuantLib::Size pricings = 0;
+        nanosecond_type pricingTime = 0;
+    };
+
+    //! simple stop watch measuring wall time
+    class StopWatch {
+    public:
+        StopWatch() : start_(std::chrono::steady_clock::now()) {}
+        nanosecond_type elapsed() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_)
+                .count();
+        }
+        //! returns the elapsed time and restarts the stop watch
+        nanosecond_type lap() {
+            auto now = std::chrono::steady_clock::now();
+            nanosecond_type result = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count();
+            start_ = now;
+            return result;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    //! record one valuation of a trade on the given date
+    void addTrade(const std::string& tradeId, const std::string& tradeType, const QuantLib::Date& date,
+                  const nanosecond_type calculatorTime, const QuantLib::Size pricings,
+                  const nanosecond_type pricingTime);
+    //! record one engine step on the given date, steps that are not related to a simulation date use the valuation date
+    void addStep(const Step step, const QuantLib::Date& date, const nanosecond_type time);
+
+    //! add the timings of another profile to this one
+    void merge(const ValuationProfile& p);
+    void clear();
+    bool empty() const { return trades_.empty() && steps_.empty(); }
+
+    //! \name Inspectors
+    //@{
+    const std::map<std::string, TradeTiming>& trades() const { return trades_; }
+    const std::map<std::pair<std::string, QuantLib::Date>, Timing>& tradeTypes() const { return tradeTypes_; }
+    const std::map<std::pair<Step, QuantLib::Date>, Timing>& steps() const { return steps_; }
+    //@}
+
+    /*! average calculator time per valuation of the trade in nanoseconds, or Null<Real> if the trade was not valued
+        in the recorded runs */
+    QuantLib::Real averageTradeTime(const std::string& tradeId) const;
+
+private:
+    std::map<std::string, TradeTiming> trades_;
+    std::map<std::pair<std::string, QuantLib::Date>, Timing> tradeTypes_;
+    std::map<std::pair<Step, QuantLib::Date>, Timing> steps_;
+};
+
+std::ostream& operator<<(std::ostream& out, const ValuationProfile::Step step);
+
+} // namespace analytics
+} // namespace ore
@@ -27,6 +27,7 @@
 
 #include <ored/report/inmemoryreport.hpp>
 #include <ored/scripting/engines/scriptedinstrumentpricingenginecg.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <qle/ad/backwardderivatives.hpp>
@@ -37,11 +38,15 @@
 #include <qle/math/randomvariable_ops.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 
+#include <ql/math/comparison.hpp>
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/weighted_sum.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <numeric>
+
 namespace ore {
 namespace analytics {
 
@@ -64,7 +69,10 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
                          const string& marketConfiguration, const string& marketConfigurationInCcy,
                          const QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData>& sensitivityData,
                          const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
-                         const IborFallbackConfig& iborFallbackConfig, const bool bumpCvaSensis,
+                         const IborFallbackConfig& iborFallbackConfig,
+                         const QuantLib::ext::shared_ptr<ore::data::NettingSetManager>& nettingSetManager,
+                         const std::string& dvaName, const std::string& fvaBorrowingCurve,
+                         const std::string& fvaLendingCurve, const bool bumpCvaSensis,
                          const bool useExternalComputeDevice, const bool externalDeviceCompatibilityMode,
                          const bool useDoublePrecisionForExternalCalculation, const std::string& externalComputeDevice,
                          const bool continueOnCalibrationError, const bool continueOnError, const std::string& context)
@@ -72,7 +80,9 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
       simMarketData_(simMarketData), engineData_(engineData), crossAssetModelData_(crossAssetModelData),
       scenarioGeneratorData_(scenarioGeneratorData), portfolio_(portfolio), marketConfiguration_(marketConfiguration),
       marketConfigurationInCcy_(marketConfigurationInCcy), sensitivityData_(sensitivityData),
-      referenceData_(referenceData), iborFallbackConfig_(iborFallbackConfig), bumpCvaSensis_(bumpCvaSensis),
+      referenceData_(referenceData), iborFallbackConfig_(iborFallbackConfig), nettingSetManager_(nettingSetManager),
+      dvaName_(dvaName), fvaBorrowingCurve_(fvaBorrowingCurve), fvaLendingCurve_(fvaLendingCurve),
+      bumpCvaSensis_(bumpCvaSensis),
       useExternalComputeDevice_(useExternalComputeDevice),
       externalDeviceCompatibilityMode_(externalDeviceCompatibilityMode),
       useDoublePrecisionForExternalCalculation_(useDoublePrecisionForExternalCalculation),
@@ -138,30 +148,97 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         crossAssetModelData_->discretization() == CrossAssetModel::Discretization::Euler,
         "XvaEngineCG: cam is required to use discretization 'Euler', please update simulation parameters accordingly.");
 
+    // read time steps per year and regression order from the engine parameters of the scripted trade product
+
+    Size timeStepsPerYear = 1;
+    Size regressionOrder = 4;
+    if (engineData_->hasProduct("ScriptedTrade")) {
+        auto const& params = engineData_->engineParameters("ScriptedTrade");
+        if (auto p = params.find("TimeStepsPerYear"); p != params.end()) {
+            int n = parseInteger(p->second);
+            QL_REQUIRE(n > 0, "XvaEngineCG: TimeStepsPerYear (" << n << ") must be positive");
+            timeStepsPerYear = static_cast<Size>(n);
+        }
+        if (auto p = params.find("RegressionOrder"); p != params.end()) {
+            int n = parseInteger(p->second);
+            QL_REQUIRE(n > 0, "XvaEngineCG: RegressionOrder (" << n << ") must be positive");
+            regressionOrder = static_cast<Size>(n);
+        }
+    }
+
+    // note: GaussianCamCG evolves the IR state of the first currency only, so we restrict the model to the domestic
+    // currency of the cam and the ibor indices in this currency
+
+    std::string baseCcy = crossAssetModelData_->domesticCurrency();
+    std::string camCcy = camBuilder_->model()->irModel(0)->parametrizationBase()->currency().code();
+    QL_REQUIRE(camCcy == baseCcy, "XvaEngineCG: first cam ir component currency ("
+                                      << camCcy << ") does not match domestic currency (" << baseCcy << ")");
+
     std::vector<std::string> currencies;                                                         // from cam
     std::vector<Handle<YieldTermStructure>> curves;                                              // from cam
     std::vector<Handle<Quote>> fxSpots;                                                          // from cam
-    std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<InterestRateIndex>>> irIndices; // from trade building
+    std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<InterestRateIndex>>> irIndices; // from sim market
     std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<ZeroInflationIndex>>>
         infIndices;                           // from trade building
     std::vector<std::string> indices;         // from trade building
     std::vector<std::string> indexCurrencies; // from trade building
 
-    // note: for the PoC we populate the containers with hardcoded values ... temp hack ...
-    currencies.push_back("EUR");
+    currencies.push_back(baseCcy);
     curves.push_back(camBuilder_->model()->irModel(0)->termStructure());
-    irIndices.push_back(std::make_pair("EUR-EURIBOR-6M", *simMarket_->iborIndex("EUR-EURIBOR-6M")));
+    for (auto const& name : simMarketData_->indices()) {
+        auto index = *simMarket_->iborIndex(name, marketConfiguration_);
+        if (index->currency().code() == baseCcy)
+            irIndices.push_back(std::make_pair(name, index));
+        else
+            DLOG("XvaEngineCG: skip index " << name << ", currency " << index->currency().code()
+                                            << " is not the domestic currency " << baseCcy);
+    }
 
-    // note: these must be fine enough for Euler, e.g. weekly over the whole simulation period
-    std::set<Date> simulationDates(scenarioGeneratorData_->getGrid()->dates().begin(),
-                                   scenarioGeneratorData_->getGrid()->dates().end());
-    // note: this should be added to CrossAssetModelData
-    Size timeStepsPerYear = 1;
+    // the exposure dates are the valuation and close-out dates of the grid, the model simulation dates refine them
+    // such that the step size does not exceed 1 / timeStepsPerYear (the cam Euler discretization needs a fine grid)
+
+    auto grid = scenarioGeneratorData_->getGrid();
+    std::vector<Date> exposureDates = grid->dates();
+    std::set<Date> simulationDates(exposureDates.begin(), exposureDates.end());
+    Date d0 = asof_;
+    for (auto const& d1 : exposureDates) {
+        Size steps = static_cast<Size>(std::ceil(static_cast<Real>(d1 - d0) * timeStepsPerYear / 365.0 - 1E-10));
+        for (Size k = 1; k < steps; ++k)
+            simulationDates.insert(d0 + static_cast<Date::serial_type>(
+                                            std::lround(static_cast<Real>(k) * static_cast<Real>(d1 - d0) / steps)));
+        d0 = d1;
+    }
+
+    DLOG("XvaEngineCG: " << exposureDates.size() << " exposure dates, " << simulationDates.size()
+                         << " simulation dates (time steps per year = " << timeStepsPerYear << ")");
+
+    /* the index of the amc path values that are conditioned on the state on each exposure date (0 = today). With
+       MporMode StickyDate the trades are valued on a close-out date as of the corresponding valuation date, i.e. we
+       condition the path value of the valuation date on the state on the close-out date. */
+
+    bool stickyCloseOut = scenarioGeneratorData_->withCloseOutLag() && scenarioGeneratorData_->withMporStickyDate();
+    std::vector<Size> pathValueIndex(exposureDates.size() + 1);
+    std::iota(pathValueIndex.begin(), pathValueIndex.end(), 0);
+    std::map<Date, Size> stickyCloseOutPathValueIndex;
+    if (stickyCloseOut) {
+        for (Size i = 0; i < exposureDates.size(); ++i) {
+            if (!grid->isValuationDate()[i])
+                continue;
+            Date c = grid->closeOutDateFromValuationDate(exposureDates[i]);
+            if (c == Date())
+                continue;
+            stickyCloseOutPathValueIndex[c] = i + 1;
+            Size k = std::distance(exposureDates.begin(), std::find(exposureDates.begin(), exposureDates.end(), c));
+            if (k < exposureDates.size() && !grid->isValuationDate()[k])
+                pathValueIndex[k + 1] = i + 1;
+        }
+    }
 
     // note: projectedStateProcessIndices can be removed from GaussianCamCG constructor most probably?
+    // note: the simulation dates are already refined, so the model should not add further time steps
     model_ = QuantLib::ext::make_shared<GaussianCamCG>(
         camBuilder_->model(), scenarioGeneratorData_->samples(), currencies, curves, fxSpots, irIndices, infIndices,
-        indices, indexCurrencies, simulationDates, timeStepsPerYear, iborFallbackConfig, std::vector<Size>(),
+        indices, indexCurrencies, simulationDates, 0, iborFallbackConfig, std::vector<Size>(),
         std::vector<std::string>(), true);
     model_->calculate();
     boost::timer::nanosecond_type timing3 = timer.elapsed().wall;
@@ -179,9 +256,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     configurations[MarketContext::pricing] = marketConfiguration_;
     auto factory = QuantLib::ext::make_shared<EngineFactory>(
         edCopy, simMarket_, configurations, referenceData_, iborFallbackConfig_,
-        EngineBuilderFactory::instance().generateAmcCgEngineBuilders(model_,
-                                                                     scenarioGeneratorData_->getGrid()->dates()),
-        true);
+        EngineBuilderFactory::instance().generateAmcCgEngineBuilders(model_, exposureDates), true);
 
     portfolio_->build(factory, "xva engine cg", true);
 
@@ -189,10 +264,13 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
     // Build computation graph for all trades ("part B") and
     // - store npv, amc npv nodes
+    // - collect the trades per netting set
 
     LOG("XvaEngineCG: build computation graph for all trades");
 
     std::vector<std::vector<std::size_t>> amcNpvNodes; // includes time zero npv
+    std::map<std::string, std::vector<Size>> nettingSetTrades;
+    std::map<std::string, std::string> nettingSetCounterparty;
 
     auto g = model_->computationGraph();
 
@@ -206,11 +284,19 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         engine->buildComputationGraph();
         std::vector<std::size_t> tmp;
         tmp.push_back(g->variable(engine->npvName() + "_0"));
-        for (std::size_t i = 0; i < simulationDates.size(); ++i) {
+        for (std::size_t i = 0; i < exposureDates.size(); ++i) {
             tmp.push_back(g->variable("_AMC_NPV_" + std::to_string(i)));
         }
         amcNpvNodes.push_back(tmp);
         g->endRedBlock();
+        std::string nettingSetId = trade->envelope().nettingSetId();
+        nettingSetTrades[nettingSetId].push_back(amcNpvNodes.size() - 1);
+        if (auto c = nettingSetCounterparty.find(nettingSetId); c == nettingSetCounterparty.end())
+            nettingSetCounterparty[nettingSetId] = trade->envelope().counterparty();
+        else if (c->second != trade->envelope().counterparty())
+            WLOG("XvaEngineCG: trade '" << id << "' has counterparty '" << trade->envelope().counterparty()
+                                        << "', expected '" << c->second << "' for netting set '" << nettingSetId
+                                        << "', will use the latter.");
     }
 
     boost::timer::nanosecond_type timing5 = timer.elapsed().wall;
@@ -219,37 +305,196 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     // This constitutes part C of the computation graph spanning "trade m range end ... lastExposureNode"
     // - pfPathExposureNodes: path amc sim values, aggregated over trades
     // - pfExposureNodes:     the corresponding conditional expectations
+    // - nettingSetNpvNodes:  the conditional expectations of the netting set values
+    // - exposureNodes:       the netting set exposures on the valuation dates taking into account the collateral
 
     std::vector<std::size_t> pfPathExposureNodes, pfExposureNodes;
-    std::vector<std::size_t> tradeSum(portfolio_->trades().size());
-    for (Size i = 0; i < simulationDates.size() + 1; ++i) {
+    std::map<std::string, std::vector<std::size_t>> nettingSetPathNodes, nettingSetNpvNodes;
+    std::vector<std::size_t> tradeSum;
+    for (Size i = 0; i < exposureDates.size() + 1; ++i) {
+        Date d = i == 0 ? model_->referenceDate() : exposureDates[i - 1];
+        tradeSum.resize(portfolio_->trades().size());
         for (Size j = 0; j < portfolio_->trades().size(); ++j) {
-            tradeSum[j] = amcNpvNodes[j][i];
+            tradeSum[j] = amcNpvNodes[j][pathValueIndex[i]];
         }
         pfPathExposureNodes.push_back(cg_add(*g, tradeSum));
-        pfExposureNodes.push_back(model_->npv(
-            pfPathExposureNodes.back(), i == 0 ? model_->referenceDate() : *std::next(simulationDates.begin(), i - 1),
-            cg_const(*g, 1.0), boost::none, ComputationGraph::nan, ComputationGraph::nan));
+        pfExposureNodes.push_back(model_->npv(pfPathExposureNodes.back(), d, cg_const(*g, 1.0), boost::none,
+                                              ComputationGraph::nan, ComputationGraph::nan));
+        for (auto const& [n, trades] : nettingSetTrades) {
+            tradeSum.resize(trades.size());
+            for (Size j = 0; j < trades.size(); ++j)
+                tradeSum[j] = amcNpvNodes[trades[j]][pathValueIndex[i]];
+            nettingSetPathNodes[n].push_back(trades.size() == 1 ? tradeSum.front() : cg_add(*g, tradeSum));
+            nettingSetNpvNodes[n].push_back(model_->npv(nettingSetPathNodes[n].back(), d, cg_const(*g, 1.0),
+                                                        boost::none, ComputationGraph::nan, ComputationGraph::nan));
+        }
+    }
+
+    std::vector<Date> valuationDates = grid->valuationDates();
+    auto exposureDateIndex = [&exposureDates](const Date& d) {
+        auto e = std::lower_bound(exposureDates.begin(), exposureDates.end(), d);
+        QL_REQUIRE(e != exposureDates.end() && *e == d, "XvaEngineCG: date " << d << " is not an exposure date");
+        return static_cast<Size>(std::distance(exposureDates.begin(), e)) + 1;
+    };
+
+    std::map<std::string, std::vector<std::size_t>> exposureNodes;
+    for (auto const& [n, npvNodes] : nettingSetNpvNodes) {
+        QuantLib::ext::shared_ptr<CSA> csa;
+        if (nettingSetManager_ && nettingSetManager_->has(n)) {
+            auto nettingSet = nettingSetManager_->get(n);
+            if (nettingSet->activeCsaFlag()) {
+                csa = nettingSet->csaDetails();
+                QL_REQUIRE(csa->csaCurrency() == baseCcy, "XvaEngineCG: csa currency "
+                                                              << csa->csaCurrency() << " of netting set '" << n
+                                                              << "' is not the base currency " << baseCcy
+                                                              << ", this is not supported.");
+                QL_REQUIRE(QuantLib::close_enough(csa->mtaRcv(), 0.0) && QuantLib::close_enough(csa->mtaPay(), 0.0),
+                           "XvaEngineCG: minimum transfer amounts (receive "
+                               << csa->mtaRcv() << ", pay " << csa->mtaPay() << ") of netting set '" << n
+                               << "' are not supported, they must be zero.");
+                auto daily = [](const Period& p) { return p.length() == 0 || p == 1 * Days; };
+                QL_REQUIRE(daily(csa->marginCallFrequency()) && daily(csa->marginPostFrequency()),
+                           "XvaEngineCG: margin call frequency "
+                               << csa->marginCallFrequency() << " and post frequency " << csa->marginPostFrequency()
+                               << " of netting set '" << n
+                               << "' are not supported, the collateral is settled on each valuation date (1D).");
+            }
+        } else {
+            WLOG("XvaEngineCG: no definition found for netting set '" << n << "', treat as uncollateralised.");
+        }
+        auto& e = exposureNodes[n];
+        e.push_back(npvNodes.front());
+        for (auto const& d : valuationDates) {
+            std::size_t v = npvNodes[exposureDateIndex(d)];
+            if (!csa) {
+                e.push_back(v);
+                continue;
+            }
+            // the npv nodes are deflated, the csa thresholds are applied to the undeflated value on the valuation
+            // date plus the independent amount held, the collateral then accrues until the close-out date and is
+            // deflated as of the close-out date
+            Date c = scenarioGeneratorData_->withCloseOutLag() ? grid->closeOutDateFromValuationDate(d) : d;
+            Size ci = exposureDateIndex(c);
+            std::size_t vc = npvNodes[ci];
+            if (stickyCloseOut && c != d && pathValueIndex[ci] != stickyCloseOutPathValueIndex.at(c)) {
+                // the close-out date is a valuation date as well, condition the sticky path value separately
+                vc = model_->npv(nettingSetPathNodes.at(n)[stickyCloseOutPathValueIndex.at(c)], c, cg_const(*g, 1.0),
+                                 boost::none, ComputationGraph::nan, ComputationGraph::nan);
+            }
+            std::size_t zero = cg_const(*g, 0.0);
+            std::size_t deflator = model_->pay(cg_const(*g, 1.0), d, d, baseCcy);
+            std::size_t closeOutDeflator = c == d ? deflator : model_->pay(cg_const(*g, 1.0), c, c, baseCcy);
+            std::size_t vu = cg_div(*g, v, deflator);
+            if (!QuantLib::close_enough(csa->independentAmountHeld(), 0.0))
+                vu = cg_add(*g, vu, cg_const(*g, csa->independentAmountHeld()));
+            std::size_t collateral = cg_subtract(
+                *g, cg_max(*g, cg_subtract(*g, vu, cg_const(*g, csa->thresholdRcv())), zero),
+                cg_max(*g, cg_subtract(*g, cg_negative(*g, vu), cg_const(*g, csa->thresholdPay())), zero));
+            if (c != d) {
+                // accrual at the discount rate of the csa currency less the compounding spread, the spread depends
+                // on whether the collateral is held or posted
+                Real tau = static_cast<Real>(c - d) / 365.0;
+                std::size_t growth = cg_div(*g, cg_const(*g, 1.0), model_->discount(d, c, baseCcy));
+                std::size_t accrual = cg_mult(*g, growth, cg_const(*g, std::exp(-csa->collatSpreadRcv() * tau)));
+                if (!QuantLib::close_enough(csa->collatSpreadRcv(), csa->collatSpreadPay())) {
+                    std::size_t held = cg_indicatorGeq(*g, collateral, zero);
+                    std::size_t payAccrual =
+                        cg_mult(*g, growth, cg_const(*g, std::exp(-csa->collatSpreadPay() * tau)));
+                    accrual = cg_add(*g, cg_mult(*g, held, accrual),
+                                     cg_mult(*g, cg_subtract(*g, cg_const(*g, 1.0), held), payAccrual));
+                }
+                collateral = cg_mult(*g, collateral, accrual);
+            }
+            e.push_back(cg_subtract(*g, vc, cg_mult(*g, collateral, closeOutDeflator)));
+        }
     }
 
     boost::timer::nanosecond_type timing6 = timer.elapsed().wall;
 
     // Add post processor
     // This constitues part D of the computation graph from lastExposureNode ... g->size()
-    // The cvaNode is the ultimate result w.r.t. which we want to compute sensitivities
-
-    // note: very simplified calculation, for testing, just multiply the EPE on each date by fixed default prob
-    auto defaultCurve = simMarket_->defaultCurve("BANK")->curve();
-    model_->registerWith(defaultCurve);
-    Size cvaNode = cg_const(*g, 0.0);
-    for (Size i = 0; i < simulationDates.size(); ++i) {
-        Date d = i == 0 ? model_->referenceDate() : *std::next(simulationDates.begin(), i - 1);
-        Date e = *std::next(simulationDates.begin(), i);
-        std::size_t defaultProb =
-            addModelParameter(*g, model_->modelParameterFunctors(), "__defaultprob_" + std::to_string(i),
-                              [defaultCurve, d, e]() { return defaultCurve->defaultProbability(d, e); });
-        cvaNode = cg_add(*g, cvaNode, cg_mult(*g, defaultProb, cg_max(*g, pfExposureNodes[i], cg_const(*g, 0.0))));
+    // The xvaNode is the ultimate result w.r.t. which we want to compute sensitivities
+    // All market inputs enter as model parameters and the model is registered with them, so that the sensi
+    // scenarios will trigger a recalculation
+
+    auto survivalProb = [this, &g](const std::string& name, const Date& d) {
+        if (d <= asof_)
+            return cg_const(*g, 1.0);
+        auto curve = simMarket_->defaultCurve(name, marketConfiguration_)->curve();
+        model_->registerWith(curve);
+        return addModelParameter(*g, model_->modelParameterFunctors(),
+                                 "__xva_sp_" + name + "_" + ore::data::to_string(d),
+                                 [curve, d]() { return curve->survivalProbability(d); });
+    };
+
+    auto lgd = [this, &g](const std::string& name) {
+        auto rr = simMarket_->recoveryRate(name, marketConfiguration_);
+        model_->registerWith(rr);
+        return cg_subtract(*g, cg_const(*g, 1.0),
+                           addModelParameter(*g, model_->modelParameterFunctors(), "__xva_rr_" + name,
+                                             [rr]() { return rr->value(); }));
+    };
+
+    auto fundingDcf = [this, &g, &baseCcy](const std::string& name, const Date& d0, const Date& d1) {
+        auto curve = simMarket_->yieldCurve(name, marketConfiguration_);
+        auto ois = simMarket_->discountCurve(baseCcy, marketConfiguration_);
+        model_->registerWith(curve);
+        model_->registerWith(ois);
+        return addModelParameter(
+            *g, model_->modelParameterFunctors(),
+            "__xva_fvadcf_" + name + "_" + ore::data::to_string(d0) + "_" + ore::data::to_string(d1),
+            [curve, ois, d0, d1]() {
+                return curve->discount(d0) / curve->discount(d1) - ois->discount(d0) / ois->discount(d1);
+            });
+    };
+
+    auto sum = [&g](const std::vector<std::size_t>& v) {
+        if (v.empty())
+            return cg_const(*g, 0.0);
+        return v.size() == 1 ? v.front() : cg_add(*g, v);
+    };
+
+    struct XvaNodes {
+        std::string counterparty;
+        std::size_t cva, dva, fca, fba;
+    };
+    std::map<std::string, XvaNodes> nettingSetXvaNodes;
+    std::vector<std::size_t> xvaTerms;
+    for (auto const& [n, e] : exposureNodes) {
+        std::string cpty = nettingSetCounterparty.at(n);
+        std::size_t zero = cg_const(*g, 0.0);
+        std::size_t cptyLgd = lgd(cpty);
+        std::size_t ownLgd = dvaName_.empty() ? zero : lgd(dvaName_);
+        std::vector<std::size_t> cvaTerms, dvaTerms, fcaTerms, fbaTerms;
+        for (Size k = 1; k < e.size(); ++k) {
+            Date d0 = k == 1 ? asof_ : valuationDates[k - 2];
+            Date d1 = valuationDates[k - 1];
+            std::size_t epe = cg_max(*g, e[k], zero);
+            std::size_t ene = cg_max(*g, cg_negative(*g, e[k]), zero);
+            std::size_t cptySp0 = survivalProb(cpty, d0);
+            cvaTerms.push_back(
+                cg_mult(*g, cg_mult(*g, cptyLgd, cg_subtract(*g, cptySp0, survivalProb(cpty, d1))), epe));
+            std::size_t sp0 = cptySp0;
+            if (!dvaName_.empty()) {
+                std::size_t ownSp0 = survivalProb(dvaName_, d0);
+                dvaTerms.push_back(
+                    cg_mult(*g, cg_mult(*g, ownLgd, cg_subtract(*g, ownSp0, survivalProb(dvaName_, d1))), ene));
+                sp0 = cg_mult(*g, sp0, ownSp0);
+            }
+            if (!fvaBorrowingCurve_.empty())
+                fcaTerms.push_back(cg_mult(*g, cg_mult(*g, sp0, fundingDcf(fvaBorrowingCurve_, d0, d1)), epe));
+            if (!fvaLendingCurve_.empty())
+                fbaTerms.push_back(cg_mult(*g, cg_mult(*g, sp0, fundingDcf(fvaLendingCurve_, d0, d1)), ene));
+        }
+        auto& x = nettingSetXvaNodes[n];
+        x.counterparty = cpty;
+        x.cva = sum(cvaTerms);
+        x.dva = sum(dvaTerms);
+        x.fca = sum(fcaTerms);
+        x.fba = sum(fbaTerms);
+        xvaTerms.push_back(cg_subtract(*g, cg_add(*g, x.cva, x.fca), cg_add(*g, x.dva, x.fba)));
     }
+    std::size_t xvaNode = sum(xvaTerms);
 
     boost::timer::nanosecond_type timing7 = timer.elapsed().wall;
 
@@ -278,7 +523,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         externalComputeDeviceSettings.useDoublePrecision = useDoublePrecisionForExternalCalculation_;
         externalComputeDeviceSettings.rngSequenceType = scenarioGeneratorData_->sequenceType();
         externalComputeDeviceSettings.rngSeed = scenarioGeneratorData_->seed();
-        externalComputeDeviceSettings.regressionOrder = 4;
+        externalComputeDeviceSettings.regressionOrder = regressionOrder;
         externalCalculationId_ = ComputeEnvironment::instance()
                                      .context()
                                      .initiateCalculation(model_->size(), 0, 0, externalComputeDeviceSettings)
@@ -316,7 +561,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     // - values needed for derivatives (except in red blocks, by their definition)
     // - red block dependencies
     // - the random variates for bump sensis
-    // - the pfExposureNodes to dump out the epe profile
+    // - the pfExposureNodes, exposureNodes and xva nodes to dump out the epe profiles and xva
 
     LOG("XvaEngineCG: do forward evaluation");
 
@@ -326,9 +571,9 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         opsExternal_ = getExternalRandomVariableOps();
         gradsExternal_ = getExternalRandomVariableGradients();
     } else {
-        ops_ = getRandomVariableOps(model_->size(), 4, QuantLib::LsmBasisSystem::Monomial, bumpCvaSensis_ ? eps : 0.0,
-                                    Null<Real>()); // todo set regression variance cutoff
-        grads_ = getRandomVariableGradients(model_->size(), 4, QuantLib::LsmBasisSystem::Monomial, eps);
+        ops_ = getRandomVariableOps(model_->size(), regressionOrder, QuantLib::LsmBasisSystem::Monomial,
+                                    bumpCvaSensis_ ? eps : 0.0, Null<Real>()); // todo set regression variance cutoff
+        grads_ = getRandomVariableGradients(model_->size(), regressionOrder, QuantLib::LsmBasisSystem::Monomial, eps);
     }
 
     std::vector<bool> keepNodes(g->size(), false);
@@ -358,34 +603,50 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         }
     }
 
-    for (auto const& n : pfExposureNodes) {
+    std::vector<std::size_t> outputNodes(pfExposureNodes);
+    for (auto const& [n, e] : exposureNodes)
+        outputNodes.insert(outputNodes.end(), e.begin(), e.end());
+    for (auto const& [n, x] : nettingSetXvaNodes)
+        outputNodes.insert(outputNodes.end(), {x.cva, x.dva, x.fca, x.fba});
+    outputNodes.push_back(xvaNode);
+
+    for (auto const& n : outputNodes) {
         keepNodes[n] = true;
     }
 
-    keepNodes[cvaNode] = true;
-
     std::vector<bool> rvOpAllowsPredeletion = QuantExt::getRandomVariableOpAllowsPredeletion();
 
+    std::vector<std::size_t> externalOutputNodes;
     std::vector<std::vector<double>> externalOutput;
     std::vector<double*> externalOutputPtr;
     if (useExternalComputeDevice_) {
         forwardEvaluation(*g, valuesExternal, opsExternal_, ExternalRandomVariable::deleter, !bumpCvaSensis_,
                           opNodeRequirements_, keepNodes, 0, ComputationGraph::nan, false,
                           ExternalRandomVariable::preDeleter, rvOpAllowsPredeletion);
-        for (Size i = 0; i < pfExposureNodes.size(); ++i) {
-            valuesExternal[pfExposureNodes[i]].declareAsOutput();
+        // declare each non-constant output node once, the xva node last
+        std::set<std::size_t> declared;
+        for (auto const& n : outputNodes) {
+            if (n != xvaNode && !g->isConstant(n) && declared.insert(n).second)
+                externalOutputNodes.push_back(n);
+        }
+        if (!g->isConstant(xvaNode))
+            externalOutputNodes.push_back(xvaNode);
+        for (auto const& n : externalOutputNodes) {
+            valuesExternal[n].declareAsOutput();
         }
-        valuesExternal[cvaNode].declareAsOutput();
-        externalOutput.resize(pfExposureNodes.size() + 1, std::vector<double>(model_->size()));
+        externalOutput.resize(externalOutputNodes.size(), std::vector<double>(model_->size()));
         externalOutputPtr.resize(externalOutput.size());
         std::transform(externalOutput.begin(), externalOutput.end(), externalOutputPtr.begin(),
                        [](std::vector<double>& v) { return &v[0]; });
         ComputeEnvironment::instance().context().finalizeCalculation(externalOutputPtr);
         // could skip this and use externalOutput directly below, but it's more convenient to copy the results to values
-        for (Size i = 0; i < pfExposureNodes.size(); ++i) {
-            values[pfExposureNodes[i]] = RandomVariable(model_->size(), externalOutputPtr[i]);
+        for (Size i = 0; i < externalOutputNodes.size(); ++i) {
+            values[externalOutputNodes[i]] = RandomVariable(model_->size(), externalOutputPtr[i]);
+        }
+        for (auto const& n : outputNodes) {
+            if (g->isConstant(n))
+                values[n] = RandomVariable(model_->size(), g->constantValue(n));
         }
-        values[cvaNode] = RandomVariable(model_->size(), externalOutputPtr.back());
     } else {
         forwardEvaluation(*g, values, ops_, RandomVariable::deleter, !bumpCvaSensis_, opNodeRequirements_, keepNodes);
     }
@@ -394,23 +655,63 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
     // Write epe / ene profile out
 
-    LOG("XvaEngineCG: Write epe report.");
+    LOG("XvaEngineCG: Write epe and xva reports.");
 
     {
         epeReport_ = QuantLib::ext::make_shared<InMemoryReport>();
         epeReport_->addColumn("Date", Date()).addColumn("EPE", double(), 4).addColumn("ENE", double(), 4);
 
-        for (Size i = 0; i < simulationDates.size() + 1; ++i) {
+        for (Size i = 0; i < exposureDates.size() + 1; ++i) {
             epeReport_->next();
-            epeReport_->add(i == 0 ? model_->referenceDate() : *std::next(simulationDates.begin(), i - 1))
+            epeReport_->add(i == 0 ? model_->referenceDate() : exposureDates[i - 1])
                 .add(expectation(max(values[pfExposureNodes[i]], RandomVariable(model_->size(), 0.0))).at(0))
                 .add(expectation(max(-values[pfExposureNodes[i]], RandomVariable(model_->size(), 0.0))).at(0));
         }
         epeReport_->end();
     }
 
-    Real cva = expectation(values[cvaNode]).at(0);
-    LOG("XvaEngineCG: Calcuated CVA (node " << cvaNode << ") = " << cva);
+    {
+        nettingSetEpeReport_ = QuantLib::ext::make_shared<InMemoryReport>();
+        nettingSetEpeReport_->addColumn("NettingSet", string())
+            .addColumn("Date", Date())
+            .addColumn("EPE", double(), 4)
+            .addColumn("ENE", double(), 4);
+
+        for (auto const& [n, e] : exposureNodes) {
+            for (Size i = 0; i < e.size(); ++i) {
+                nettingSetEpeReport_->next();
+                nettingSetEpeReport_->add(n)
+                    .add(i == 0 ? model_->referenceDate() : valuationDates[i - 1])
+                    .add(expectation(max(values[e[i]], RandomVariable(model_->size(), 0.0))).at(0))
+                    .add(expectation(max(-values[e[i]], RandomVariable(model_->size(), 0.0))).at(0));
+            }
+        }
+        nettingSetEpeReport_->end();
+    }
+
+    {
+        xvaReport_ = QuantLib::ext::make_shared<InMemoryReport>();
+        xvaReport_->addColumn("NettingSet", string())
+            .addColumn("Counterparty", string())
+            .addColumn("CVA", double(), 2)
+            .addColumn("DVA", double(), 2)
+            .addColumn("FBA", double(), 2)
+            .addColumn("FCA", double(), 2);
+
+        for (auto const& [n, x] : nettingSetXvaNodes) {
+            xvaReport_->next();
+            xvaReport_->add(n)
+                .add(x.counterparty)
+                .add(expectation(values[x.cva]).at(0))
+                .add(expectation(values[x.dva]).at(0))
+                .add(expectation(values[x.fba]).at(0))
+                .add(expectation(values[x.fca]).at(0));
+        }
+        xvaReport_->end();
+    }
+
+    Real xva = expectation(values[xvaNode]).at(0);
+    LOG("XvaEngineCG: Calcuated XVA = CVA - DVA + FCA - FBA (node " << xvaNode << ") = " << xva);
 
     rvMemMax = std::max(rvMemMax, numberOfStochasticRvs(values) + numberOfStochasticRvs(derivatives));
 
@@ -430,7 +731,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
             LOG("XvaEngineCG: run backward derivatives");
 
-            derivatives[cvaNode] = RandomVariable(model_->size(), 1.0);
+            derivatives[xvaNode] = RandomVariable(model_->size(), 1.0);
 
             std::vector<bool> keepNodesDerivatives(g->size(), false);
 
@@ -477,9 +778,9 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
         simMarket_->scenarioGenerator() = sensiScenarioGenerator_;
 
-        auto resultCube = QuantLib::ext::make_shared<DoublePrecisionSensiCube>(std::set<std::string>{"CVA"}, asof_,
+        auto resultCube = QuantLib::ext::make_shared<DoublePrecisionSensiCube>(std::set<std::string>{"XVA"}, asof_,
                                                                                sensiScenarioGenerator_->samples());
-        resultCube->setT0(cva, 0, 0);
+        resultCube->setT0(xva, 0, 0);
 
         model_->alwaysForwardNotifications();
 
@@ -507,7 +808,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
                 if (!bumpCvaSensis_) {
 
-                    // calcuate CVA sensi using ad derivatives
+                    // calcuate XVA sensi using ad derivatives
 
                     auto modelParameters = model_->modelParameters();
                     Size i = 0;
@@ -523,7 +824,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
                 } else {
 
-                    // calcuate CVA sensi doing full recalc of CVA
+                    // calcuate XVA sensi doing full recalc of XVA
 
                     if (useExternalComputeDevice_) {
                         ComputeEnvironment::instance().context().initiateCalculation(
@@ -531,19 +832,20 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
                         populateConstants(values, valuesExternal);
                         populateModelParameters(model_->modelParameters(), values, valuesExternal);
                         ComputeEnvironment::instance().context().finalizeCalculation(externalOutputPtr);
-                        values[cvaNode] = RandomVariable(model_->size(), externalOutputPtr.back());
+                        if (!g->isConstant(xvaNode))
+                            values[xvaNode] = RandomVariable(model_->size(), externalOutputPtr.back());
                     } else {
                         populateModelParameters(model_->modelParameters(), values, valuesExternal);
                         forwardEvaluation(*g, values, ops_, RandomVariable::deleter, true, opNodeRequirements_,
                                           keepNodes);
                     }
-                    sensi = expectation(values[cvaNode]).at(0) - cva;
+                    sensi = expectation(values[xvaNode]).at(0) - xva;
                 }
             }
 
             // set result in cube
 
-            resultCube->set(cva + sensi, 0, 0, sample, 0);
+            resultCube->set(xva + sensi, 0, 0, sample, 0);
         }
 
         timing12 = timer.elapsed().wall;
@@ -31,6 +31,7 @@
 #include <ored/configuration/curveconfigurations.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/portfolio/nettingsetmanager.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/scripting/models/gaussiancamcg.hpp>
 #include <ored/utilities/progressbar.hpp>
@@ -47,6 +48,28 @@ namespace analytics {
 using namespace QuantLib;
 using namespace ore::data;
 
+//! XVA engine using the computation graph infrastructure
+/*! The engine builds one computation graph covering the simulation of the model, the AMC valuation of the trades,
+    the netting set exposures and the XVA post processing. The XVA is computed in one forward evaluation, the
+    sensitivities w.r.t. the sim market scenarios configured in the sensitivity data in one backward derivatives run
+    (or, alternatively, by bump and revaluation).
+
+    - the model is a GaussianCamCG in the domestic currency of the cross asset model data, the simulation grid is the
+      union of the valuation and close-out dates of the scenario generator data grid, refined such that the step size
+      does not exceed 1 / TimeStepsPerYear (engine parameter of the ScriptedTrade product in the engine data). With
+      MporMode StickyDate the close-out value is the path value of the valuation date conditioned on the state on
+      the close-out date, i.e. cashflows in the margin period of risk are included, exercise decisions within this
+      period are not frozen though.
+    - the conditional expectations are computed by regression with the order given by the engine parameter
+      RegressionOrder of the ScriptedTrade product
+    - the exposure of a netting set with an active CSA is the close-out value reduced by the collateral settled on
+      the valuation date which is determined from the netting set value, the independent amount held and the
+      thresholds of the CSA. The collateral accrues at the discount rate less the compounding spread until the
+      close-out date. The CSA currency must be the domestic currency, the MTAs must be zero and the margin call and
+      post frequencies must be 1D. Without an active CSA the exposure is the netting set value on the valuation date.
+    - the CVA is computed from the default curve of the counterparty of each netting set, the DVA from the default
+      curve dvaName, the FVA from the borrowing and lending curves, if given. The sensitivities are computed for the
+      sum CVA - DVA + FCA - FBA over all netting sets. */
 class XvaEngineCG : public ore::data::ProgressReporter {
 public:
     XvaEngineCG(const Size nThreads, const Date& asof, const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
@@ -62,13 +85,18 @@ public:
                 const QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData>& sensitivityData = nullptr,
                 const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData = nullptr,
                 const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
-                const bool bumpCvaSensis = false, const bool useExternalComputeDevice = false,
+                const QuantLib::ext::shared_ptr<ore::data::NettingSetManager>& nettingSetManager = nullptr,
+                const std::string& dvaName = std::string(), const std::string& fvaBorrowingCurve = std::string(),
+                const std::string& fvaLendingCurve = std::string(), const bool bumpCvaSensis = false,
+                const bool useExternalComputeDevice = false,
                 const bool externalDeviceCompatibilityMode = false,
                 const bool useDoublePrecisionForExternalCalculation = false,
                 const std::string& externalComputeDevice = std::string(), const bool continueOnCalibrationError = true,
                 const bool continueOnError = true, const std::string& context = "xva engine cg");
 
     QuantLib::ext::shared_ptr<InMemoryReport> exposureReport() { return epeReport_; }
+    QuantLib::ext::shared_ptr<InMemoryReport> nettingSetExposureReport() { return nettingSetEpeReport_; }
+    QuantLib::ext::shared_ptr<InMemoryReport> xvaReport() { return xvaReport_; }
     QuantLib::ext::shared_ptr<InMemoryReport> sensiReport() { return sensiReport_; }
 
 private:
@@ -95,6 +123,10 @@ private:
     QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData> sensitivityData_;
     QuantLib::ext::shared_ptr<ReferenceDataManager> referenceData_;
     IborFallbackConfig iborFallbackConfig_;
+    QuantLib::ext::shared_ptr<ore::data::NettingSetManager> nettingSetManager_;
+    std::string dvaName_;
+    std::string fvaBorrowingCurve_;
+    std::string fvaLendingCurve_;
     bool bumpCvaSensis_;
     bool useExternalComputeDevice_;
     bool externalDeviceCompatibilityMode_;
@@ -119,7 +151,7 @@ private:
     std::size_t externalCalculationId_;
 
     // output reports
-    QuantLib::ext::shared_ptr<InMemoryReport> epeReport_, sensiReport_;
+    QuantLib::ext::shared_ptr<InMemoryReport> epeReport_, nettingSetEpeReport_, xvaReport_, sensiReport_;
 };
 
 } // namespace analytics
@@ -47,11 +47,13 @@
 #include <orea/app/marketdatainmemoryloader.hpp>
 #include <orea/app/marketdataloader.hpp>
 #include <orea/app/oreapp.hpp>
+#include <orea/app/oreserver.hpp>
 #include <orea/app/parameters.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/sensitivityrunner.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/app/structuredanalyticswarning.hpp>
+#include <orea/app/todaysmarketcache.hpp>
 #include <orea/app/xvarunner.hpp>
 #include <orea/app/zerosensitivityloader.hpp>
 #include <orea/cube/cube_io.hpp>
@@ -69,8 +71,10 @@
 #include <orea/cube/sparsenpvcube.hpp>
 #include <orea/engine/amcvaluationengine.hpp>
 #include <orea/engine/bufferedsensitivitystream.hpp>
+#include <orea/engine/compactsensitivitystream.hpp>
 #include <orea/engine/cptycalculator.hpp>
 #include <orea/engine/decomposedsensitivitystream.hpp>
+#include <orea/engine/deltagammanpvcalculator.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/historicalpnlgenerator.hpp>
 #include <orea/engine/historicalsensipnlcalculator.hpp>
@@ -80,6 +84,7 @@
 #include <orea/engine/mporcalculator.hpp>
 #include <orea/engine/multistatenpvcalculator.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
+#include <orea/engine/npvmemoisation.hpp>
 #include <orea/engine/npvrecord.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
@@ -102,6 +107,7 @@
 #include <orea/engine/stresstest.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/engine/valuationprofile.hpp>
 #include <orea/engine/varbacktest.hpp>
 #include <orea/engine/varcalculator.hpp>
 #include <orea/engine/xvaenginecg.hpp>
@@ -43,7 +43,7 @@ ScenarioGeneratorBuilder::build(QuantLib::ext::shared_ptr<QuantExt::CrossAssetMo
                                 QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory,
                                 QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> marketConfig, Date asof,
                                 QuantLib::ext::shared_ptr<ore::data::Market> initMarket, const std::string& configuration,
-                                const QuantLib::ext::shared_ptr<PathGeneratorFactory>& pf) {
+                                const QuantLib::ext::shared_ptr<PathGeneratorFactory>& pf, const Size firstPath) {
 
     LOG("ScenarioGeneratorBuilder::build() called");
 
@@ -55,8 +55,8 @@ ScenarioGeneratorBuilder::build(QuantLib::ext::shared_ptr<QuantExt::CrossAssetMo
         tmp->resetCache(data_->getGrid()->timeGrid().size() - 1);
     }
 
-    auto pathGen = pf->build(data_->sequenceType(), process, data_->getGrid()->timeGrid(), data_->seed(),
-                             data_->ordering(), data_->directionIntegers());
+    auto pathGen = pf->buildSubstream(data_->sequenceType(), process, data_->getGrid()->timeGrid(), data_->seed(),
+                                      data_->ordering(), data_->directionIntegers(), firstPath);
 
     return QuantLib::ext::make_shared<CrossAssetModelScenarioGenerator>(model, pathGen, scenarioFactory, marketConfig, asof,
                                                                 data_->getGrid(), initMarket, configuration);
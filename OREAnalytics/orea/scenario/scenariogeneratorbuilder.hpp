@@ -59,13 +59,15 @@ public:
     //! Constructor
     ScenarioGeneratorBuilder(QuantLib::ext::shared_ptr<ScenarioGeneratorData> data) : data_(data) {}
 
-    //! Build function
+    /*! Build function, if firstPath > 0 the generator returns the scenarios starting at sample firstPath, this can
+        be used to split a simulation into independent reproducible parts, see MultiPathGeneratorSubstream */
     QuantLib::ext::shared_ptr<ScenarioGenerator>
     build(QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> model, QuantLib::ext::shared_ptr<ScenarioFactory> sf,
           QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> marketConfig, Date asof,
           QuantLib::ext::shared_ptr<ore::data::Market> initMarket,
           const std::string& configuration = ore::data::Market::defaultConfiguration,
-          const QuantLib::ext::shared_ptr<PathGeneratorFactory>& pf = QuantLib::ext::make_shared<MultiPathGeneratorFactory>());
+          const QuantLib::ext::shared_ptr<PathGeneratorFactory>& pf = QuantLib::ext::make_shared<MultiPathGeneratorFactory>(),
+          const Size firstPath = 0);
 
 private:
     QuantLib::ext::shared_ptr<ScenarioGeneratorData> data_;
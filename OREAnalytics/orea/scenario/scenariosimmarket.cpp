@@ -37,6 +37,7 @@
 
 #include <qle/indexes/fallbackiborindex.hpp>
 #include <qle/indexes/fallbackovernightindex.hpp>
+#include <qle/indexes/forecastfixingcache.hpp>
 #include <qle/indexes/inflationindexobserver.hpp>
 #include <qle/indexes/inflationindexwrapper.hpp>
 #include <qle/instruments/makeoiscapfloor.hpp>
@@ -2968,6 +2969,7 @@ void ScenarioSimMarket::reset() {
     if (ObservationMode::instance().mode() == ObservationMode::Mode::Unregister) {
         QuantLib::ext::shared_ptr<QuantLib::Observable> obs = QuantLib::Settings::instance().evaluationDate();
         obs->notifyObservers();
+        QuantExt::ForecastFixingCacheSettings::instance().invalidate();
     }
     // reset fixing manager
     fixingManager_->reset();
@@ -3094,7 +3096,7 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
 
 void ScenarioSimMarket::preUpdate() {
     ObservationMode::Mode om = ObservationMode::instance().mode();
-    if (om == ObservationMode::Mode::Disable)
+    if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Track)
         ObservableSettings::instance().disableUpdates(false);
     else if (om == ObservationMode::Mode::Defer)
         ObservableSettings::instance().disableUpdates(true);
@@ -3130,9 +3132,13 @@ void ScenarioSimMarket::postUpdate(const Date& d, bool withFixings) {
     ObservationMode::Mode om = ObservationMode::instance().mode();
 
     // Observation Mode - key to update these before fixings are set
-    if (om == ObservationMode::Mode::Disable) {
+    if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Track) {
         refresh();
         ObservableSettings::instance().enableUpdates();
+        // the indices did not see the notifications, so their forecast fixing caches might be stale
+        QuantExt::ForecastFixingCacheSettings::instance().invalidate();
+    } else if (om == ObservationMode::Mode::Unregister) {
+        QuantExt::ForecastFixingCacheSettings::instance().invalidate();
     } else if (om == ObservationMode::Mode::Defer) {
         ObservableSettings::instance().enableUpdates();
     }
@@ -141,6 +141,9 @@ public:
 
     void applyScenario(const QuantLib::ext::shared_ptr<Scenario>& scenario);
 
+    //! The quotes holding the simulated market data by risk factor key
+    const std::map<RiskFactorKey, QuantLib::ext::shared_ptr<SimpleQuote>>& simData() const { return simData_; }
+
 protected:
     
 
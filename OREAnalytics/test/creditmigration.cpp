@@ -0,0 +1,214 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/creditmigrationhelper.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <ored/portfolio/fxforward.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/time/daycounters/actualactual.hpp>
+#include <qle/math/matrixfunctions.hpp>
+#include <qle/models/hullwhitebucketing.hpp>
+#include <qle/models/transitionmatrix.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <numeric>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// synthetic cubes and credit simulation parameters, entity i is the counterparty of netting set NS_i
+struct CreditMigrationTestData {
+    CreditMigrationTestData(const string& evaluation, const Size entities, const Real loading, const bool marketRisk,
+                            const Size samples, const Size paths)
+        : today(1, January, 2024), dates({Date(1, July, 2024), Date(1, January, 2025)}),
+          portfolio(QuantLib::ext::make_shared<Portfolio>()),
+          parameters(QuantLib::ext::make_shared<CreditSimulationParameters>()) {
+
+        std::set<string> nettingSets;
+        for (Size i = 0; i < entities; ++i) {
+            string entity = "CPTY_" + std::to_string(i), nettingSet = "NS_" + std::to_string(i);
+            auto trade = QuantLib::ext::make_shared<ore::data::FxForward>(Envelope(entity, nettingSet), "2025-07-01",
+                                                                          "EUR", 1.0E6, "USD", 1.1E6);
+            trade->id() = "Trade_" + std::to_string(i);
+            portfolio->add(trade);
+            nettingSets.insert(nettingSet);
+            parameters->entities().push_back(entity);
+            parameters->factorLoadings().push_back(Array(1, loading));
+            parameters->transitionMatrices().push_back("Rating");
+            parameters->initialStates().push_back(i % 2);
+            parameters->nettingSetIds().push_back(nettingSet);
+        }
+
+        transitionMatrix = Matrix(3, 3, 0.0);
+        transitionMatrix[0][0] = 0.90;
+        transitionMatrix[0][1] = 0.08;
+        transitionMatrix[0][2] = 0.02;
+        transitionMatrix[1][0] = 0.10;
+        transitionMatrix[1][1] = 0.85;
+        transitionMatrix[1][2] = 0.05;
+        transitionMatrix[2][2] = 1.0;
+        parameters->transitionMatrix()["Rating"] = transitionMatrix;
+        parameters->marketRisk() = marketRisk;
+        parameters->creditRisk() = true;
+        parameters->zeroMarketPnl() = false;
+        parameters->evaluation() = evaluation;
+        parameters->doubleDefault() = false;
+        parameters->seed() = 42;
+        parameters->paths() = paths;
+        parameters->creditMode() = "Migration";
+        parameters->loanExposureMode() = "Value";
+
+        cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dates, samples);
+        nettedCube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, nettingSets, dates, samples);
+        aggData = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+        MersenneTwisterUniformRng rng(17);
+        InverseCumulativeNormal icn;
+        for (Size i = 0; i < entities; ++i)
+            cube->setT0(1000.0 * (i + 1), i);
+        for (Size d = 0; d < dates.size(); ++d) {
+            Real t = ActualActual(ActualActual::ISDA).yearFraction(today, dates[d]);
+            for (Size k = 0; k < samples; ++k) {
+                aggData->set(d, k, std::sqrt(t) * icn(rng.nextReal()), AggregationScenarioDataType::CreditState, "0");
+                for (Size i = 0; i < entities; ++i) {
+                    cube->set(1000.0 * (i + 1) + 500.0 * (rng.nextReal() - 0.5), i, d, k);
+                    nettedCube->set(1000.0 * (i + 1) * (rng.nextReal() - 0.2), i, d, k);
+                }
+            }
+        }
+    }
+
+    QuantLib::ext::shared_ptr<CreditMigrationHelper> helper(const Size nThreads) const {
+        auto hlp = QuantLib::ext::make_shared<CreditMigrationHelper>(
+            parameters, cube, nettedCube, aggData, Null<Size>(), Null<Size>(), -5000.0, 5000.0, 100,
+            Matrix(1, 1, 1.0), "EUR", nThreads);
+        hlp->build(portfolio->trades());
+        return hlp;
+    }
+
+    Date today;
+    vector<Date> dates;
+    QuantLib::ext::shared_ptr<Portfolio> portfolio;
+    QuantLib::ext::shared_ptr<CreditSimulationParameters> parameters;
+    Matrix transitionMatrix;
+    QuantLib::ext::shared_ptr<NPVCube> cube, nettedCube;
+    QuantLib::ext::shared_ptr<AggregationScenarioData> aggData;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CreditMigrationTest)
+
+BOOST_AUTO_TEST_CASE(testPnlDistributionAccumulator) {
+
+    BOOST_TEST_MESSAGE("Testing pnl distribution accumulator...");
+
+    PnlDistributionAccumulator a(4), b(4);
+    Array p(4, 0.0);
+    p[0] = p[2] = 0.5;
+    a.add(1, 0.25);
+    a.add(p, 0.5);
+    b.add(3, 0.5);
+    a.merge(b);
+    BOOST_REQUIRE_EQUAL(a.buckets(), 4);
+    BOOST_CHECK_EQUAL(a.probabilities()[0], 0.25);
+    BOOST_CHECK_EQUAL(a.probabilities()[1], 0.25);
+    BOOST_CHECK_EQUAL(a.probabilities()[2], 0.25);
+    BOOST_CHECK_EQUAL(a.probabilities()[3], 0.5);
+    BOOST_CHECK_THROW(a.add(Array(3, 0.0), 1.0), QuantLib::Error);
+    BOOST_CHECK_THROW(a.merge(PnlDistributionAccumulator(5)), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testPnlDistributionMultiThreaded) {
+
+    if (!QuantExt::supports_Expm() || !QuantExt::supports_Logm()) {
+        BOOST_CHECK(true);
+        return;
+    }
+
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution for different numbers of threads...");
+
+    // 100 samples are processed in four blocks, the last one is incomplete
+    for (auto const& evaluation : {"Analytic", "TerminalSimulation"}) {
+        CreditMigrationTestData data(evaluation, 2, 0.5, true, 100, 50);
+        Array serial = data.helper(1)->pnlDistribution(1);
+        for (Size nThreads : {2, 4, 8}) {
+            Array parallel = data.helper(nThreads)->pnlDistribution(1);
+            BOOST_REQUIRE_EQUAL(serial.size(), parallel.size());
+            for (Size i = 0; i < serial.size(); ++i)
+                BOOST_CHECK_EQUAL(serial[i], parallel[i]);
+        }
+        BOOST_CHECK_CLOSE(std::accumulate(serial.begin(), serial.end(), 0.0), 1.0, 1.0E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testTerminalSimulationRngSequence) {
+
+    if (!QuantExt::supports_Expm() || !QuantExt::supports_Logm()) {
+        BOOST_CHECK(true);
+        return;
+    }
+
+    BOOST_TEST_MESSAGE("Testing credit migration terminal simulation against one rng sequence over all paths...");
+
+    // one entity without systemic factor and without market risk, so that each inner path defaults if its uniform
+    // draw exceeds the non-default probability of the rescaled transition matrix
+    Size samples = 70, paths = 50;
+    CreditMigrationTestData data("TerminalSimulation", 1, 0.0, false, samples, paths);
+    auto hlp = data.helper(3);
+    Array distribution = hlp->pnlDistribution(1);
+
+    Matrix m = data.transitionMatrix;
+    QuantExt::sanitiseTransitionMatrix(m);
+    Real t = ActualActual(ActualActual::ISDA).yearFraction(data.today, data.dates[1]);
+    Matrix mt = QuantExt::Expm(t * QuantExt::generator(m));
+    Real survival = mt[0][0] + mt[0][1];
+
+    QuantExt::HullWhiteBucketing bucketing(hlp->upperBucketBound().begin(), hlp->upperBucketBound().end());
+    Array expected(distribution.size(), 0.0);
+    MersenneTwisterUniformRng rng(data.parameters->seed());
+    for (Size k = 0; k < samples; ++k) {
+        Size defaults = 0;
+        for (Size p = 0; p < paths; ++p) {
+            if (rng.next().value > survival)
+                ++defaults;
+        }
+        Real exposure = std::max(data.nettedCube->get(0, 1, k), 0.0);
+        expected[bucketing.index(-exposure)] += static_cast<Real>(defaults) / paths / samples;
+        expected[bucketing.index(0.0)] += static_cast<Real>(paths - defaults) / paths / samples;
+    }
+
+    BOOST_REQUIRE_EQUAL(distribution.size(), expected.size());
+    for (Size i = 0; i < distribution.size(); ++i)
+        BOOST_CHECK_SMALL(distribution[i] - expected[i], 1.0E-12);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -31,20 +31,25 @@
 #include <ored/model/lgmdata.hpp>
 #include <ored/model/irlgmdata.hpp>
 #include <ored/portfolio/builders/swap.hpp>
+#include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/portfolio/swap.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
 #include <oret/toplevelfixture.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/methods/montecarlo/lsmbasissystem.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/date.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
+#include <qle/math/stabilisedglls.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <test/oreatoplevelfixture.hpp>
 
 #include "testmarket.hpp"
 
+#include <orea/aggregation/collatexposurehelper.hpp>
 #include <orea/aggregation/exposurecalculator.hpp>
 #include <orea/aggregation/nettedexposurecalculator.hpp>
 #include <orea/aggregation/dimcalculator.hpp>
@@ -70,6 +75,53 @@ using namespace ore::analytics;
 
 using testsuite::TestMarket;
 
+namespace {
+
+// collateral balance paths generated path by path as before the parallelisation, i.e. with the grid search for each
+// path, date and input, used as a reference for the multi-threaded implementation
+vector<QuantLib::ext::shared_ptr<CollateralAccount>>
+legacyCollateralBalancePaths(const QuantLib::ext::shared_ptr<NettingSetDefinition>& csaDef, const Real nettingSetPv,
+                             const Date& date_t0, const vector<vector<Real>>& nettingSetValues,
+                             const Date& nettingSet_maturity, const vector<Date>& dateGrid, const Real csaFxTodayRate,
+                             const vector<vector<Real>>& csaFxScenarioRates, const Real csaTodayCollatCurve,
+                             const vector<vector<Real>>& csaScenCollatCurves,
+                             const CollateralExposureHelper::CalculationType calcType) {
+    auto tmpAcc = QuantLib::ext::make_shared<CollateralAccount>(csaDef, 0.0, date_t0);
+    Real bal_t0 = CollateralExposureHelper::marginRequirementCalc(tmpAcc, nettingSetPv, date_t0);
+    CollateralAccount baseAcc(csaDef, bal_t0, date_t0);
+    vector<QuantLib::ext::shared_ptr<CollateralAccount>> paths;
+    Date simEndDate = std::min(nettingSet_maturity, dateGrid.back()) + csaDef->csaDetails()->marginPeriodOfRisk();
+    for (unsigned i = 0; i < nettingSetValues.front().size(); i++) {
+        auto collat = QuantLib::ext::make_shared<CollateralAccount>(baseAcc);
+        Date tmpDate = date_t0;
+        Date nextMarginReqDateUs = date_t0;
+        Date nextMarginReqDateCtp = date_t0;
+        while (tmpDate <= simEndDate) {
+            bool eligMarginReqDateUs = tmpDate == nextMarginReqDateUs;
+            bool eligMarginReqDateCtp = tmpDate == nextMarginReqDateCtp;
+            Real uncollatVal = CollateralExposureHelper::estimateUncollatValue(tmpDate, nettingSetPv, date_t0,
+                                                                               nettingSetValues, i, dateGrid);
+            Real fxValue = CollateralExposureHelper::estimateUncollatValue(tmpDate, csaFxTodayRate, date_t0,
+                                                                           csaFxScenarioRates, i, dateGrid);
+            Real annualisedZeroRate = CollateralExposureHelper::estimateUncollatValue(
+                tmpDate, csaTodayCollatCurve, date_t0, csaScenCollatCurves, i, dateGrid);
+            uncollatVal /= fxValue;
+            CollateralExposureHelper::updateMarginCall(collat, uncollatVal, tmpDate, annualisedZeroRate, calcType,
+                                                       eligMarginReqDateUs, eligMarginReqDateCtp);
+            if (nextMarginReqDateUs == tmpDate)
+                nextMarginReqDateUs = tmpDate + csaDef->csaDetails()->marginCallFrequency();
+            if (nextMarginReqDateCtp == tmpDate)
+                nextMarginReqDateCtp = tmpDate + csaDef->csaDetails()->marginPostFrequency();
+            tmpDate = std::min(nextMarginReqDateUs, nextMarginReqDateCtp);
+        }
+        collat->closeAccount(simEndDate + Period(1, Days));
+        paths.push_back(collat);
+    }
+    return paths;
+}
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(CollateralisedExposureTest)
@@ -698,5 +750,161 @@ BOOST_AUTO_TEST_CASE(NettedExposureCalculatorTest) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(CollateralBalancePathsMultiThreadedTest) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded collateral balance path generation...");
+
+    Date today(15, March, 2024);
+    QuantLib::ext::shared_ptr<NettingSetDefinition> nettingSetDefinition =
+        QuantLib::ext::make_shared<NettingSetDefinition>("NS", "Bilateral", "EUR", "EUR-EONIA", 1000.0, 2000.0, 100.0,
+                                                         200.0, 0.0, "FIXED", "1W", "2W", "2W", 0.0, 0.0,
+                                                         std::vector<std::string>{"EUR"});
+
+    vector<Date> dateGrid;
+    for (Size i = 1; i <= 50; ++i)
+        dateGrid.push_back(today + (3 * i) * Days);
+
+    Size samples = 101;
+    MersenneTwisterUniformRng rng(42);
+    vector<vector<Real>> values(dateGrid.size(), vector<Real>(samples));
+    vector<vector<Real>> fxRates(dateGrid.size(), vector<Real>(samples));
+    vector<vector<Real>> rates(dateGrid.size(), vector<Real>(samples));
+    for (Size i = 0; i < dateGrid.size(); ++i) {
+        for (Size k = 0; k < samples; ++k) {
+            values[i][k] = 1.0E5 * (rng.nextReal() - 0.5);
+            fxRates[i][k] = 0.9 + 0.2 * rng.nextReal();
+            rates[i][k] = 0.05 * rng.nextReal();
+        }
+    }
+
+    for (auto calcType : {CollateralExposureHelper::Symmetric, CollateralExposureHelper::AsymmetricCVA,
+                          CollateralExposureHelper::NoLag}) {
+        auto paths1 = CollateralExposureHelper::collateralBalancePaths(nettingSetDefinition, 1000.0, today, values,
+                                                                      dateGrid.back(), dateGrid, 1.0, fxRates, 0.01,
+                                                                      rates, calcType, nullptr, 1);
+        auto paths4 = CollateralExposureHelper::collateralBalancePaths(nettingSetDefinition, 1000.0, today, values,
+                                                                      dateGrid.back(), dateGrid, 1.0, fxRates, 0.01,
+                                                                      rates, calcType, nullptr, 4);
+        auto legacy = legacyCollateralBalancePaths(nettingSetDefinition, 1000.0, today, values, dateGrid.back(),
+                                                   dateGrid, 1.0, fxRates, 0.01, rates, calcType);
+        BOOST_REQUIRE_EQUAL(paths1->size(), samples);
+        BOOST_REQUIRE_EQUAL(paths4->size(), samples);
+        BOOST_REQUIRE_EQUAL(legacy.size(), samples);
+        for (Size k = 0; k < samples; ++k) {
+            for (auto const& d : dateGrid) {
+                BOOST_CHECK_EQUAL(paths1->at(k)->accountBalance(d), paths4->at(k)->accountBalance(d));
+                BOOST_CHECK_SMALL(paths1->at(k)->accountBalance(d) - legacy[k]->accountBalance(d), 1.0E-6);
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(DimRegressionMultiThreadedTest) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded DIM regression against single-threaded and StabilisedGLLS results...");
+
+    Date today(15, March, 2024);
+    Settings::instance().evaluationDate() = today;
+
+    // two netting sets, the trades are only used to map the cube rows to netting sets
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    vector<Real> exposures = {1.0E6, -4.0E5, 2.0E6};
+    vector<string> nettingSets = {"NS1", "NS1", "NS2"};
+    for (Size i = 0; i < exposures.size(); ++i) {
+        auto trade = QuantLib::ext::make_shared<ore::data::FxForward>(Envelope("CP", nettingSets[i]), "2025-03-15",
+                                                                      "EUR", 1.0E6, "USD", 1.1E6);
+        trade->id() = "Trade_" + std::to_string(i);
+        portfolio->add(trade);
+    }
+
+    // synthetic regular cube with weekly dates, the npv moves are proportional to the regressor level
+    Size nDates = 12, samples = 400;
+    vector<Date> dates;
+    for (Size j = 0; j < nDates; ++j)
+        dates.push_back(today + 7 * (j + 1));
+    string index = "EUR-EURIBOR-6M";
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dates, samples);
+    auto asd = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(nDates, samples);
+    MersenneTwisterUniformRng rng(42);
+    for (Size k = 0; k < samples; ++k) {
+        Real x = 0.02 + 0.02 * rng.nextReal();
+        for (Size j = 0; j < nDates; ++j) {
+            Real t = static_cast<Real>(dates[j] - today) / 365.0;
+            asd->set(j, k, x, AggregationScenarioDataType::IndexFixing, index);
+            asd->set(j, k, std::exp(0.01 * t) * (1.0 + 0.01 * (rng.nextReal() - 0.5)),
+                     AggregationScenarioDataType::Numeraire);
+            for (Size i = 0; i < exposures.size(); ++i)
+                cube->set(exposures[i] * x, i, j, k);
+            x += 0.2 * x * (rng.nextReal() - 0.5);
+        }
+    }
+    auto cubeInterpreter =
+        QuantLib::ext::make_shared<CubeInterpretation>(false, false, Handle<AggregationScenarioData>(asd));
+
+    Real quantile = 0.99;
+    Size horizonCalendarDays = 14, regressionOrder = 2;
+    vector<string> regressors = {index};
+    auto inputs = QuantLib::ext::make_shared<InputParameters>();
+    auto dimCalculator = [&](Size nThreads) {
+        auto calc = QuantLib::ext::make_shared<RegressionDynamicInitialMarginCalculator>(
+            inputs, portfolio, cube, cubeInterpreter, asd, quantile, horizonCalendarDays, regressionOrder, regressors,
+            0, 0.0, std::map<std::string, Real>(), nThreads);
+        calc->build();
+        return calc;
+    };
+    auto serial = dimCalculator(1);
+    auto parallel = dimCalculator(4);
+
+    // the results do not depend on the number of threads
+    for (auto const& n : {"NS1", "NS2"}) {
+        for (Size j = 0; j < nDates - 1; ++j) {
+            BOOST_CHECK_EQUAL(serial->expectedIM(n)[j], parallel->expectedIM(n)[j]);
+            BOOST_CHECK_EQUAL(serial->zeroOrderResults(n)[j], parallel->zeroOrderResults(n)[j]);
+            BOOST_CHECK_EQUAL(serial->simpleResultsUpper(n)[j], parallel->simpleResultsUpper(n)[j]);
+            BOOST_CHECK_EQUAL(serial->simpleResultsLower(n)[j], parallel->simpleResultsLower(n)[j]);
+            for (Size k = 0; k < samples; ++k)
+                BOOST_CHECK_EQUAL(serial->dynamicIM(n)[j][k], parallel->dynamicIM(n)[j][k]);
+        }
+    }
+    for (Size i = 0; i < serial->dimCube()->numIds(); ++i)
+        for (Size j = 0; j < nDates - 1; ++j)
+            for (Size k = 0; k < samples; ++k)
+                BOOST_CHECK_EQUAL(serial->dimCube()->get(i, j, k), parallel->dimCube()->get(i, j, k));
+
+    // the regression on the regressor columns matches the StabilisedGLLS regression on the sample arrays
+    std::vector<ext::function<Real(Array)>> v(LsmBasisSystem::multiPathBasisSystem(1, regressionOrder,
+                                                                                   LsmBasisSystem::Monomial));
+    Real confidenceLevel = InverseCumulativeNormal()(quantile);
+    Size tradeIndex = 0;
+    for (auto const& n : {"NS1", "NS2"}) {
+        Size nTrades = n == string("NS1") ? 2 : 1;
+        for (Size j = 0; j < nDates - 1; ++j) {
+            vector<Array> rx(samples);
+            vector<Real> ry(samples);
+            for (Size k = 0; k < samples; ++k) {
+                Real npv = 0.0, closeOutNpv = 0.0;
+                for (Size i = tradeIndex; i < tradeIndex + nTrades; ++i) {
+                    npv += cubeInterpreter->getDefaultNpv(cube, i, j, k);
+                    closeOutNpv += cubeInterpreter->getCloseOutNpv(cube, i, j, k);
+                }
+                Real z = closeOutNpv * asd->get(j + 1, k, AggregationScenarioDataType::Numeraire) -
+                         npv * asd->get(j, k, AggregationScenarioDataType::Numeraire);
+                rx[k] = Array(1, asd->get(j, k, AggregationScenarioDataType::IndexFixing, index));
+                ry[k] = z * z;
+            }
+            QuantExt::StabilisedGLLS ls(rx, ry, v, QuantExt::StabilisedGLLS::MeanStdDev);
+            Real horizonScaling = std::sqrt(1.0 * horizonCalendarDays / (dates[j + 1] - dates[j]));
+            Real tolerance = 1.0E-8 * serial->expectedIM(n)[j];
+            for (Size k = 0; k < samples; ++k) {
+                Real expected = std::sqrt(std::max(ls.eval(rx[k], v), 0.0)) * horizonScaling * confidenceLevel /
+                                asd->get(j, k, AggregationScenarioDataType::Numeraire);
+                BOOST_CHECK_SMALL(serial->dynamicIM(n)[j][k] - expected, tolerance);
+            }
+        }
+        tradeIndex += nTrades;
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/sensicube.hpp>
+#include <orea/engine/npvmemoisation.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/clonescenariofactory.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/sensitivityscenariogenerator.hpp>
+#include <ored/portfolio/builders/swap.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/dategrid.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <test/oreatoplevelfixture.hpp>
+#include <test/testportfolio.hpp>
+
+#include "testmarket.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::TestConfigurationObjects;
+using testsuite::TestMarket;
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(NpvMemoisationTest)
+
+BOOST_AUTO_TEST_CASE(testMemoisedCubeMatchesFullRepricing) {
+
+    BOOST_TEST_MESSAGE("Testing that npv memoisation reproduces the cube of a full repricing...");
+
+    SavedSettings backup;
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    auto initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    auto simMarketData = TestConfigurationObjects::setupSimMarketData5();
+    auto sensiData = TestConfigurationObjects::setupSensitivityScenarioData5();
+    auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(initMarket, simMarketData);
+    auto scenarioFactory = QuantLib::ext::make_shared<CloneScenarioFactory>(simMarket->baseScenario());
+    auto scenarioGenerator = QuantLib::ext::make_shared<SensitivityScenarioGenerator>(
+        sensiData, simMarket->baseScenario(), simMarketData, simMarket, scenarioFactory, false);
+    simMarket->scenarioGenerator() = scenarioGenerator;
+
+    auto data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    auto factory = QuantLib::ext::make_shared<EngineFactory>(data, simMarket);
+
+    // A, B, C are multiples of each other (C with opposite direction), D and E differ in rate and currency
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(buildSwap("A", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("B", "EUR", true, 30000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("C", "EUR", false, 5000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("D", "EUR", true, 10000000.0, 0, 10, 0.04, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("E", "USD", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->build(factory);
+
+    NpvMemoisation memoisation;
+    memoisation.build(portfolio);
+    BOOST_CHECK_EQUAL(memoisation.numberOfClasses(), 1);
+    BOOST_CHECK_EQUAL(memoisation.numberOfMemoisedTrades(), 2);
+    BOOST_CHECK_EQUAL(memoisation.representative(1), 0);
+    BOOST_CHECK_EQUAL(memoisation.representative(2), 0);
+    BOOST_CHECK_CLOSE(memoisation.scale(1), 3.0, 1.0E-10);
+    BOOST_CHECK_CLOSE(memoisation.scale(2), -0.5, 1.0E-10);
+    BOOST_CHECK(!memoisation.isMemoised(3));
+    BOOST_CHECK(!memoisation.isMemoised(4));
+
+    NpvMemoisation memoisationExcludingSwaps({"Swap"});
+    memoisationExcludingSwaps.build(portfolio);
+    BOOST_CHECK_EQUAL(memoisationExcludingSwaps.numberOfMemoisedTrades(), 0);
+
+    auto dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
+    auto buildCube = [&](const bool useMemoisation) {
+        QuantLib::ext::shared_ptr<NPVCube> cube = QuantLib::ext::make_shared<DoublePrecisionSensiCube>(
+            portfolio->ids(), today, scenarioGenerator->samples());
+        ValuationEngine engine(today, dg, simMarket);
+        if (useMemoisation)
+            engine.enableNpvMemoisation();
+        vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+        calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData->baseCcy()));
+        engine.buildCube(portfolio, cube, calculators);
+        return cube;
+    };
+
+    auto fullCube = buildCube(false);
+    auto memoisedCube = buildCube(true);
+
+    for (Size i = 0; i < portfolio->size(); ++i) {
+        BOOST_CHECK_CLOSE(memoisedCube->getT0(i), fullCube->getT0(i), 1.0E-10);
+        for (Size k = 0; k < fullCube->samples(); ++k) {
+            Real full = fullCube->get(i, 0, k), memoised = memoisedCube->get(i, 0, k);
+            BOOST_CHECK_SMALL(memoised - full, 1.0E-6 * std::max(1.0, std::abs(full)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
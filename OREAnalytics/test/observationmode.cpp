@@ -49,6 +49,7 @@
 #include <ored/utilities/osutils.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/date.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
@@ -355,6 +356,101 @@ void simulation(string dateGridString, bool checkFixings) {
     }
 }
 
+// scenario generator returning the base scenario with a single discount factor replaced, one scenario per sample
+class DiscountShiftScenarioGenerator : public ScenarioGenerator {
+public:
+    DiscountShiftScenarioGenerator(const QuantLib::ext::shared_ptr<Scenario>& baseScenario,
+                                   const vector<pair<RiskFactorKey, Real>>& shifts)
+        : baseScenario_(baseScenario), shifts_(shifts) {}
+    QuantLib::ext::shared_ptr<Scenario> next(const Date& d) override {
+        auto s = baseScenario_->clone();
+        QL_REQUIRE(sample_ < shifts_.size(), "DiscountShiftScenarioGenerator: no more scenarios");
+        auto const& [key, factor] = shifts_[sample_++];
+        if (factor != 1.0)
+            s->add(key, baseScenario_->get(key) * factor);
+        return s;
+    }
+    void reset() override { sample_ = 0; }
+
+private:
+    QuantLib::ext::shared_ptr<Scenario> baseScenario_;
+    vector<pair<RiskFactorKey, Real>> shifts_;
+    Size sample_ = 0;
+};
+
+// value a EUR and a USD swap under scenarios shifting the EUR and USD discount curves at today's date
+vector<Real> trackedScenarioValues(ObservationMode::Mode mode, Size& tradeUpdates, Size& tradeUpdatesSkipped) {
+    SavedSettings backup;
+    ObservationMode::instance().setMode(mode);
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+
+    auto parameters = QuantLib::ext::make_shared<analytics::ScenarioSimMarketParameters>();
+    parameters->baseCcy() = "EUR";
+    parameters->setDiscountCurveNames({"EUR", "USD"});
+    parameters->setYieldCurveTenors("",
+                                    {1 * Months, 6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years, 20 * Years});
+    parameters->setIndices({"EUR-EURIBOR-6M", "USD-LIBOR-3M"});
+    parameters->interpolation() = "LogLinear";
+    parameters->setSwapVolTerms("", {6 * Months, 1 * Years});
+    parameters->setSwapVolExpiries("", {1 * Years, 2 * Years});
+    parameters->setSwapVolKeys({"EUR", "USD"});
+    parameters->swapVolDecayMode() = "ForwardVariance";
+    parameters->setSimulateSwapVols(false);
+    parameters->setFxVolExpiries("", vector<Period>{1 * Months, 3 * Months, 6 * Months, 2 * Years});
+    parameters->setFxVolDecayMode(string("ConstantVariance"));
+    parameters->setSimulateFXVols(false);
+    parameters->setFxVolCcyPairs({"USDEUR"});
+    parameters->setFxCcyPairs({"USDEUR"});
+
+    auto simMarket = QuantLib::ext::make_shared<analytics::ScenarioSimMarket>(initMarket, parameters);
+    RiskFactorKey eurKey(RiskFactorKey::KeyType::DiscountCurve, "EUR", 4);
+    RiskFactorKey usdKey(RiskFactorKey::KeyType::DiscountCurve, "USD", 4);
+    // sample 0: base, 1 and 2: EUR shifted, 3: USD shifted (and EUR back to base)
+    vector<pair<RiskFactorKey, Real>> shifts = {{eurKey, 1.0}, {eurKey, 0.99}, {eurKey, 0.98}, {usdKey, 0.99}};
+    simMarket->scenarioGenerator() =
+        QuantLib::ext::make_shared<DiscountShiftScenarioGenerator>(simMarket->baseScenario(), shifts);
+
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    QuantLib::ext::shared_ptr<EngineFactory> factory = QuantLib::ext::make_shared<EngineFactory>(data, simMarket);
+
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    for (auto const& [ccy, index, floatFreq] :
+         vector<std::tuple<string, string, string>>{{"EUR", "EUR-EURIBOR-6M", "6M"}, {"USD", "USD-LIBOR-3M", "3M"}}) {
+        ScheduleData floatSchedule(ScheduleRules("2016-05-16", "2026-05-16", floatFreq, "TARGET", "MF", "MF", "Forward"));
+        ScheduleData fixedSchedule(ScheduleRules("2016-05-16", "2026-05-16", "1Y", "TARGET", "MF", "MF", "Forward"));
+        LegData fixedLeg(QuantLib::ext::make_shared<FixedLegData>(vector<double>(1, 0.02)), true, ccy, fixedSchedule,
+                         "30/360", vector<double>(1, 1000000));
+        LegData floatingLeg(QuantLib::ext::make_shared<FloatingLegData>(index, 2, false, vector<double>(1, 0.0)), false,
+                            ccy, floatSchedule, "ACT/360", vector<double>(1, 1000000));
+        QuantLib::ext::shared_ptr<Trade> swap(new data::Swap(Envelope("CP"), floatingLeg, fixedLeg));
+        swap->id() = "SWAP_" + ccy;
+        portfolio->add(swap);
+    }
+    portfolio->build(factory);
+
+    auto dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
+    ValuationEngine valEngine(today, dg, simMarket);
+    QuantLib::ext::shared_ptr<NPVCube> cube =
+        QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dg->dates(), shifts.size());
+    vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+    calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>("EUR"));
+    valEngine.buildCube(portfolio, cube, calculators);
+
+    tradeUpdates = valEngine.tradeUpdates();
+    tradeUpdatesSkipped = valEngine.tradeUpdatesSkipped();
+    vector<Real> result;
+    for (Size j = 0; j < portfolio->size(); ++j)
+        for (Size k = 0; k < shifts.size(); ++k)
+            result.push_back(cube->get(j, 0, k));
+    return result;
+}
+
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(ObservationModeTest)
@@ -432,6 +528,44 @@ BOOST_AUTO_TEST_CASE(testDefer) {
     simulation("10,1Y", true);
 }
 
+BOOST_AUTO_TEST_CASE(testTrack) {
+    ObservationMode::instance().setMode(ObservationMode::Mode::Track);
+    setConventions();
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Track, Long Grid, No Fixing Checks");
+    simulation("11,1Y", false);
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Track, Long Grid, With Fixing Checks");
+    simulation("11,1Y", true);
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Track, Short Grid, No Fixing Checks");
+    simulation("10,1Y", false);
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Track, Short Grid, With Fixing Checks");
+    simulation("10,1Y", true);
+}
+
+BOOST_AUTO_TEST_CASE(testTrackSkipsUnaffectedTrades) {
+    BOOST_TEST_MESSAGE("Testing Observation Mode Track only updates trades depending on changed quotes");
+    setConventions();
+
+    Size updates, skipped;
+    vector<Real> reference = trackedScenarioValues(ObservationMode::Mode::Disable, updates, skipped);
+    vector<Real> tracked = trackedScenarioValues(ObservationMode::Mode::Track, updates, skipped);
+
+    // sample 0 updates both trades (new valuation date), samples 1 and 2 only the EUR swap, sample 3 both swaps
+    BOOST_CHECK_EQUAL(updates, 6);
+    BOOST_CHECK_EQUAL(skipped, 2);
+
+    BOOST_REQUIRE_EQUAL(reference.size(), tracked.size());
+    for (Size i = 0; i < reference.size(); ++i)
+        BOOST_CHECK_CLOSE(reference[i], tracked[i], 1E-10);
+    // the EUR swap reacts to the EUR shifts, the USD swap to the USD shift
+    BOOST_CHECK(std::abs(tracked[1] - tracked[0]) > 1.0);
+    BOOST_CHECK(std::abs(tracked[2] - tracked[1]) > 1.0);
+    BOOST_CHECK(std::abs(tracked[7] - tracked[6]) > 1.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
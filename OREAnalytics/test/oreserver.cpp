@@ -0,0 +1,247 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/algorithm/string.hpp>
+#include <boost/test/unit_test.hpp>
+#include <orea/app/oreserver.hpp>
+#include <orea/app/todaysmarketcache.hpp>
+#include <ored/marketdata/inmemoryloader.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore::data;
+using namespace ore::analytics;
+using boost::filesystem::path;
+
+namespace {
+
+// ORE parameters with the test inputs and an npv analytic writing to the given output path
+QuantLib::ext::shared_ptr<Parameters> serverParameters(const string& outputPath) {
+    string xml = "<ORE><Setup>"
+                 "<Parameter name=\"asofDate\">2016-02-05</Parameter>"
+                 "<Parameter name=\"inputPath\">" +
+                 TEST_INPUT +
+                 "</Parameter>"
+                 "<Parameter name=\"outputPath\">" +
+                 outputPath +
+                 "</Parameter>"
+                 "<Parameter name=\"logFile\">log.txt</Parameter>"
+                 "<Parameter name=\"logMask\">31</Parameter>"
+                 "<Parameter name=\"marketDataFile\">market.txt</Parameter>"
+                 "<Parameter name=\"fixingDataFile\">fixings.txt</Parameter>"
+                 "<Parameter name=\"curveConfigFile\">curveconfig.xml</Parameter>"
+                 "<Parameter name=\"conventionsFile\">conventions.xml</Parameter>"
+                 "<Parameter name=\"marketConfigFile\">todaysmarket.xml</Parameter>"
+                 "<Parameter name=\"pricingEnginesFile\">pricingengine.xml</Parameter>"
+                 "<Parameter name=\"portfolioFile\">portfolio.xml</Parameter>"
+                 "</Setup><Markets>"
+                 "<Parameter name=\"lgmcalibration\">default</Parameter>"
+                 "<Parameter name=\"fxcalibration\">default</Parameter>"
+                 "<Parameter name=\"pricing\">default</Parameter>"
+                 "<Parameter name=\"simulation\">default</Parameter>"
+                 "</Markets><Analytics><Analytic type=\"npv\">"
+                 "<Parameter name=\"active\">Y</Parameter>"
+                 "<Parameter name=\"baseCurrency\">EUR</Parameter>"
+                 "<Parameter name=\"outputFileName\">npv.csv</Parameter>"
+                 "</Analytic></Analytics></ORE>";
+    auto params = QuantLib::ext::make_shared<Parameters>();
+    params->fromXMLString(xml);
+    return params;
+}
+
+// trade id => base currency npv from the npv report
+map<string, Real> readNpvs(const string& fileName) {
+    ifstream in(fileName);
+    BOOST_REQUIRE(in.is_open());
+    string line;
+    BOOST_REQUIRE(getline(in, line));
+    boost::trim_left_if(line, boost::is_any_of("#"));
+    vector<string> header;
+    boost::split(header, line, boost::is_any_of(","));
+    auto idColumn = std::distance(header.begin(), std::find(header.begin(), header.end(), "TradeId"));
+    auto npvColumn = std::distance(header.begin(), std::find(header.begin(), header.end(), "NPV(Base)"));
+    BOOST_REQUIRE(idColumn < static_cast<long>(header.size()) && npvColumn < static_cast<long>(header.size()));
+    map<string, Real> npvs;
+    while (getline(in, line)) {
+        vector<string> fields;
+        boost::split(fields, line, boost::is_any_of(","));
+        if (fields.size() == header.size())
+            npvs[fields[idColumn]] = parseReal(fields[npvColumn]);
+    }
+    return npvs;
+}
+
+// true if the response to a RUN request is OK and lists the npv report
+bool npvWritten(const string& response) {
+    vector<string> tokens;
+    boost::split(tokens, response, boost::is_any_of(" ,"));
+    return tokens.front() == "OK" && std::find(tokens.begin(), tokens.end(), "npv") != tokens.end();
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(OREServerTest)
+
+BOOST_AUTO_TEST_CASE(testRequests) {
+
+    BOOST_TEST_MESSAGE("Testing ORE server requests on warm inputs...");
+
+    string outputPath = TEST_OUTPUT;
+    string npvFile = (path(outputPath) / "npv.csv").string();
+
+    OREServer server(serverParameters(outputPath));
+
+    BOOST_CHECK(npvWritten(server.process("RUN NPV")));
+    auto npvs = readNpvs(npvFile);
+    BOOST_REQUIRE_EQUAL(npvs.size(), 1);
+    Real npv5Y = npvs.at("Swap_5Y");
+    BOOST_CHECK_EQUAL(server.cachedMarkets(), 1);
+
+    // load another trade, the cached market is reused
+    BOOST_CHECK_EQUAL(server.process("TRADES " + TEST_INPUT_FILE("trades.xml")), "OK added=1 amended=0");
+    BOOST_CHECK(npvWritten(server.process("RUN NPV")));
+    npvs = readNpvs(npvFile);
+    BOOST_REQUIRE_EQUAL(npvs.size(), 2);
+    BOOST_CHECK_CLOSE(npvs.at("Swap_5Y"), npv5Y, 1.0E-10);
+    BOOST_CHECK_EQUAL(server.cachedMarkets(), 1);
+
+    // a quote update updates the cached market in place
+    BOOST_CHECK_EQUAL(server.process("QUOTES " + TEST_INPUT_FILE("quotes.txt")), "OK quotes=1 markets=1 removed=0");
+    BOOST_CHECK_EQUAL(server.cachedMarkets(), 1);
+    BOOST_CHECK(npvWritten(server.process("RUN NPV")));
+    auto updatedNpvs = readNpvs(npvFile);
+    BOOST_REQUIRE_EQUAL(updatedNpvs.size(), 2);
+    BOOST_CHECK(std::abs(updatedNpvs.at("Swap_5Y") - npv5Y) > 1.0);
+
+    // run on a subset, remove a trade, errors
+    BOOST_CHECK(npvWritten(server.process("RUN NPV Swap_10Y")));
+    npvs = readNpvs(npvFile);
+    BOOST_REQUIRE_EQUAL(npvs.size(), 1);
+    BOOST_CHECK_CLOSE(npvs.at("Swap_10Y"), updatedNpvs.at("Swap_10Y"), 1.0E-10);
+    BOOST_CHECK_EQUAL(server.process("REMOVE Swap_5Y,Swap_1Y"), "OK removed=1");
+    BOOST_CHECK(boost::starts_with(server.process("RUN NPV Swap_5Y"), "ERROR"));
+    BOOST_CHECK(boost::starts_with(server.process("FOO"), "ERROR"));
+
+    // reload drops the quote update, the trade changes and the cached markets
+    BOOST_CHECK_EQUAL(server.process("RELOAD"), "OK");
+    BOOST_CHECK_EQUAL(server.cachedMarkets(), 0);
+    BOOST_CHECK(npvWritten(server.process("RUN NPV")));
+    npvs = readNpvs(npvFile);
+    BOOST_REQUIRE_EQUAL(npvs.size(), 1);
+    BOOST_CHECK_CLOSE(npvs.at("Swap_5Y"), npv5Y, 1.0E-10);
+
+    // the market updated in place matches a market built from the updated quotes
+    OREServer fresh(serverParameters(outputPath));
+    BOOST_CHECK_EQUAL(fresh.process("QUOTES " + TEST_INPUT_FILE("quotes.txt")), "OK quotes=1 markets=0 removed=0");
+    BOOST_CHECK(npvWritten(fresh.process("RUN NPV")));
+    BOOST_CHECK_EQUAL(fresh.process("TRADES " + TEST_INPUT_FILE("trades.xml")), "OK added=1 amended=0");
+    BOOST_CHECK(npvWritten(fresh.process("RUN NPV")));
+    auto freshNpvs = readNpvs(npvFile);
+    BOOST_REQUIRE_EQUAL(freshNpvs.size(), 2);
+    for (auto const& [id, npv] : freshNpvs)
+        BOOST_CHECK_CLOSE(updatedNpvs.at(id), npv, 1.0E-8);
+}
+
+BOOST_AUTO_TEST_CASE(testCommandLoop) {
+
+    BOOST_TEST_MESSAGE("Testing ORE server command loop...");
+
+    OREServer server(serverParameters(TEST_OUTPUT));
+
+    std::istringstream in("# comment\n"
+                          "RUN NPV\n"
+                          "\n"
+                          "TRADES " +
+                          TEST_INPUT_FILE("trades.xml") +
+                          "\n"
+                          "QUOTES " +
+                          TEST_INPUT_FILE("quotes.txt") +
+                          "\n"
+                          "RUN NPV\n"
+                          "quit\n"
+                          "RUN NPV\n");
+    std::ostringstream out;
+    server.serve(in, out);
+
+    vector<string> responses;
+    string r = boost::trim_copy(out.str());
+    boost::split(responses, r, boost::is_any_of("\n"));
+    BOOST_REQUIRE_EQUAL(responses.size(), 5);
+    BOOST_CHECK(npvWritten(responses[0]));
+    BOOST_CHECK_EQUAL(responses[1], "OK added=1 amended=0");
+    BOOST_CHECK_EQUAL(responses[2], "OK quotes=1 markets=1 removed=0");
+    BOOST_CHECK(npvWritten(responses[3]));
+    BOOST_CHECK_EQUAL(responses[4], "OK");
+}
+
+BOOST_AUTO_TEST_CASE(testTodaysMarketCacheKey) {
+
+    BOOST_TEST_MESSAGE("Testing today's market cache key...");
+
+    Date asof(5, Feb, 2016);
+    TodaysMarketParameters todaysMarketParams;
+    todaysMarketParams.fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    CurveConfigurations curveConfigs;
+    curveConfigs.fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto loader = QuantLib::ext::make_shared<InMemoryLoader>();
+    auto otherLoader = QuantLib::ext::make_shared<InMemoryLoader>();
+    IborFallbackConfig fallbackConfig = IborFallbackConfig::defaultConfig();
+    IborFallbackConfig noFallbackConfig(false, false, false, {});
+
+    TodaysMarketCache cache;
+    auto key = [&](const Loader& l, bool continueOnError, bool lazyBuild, const string& excludeRegex,
+                   const IborFallbackConfig& c) {
+        return TodaysMarketCache::key(asof, todaysMarketParams, curveConfigs, l, continueOnError, lazyBuild,
+                                      excludeRegex, c);
+    };
+    cache.add(key(*loader, false, true, "", fallbackConfig), {loader, nullptr});
+
+    // equal configurations in different objects share the entry
+    TodaysMarketParameters todaysMarketParams2;
+    todaysMarketParams2.fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    TodaysMarketCache::Entry entry;
+    BOOST_CHECK(cache.get(TodaysMarketCache::key(asof, todaysMarketParams2, curveConfigs, *loader, false, true, "",
+                                                 IborFallbackConfig::defaultConfig()),
+                          entry));
+    BOOST_CHECK(entry.loader == loader);
+
+    // a change of the loader or of one of the build flags is a miss
+    BOOST_CHECK(!cache.get(key(*otherLoader, false, true, "", fallbackConfig), entry));
+    BOOST_CHECK(!cache.get(key(*loader, true, true, "", fallbackConfig), entry));
+    BOOST_CHECK(!cache.get(key(*loader, false, false, "", fallbackConfig), entry));
+    BOOST_CHECK(!cache.get(key(*loader, false, true, "BOND_.*", fallbackConfig), entry));
+    BOOST_CHECK(!cache.get(key(*loader, false, true, "", noFallbackConfig), entry));
+    BOOST_CHECK(!cache.get(TodaysMarketCache::key(asof + 1, todaysMarketParams, curveConfigs, *loader, false, true, "",
+                                                  fallbackConfig),
+                           entry));
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
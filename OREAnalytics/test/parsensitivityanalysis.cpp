@@ -50,6 +50,7 @@
 #include <ored/utilities/osutils.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <ql/math/comparison.hpp>
 #include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/date.hpp>
@@ -1567,6 +1568,64 @@ void ParSensitivityAnalysisTest::test2dZeroShifts() {
     IndexManager::instance().clearHistories();
 }
 
+void ParSensitivityAnalysisTest::testParJacobianMultiThreaded() {
+    BOOST_TEST_MESSAGE("Testing multi-threaded par instrument sensitivities");
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipping test, requires a build with QL_ENABLE_SESSIONS = ON");
+#else
+    SavedSettings backup;
+    ObservationMode::Mode backupMode = ObservationMode::instance().mode();
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData = setupSimMarketData5();
+    QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData = setupSensitivityScenarioData5(true);
+
+    // align the pillars once, both par analyses below use the same sim market parameters
+    ParSensitivityAnalysis(today, simMarketData, *sensiData, Market::defaultConfiguration).alignPillars();
+
+    auto buildSimMarket = [&simMarketData, today]() {
+        return QuantLib::ext::make_shared<analytics::ScenarioSimMarket>(
+            QuantLib::ext::make_shared<TestMarket>(today), simMarketData);
+    };
+
+    auto computeJacobian = [&](Size nThreads) {
+        auto simMarket = buildSimMarket();
+        QuantLib::ext::shared_ptr<Scenario> baseScenario = simMarket->baseScenario();
+        simMarket->scenarioGenerator() = QuantLib::ext::make_shared<SensitivityScenarioGenerator>(
+            sensiData, baseScenario, simMarketData, simMarket,
+            QuantLib::ext::make_shared<DeltaScenarioFactory>(baseScenario), false);
+        ParSensitivityAnalysis parAnalysis(today, simMarketData, *sensiData, Market::defaultConfiguration);
+        parAnalysis.computeParInstrumentSensitivities(simMarket, nThreads,
+                                                      [&buildSimMarket](Size) { return buildSimMarket(); });
+        return parAnalysis.parSensitivities();
+    };
+
+    auto serial = computeJacobian(1);
+    auto parallel = computeJacobian(4);
+
+    BOOST_CHECK(!serial.empty());
+    BOOST_CHECK_EQUAL(serial.size(), parallel.size());
+    for (auto const& [keys, value] : serial) {
+        auto p = parallel.find(keys);
+        if (p == parallel.end()) {
+            BOOST_ERROR("par sensitivity " << keys.first << " w.r.t. " << keys.second
+                                           << " missing in multi-threaded result");
+            continue;
+        }
+        BOOST_CHECK_MESSAGE(QuantLib::close_enough(value, p->second),
+                            "par sensitivity " << keys.first << " w.r.t. " << keys.second << ": serial " << value
+                                               << ", multi-threaded " << p->second);
+    }
+
+    ObservationMode::instance().setMode(backupMode);
+    IndexManager::instance().clearHistories();
+#endif
+}
+
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(ParSensitivityAnalysis)
@@ -1606,6 +1665,11 @@ BOOST_AUTO_TEST_CASE(ParConversionUnregisterObs) {
     ParSensitivityAnalysisTest::testParConversionUnregisterObs();
 }
 
+BOOST_AUTO_TEST_CASE(ParJacobianMultiThreaded) {
+    BOOST_TEST_MESSAGE("Testing Par Jacobian MultiThreaded");
+    ParSensitivityAnalysisTest::testParJacobianMultiThreaded();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -49,6 +49,8 @@ public:
     static void testParConversionDeferObs();
     //! Test par conversion of sensitivities ("Unregister" observation mode)
     static void testParConversionUnregisterObs();
+    //! Test that the multi-threaded par instrument sensitivities match the single-threaded ones
+    static void testParJacobianMultiThreaded();
     static boost::unit_test_framework::test_suite* suite();
 };
 } // namespace testsuite
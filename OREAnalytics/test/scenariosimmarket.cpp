@@ -22,6 +22,8 @@
 #include <ored/configuration/conventions.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/marketdata/marketimpl.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
 #include <ored/utilities/log.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/termstructures/credit/flathazardrate.hpp>
@@ -33,9 +35,12 @@
 #include <test/oreatoplevelfixture.hpp>
 
 #include "testmarket.hpp"
+#include "testportfolio.hpp"
 
 #include <ql/indexes/ibor/all.hpp>
 
+#include <mutex>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace boost::unit_test_framework;
@@ -43,6 +48,11 @@ using namespace std;
 using namespace ore;
 using namespace ore::data;
 
+using testsuite::buildCap;
+using testsuite::buildEuropeanSwaption;
+using testsuite::buildFxOption;
+using testsuite::buildSwap;
+using testsuite::TestConfigurationObjects;
 using testsuite::TestMarket;
 
 namespace {
@@ -306,6 +316,100 @@ BOOST_AUTO_TEST_CASE(testScenarioSimMarket) {
     testToXML(parameters);
 }
 
+BOOST_AUTO_TEST_CASE(testParallelPortfolioBuild) {
+    BOOST_TEST_MESSAGE("Testing portfolio built in parallel against ScenarioSimMarkets...");
+
+    SavedSettings backup;
+
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    auto parameters = TestConfigurationObjects::setupSimMarketData5();
+    auto simMarket = QuantLib::ext::make_shared<analytics::ScenarioSimMarket>(initMarket, parameters);
+
+    auto data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    data->model("EuropeanSwaption") = "BlackBachelier";
+    data->engine("EuropeanSwaption") = "BlackBachelierSwaptionEngine";
+    data->model("FxOption") = "GarmanKohlhagen";
+    data->engine("FxOption") = "AnalyticEuropeanEngine";
+    data->model("CapFloor") = "IborCapModel";
+    data->engine("CapFloor") = "IborCapEngine";
+
+    // every worker of the parallel build creates its own sim market and factory, the sim markets are collected
+    std::mutex mutex;
+    std::vector<QuantLib::ext::shared_ptr<analytics::ScenarioSimMarket>> workerSimMarkets;
+    auto factoryMaker = [&data, &parameters, &mutex, &workerSimMarkets](Size) {
+        auto m = QuantLib::ext::make_shared<analytics::ScenarioSimMarket>(
+            QuantLib::ext::make_shared<TestMarket>(Settings::instance().evaluationDate()), parameters);
+        std::lock_guard<std::mutex> lock(mutex);
+        workerSimMarkets.push_back(m);
+        return QuantLib::ext::make_shared<EngineFactory>(data, m);
+    };
+
+    auto makePortfolio = []() {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        for (Size i = 0; i < 5; ++i) {
+            string n = std::to_string(i);
+            portfolio->add(buildSwap("Swap_EUR_" + n, "EUR", true, 10000000.0, 0, 5 + i, 0.03, 0.00, "1Y", "30/360",
+                                     "6M", "A360", "EUR-EURIBOR-6M"));
+            portfolio->add(buildSwap("Swap_USD_" + n, "USD", true, 10000000.0, 0, 5 + i, 0.02, 0.00, "6M", "30/360",
+                                     "3M", "A360", "USD-LIBOR-3M"));
+            portfolio->add(buildEuropeanSwaption("Swaption_EUR_" + n, "Long", "EUR", true, 1000000.0, 1 + i, 5, 0.02,
+                                                 0.00, "1Y", "30/360", "6M", "A360", "EUR-EURIBOR-6M", "Physical"));
+            portfolio->add(buildFxOption("FxOption_EUR_USD_" + n, "Long", "Call", 1 + i, "EUR", 10000000.0, "USD",
+                                         11000000.0));
+            portfolio->add(buildCap("Cap_EUR_" + n, "EUR", "Long", 0.05, 1000000.0, 0, 5 + i, "6M", "A360",
+                                    "EUR-EURIBOR-6M"));
+        }
+        return portfolio;
+    };
+
+    auto serial = makePortfolio();
+    serial->build(QuantLib::ext::make_shared<EngineFactory>(data, simMarket));
+    auto parallel = makePortfolio();
+    parallel->build(factoryMaker, 4);
+    BOOST_REQUIRE_EQUAL(parallel->size(), serial->size());
+#ifdef QL_ENABLE_SESSIONS
+    BOOST_CHECK_EQUAL(workerSimMarkets.size(), 4);
+#endif
+
+    auto checkNpvs = [&serial, &parallel]() {
+        map<string, Real> npvs;
+        for (auto const& [id, t] : serial->trades()) {
+            auto p = parallel->get(id);
+            BOOST_REQUIRE(p != nullptr);
+            npvs[id] = t->instrument()->NPV();
+            BOOST_CHECK_CLOSE(p->instrument()->NPV(), npvs[id], 1.0E-10);
+        }
+        return npvs;
+    };
+
+    BOOST_TEST_MESSAGE("Checking NPVs for the base scenario...");
+    auto baseNpvs = checkNpvs();
+
+    // the trades built in parallel observe the sim market of their worker
+    auto scenario = simMarket->baseScenario()->clone();
+    auto keys = scenario->keys();
+    for (auto const& key : keys) {
+        if (key.keytype == analytics::RiskFactorKey::KeyType::DiscountCurve)
+            scenario->add(key, scenario->get(key) * 0.99);
+    }
+    simMarket->applyScenario(scenario);
+    for (auto const& m : workerSimMarkets)
+        m->applyScenario(scenario);
+
+    BOOST_TEST_MESSAGE("Checking NPVs for the shifted scenario...");
+    auto shiftedNpvs = checkNpvs();
+    Size changed = 0;
+    for (auto const& [id, npv] : shiftedNpvs) {
+        if (!QuantLib::close_enough(npv, baseNpvs[id]))
+            ++changed;
+    }
+    BOOST_CHECK_EQUAL(changed, shiftedNpvs.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
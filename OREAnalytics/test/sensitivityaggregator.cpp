@@ -16,7 +16,9 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <orea/engine/compactsensitivitystream.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <oret/toplevelfixture.hpp>
@@ -26,6 +28,7 @@
 using namespace boost::unit_test_framework;
 using namespace std;
 
+using ore::analytics::CompactSensitivityStream;
 using ore::analytics::RiskFactorKey;
 using ore::analytics::SensitivityAggregator;
 using ore::analytics::SensitivityInMemoryStream;
@@ -240,6 +243,54 @@ BOOST_AUTO_TEST_CASE(testGeneralAggregationFunctionCategories) {
     check(expAggregationAll, res, "all_except_002");
 }
 
+BOOST_AUTO_TEST_CASE(testCompactStreamAggregation) {
+
+    BOOST_TEST_MESSAGE("Testing aggregation of a compact sensitivity stream");
+
+    SensitivityInMemoryStream ss(records.begin(), records.end());
+    CompactSensitivityStream cs(ss);
+    BOOST_CHECK_EQUAL(cs.size(), records.size());
+
+    // trade ids, keys and strings are interned
+    BOOST_CHECK_EQUAL(cs.tradeIdDictionary().size(), QuantLib::Size(7));
+    BOOST_CHECK_EQUAL(cs.stringDictionary().size(), QuantLib::Size(8));
+
+    // the stream reproduces the records
+    set<SensitivityRecord> streamed;
+    while (SensitivityRecord sr = cs.next())
+        streamed.insert(sr);
+    check(records, streamed, "compact stream");
+
+    set<pair<string, QuantLib::Size>> trades = {make_pair("trade_001", 0), make_pair("trade_003", 1),
+                                                make_pair("trade_004", 2), make_pair("trade_005", 3),
+                                                make_pair("trade_006", 4)};
+    map<string, set<std::pair<std::string, QuantLib::Size>>> categories;
+    for (const auto& trade : trades)
+        categories[trade.first] = {trade};
+    categories["all_except_002"] = trades;
+
+    SensitivityAggregator sAgg(categories);
+    sAgg.aggregate(cs);
+    for (const auto& trade : trades)
+        check(filter(records, trade.first), sAgg.sensitivities(trade.first), trade.first);
+    check(expAggregationAll, sAgg.sensitivities("all_except_002"), "all_except_002");
+
+    // binary round trip
+    string fileName = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    cs.toBinaryFile(fileName);
+    auto restored = CompactSensitivityStream::fromBinaryFile(fileName);
+    BOOST_REQUIRE_EQUAL(restored->size(), cs.size());
+    for (QuantLib::Size i = 0; i < cs.size(); ++i) {
+        SensitivityRecord r1 = cs.record(i), r2 = restored->record(i);
+        BOOST_CHECK_EQUAL(r1, r2);
+        BOOST_CHECK_EQUAL(r1.desc_1, r2.desc_1);
+        BOOST_CHECK_EQUAL(r1.currency, r2.currency);
+        BOOST_CHECK_EQUAL(r1.delta, r2.delta);
+        BOOST_CHECK_EQUAL(r1.gamma, r2.gamma);
+    }
+    boost::filesystem::remove(fileName);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
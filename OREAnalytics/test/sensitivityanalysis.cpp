@@ -49,10 +49,14 @@
 #include <ored/portfolio/commodityoption.hpp>
 #include <ored/portfolio/equityforward.hpp>
 #include <ored/portfolio/equityoption.hpp>
+#include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/fxoption.hpp>
 #include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/scriptedtrade.hpp>
 #include <ored/portfolio/swap.hpp>
 #include <ored/portfolio/swaption.hpp>
+#include <ored/scripting/engines/scriptedinstrumentpricingenginecg.hpp>
+#include <ored/scripting/scriptedinstrument.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -841,6 +845,11 @@ BOOST_AUTO_TEST_CASE(testPortfolioSensitivityUnregisterObs) {
     testPortfolioSensitivity(ObservationMode::Mode::Unregister);
 }
 
+BOOST_AUTO_TEST_CASE(testPortfolioSensitivityTrackObs) {
+    BOOST_TEST_MESSAGE("Testing Portfolio sensitivity (Track observation mode)");
+    testPortfolioSensitivity(ObservationMode::Mode::Track);
+}
+
 void test1dShifts(bool granular) {
     BOOST_TEST_MESSAGE("Testing 1d shifts " << (granular ? "granular" : "sparse"));
 
@@ -1993,6 +2002,284 @@ BOOST_AUTO_TEST_CASE(testCrossGamma) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testAnalyticDeltaGammaAgainstRepricing) {
+
+    BOOST_TEST_MESSAGE("Testing analytic delta gamma scenario npvs against full repricing...");
+
+    SavedSettings backup;
+
+    ObservationMode::Mode backupMode = ObservationMode::instance().mode();
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData =
+        TestConfigurationObjects::setupSimMarketData5();
+    QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData =
+        TestConfigurationObjects::setupSensitivityScenarioData5();
+
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    data->model("FxForward") = "DiscountedCashflows";
+    data->engine("FxForward") = "DiscountingFxForwardEngine";
+
+    auto buildPortfolio = [&today]() {
+        QuantLib::ext::shared_ptr<Portfolio> portfolio(new Portfolio());
+        portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M",
+                                 "A360", "EUR-EURIBOR-6M"));
+        portfolio->add(buildSwap("2_Swap_USD", "USD", false, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M",
+                                 "A360", "USD-LIBOR-3M"));
+        auto fxForward = QuantLib::ext::make_shared<ore::data::FxForward>(
+            Envelope("CP"), ore::data::to_string(today + 2 * Years), "EUR", 10000000.0, "USD", 11000000.0);
+        fxForward->id() = "3_FxForward_EUR_USD";
+        portfolio->add(fxForward);
+        return portfolio;
+    };
+
+    auto runSensitivities = [&](const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const bool analytic) {
+        auto sa = QuantLib::ext::make_shared<SensitivityAnalysis>(portfolio, initMarket, Market::defaultConfiguration,
+                                                                  data, simMarketData, sensiData, false);
+        sa->useAnalyticDeltaGamma(analytic);
+        sa->generateSensitivities();
+        return sa;
+    };
+
+    auto portfolioAnalytic = buildPortfolio();
+    auto portfolioRepriced = buildPortfolio();
+    auto saAnalytic = runSensitivities(portfolioAnalytic, true);
+    auto saRepriced = runSensitivities(portfolioRepriced, false);
+
+    // the swaps and the fx forward are priced with the delta gamma engines in analytic mode only
+    for (auto const& [id, trade] : portfolioAnalytic->trades()) {
+        auto wrapper = trade->instrument();
+        BOOST_REQUIRE(wrapper != nullptr && wrapper->qlInstrument() != nullptr);
+        BOOST_CHECK_MESSAGE(wrapper->qlInstrument()->additionalResults().count("bucketTimes") == 1,
+                            "trade " << id << " is not priced with a delta gamma engine");
+    }
+    for (auto const& [id, trade] : portfolioRepriced->trades())
+        BOOST_CHECK(trade->instrument()->qlInstrument()->additionalResults().count("bucketTimes") == 0);
+
+    // the second order expansion matches the full repricing up to the differences in the mapping of the shifts
+    // to the curves, the fx deltas are exact
+    auto const& cubeAnalytic = saAnalytic->sensiCube();
+    auto const& cubeRepriced = saRepriced->sensiCube();
+    Size count = 0;
+    for (auto const& [id, trade] : portfolioRepriced->trades()) {
+        BOOST_CHECK_CLOSE(cubeAnalytic->npv(id), cubeRepriced->npv(id), 1.0E-8);
+        Real maxDelta = 0.0;
+        for (auto const& f : cubeRepriced->factors())
+            maxDelta = std::max(maxDelta, std::abs(cubeRepriced->delta(id, f)));
+        for (auto const& f : cubeRepriced->factors()) {
+            Real delta = cubeRepriced->delta(id, f);
+            if (std::abs(delta) < 1.0E-4 * maxDelta)
+                continue;
+            Real deltaAnalytic = cubeAnalytic->delta(id, f);
+            BOOST_CHECK_MESSAGE(std::abs(deltaAnalytic - delta) <= 0.01 * std::abs(delta),
+                                "delta " << id << " " << cubeRepriced->factorDescription(f) << ": analytic "
+                                         << deltaAnalytic << ", repriced " << delta);
+            Real gamma = cubeRepriced->gamma(id, f);
+            Real gammaAnalytic = cubeAnalytic->gamma(id, f);
+            BOOST_CHECK_MESSAGE(std::abs(gammaAnalytic - gamma) <= 0.05 * std::abs(gamma) + 1.0E-4 * std::abs(delta),
+                                "gamma " << id << " " << cubeRepriced->factorDescription(f) << ": analytic "
+                                         << gammaAnalytic << ", repriced " << gamma);
+            ++count;
+        }
+    }
+    BOOST_TEST_MESSAGE("number of deltas and gammas checked = " << count);
+    BOOST_CHECK(count > 0);
+
+    ObservationMode::instance().setMode(backupMode);
+    IndexManager::instance().clearHistories();
+}
+
+BOOST_AUTO_TEST_CASE(testEnableScriptedTradeAdProductTags) {
+
+    BOOST_TEST_MESSAGE("Testing that AD is enabled per scripted trade product tag...");
+
+    EngineData ed;
+    ed.model("ScriptedTrade") = "Generic";
+    ed.engine("ScriptedTrade") = "Generic";
+    auto& modelParams = ed.modelParameters("ScriptedTrade");
+    auto& engineParams = ed.engineParameters("ScriptedTrade");
+    modelParams["Model"] = "GaussianCam";
+    modelParams["Model_LocalVolTag"] = "LocalVol";
+    modelParams["Model_BlackScholesTag"] = "BlackScholes";
+    engineParams["Engine"] = "MC";
+    engineParams["Engine_FdTag"] = "FD";
+    engineParams["UseAD_ExplicitTag"] = "false";
+
+    // product priced with a non generic model is not touched
+    ed.model("Swap") = "DiscountedCashflows";
+    ed.engine("Swap") = "DiscountingSwapEngine";
+    ed.engineParameters("Swap");
+
+    enableScriptedTradeAd(ed);
+
+    auto const& p = ed.engineParameters("ScriptedTrade");
+    auto value = [&p](const std::string& k) { return p.count(k) == 0 ? std::string("<none>") : p.at(k); };
+    BOOST_CHECK_EQUAL(value("UseAD"), "true");
+    BOOST_CHECK_EQUAL(value("UseAD_LocalVolTag"), "false");
+    BOOST_CHECK_EQUAL(value("UseAD_FdTag"), "false");
+    BOOST_CHECK_EQUAL(value("UseAD_ExplicitTag"), "false");
+    // the unqualified UseAD already applies to the black scholes tag
+    BOOST_CHECK_EQUAL(value("UseAD_BlackScholesTag"), "<none>");
+    BOOST_CHECK(ed.engineParameters("Swap").empty());
+
+    // a non AD capable default model, AD is only switched on for the capable tag
+    EngineData ed2;
+    ed2.model("ScriptedTrade") = "Generic";
+    ed2.engine("ScriptedTrade") = "Generic";
+    ed2.modelParameters("ScriptedTrade")["Model"] = "LocalVol";
+    ed2.modelParameters("ScriptedTrade")["Model_CamTag"] = "GaussianCam";
+    ed2.engineParameters("ScriptedTrade")["Engine"] = "MC";
+    enableScriptedTradeAd(ed2);
+    auto const& p2 = ed2.engineParameters("ScriptedTrade");
+    BOOST_CHECK(p2.find("UseAD") == p2.end());
+    BOOST_CHECK(p2.find("UseAD_CamTag") != p2.end() && p2.at("UseAD_CamTag") == "true");
+
+    // an explicit unqualified UseAD is kept and applies to all tags
+    EngineData ed3;
+    ed3.model("ScriptedTrade") = "Generic";
+    ed3.engine("ScriptedTrade") = "Generic";
+    ed3.modelParameters("ScriptedTrade")["Model"] = "GaussianCam";
+    ed3.modelParameters("ScriptedTrade")["Model_BlackScholesTag"] = "BlackScholes";
+    ed3.engineParameters("ScriptedTrade")["Engine"] = "MC";
+    ed3.engineParameters("ScriptedTrade")["UseAD"] = "false";
+    enableScriptedTradeAd(ed3);
+    auto const& p3 = ed3.engineParameters("ScriptedTrade");
+    BOOST_CHECK_EQUAL(p3.at("UseAD"), "false");
+    BOOST_CHECK(p3.find("UseAD_BlackScholesTag") == p3.end());
+}
+
+BOOST_AUTO_TEST_CASE(testScriptedTradeAdAgainstBumping) {
+
+    BOOST_TEST_MESSAGE("Testing AD deltas of a scripted trade against bump and revaluation...");
+
+    SavedSettings backup;
+
+    ObservationMode::Mode backupMode = ObservationMode::instance().mode();
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData =
+        TestConfigurationObjects::setupSimMarketData5();
+    QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData =
+        TestConfigurationObjects::setupSensitivityScenarioData5();
+    sensiData->computeGamma() = false;
+
+    // the bumped run uses the same cg engine and seed as the AD run, only the cached sensis are not used
+    auto engineData = [](const bool useCg) {
+        auto data = QuantLib::ext::make_shared<EngineData>();
+        data->model("ScriptedTrade") = "Generic";
+        data->engine("ScriptedTrade") = "Generic";
+        auto& modelParams = data->modelParameters("ScriptedTrade");
+        modelParams["Model"] = "BlackScholes";
+        modelParams["BaseCcy"] = "EUR";
+        modelParams["EnforceBaseCcy"] = "false";
+        modelParams["FullDynamicFx"] = "false";
+        modelParams["GridCoarsening"] = "3M(1W),1Y(1M),5Y(3M),10Y(1Y),50Y(5Y)";
+        auto& engineParams = data->engineParameters("ScriptedTrade");
+        engineParams["Engine"] = "MC";
+        engineParams["Samples"] = "10000";
+        engineParams["RegressionOrder"] = "2";
+        engineParams["TimeStepsPerYear"] = "1";
+        engineParams["Interactive"] = "false";
+        engineParams["UseCG"] = useCg ? "true" : "false";
+        return data;
+    };
+
+    auto buildPortfolio = [&today]() {
+        ScriptedTradeScriptData script(
+            "NUMBER Payoff; Payoff = PutCall * (Underlying(Expiry) - Strike);"
+            " Option = PAY(LongShort * Quantity * max(Payoff, 0), Expiry, Settlement, PayCcy);",
+            "Option", {}, {}, {}, {ScriptedTradeScriptData::CalibrationData("Underlying", {"Strike"})});
+        string expiry = ore::data::to_string(today + 2 * Years);
+        auto trade = QuantLib::ext::make_shared<ScriptedTrade>(
+            Envelope("CP"),
+            vector<ScriptedTradeEventData>{ScriptedTradeEventData("Expiry", expiry),
+                                           ScriptedTradeEventData("Settlement", expiry)},
+            vector<ScriptedTradeValueTypeData>{ScriptedTradeValueTypeData("Number", "PutCall", "1"),
+                                               ScriptedTradeValueTypeData("Number", "LongShort", "1"),
+                                               ScriptedTradeValueTypeData("Number", "Quantity", "100000"),
+                                               ScriptedTradeValueTypeData("Number", "Strike", "12.5")},
+            vector<ScriptedTradeValueTypeData>{ScriptedTradeValueTypeData("Index", "Underlying", "EQ-Lufthansa")},
+            vector<ScriptedTradeValueTypeData>{ScriptedTradeValueTypeData("Currency", "PayCcy", "EUR")},
+            vector<ScriptedTradeValueTypeData>{}, std::map<std::string, ScriptedTradeScriptData>{{"", script}}, "");
+        trade->id() = "EquityCall";
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->add(trade);
+        return portfolio;
+    };
+
+    auto pricingEngineCG = [](const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
+        auto instr = QuantLib::ext::dynamic_pointer_cast<ScriptedInstrument>(
+            portfolio->get("EquityCall")->instrument()->qlInstrument());
+        BOOST_REQUIRE(instr);
+        return QuantLib::ext::dynamic_pointer_cast<ScriptedInstrumentPricingEngineCG>(instr->pricingEngine());
+    };
+
+    auto runSensitivities = [&](const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                const QuantLib::ext::shared_ptr<EngineData>& data, const bool useAd) {
+        auto sa = QuantLib::ext::make_shared<SensitivityAnalysis>(portfolio, initMarket, Market::defaultConfiguration,
+                                                                  data, simMarketData, sensiData, false);
+        sa->useAd(useAd);
+        sa->generateSensitivities();
+        return sa;
+    };
+
+    auto portfolioAd = buildPortfolio();
+    auto portfolioBumped = buildPortfolio();
+    auto saAd = runSensitivities(portfolioAd, engineData(true), true);
+    auto saBumped = runSensitivities(portfolioBumped, engineData(true), false);
+
+    auto engineAd = pricingEngineCG(portfolioAd);
+    BOOST_REQUIRE(engineAd);
+    BOOST_CHECK(engineAd->haveCachedSensis());
+    auto engineBumped = pricingEngineCG(portfolioBumped);
+    BOOST_REQUIRE(engineBumped);
+    BOOST_CHECK(!engineBumped->haveCachedSensis());
+
+    // the AD deltas are first order, the bumped deltas contain the convexity over the shift size
+    auto const& cubeAd = saAd->sensiCube();
+    auto const& cubeBumped = saBumped->sensiCube();
+    BOOST_CHECK_CLOSE(cubeAd->npv("EquityCall"), cubeBumped->npv("EquityCall"), 1.0E-8);
+    Real maxDelta = 0.0;
+    for (auto const& f : cubeBumped->factors())
+        maxDelta = std::max(maxDelta, std::abs(cubeBumped->delta("EquityCall", f)));
+    BOOST_REQUIRE(maxDelta > 0.0);
+    Size count = 0;
+    std::set<RiskFactorKey::KeyType> keyTypes;
+    for (auto const& f : cubeBumped->factors()) {
+        Real delta = cubeBumped->delta("EquityCall", f);
+        if (std::abs(delta) < 1.0E-3 * maxDelta)
+            continue;
+        Real deltaAd = cubeAd->delta("EquityCall", f);
+        BOOST_CHECK_MESSAGE(std::abs(deltaAd - delta) <= 0.02 * std::abs(delta),
+                            "delta " << cubeBumped->factorDescription(f) << ": ad " << deltaAd << ", bumped "
+                                     << delta);
+        keyTypes.insert(f.keytype);
+        ++count;
+    }
+    BOOST_TEST_MESSAGE("number of deltas checked = " << count);
+    BOOST_CHECK(keyTypes.count(RiskFactorKey::KeyType::EquitySpot) == 1);
+    BOOST_CHECK(keyTypes.count(RiskFactorKey::KeyType::DiscountCurve) == 1);
+
+    // gamma runs do not enable AD, the configured non-cg engine is used for the repricing
+    sensiData->computeGamma() = true;
+    auto portfolioGamma = buildPortfolio();
+    runSensitivities(portfolioGamma, engineData(false), true);
+    BOOST_CHECK(pricingEngineCG(portfolioGamma) == nullptr);
+
+    ObservationMode::instance().setMode(backupMode);
+    IndexManager::instance().clearHistories();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -381,6 +381,85 @@ BOOST_AUTO_TEST_CASE(regression) {
     IndexManager::instance().clearHistories();
 }
 
+
+BOOST_AUTO_TEST_CASE(multiThreaded) {
+    BOOST_TEST_MESSAGE("Testing multi-threaded stress test against the single-threaded run");
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipping test, requires a build with QL_ENABLE_SESSIONS = ON");
+#else
+    SavedSettings backup;
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData = setupStressSimMarketData();
+    stressConv();
+
+    // five scenarios with scaled shifts, so that the slices of the worker threads differ in size
+    QuantLib::ext::shared_ptr<StressTestScenarioData> stressData = setupStressScenarioData();
+    StressTestScenarioData::StressTestData data = stressData->data().front();
+    stressData->data().clear();
+    for (Size k = 1; k <= 5; ++k) {
+        StressTestScenarioData::StressTestData scaled = data;
+        scaled.label = "stresstest_" + std::to_string(k);
+        for (auto& [_, c] : scaled.discountCurveShifts)
+            for (auto& s : c.shifts)
+                s *= k;
+        for (auto& [_, c] : scaled.indexCurveShifts)
+            for (auto& s : c.shifts)
+                s *= k;
+        for (auto& [_, f] : scaled.fxShifts)
+            f.shiftSize *= k;
+        stressData->data().push_back(scaled);
+    }
+
+    QuantLib::ext::shared_ptr<EngineData> engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    engineData->model("EuropeanSwaption") = "BlackBachelier";
+    engineData->engine("EuropeanSwaption") = "BlackBachelierSwaptionEngine";
+    engineData->model("FxOption") = "GarmanKohlhagen";
+    engineData->engine("FxOption") = "AnalyticEuropeanEngine";
+
+    QuantLib::ext::shared_ptr<Portfolio> portfolio(new Portfolio());
+    portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("2_Swap_USD", "USD", true, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->add(buildEuropeanSwaption("3_Swaption_EUR", "Long", "EUR", true, 1000000.0, 2, 5, 0.03, 0.00, "1Y",
+                                         "30/360", "6M", "A360", "EUR-EURIBOR-6M"));
+    portfolio->add(buildFxOption("4_FxOption_EUR_USD", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0));
+    portfolio->build(QuantLib::ext::make_shared<EngineFactory>(
+        engineData, QuantLib::ext::make_shared<analytics::ScenarioSimMarket>(initMarket, simMarketData)));
+
+    ore::analytics::StressTest serial(portfolio, initMarket, "default", engineData, simMarketData, stressData);
+
+    // each worker thread builds its own test market
+    ore::analytics::StressTest::MarketFactory marketFactory = [today](Size) {
+        return QuantLib::ext::make_shared<TestMarket>(today);
+    };
+    ore::analytics::StressTest multiThreaded(portfolio, initMarket, "default", engineData, simMarketData, stressData,
+                                             CurveConfigurations(), TodaysMarketParameters(), nullptr, nullptr,
+                                             IborFallbackConfig::defaultConfig(), false, 3, marketFactory);
+
+    BOOST_CHECK(serial.trades() == multiThreaded.trades());
+    BOOST_REQUIRE_EQUAL(serial.baseNPV().size(), multiThreaded.baseNPV().size());
+    BOOST_REQUIRE_EQUAL(serial.shiftedNPV().size(), multiThreaded.shiftedNPV().size());
+    BOOST_REQUIRE_EQUAL(serial.shiftedNPV().size(), portfolio->size() * stressData->data().size());
+    for (auto const& [id, npv] : serial.baseNPV()) {
+        BOOST_REQUIRE(multiThreaded.baseNPV().count(id) == 1);
+        BOOST_CHECK_CLOSE(multiThreaded.baseNPV().at(id), npv, 1.0E-10);
+    }
+    for (auto const& [key, npv] : serial.shiftedNPV()) {
+        BOOST_REQUIRE(multiThreaded.shiftedNPV().count(key) == 1);
+        BOOST_CHECK_CLOSE(multiThreaded.shiftedNPV().at(key), npv, 1.0E-10);
+    }
+    IndexManager::instance().clearHistories();
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,346 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "testportfolio.hpp"
+#include <boost/test/unit_test.hpp>
+#include <orea/app/reportwriter.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/multithreadedvaluationengine.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/engine/valuationprofile.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariogeneratordata.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/fxforward.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <ored/utilities/to_string.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/utilities/null.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::buildSwap;
+
+namespace {
+
+using Step = ValuationProfile::Step;
+
+QuantLib::ext::shared_ptr<Portfolio> fxForwardPortfolio(const Size n) {
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    for (Size i = 0; i < n; ++i) {
+        auto trade = QuantLib::ext::make_shared<ore::data::FxForward>(Envelope("CPTY_A", "NS"), "2025-07-01", "EUR",
+                                                                      1.0E6, "USD", 1.1E6);
+        trade->id() = "Trade_" + std::to_string(i);
+        portfolio->add(trade);
+    }
+    return portfolio;
+}
+
+QuantLib::ext::shared_ptr<Portfolio> swapPortfolio() {
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    for (Size i = 0; i < 6; ++i)
+        portfolio->add(buildSwap("Swap_" + std::to_string(i), "EUR", i % 2 == 0, 1.0E6, 1, 3 + i, 0.02, 0.0, "1Y",
+                                 "30/360", "6M", "A360", "EUR-EURIBOR-6M"));
+    return portfolio;
+}
+
+template <class T> T reportValue(const InMemoryReport& report, const Size row, const Size column) {
+    return boost::get<T>(report.value(row, column));
+}
+
+/* checks the counts of a profile recorded by nEngines valuation engines on the given grid, every engine applies all
+   scenarios, the trades are valued by exactly one of the engines */
+void checkProfileCounts(const ValuationProfile& profile, const Portfolio& portfolio, const Date& asof,
+                        const DateGrid& grid, const Size samples, const Size nEngines) {
+    BOOST_REQUIRE_EQUAL(profile.trades().size(), portfolio.size());
+    for (auto const& [id, t] : profile.trades()) {
+        BOOST_CHECK_EQUAL(t.tradeType, "Swap");
+        BOOST_CHECK_EQUAL(t.calculators.count, grid.dates().size() * samples);
+    }
+    BOOST_REQUIRE_EQUAL(profile.tradeTypes().size(), grid.dates().size());
+    for (auto const& d : grid.dates()) {
+        auto t = profile.tradeTypes().find(std::make_pair(string("Swap"), d));
+        BOOST_REQUIRE_MESSAGE(t != profile.tradeTypes().end(), "no trade type timing on " << d);
+        BOOST_CHECK_EQUAL(t->second.count, portfolio.size() * samples);
+        for (auto step : {Step::ApplyScenario, Step::MarketUpdate, Step::TradeCalculators}) {
+            auto s = profile.steps().find(std::make_pair(step, d));
+            BOOST_REQUIRE_MESSAGE(s != profile.steps().end(), "no timing of step " << step << " on " << d);
+            BOOST_CHECK_EQUAL(s->second.count, nEngines * samples);
+        }
+    }
+    auto fixings = profile.steps().find(std::make_pair(Step::Fixings, asof));
+    BOOST_REQUIRE(fixings != profile.steps().end());
+    BOOST_CHECK_EQUAL(fixings->second.count, nEngines * samples);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ValuationProfileTest)
+
+BOOST_AUTO_TEST_CASE(testMerge) {
+
+    BOOST_TEST_MESSAGE("Testing valuation profile merge and average trade times...");
+
+    Date d1(1, July, 2024), d2(1, January, 2025);
+
+    ValuationProfile p1, p2;
+    BOOST_CHECK(p1.empty());
+    p1.addTrade("Trade_0", "Swap", d1, 1000, 1, 800);
+    p1.addTrade("Trade_0", "Swap", d2, 3000, 2, 2500);
+    p1.addStep(Step::ApplyScenario, d1, 500);
+    p2.addTrade("Trade_0", "Swap", d1, 5000, 1, 4000);
+    p2.addTrade("Trade_1", "FxForward", d1, 2000, 1, 1500);
+    p2.addStep(Step::ApplyScenario, d1, 700);
+    p2.addStep(Step::Fixings, d1, 100);
+
+    BOOST_CHECK_CLOSE(p1.averageTradeTime("Trade_0"), 2000.0, 1.0E-12);
+    BOOST_CHECK(p1.averageTradeTime("Trade_1") == Null<Real>());
+
+    p1.merge(p2);
+    BOOST_CHECK(!p1.empty());
+
+    BOOST_REQUIRE_EQUAL(p1.trades().size(), 2);
+    auto const& t0 = p1.trades().at("Trade_0");
+    BOOST_CHECK_EQUAL(t0.tradeType, "Swap");
+    BOOST_CHECK_EQUAL(t0.calculators.count, 3);
+    BOOST_CHECK_EQUAL(t0.calculators.total, 9000);
+    BOOST_CHECK_EQUAL(t0.calculators.max, 5000);
+    BOOST_CHECK_EQUAL(t0.pricings, 4);
+    BOOST_CHECK_EQUAL(t0.pricingTime, 7300);
+    BOOST_CHECK_CLOSE(p1.averageTradeTime("Trade_0"), 3000.0, 1.0E-12);
+    BOOST_CHECK_CLOSE(p1.averageTradeTime("Trade_1"), 2000.0, 1.0E-12);
+
+    BOOST_REQUIRE_EQUAL(p1.tradeTypes().size(), 3);
+    auto const& swapD1 = p1.tradeTypes().at(std::make_pair(string("Swap"), d1));
+    BOOST_CHECK_EQUAL(swapD1.count, 2);
+    BOOST_CHECK_EQUAL(swapD1.total, 6000);
+    BOOST_CHECK_EQUAL(p1.tradeTypes().at(std::make_pair(string("Swap"), d2)).count, 1);
+
+    BOOST_REQUIRE_EQUAL(p1.steps().size(), 2);
+    auto const& apply = p1.steps().at(std::make_pair(Step::ApplyScenario, d1));
+    BOOST_CHECK_EQUAL(apply.count, 2);
+    BOOST_CHECK_EQUAL(apply.total, 1200);
+    BOOST_CHECK_EQUAL(apply.max, 700);
+    BOOST_CHECK_CLOSE(apply.average(), 600.0, 1.0E-12);
+
+    p1.clear();
+    BOOST_CHECK(p1.empty());
+    BOOST_CHECK(p1.averageTradeTime("Trade_0") == Null<Real>());
+}
+
+BOOST_AUTO_TEST_CASE(testReports) {
+
+    BOOST_TEST_MESSAGE("Testing valuation profile reports...");
+
+    Date d1(1, July, 2024), d2(1, January, 2025);
+
+    ValuationProfile p;
+    p.addTrade("Trade_0", "Swap", d1, 1000, 1, 800);
+    p.addTrade("Trade_0", "Swap", d2, 3000, 2, 2500);
+    p.addTrade("Trade_1", "FxForward", d1, 2000, 1, 1500);
+    p.addStep(Step::MarketUpdate, d1, 4000);
+    p.addStep(Step::MarketUpdate, d1, 6000);
+    p.addStep(Step::Fixings, d1, 1000);
+
+    InMemoryReport trades;
+    ReportWriter().writeValuationProfileTrades(trades, p);
+    BOOST_REQUIRE_EQUAL(trades.columns(), 8);
+    BOOST_REQUIRE_EQUAL(trades.rows(), 2);
+    BOOST_CHECK_EQUAL(trades.header(0), "TradeId");
+    BOOST_CHECK_EQUAL(reportValue<string>(trades, 0, 0), "Trade_0");
+    BOOST_CHECK_EQUAL(reportValue<string>(trades, 0, 1), "Swap");
+    BOOST_CHECK_EQUAL(reportValue<Size>(trades, 0, 2), 2);
+    BOOST_CHECK_EQUAL(reportValue<Size>(trades, 0, 3), 4);
+    BOOST_CHECK_CLOSE(reportValue<Real>(trades, 0, 4), 2.0, 1.0E-12);
+    BOOST_CHECK_EQUAL(reportValue<Size>(trades, 0, 5), 3);
+    BOOST_CHECK_EQUAL(reportValue<Size>(trades, 0, 6), 3);
+    BOOST_CHECK_EQUAL(reportValue<Size>(trades, 0, 7), 3);
+    BOOST_CHECK_EQUAL(reportValue<string>(trades, 1, 0), "Trade_1");
+
+    // per trade type the total over all dates followed by the dates
+    InMemoryReport tradeTypes;
+    ReportWriter().writeValuationProfileTradeTypes(tradeTypes, p);
+    BOOST_REQUIRE_EQUAL(tradeTypes.columns(), 6);
+    BOOST_REQUIRE_EQUAL(tradeTypes.rows(), 5);
+    vector<pair<string, string>> expected = {{"FxForward", "All"},
+                                             {"FxForward", ore::data::to_string(d1)},
+                                             {"Swap", "All"},
+                                             {"Swap", ore::data::to_string(d1)},
+                                             {"Swap", ore::data::to_string(d2)}};
+    for (Size i = 0; i < expected.size(); ++i) {
+        BOOST_CHECK_EQUAL(reportValue<string>(tradeTypes, i, 0), expected[i].first);
+        BOOST_CHECK_EQUAL(reportValue<string>(tradeTypes, i, 1), expected[i].second);
+    }
+    BOOST_CHECK_EQUAL(reportValue<Size>(tradeTypes, 2, 2), 2);
+    BOOST_CHECK_EQUAL(reportValue<Size>(tradeTypes, 2, 3), 4);
+    BOOST_CHECK_EQUAL(reportValue<Size>(tradeTypes, 4, 3), 3);
+
+    // the fixing resets are reported under the valuation date, there are no rows without a date
+    InMemoryReport steps;
+    ReportWriter().writeValuationProfileSteps(steps, p);
+    BOOST_REQUIRE_EQUAL(steps.columns(), 6);
+    BOOST_REQUIRE_EQUAL(steps.rows(), 2);
+    BOOST_CHECK_EQUAL(reportValue<string>(steps, 0, 0), "MarketUpdate");
+    BOOST_CHECK_EQUAL(reportValue<string>(steps, 0, 1), ore::data::to_string(d1));
+    BOOST_CHECK_EQUAL(reportValue<Size>(steps, 0, 2), 2);
+    BOOST_CHECK_EQUAL(reportValue<Size>(steps, 0, 3), 10);
+    BOOST_CHECK_CLOSE(reportValue<Real>(steps, 0, 4), 5.0, 1.0E-12);
+    BOOST_CHECK_EQUAL(reportValue<Size>(steps, 0, 5), 6);
+    BOOST_CHECK_EQUAL(reportValue<string>(steps, 1, 0), "Fixings");
+    BOOST_CHECK_EQUAL(reportValue<string>(steps, 1, 1), ore::data::to_string(d1));
+}
+
+BOOST_AUTO_TEST_CASE(testPortfolioSplit) {
+
+    BOOST_TEST_MESSAGE("Testing portfolio split of the multi-threaded valuation engine with a prior profile...");
+
+    auto portfolio = fxForwardPortfolio(5);
+
+    // without pricing stats and profile the trades are assigned round robin in the order of their ids
+    auto parts = splitPortfolio(portfolio, 2);
+    BOOST_REQUIRE_EQUAL(parts.size(), 2);
+    BOOST_CHECK(parts[0]->ids() == std::set<string>({"Trade_0", "Trade_2", "Trade_4"}));
+    BOOST_CHECK(parts[1]->ids() == std::set<string>({"Trade_1", "Trade_3"}));
+
+    // the pricing stats of a trade are used if the profile holds no timings for it
+    portfolio->get("Trade_4")->resetPricingStats(2, 60000);
+
+    Date d(1, July, 2024);
+    auto profile = QuantLib::ext::make_shared<ValuationProfile>();
+    profile->addTrade("Trade_0", "FxForward", d, 1000, 1, 0);
+    profile->addTrade("Trade_1", "FxForward", d, 5000, 1, 0);
+    profile->addTrade("Trade_2", "FxForward", d, 20000, 1, 0);
+    profile->addTrade("Trade_3", "FxForward", d, 40000, 1, 0);
+
+    // order by decreasing time is Trade_3 (40000), Trade_4 (30000), Trade_2 (20000), Trade_1 (5000), Trade_0 (1000)
+    parts = splitPortfolio(portfolio, 2, profile);
+    BOOST_REQUIRE_EQUAL(parts.size(), 2);
+    BOOST_CHECK(parts[0]->ids() == std::set<string>({"Trade_3", "Trade_2", "Trade_0"}));
+    BOOST_CHECK(parts[1]->ids() == std::set<string>({"Trade_4", "Trade_1"}));
+
+    parts = splitPortfolio(portfolio, 3, profile);
+    BOOST_REQUIRE_EQUAL(parts.size(), 3);
+    BOOST_CHECK(parts[0]->ids() == std::set<string>({"Trade_3", "Trade_1"}));
+    BOOST_CHECK(parts[1]->ids() == std::set<string>({"Trade_4", "Trade_0"}));
+    BOOST_CHECK(parts[2]->ids() == std::set<string>({"Trade_2"}));
+
+    BOOST_CHECK_THROW(splitPortfolio(portfolio, 0, profile), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testEngineRun) {
+
+    BOOST_TEST_MESSAGE("Testing valuation profiles recorded by the single- and multi-threaded valuation engines...");
+
+    Date asof(5, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto loader =
+        QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"), false);
+
+    auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto crossAssetModelData = QuantLib::ext::make_shared<CrossAssetModelData>();
+    crossAssetModelData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto scenarioGeneratorData = QuantLib::ext::make_shared<ScenarioGeneratorData>();
+    scenarioGeneratorData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto grid = scenarioGeneratorData->getGrid();
+    Size samples = scenarioGeneratorData->samples();
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+
+    auto initMarket = QuantLib::ext::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs, false);
+    CrossAssetModelBuilder modelBuilder(initMarket, crossAssetModelData);
+    auto scenarioGenerator = ScenarioGeneratorBuilder(scenarioGeneratorData)
+                                 .build(*modelBuilder.model(), QuantLib::ext::make_shared<SimpleScenarioFactory>(true),
+                                        simMarketData, asof, initMarket);
+
+    auto calculators = []() {
+        return vector<QuantLib::ext::shared_ptr<ValuationCalculator>>{QuantLib::ext::make_shared<NPVCalculator>("EUR")};
+    };
+
+    // single-threaded run
+
+    auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(initMarket, simMarketData);
+    simMarket->scenarioGenerator() = scenarioGenerator;
+    auto portfolio = swapPortfolio();
+    portfolio->build(QuantLib::ext::make_shared<EngineFactory>(engineData, simMarket));
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(asof, portfolio->ids(),
+                                                                        grid->valuationDates(), samples);
+
+    auto profile = QuantLib::ext::make_shared<ValuationProfile>();
+    ValuationEngine engine(asof, grid, simMarket);
+    engine.enableProfiling(profile);
+    engine.buildCube(portfolio, cube, calculators());
+
+    checkProfileCounts(*profile, *portfolio, asof, *grid, samples, 1);
+
+    // multi-threaded run, the trade counts of the merged worker profiles are the same as above
+
+#ifdef QL_ENABLE_SESSIONS
+    const Size nThreads = 3;
+    auto mtProfile = QuantLib::ext::make_shared<ValuationProfile>();
+    MultiThreadedValuationEngine mtEngine(nThreads, asof, grid, samples, loader, scenarioGenerator, engineData,
+                                          curveConfigs, todaysMarketParams, Market::defaultConfiguration,
+                                          simMarketData);
+    mtEngine.enableProfiling(mtProfile);
+    auto mtPortfolio = swapPortfolio();
+    mtEngine.buildCube(mtPortfolio, calculators);
+    BOOST_REQUIRE_EQUAL(mtEngine.outputCubes().size(), nThreads);
+
+    checkProfileCounts(*mtProfile, *mtPortfolio, asof, *grid, samples, nThreads);
+    for (auto const& [id, t] : profile->trades())
+        BOOST_CHECK_EQUAL(mtProfile->trades().at(id).calculators.count, t.calculators.count);
+    for (auto const& [key, t] : profile->tradeTypes())
+        BOOST_CHECK_EQUAL(mtProfile->tradeTypes().at(key).count, t.count);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,444 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/engine/xvaenginecg.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariogeneratordata.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/sensitivityscenariodata.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/nettingsetmanager.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/scriptedtrade.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <map>
+#include <numeric>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// netting set CPTY_A with a bilateral CSA
+QuantLib::ext::shared_ptr<NettingSetManager>
+csaNettingSetManager(const string& csaCurrency, const Real threshold, const Real mta = 0.0,
+                     const Real independentAmountHeld = 0.0, const string& marginFrequency = "1D",
+                     const Real collateralSpread = 0.0) {
+    string t = std::to_string(threshold);
+    string m = std::to_string(mta);
+    string s = std::to_string(collateralSpread);
+    string xml = "<NettingSetDefinitions><NettingSet>"
+                 "<NettingSetId>CPTY_A</NettingSetId>"
+                 "<ActiveCSAFlag>true</ActiveCSAFlag>"
+                 "<CSADetails>"
+                 "<Bilateral>Bilateral</Bilateral>"
+                 "<CSACurrency>" +
+                 csaCurrency +
+                 "</CSACurrency>"
+                 "<Index>" +
+                 (csaCurrency == "EUR" ? string("EUR-EONIA") : string("USD-SOFR")) +
+                 "</Index>"
+                 "<ThresholdPay>" +
+                 t +
+                 "</ThresholdPay>"
+                 "<ThresholdReceive>" +
+                 t +
+                 "</ThresholdReceive>"
+                 "<MinimumTransferAmountPay>" +
+                 m +
+                 "</MinimumTransferAmountPay>"
+                 "<MinimumTransferAmountReceive>" +
+                 m +
+                 "</MinimumTransferAmountReceive>"
+                 "<IndependentAmount>"
+                 "<IndependentAmountHeld>" +
+                 std::to_string(independentAmountHeld) +
+                 "</IndependentAmountHeld>"
+                 "<IndependentAmountType>FIXED</IndependentAmountType>"
+                 "</IndependentAmount>"
+                 "<MarginingFrequency><CallFrequency>" +
+                 marginFrequency + "</CallFrequency><PostFrequency>" + marginFrequency +
+                 "</PostFrequency>"
+                 "</MarginingFrequency>"
+                 "<MarginPeriodOfRisk>2W</MarginPeriodOfRisk>"
+                 "<CollateralCompoundingSpreadReceive>" +
+                 s +
+                 "</CollateralCompoundingSpreadReceive>"
+                 "<CollateralCompoundingSpreadPay>" +
+                 s + "</CollateralCompoundingSpreadPay>"
+                 "<EligibleCollaterals><Currencies><Currency>" +
+                 csaCurrency +
+                 "</Currency></Currencies></EligibleCollaterals>"
+                 "</CSADetails>"
+                 "</NettingSet></NettingSetDefinitions>";
+    auto nettingSetManager = QuantLib::ext::make_shared<NettingSetManager>();
+    nettingSetManager->fromXMLString(xml);
+    return nettingSetManager;
+}
+
+// runs the xva engine on the scripted 5Y swap against CPTY_A in the test inputs
+QuantLib::ext::shared_ptr<XvaEngineCG>
+runXvaEngineCG(const QuantLib::ext::shared_ptr<NettingSetManager>& nettingSetManager,
+               const bool withCloseOutLag = false, const bool withMporStickyDate = false,
+               const string& dvaName = string(), const string& fvaBorrowingCurve = string(),
+               const string& fvaLendingCurve = string(),
+               const QuantLib::ext::shared_ptr<SensitivityScenarioData>& sensitivityData = nullptr,
+               const bool bumpCvaSensis = false) {
+    Date asof(5, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto loader =
+        QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"), false);
+
+    auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto crossAssetModelData = QuantLib::ext::make_shared<CrossAssetModelData>();
+    crossAssetModelData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto scenarioGeneratorData = QuantLib::ext::make_shared<ScenarioGeneratorData>();
+    scenarioGeneratorData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    if (withCloseOutLag) {
+        scenarioGeneratorData->withCloseOutLag() = true;
+        scenarioGeneratorData->withMporStickyDate() = withMporStickyDate;
+        scenarioGeneratorData->closeOutLag() = 2 * Weeks;
+        scenarioGeneratorData->getGrid()->addCloseOutDates(2 * Weeks);
+    }
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+
+    return QuantLib::ext::make_shared<XvaEngineCG>(
+        1, asof, loader, curveConfigs, todaysMarketParams, simMarketData, engineData, crossAssetModelData,
+        scenarioGeneratorData, portfolio, Market::defaultConfiguration, Market::defaultConfiguration, sensitivityData,
+        nullptr, IborFallbackConfig::defaultConfig(), nettingSetManager, dvaName, fvaBorrowingCurve, fvaLendingCurve,
+        bumpCvaSensis);
+}
+
+/* classic reference for the uncollateralised CVA of the scripted swap: the vanilla swap with the same cashflows is
+   valued on the same grid by the ValuationEngine, the CVA is computed from the deflated exposures. Returns the CVA
+   and the standard error of the estimate. */
+std::pair<Real, Real> classicCva() {
+    Date asof(5, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto loader =
+        QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"), false);
+    auto initMarket = QuantLib::ext::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs, false);
+
+    auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto crossAssetModelData = QuantLib::ext::make_shared<CrossAssetModelData>();
+    crossAssetModelData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto scenarioGeneratorData = QuantLib::ext::make_shared<ScenarioGeneratorData>();
+    scenarioGeneratorData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto grid = scenarioGeneratorData->getGrid();
+    Size samples = scenarioGeneratorData->samples();
+
+    CrossAssetModelBuilder modelBuilder(initMarket, crossAssetModelData);
+    auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(initMarket, simMarketData);
+    simMarket->scenarioGenerator() =
+        ScenarioGeneratorBuilder(scenarioGeneratorData)
+            .build(*modelBuilder.model(), QuantLib::ext::make_shared<SimpleScenarioFactory>(true), simMarketData, asof,
+                   initMarket);
+    auto asd = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(grid->valuationDates().size(), samples);
+    simMarket->aggregationScenarioData() = asd;
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->fromFile(TEST_INPUT_FILE("swap.xml"));
+    portfolio->build(QuantLib::ext::make_shared<EngineFactory>(engineData, simMarket));
+
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(asof, portfolio->ids(),
+                                                                        grid->valuationDates(), samples);
+    ValuationEngine(asof, grid, simMarket)
+        .buildCube(portfolio, cube, {QuantLib::ext::make_shared<NPVCalculator>("EUR")});
+
+    auto curve = initMarket->defaultCurve("CPTY_A")->curve();
+    Real lgd = 1.0 - initMarket->recoveryRate("CPTY_A")->value();
+    std::vector<Real> pathCva(samples, 0.0);
+    Date d0 = asof;
+    for (Size k = 0; k < grid->valuationDates().size(); ++k) {
+        Date d1 = grid->valuationDates()[k];
+        Real pd = curve->survivalProbability(d0) - curve->survivalProbability(d1);
+        for (Size i = 0; i < samples; ++i)
+            pathCva[i] += lgd * pd * std::max(cube->get(0, k, i), 0.0) /
+                          asd->get(k, i, AggregationScenarioDataType::Numeraire);
+        d0 = d1;
+    }
+    Real mean = std::accumulate(pathCva.begin(), pathCva.end(), 0.0) / samples;
+    Real variance = 0.0;
+    for (auto c : pathCva)
+        variance += (c - mean) * (c - mean) / (samples - 1);
+    return std::make_pair(mean, std::sqrt(variance / samples));
+}
+
+template <class T> T reportValue(const QuantLib::ext::shared_ptr<InMemoryReport>& report, const Size row,
+                                 const Size column) {
+    return boost::get<T>(report->value(row, column));
+}
+
+// the scripted swap is set up in all test cases
+struct ScriptLibrarySetup {
+    ScriptLibrarySetup() {
+        ScriptLibraryData library;
+        library.fromFile(TEST_INPUT_FILE("scriptlibrary.xml"));
+        ScriptLibraryStorage::instance().set(std::move(library));
+    }
+    ~ScriptLibrarySetup() { ScriptLibraryStorage::instance().clear(); }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(XvaEngineCGTest)
+
+BOOST_AUTO_TEST_CASE(testActiveCsa) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG exposures and CVA with an active CSA...");
+
+    ScriptLibrarySetup setup;
+
+    auto uncollateralised = runXvaEngineCG(nullptr);
+    auto xva = uncollateralised->xvaReport();
+    BOOST_REQUIRE_EQUAL(xva->rows(), 1);
+    Real cva = reportValue<Real>(xva, 0, 2);
+    BOOST_CHECK(cva > 0.0);
+
+    // thresholds that are never reached, no collateral is posted
+    auto highThresholds = runXvaEngineCG(csaNettingSetManager("EUR", 1.0E12));
+    auto epe = uncollateralised->nettingSetExposureReport();
+    auto epeHighThresholds = highThresholds->nettingSetExposureReport();
+    BOOST_REQUIRE_EQUAL(epe->rows(), 11);
+    BOOST_REQUIRE_EQUAL(epeHighThresholds->rows(), epe->rows());
+    for (Size i = 0; i < epe->rows(); ++i) {
+        BOOST_CHECK_EQUAL(reportValue<Date>(epeHighThresholds, i, 1), reportValue<Date>(epe, i, 1));
+        BOOST_CHECK_CLOSE(reportValue<Real>(epeHighThresholds, i, 2), reportValue<Real>(epe, i, 2), 1.0E-8);
+    }
+    BOOST_CHECK_CLOSE(reportValue<Real>(highThresholds->xvaReport(), 0, 2), cva, 1.0E-8);
+
+    // zero thresholds without close-out lag, the collateral offsets the exposure on each valuation date
+    auto fullyCollateralised = runXvaEngineCG(csaNettingSetManager("EUR", 0.0));
+    auto epeFullyCollateralised = fullyCollateralised->nettingSetExposureReport();
+    BOOST_REQUIRE_EQUAL(epeFullyCollateralised->rows(), epe->rows());
+    for (Size i = 1; i < epeFullyCollateralised->rows(); ++i) {
+        BOOST_CHECK_SMALL(reportValue<Real>(epeFullyCollateralised, i, 2), 1.0E-6);
+        BOOST_CHECK_SMALL(reportValue<Real>(epeFullyCollateralised, i, 3), 1.0E-6);
+    }
+    BOOST_CHECK_SMALL(reportValue<Real>(fullyCollateralised->xvaReport(), 0, 2), 1.0E-6);
+
+    // zero thresholds with close-out lag, the exposure is the value change over the margin period of risk
+    Real cvaLag = reportValue<Real>(runXvaEngineCG(nullptr, true)->xvaReport(), 0, 2);
+    Real cvaCollateralisedLag =
+        reportValue<Real>(runXvaEngineCG(csaNettingSetManager("EUR", 0.0), true)->xvaReport(), 0, 2);
+    BOOST_CHECK(cvaLag > 0.0);
+    BOOST_CHECK(cvaCollateralisedLag > 0.0);
+    BOOST_CHECK(cvaCollateralisedLag < 0.5 * cvaLag);
+}
+
+BOOST_AUTO_TEST_CASE(testDvaAndFva) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG DVA and FVA...");
+
+    ScriptLibrarySetup setup;
+
+    auto cvaOnly = runXvaEngineCG(nullptr)->xvaReport();
+    auto xva = runXvaEngineCG(nullptr, false, false, "BANK", "BANK_EUR_BORROW", "BANK_EUR_LEND")->xvaReport();
+
+    BOOST_REQUIRE_EQUAL(xva->rows(), 1);
+    BOOST_CHECK_EQUAL(reportValue<string>(xva, 0, 0), "CPTY_A");
+    BOOST_CHECK_EQUAL(reportValue<string>(xva, 0, 1), "CPTY_A");
+    for (Size c = 2; c < 6; ++c)
+        BOOST_CHECK_MESSAGE(reportValue<Real>(xva, 0, c) > 0.0,
+                            xva->header(c) << " (" << reportValue<Real>(xva, 0, c) << ") expected to be positive");
+
+    // the CVA does not depend on the own default curve and the funding curves
+    BOOST_CHECK_CLOSE(reportValue<Real>(xva, 0, 2), reportValue<Real>(cvaOnly, 0, 2), 1.0E-8);
+
+    // without dva name and funding curves the DVA, FBA and FCA are zero
+    for (Size c = 3; c < 6; ++c)
+        BOOST_CHECK_EQUAL(reportValue<Real>(cvaOnly, 0, c), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(testStickyCloseOut) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG with sticky close-out dates...");
+
+    ScriptLibrarySetup setup;
+
+    // without collateral the close-out value is the conditional expectation of the valuation date path value, so the
+    // CVA matches the one computed on the actual close-out dates up to the cashflows in the margin period of risk and
+    // the regression error
+    Real cvaLag = reportValue<Real>(runXvaEngineCG(nullptr, true, false)->xvaReport(), 0, 2);
+    Real cvaSticky = reportValue<Real>(runXvaEngineCG(nullptr, true, true)->xvaReport(), 0, 2);
+    BOOST_CHECK(cvaSticky > 0.0);
+    BOOST_CHECK_CLOSE(cvaSticky, cvaLag, 5.0);
+
+    // with zero thresholds the exposure is the value change over the margin period of risk
+    Real cvaCollateralisedSticky =
+        reportValue<Real>(runXvaEngineCG(csaNettingSetManager("EUR", 0.0), true, true)->xvaReport(), 0, 2);
+    BOOST_CHECK(cvaCollateralisedSticky > 0.0);
+    BOOST_CHECK(cvaCollateralisedSticky < 0.5 * cvaSticky);
+}
+
+BOOST_AUTO_TEST_CASE(testIndependentAmountAndCollateralAccrual) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG independent amount and collateral accrual...");
+
+    ScriptLibrarySetup setup;
+
+    // zero thresholds without close-out lag, the independent amount held is all that is left of the exposure
+    Real ia = 1.0E6;
+    auto withIa = runXvaEngineCG(csaNettingSetManager("EUR", 0.0, 0.0, ia));
+    auto epe = withIa->nettingSetExposureReport();
+    for (Size i = 1; i < epe->rows(); ++i) {
+        BOOST_CHECK_SMALL(reportValue<Real>(epe, i, 2), 1.0E-6);
+        // the ene is deflated
+        Real ene = reportValue<Real>(epe, i, 3);
+        BOOST_CHECK_MESSAGE(ene > 0.85 * ia && ene < 1.01 * ia,
+                            "ene " << ene << " on " << reportValue<Date>(epe, i, 1) << " expected to be close to "
+                                   << ia);
+    }
+    BOOST_CHECK_SMALL(reportValue<Real>(withIa->xvaReport(), 0, 2), 1.0E-6);
+
+    // with close-out lag the collateral accrues at the discount rate less the compounding spread, the independent
+    // amount keeps the collateral held on almost all paths, so a high spread reduces the ene
+    auto enes = [ia](const Real spread) {
+        auto epe = runXvaEngineCG(csaNettingSetManager("EUR", 0.0, 0.0, ia, "1D", spread), true)
+                       ->nettingSetExposureReport();
+        Real sum = 0.0;
+        for (Size i = 1; i < epe->rows(); ++i)
+            sum += reportValue<Real>(epe, i, 3);
+        return sum;
+    };
+    Real ene = enes(0.0), eneSpread = enes(0.5);
+    BOOST_TEST_MESSAGE("sum of ene without spread " << ene << ", with spread " << eneSpread);
+    BOOST_CHECK(ene > 0.0);
+    BOOST_CHECK(eneSpread < ene);
+}
+
+BOOST_AUTO_TEST_CASE(testAdVsBumpSensitivities) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG AD sensitivities against bump and revalue...");
+
+    ScriptLibrarySetup setup;
+
+    auto sensitivityData = QuantLib::ext::make_shared<SensitivityScenarioData>();
+    sensitivityData->fromFile(TEST_INPUT_FILE("sensitivity.xml"));
+
+    auto sensis = [&sensitivityData](const bool bump) {
+        auto report =
+            runXvaEngineCG(nullptr, false, false, string(), string(), string(), sensitivityData, bump)->sensiReport();
+        BOOST_REQUIRE(report);
+        std::map<string, Real> result;
+        for (Size i = 0; i < report->rows(); ++i) {
+            if (reportValue<string>(report, i, 2) == "Up")
+                result[reportValue<string>(report, i, 1)] = reportValue<Real>(report, i, 7);
+        }
+        return result;
+    };
+
+    auto ad = sensis(false);
+    auto bump = sensis(true);
+
+    BOOST_REQUIRE(!bump.empty());
+    Size compared = 0;
+    for (auto const& [factor, b] : bump) {
+        if (std::abs(b) < 1.0)
+            continue;
+        auto a = ad.find(factor);
+        BOOST_REQUIRE_MESSAGE(a != ad.end(), "no ad sensitivity for " << factor);
+        BOOST_TEST_MESSAGE(factor << ": ad " << a->second << " bump " << b);
+        BOOST_CHECK_CLOSE(a->second, b, 5.0);
+        ++compared;
+    }
+    BOOST_CHECK(compared > 0);
+}
+
+BOOST_AUTO_TEST_CASE(testClassicCvaReference) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG CVA against a classic valuation engine run...");
+
+    ScriptLibrarySetup setup;
+
+    Real cva = reportValue<Real>(runXvaEngineCG(nullptr)->xvaReport(), 0, 2);
+    auto [cvaClassic, error] = classicCva();
+    BOOST_TEST_MESSAGE("cva cg " << cva << ", classic " << cvaClassic << " +- " << error);
+
+    // both runs draw their own paths, the difference of the two estimates is within three standard errors
+    BOOST_CHECK(cvaClassic > 0.0);
+    BOOST_CHECK_SMALL(cva - cvaClassic, 3.0 * std::sqrt(2.0) * error);
+}
+
+BOOST_AUTO_TEST_CASE(testUnsupportedSetups) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG rejects a non-base CSA currency, MTAs and non-daily margining...");
+
+    ScriptLibrarySetup setup;
+
+    BOOST_CHECK_THROW(runXvaEngineCG(csaNettingSetManager("USD", 0.0)), QuantLib::Error);
+    BOOST_CHECK_THROW(runXvaEngineCG(csaNettingSetManager("EUR", 0.0, 1.0E5)), QuantLib::Error);
+    BOOST_CHECK_THROW(runXvaEngineCG(csaNettingSetManager("EUR", 0.0, 0.0, 0.0, "1W")), QuantLib::Error);
+    BOOST_CHECK_NO_THROW(runXvaEngineCG(nullptr, true, false));
+    BOOST_CHECK_NO_THROW(runXvaEngineCG(nullptr, true, true));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -482,34 +482,35 @@ void CommodityCurve::buildPiecewiseCurve(const Date& asof, const CommodityCurveC
     Real maxF = bc.maxFactor();
     Real minF = bc.minFactor();
     Size noThrowSteps = bc.dontThrowSteps();
+    bool warmStart = bc.warmStart();
 
     // Create curve based on interpolation method provided.
     Currency ccy = parseCurrency(config.currency());
     if (interpolationMethod_ == "Linear") {
-        BS<Crv<Linear>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps);
+        BS<Crv<Linear>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps, warmStart);
         commodityPriceCurve_ = QuantLib::ext::make_shared<Crv<Linear>>(asof, instruments, dayCounter_, ccy, Linear(), bs);
     } else if (interpolationMethod_ == "LogLinear") {
-        BS<Crv<QuantLib::LogLinear>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps);
+        BS<Crv<QuantLib::LogLinear>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps, warmStart);
         commodityPriceCurve_ = QuantLib::ext::make_shared<Crv<QuantLib::LogLinear>>(asof, instruments,
             dayCounter_, ccy, QuantLib::LogLinear(), bs);
     } else if (interpolationMethod_ == "Cubic") {
-        BS<Crv<QuantLib::Cubic>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps);
+        BS<Crv<QuantLib::Cubic>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps, warmStart);
         commodityPriceCurve_ = QuantLib::ext::make_shared<Crv<QuantLib::Cubic>>(asof, instruments,
             dayCounter_, ccy, QuantLib::Cubic(), bs);
     } else if (interpolationMethod_ == "LinearFlat") {
-        BS<Crv<QuantExt::LinearFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps);
+        BS<Crv<QuantExt::LinearFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps, warmStart);
         commodityPriceCurve_ = QuantLib::ext::make_shared<Crv<QuantExt::LinearFlat>>(asof, instruments,
             dayCounter_, ccy, QuantExt::LinearFlat(), bs);
     } else if (interpolationMethod_ == "LogLinearFlat") {
-        BS<Crv<QuantExt::LogLinearFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps);
+        BS<Crv<QuantExt::LogLinearFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps, warmStart);
         commodityPriceCurve_ = QuantLib::ext::make_shared<Crv<QuantExt::LogLinearFlat>>(asof, instruments,
             dayCounter_, ccy, QuantExt::LogLinearFlat(), bs);
     } else if (interpolationMethod_ == "CubicFlat") {
-        BS<Crv<QuantExt::CubicFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps);
+        BS<Crv<QuantExt::CubicFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps, warmStart);
         commodityPriceCurve_ = QuantLib::ext::make_shared<Crv<QuantExt::CubicFlat>>(asof, instruments,
             dayCounter_, ccy, QuantExt::CubicFlat(), bs);
     } else if (interpolationMethod_ == "BackwardFlat") {
-        BS<Crv<BackwardFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps);
+        BS<Crv<BackwardFlat>> bs(acc, globalAcc, noThrow, maxAttempts, maxF, minF, noThrowSteps, warmStart);
         commodityPriceCurve_ = QuantLib::ext::make_shared<Crv<BackwardFlat>>(asof, instruments,
             dayCounter_, ccy, BackwardFlat(), bs);
     } else {
@@ -189,6 +189,16 @@ void CSVLoader::loadFile(const string& filename, DataType dataType) {
     LOG("CSVLoader completed processing " << filename);
 }
 
+void CSVLoader::setQuote(const QuantLib::Date& d, const string& name, QuantLib::Real value) {
+    auto md = parseMarketDatum(d, name, value);
+    auto& data = data_[d];
+    auto it = data.find(md);
+    if (it != data.end())
+        data.erase(it);
+    data.insert(md);
+    DLOG("Set MarketDatum " << name << " on " << d << " to " << value);
+}
+
 vector<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::loadQuotes(const QuantLib::Date& d) const {
     auto it = data_.find(d);
     if (it == data_.end())
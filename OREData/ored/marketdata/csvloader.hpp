@@ -97,6 +97,9 @@ public:
     std::set<QuantExt::Dividend> loadDividends() const override { return dividends_; }
     //@}
 
+    //! Add a quote or replace the value of an existing quote
+    void setQuote(const QuantLib::Date& d, const string& name, QuantLib::Real value);
+
 private:
     enum class DataType { Market, Fixing, Dividend };
     void loadFile(const string&, DataType);
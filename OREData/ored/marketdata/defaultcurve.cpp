@@ -434,10 +434,11 @@ void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveC
     Real maxFactor = config.allowNegativeRates() ? config.bootstrapConfig().maxFactor() : 1.0;
     Real minFactor = config.bootstrapConfig().minFactor();
     Size dontThrowSteps = config.bootstrapConfig().dontThrowSteps();
+    bool warmStart = config.bootstrapConfig().warmStart();
 
     typedef PiecewiseDefaultCurve<QuantExt::SurvivalProbability, LogLinear, QuantExt::IterativeBootstrap> SpCurve;
     SpCurve::bootstrap_type btconfig(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                   minFactor, dontThrowSteps);
+                                                   minFactor, dontThrowSteps, warmStart);
     QuantLib::ext::shared_ptr<DefaultProbabilityTermStructure> qlCurve;
 
     if (config.indexTerm() != 0 * Days) {
@@ -488,7 +489,7 @@ void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveC
         QuantLib::ext::shared_ptr<DefaultProbabilityTermStructure> tmp = QuantLib::ext::make_shared<SpCurve>(
             asof, helpers, config.dayCounter(), LogLinear(),
             QuantExt::IterativeBootstrap<SpCurve>(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                  minFactor, dontThrowSteps));
+                                                  minFactor, dontThrowSteps, warmStart));
 
         // As for yield curves we need to copy the piecewise curve because on eval date changes the relative date
         // helpers with trigger a bootstrap.
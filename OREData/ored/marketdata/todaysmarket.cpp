@@ -44,6 +44,7 @@
 #include <ored/utilities/indexnametranslator.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
+#include <ored/utilities/wildcard.hpp>
 #include <qle/indexes/dividendmanager.hpp>
 #include <qle/indexes/equityindex.hpp>
 #include <qle/indexes/fallbackiborindex.hpp>
@@ -53,6 +54,7 @@
 #include <qle/termstructures/blackvolsurfacewithatm.hpp>
 #include <qle/termstructures/pricetermstructureadapter.hpp>
 
+#include <ql/quotes/simplequote.hpp>
 #include <ql/tuple.hpp>
 
 #include <boost/graph/topological_sort.hpp>
@@ -60,6 +62,10 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -73,23 +79,93 @@ using QuantExt::applyDividends;
 namespace ore {
 namespace data {
 
+namespace {
+
+// links the relinkable handle with the given key to p and returns it
+template <class T>
+Handle<T> link(std::map<std::string, RelinkableHandle<T>>& links, const std::string& key,
+               const QuantLib::ext::shared_ptr<T>& p) {
+    RelinkableHandle<T>& h = links[key];
+    if (h.currentLink() != p)
+        h.linkTo(p);
+    return h;
+}
+
+// replaces the handles in the map by relinkable handles sharing their links, entries that were rebuilt since the last
+// call are relinked to the rebuilt objects
+template <class K, class T>
+void linkHandles(std::map<K, Handle<T>>& handles, std::map<K, RelinkableHandle<T>>& links) {
+    for (auto& [key, h] : handles) {
+        auto [l, inserted] = links.try_emplace(key);
+        if (!inserted && l->second.currentLink() == h.currentLink())
+            continue;
+        l->second.linkTo(h.currentLink());
+        h = l->second;
+    }
+}
+
+template <class Handles, class Links, std::size_t... I>
+void linkHandles(const Handles& handles, Links& links, std::index_sequence<I...>) {
+    (linkHandles(std::get<I>(handles), std::get<I>(links)), ...);
+}
+
+template <class M> struct RelinkableHandleMap;
+template <class K, class T> struct RelinkableHandleMap<std::map<K, Handle<T>>> {
+    using type = std::map<K, RelinkableHandle<T>>;
+};
+
+template <class... M>
+std::tuple<typename RelinkableHandleMap<M>::type...> relinkableHandleMaps(const std::tuple<M&...>&);
+
+// true if one of the quotes, which may contain wildcards, is in the set of names
+bool requiresQuotes(const std::vector<std::string>& quotes, const std::set<std::string>& names) {
+    for (auto const& q : quotes) {
+        Wildcard w(q);
+        if (w.hasWildcard()) {
+            if (std::any_of(names.begin(), names.end(), [&w](const std::string& n) { return w.matches(n); }))
+                return true;
+        } else if (names.count(q) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+struct TodaysMarket::HandleLinks {
+    decltype(relinkableHandleMaps(std::declval<const TodaysMarket&>().handleMaps())) maps;
+};
+
 TodaysMarket::TodaysMarket(const Date& asof, const QuantLib::ext::shared_ptr<TodaysMarketParameters>& params,
                            const QuantLib::ext::shared_ptr<Loader>& loader,
                            const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs, const bool continueOnError,
                            const bool loadFixings, const bool lazyBuild,
                            const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                            const bool preserveQuoteLinkage, const IborFallbackConfig& iborFallbackConfig,
-                           const bool buildCalibrationInfo, const bool handlePseudoCurrencies)
+                           const bool buildCalibrationInfo, const bool handlePseudoCurrencies,
+                           const BootstrappedYieldCurveNodes& bootstrappedYieldCurveNodes)
     : MarketImpl(handlePseudoCurrencies), params_(params), loader_(loader), curveConfigs_(curveConfigs),
       continueOnError_(continueOnError), loadFixings_(loadFixings), lazyBuild_(lazyBuild),
       preserveQuoteLinkage_(preserveQuoteLinkage), referenceData_(referenceData),
-      iborFallbackConfig_(iborFallbackConfig), buildCalibrationInfo_(buildCalibrationInfo) {
+      iborFallbackConfig_(iborFallbackConfig), buildCalibrationInfo_(buildCalibrationInfo),
+      bootstrappedYieldCurveNodes_(bootstrappedYieldCurveNodes),
+      handleLinks_(QuantLib::ext::make_shared<HandleLinks>()) {
     QL_REQUIRE(params_, "TodaysMarket: TodaysMarketParameters are null");
     QL_REQUIRE(loader_, "TodaysMarket: Loader is null");
     QL_REQUIRE(curveConfigs_, "TodaysMarket: CurveConfigurations are null");
     initialise(asof);
 }
 
+BootstrappedYieldCurveNodes TodaysMarket::bootstrappedYieldCurveNodes() const {
+    BootstrappedYieldCurveNodes result;
+    for (auto const& [name, curve] : requiredYieldCurves_) {
+        if (auto nodes = curve->bootstrappedNodes())
+            result[name] = nodes;
+    }
+    return result;
+}
+
 namespace {
 struct Count {
     void inc() { ++count; }
@@ -225,6 +301,8 @@ void TodaysMarket::initialise(const Date& asof) {
             LOG("Loaded CurvesSpecs: success: " << countSuccess << ", error: " << countError);
         }
 
+        linkHandles();
+
     } else {
         LOG("Build objects in TodaysMarket lazily, i.e. when requested.");
     }
@@ -296,9 +374,11 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
             auto itr = requiredYieldCurves_.find(ycspec->name());
             if (itr == requiredYieldCurves_.end()) {
                 DLOG("Building YieldCurve for asof " << asof_);
+                auto nodes = bootstrappedYieldCurveNodes_.find(ycspec->name());
                 QuantLib::ext::shared_ptr<YieldCurve> yieldCurve = QuantLib::ext::make_shared<YieldCurve>(
                     asof_, *ycspec, *curveConfigs_, *loader_, requiredYieldCurves_, requiredDefaultCurves_, *fx_,
-                    referenceData_, iborFallbackConfig_, preserveQuoteLinkage_, buildCalibrationInfo_, this);
+                    referenceData_, iborFallbackConfig_, preserveQuoteLinkage_, buildCalibrationInfo_, this,
+                    nodes == bootstrappedYieldCurveNodes_.end() ? nullptr : nodes->second);
                 calibrationInfo_->yieldCurveCalibrationInfo[ycspec->name()] = yieldCurve->calibrationInfo();
                 itr = requiredYieldCurves_.insert(make_pair(ycspec->name(), yieldCurve)).first;
                 DLOG("Added YieldCurve \"" << ycspec->name() << "\" to requiredYieldCurves map");
@@ -308,21 +388,25 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
                 }
             }
 
+            // the market and the indices use the relinkable handle of the spec, see update()
+            Handle<YieldTermStructure> handle =
+                link(yieldCurveLinks_, ycspec->name(), itr->second->handle().currentLink());
+
             if (node.obj == MarketObject::DiscountCurve) {
                 DLOG("Adding DiscountCurve(" << node.name << ") with spec " << *ycspec << " to configuration "
                                              << configuration);
-                yieldCurves_[make_tuple(configuration, YieldCurveType::Discount, node.name)] = itr->second->handle();
+                yieldCurves_[make_tuple(configuration, YieldCurveType::Discount, node.name)] = handle;
 
             } else if (node.obj == MarketObject::YieldCurve) {
                 DLOG("Adding YieldCurve(" << node.name << ") with spec " << *ycspec << " to configuration "
                                           << configuration);
-                yieldCurves_[make_tuple(configuration, YieldCurveType::Yield, node.name)] = itr->second->handle();
+                yieldCurves_[make_tuple(configuration, YieldCurveType::Yield, node.name)] = handle;
 
             } else if (node.obj == MarketObject::IndexCurve) {
                 DLOG("Adding Index(" << node.name << ") with spec " << *ycspec << " to configuration "
                                      << configuration);
                 // ibor fallback handling
-                auto tmpIndex = parseIborIndex(node.name, itr->second->handle());
+                auto tmpIndex = parseIborIndex(node.name, handle);
                 if (iborFallbackConfig_.isIndexReplaced(node.name, asof_)) {
                     auto fallbackData = iborFallbackConfig_.fallbackData(node.name);
                     QuantLib::ext::shared_ptr<IborIndex> rfrIndex;
@@ -586,7 +670,8 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
                 QL_REQUIRE(ts,
                            "expected zero inflation term structure for index " << node.name << ", but could not cast");
                 // index is not interpolated
-                auto tmp = parseZeroInflationIndex(node.name, Handle<ZeroInflationTermStructure>(ts));
+                auto tmp =
+                    parseZeroInflationIndex(node.name, link(zeroInflationCurveLinks_, inflationspec->name(), ts));
                 zeroInflationIndices_[make_pair(configuration, node.name)] = Handle<ZeroInflationIndex>(tmp);
             }
 
@@ -600,7 +685,7 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
                 yoyInflationIndices_[make_pair(configuration, node.name)] =
                     Handle<YoYInflationIndex>(QuantLib::ext::make_shared<QuantExt::YoYInflationIndexWrapper>(
                         parseZeroInflationIndex(node.name, Handle<ZeroInflationTermStructure>()), false,
-                        Handle<YoYInflationTermStructure>(ts)));
+                        link(yoyInflationCurveLinks_, inflationspec->name(), ts)));
             }
             break;
         }
@@ -652,10 +737,16 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
 
             DLOG("Adding EquityCurve (" << node.name << ") with spec " << *equityspec << " to configuration "
                                         << configuration);
-            yieldCurves_[make_tuple(configuration, YieldCurveType::EquityDividend, node.name)] =
-                itr->second->equityIndex()->equityDividendCurve();
-            equitySpots_[make_pair(configuration, node.name)] = itr->second->equityIndex()->equitySpot();
-            equityCurves_[make_pair(configuration, node.name)] = Handle<EquityIndex2>(itr->second->equityIndex());
+            // the index is cloned with the relinkable curve handles of the spec, see update()
+            auto eqIndex = itr->second->equityIndex();
+            Handle<YieldTermStructure> forecast =
+                link(equityForecastCurveLinks_, equityspec->name(), eqIndex->equityForecastCurve().currentLink());
+            Handle<YieldTermStructure> dividend =
+                link(equityDividendCurveLinks_, equityspec->name(), eqIndex->equityDividendCurve().currentLink());
+            yieldCurves_[make_tuple(configuration, YieldCurveType::EquityDividend, node.name)] = dividend;
+            equitySpots_[make_pair(configuration, node.name)] = eqIndex->equitySpot();
+            equityCurves_[make_pair(configuration, node.name)] =
+                Handle<EquityIndex2>(eqIndex->clone(eqIndex->equitySpot(), forecast, dividend));
             IndexNameTranslator::instance().add(itr->second->equityIndex()->name(),
                                                 "EQ-" + itr->second->equityIndex()->name());
             break;
@@ -742,7 +833,10 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
 
             DLOG("Adding CommodityCurve, " << node.name << ", with spec " << *commodityCurveSpec << " to configuration "
                                            << configuration);
-            Handle<CommodityIndex> commIdx(itr->second->commodityIndex());
+            // the index is cloned with the relinkable price curve handle of the spec, see update()
+            auto index = itr->second->commodityIndex();
+            Handle<CommodityIndex> commIdx(index->clone(
+                Date(), link(commodityPriceCurveLinks_, commodityCurveSpec->name(), index->priceCurve().currentLink())));
             commodityIndices_[make_pair(configuration, node.name)] = commIdx;
             calibrationInfo_->commodityCurveCalibrationInfo[commodityCurveSpec->name()] = itr->second->calibrationInfo();
             break;
@@ -930,6 +1024,9 @@ void TodaysMarket::require(const MarketObject o, const string& name, const strin
         DLOG("Loaded CurvesSpecs: success: " << countSuccess << ", error: " << countError);
     }
 
+    if (countSuccess > 0)
+        linkHandles();
+
     // output errors
 
     if (!buildErrors.empty()) {
@@ -946,6 +1043,176 @@ void TodaysMarket::require(const MarketObject o, const string& name, const strin
     }
 } // TodaysMarket::require()
 
+Size TodaysMarket::update(const std::vector<QuantLib::ext::shared_ptr<MarketDatum>>& data) {
+
+    // set the new values on the loader quotes
+
+    std::set<std::string> changed;
+    bool fxChanged = false;
+    for (auto const& d : data) {
+        QL_REQUIRE(d, "TodaysMarket::update(): market datum is null");
+        auto md = loader_->get(std::make_pair(d->name(), true), asof_);
+        QL_REQUIRE(md, "TodaysMarket::update(): quote '" << d->name() << "' not found in loader");
+        auto q = QuantLib::ext::dynamic_pointer_cast<SimpleQuote>(*md->quote());
+        QL_REQUIRE(q, "TodaysMarket::update(): quote '" << d->name() << "' in loader is not a SimpleQuote");
+        q->setValue(d->quote()->value());
+        changed.insert(d->name());
+        fxChanged = fxChanged || md->instrumentType() == MarketDatum::InstrumentType::FX_SPOT;
+    }
+
+    // the FX triangulation observes the loader quotes and does not need to be rebuilt, but the FX spot nodes are
+    // marked as affected, so that objects built from FX spot values are rebuilt
+
+    std::map<std::string, bool> specRequiresChangedQuotes;
+    auto requiresChangedQuotes = [this, &changed, &specRequiresChangedQuotes, fxChanged](const Node& node) {
+        if (!node.curveSpec)
+            return false;
+        if (node.curveSpec->baseType() == CurveSpec::CurveType::FX)
+            return fxChanged;
+        auto [r, inserted] = specRequiresChangedQuotes.try_emplace(node.curveSpec->name(), false);
+        if (inserted && curveConfigs_->has(node.curveSpec->baseType(), node.curveSpec->curveConfigID()))
+            r->second =
+                requiresQuotes(curveConfigs_->get(node.curveSpec->baseType(), node.curveSpec->curveConfigID())->quotes(),
+                               changed);
+        return r->second;
+    };
+
+    // find the affected nodes, i.e. the nodes requiring one of the changed quotes and all nodes depending on them;
+    // the objects are shared between the configurations via their spec names, so we iterate until the set of
+    // affected specs does not change any more
+
+    std::map<std::string, std::set<Vertex>> affected;
+    std::set<std::string> affectedSpecs;
+    bool done = false;
+    while (!done) {
+        done = true;
+        for (auto& [configuration, g] : dependencies_) {
+            auto& a = affected[configuration];
+            std::vector<Vertex> stack;
+            VertexIterator v, vend;
+            for (std::tie(v, vend) = boost::vertices(g); v != vend; ++v) {
+                if (a.count(*v) == 0 && ((g[*v].curveSpec && affectedSpecs.count(g[*v].curveSpec->name()) > 0) ||
+                                         requiresChangedQuotes(g[*v])))
+                    stack.push_back(*v);
+            }
+            while (!stack.empty()) {
+                Vertex w = stack.back();
+                stack.pop_back();
+                if (!a.insert(w).second)
+                    continue;
+                if (g[w].curveSpec && affectedSpecs.insert(g[w].curveSpec->name()).second)
+                    done = false;
+                boost::graph_traits<Graph>::in_edge_iterator e, eend;
+                for (std::tie(e, eend) = boost::in_edges(w, g); e != eend; ++e)
+                    stack.push_back(boost::source(*e, g));
+            }
+        }
+    }
+
+    // mark the affected nodes as not built, nodes that were not built before (lazy build or build errors) are left
+    // to the usual build process
+
+    std::map<std::string, std::set<Vertex>> rebuild;
+    for (auto const& [configuration, vertices] : affected) {
+        Graph& g = dependencies_[configuration];
+        for (auto const& v : vertices) {
+            if (g[v].built)
+                rebuild[configuration].insert(v);
+            g[v].built = false;
+            if (g[v].obj == MarketObject::SwapIndexCurve)
+                requiredSwapIndices_[configuration].erase(g[v].name);
+        }
+    }
+
+    Size count = 0;
+    for (auto const& r : rebuild)
+        count += r.second.size();
+    DLOG("TodaysMarket::update(): " << changed.size() << " changed quotes, " << affectedSpecs.size()
+                                    << " affected specs, rebuilding " << count << " nodes");
+    if (affectedSpecs.empty())
+        return 0;
+
+    // remove the affected objects, the bootstrapped nodes of the affected yield curves are outdated as well
+
+    for (auto const& s : affectedSpecs) {
+        requiredYieldCurves_.erase(s);
+        bootstrappedYieldCurveNodes_.erase(s);
+        requiredFxVolCurves_.erase(s);
+        requiredGenericYieldVolCurves_.erase(s);
+        requiredCapFloorVolCurves_.erase(s);
+        requiredDefaultCurves_.erase(s);
+        requiredCDSVolCurves_.erase(s);
+        requiredBaseCorrelationCurves_.erase(s);
+        requiredInflationCurves_.erase(s);
+        requiredInflationCapFloorVolCurves_.erase(s);
+        requiredEquityCurves_.erase(s);
+        requiredEquityVolCurves_.erase(s);
+        requiredSecurities_.erase(s);
+        requiredCommodityCurves_.erase(s);
+        requiredCommodityVolCurves_.erase(s);
+        requiredCorrelationCurves_.erase(s);
+    }
+
+    // rebuild the nodes, discount curves first as in initialise()
+
+    map<string, string> buildErrors;
+    for (auto const& [configuration, vertices] : rebuild) {
+        Graph& g = dependencies_[configuration];
+        for (auto const& v : vertices) {
+            if (g[v].obj == MarketObject::DiscountCurve)
+                require(MarketObject::DiscountCurve, g[v].name, configuration, true);
+        }
+    }
+
+    for (auto const& [configuration, vertices] : rebuild) {
+        Graph& g = dependencies_[configuration];
+        std::vector<Vertex> order;
+        try {
+            boost::topological_sort(g, std::back_inserter(order));
+        } catch (const std::exception& e) {
+            buildErrors["CurveDependencyGraph"] = "Topological sort of dependency graph failed for configuration " +
+                                                  configuration + " (" + ore::data::to_string(e.what()) + ")";
+            continue;
+        }
+        for (auto const& m : order) {
+            if (g[m].built || vertices.count(m) == 0)
+                continue;
+            try {
+                buildNode(configuration, g[m]);
+                DLOG("rebuilt node " << g[m] << " in configuration " << configuration);
+            } catch (const std::exception& e) {
+                buildErrors[g[m].curveSpec ? g[m].curveSpec->name() : g[m].name] = e.what();
+                ALOG("error while rebuilding node " << g[m] << " in configuration " << configuration << ": "
+                                                    << e.what());
+            }
+        }
+    }
+
+    // relink the handles handed out before the update to the rebuilt objects
+
+    linkHandles();
+
+    if (!buildErrors.empty()) {
+        for (auto const& error : buildErrors) {
+            StructuredCurveErrorMessage(error.first, "Failed to Build Curve", error.second).log();
+        }
+        if (!continueOnError_) {
+            string errStr;
+            for (auto const& error : buildErrors) {
+                errStr += "(" + error.first + ": " + error.second + "); ";
+            }
+            QL_FAIL("Cannot rebuild all affected curves! Building failed for: " << errStr);
+        }
+    }
+
+    return count;
+} // TodaysMarket::update()
+
+void TodaysMarket::linkHandles() const {
+    auto maps = handleMaps();
+    ore::data::linkHandles(maps, handleLinks_->maps, std::make_index_sequence<std::tuple_size_v<decltype(maps)>>());
+}
+
 std::ostream& operator<<(std::ostream& o, const DependencyGraph::Node& n) {
     return o << n.obj << "(" << n.name << "," << n.mapping << ")";
 }
@@ -31,6 +31,7 @@
 #include <ored/marketdata/todaysmarketcalibrationinfo.hpp>
 #include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/marketdata/dependencygraph.hpp>
+#include <ored/marketdata/yieldcurve.hpp>
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/directed_graph.hpp>
@@ -39,12 +40,12 @@
 #include <boost/enable_shared_from_this.hpp>
 
 #include <map>
+#include <tuple>
 
 namespace ore {
 namespace data {
 
 class ReferenceDataManager;
-class YieldCurve;
 class FXSpot;
 class FXVolCurve;
 class GenericYieldVolCurve;
@@ -62,6 +63,9 @@ class CommodityCurve;
 class CommodityVolCurve;
 class CorrelationCurve;
 
+//! Nodes of bootstrapped yield curves, the key is the curve spec name
+using BootstrappedYieldCurveNodes = std::map<std::string, QuantLib::ext::shared_ptr<const YieldCurve::BootstrappedNodes>>;
+
 // TODO: rename class
 //! Today's Market
 /*!
@@ -103,10 +107,27 @@ public:
         //! build calibration info?
         const bool buildCalibrationInfo = true,
         //! support pseudo currencies
-        const bool handlePseudoCurrencies = true);
+        const bool handlePseudoCurrencies = true,
+        /*! Nodes of yield curves bootstrapped by another instance with the same asof, market data and
+            configuration, the bootstrap is skipped for these curves. Only used if preserveQuoteLinkage is false. */
+        const BootstrappedYieldCurveNodes& bootstrappedYieldCurveNodes = {});
 
     QuantLib::ext::shared_ptr<TodaysMarketCalibrationInfo> calibrationInfo() const { return calibrationInfo_; }
 
+    /*! Nodes of the bootstrapped yield curves built so far, these can be passed to another instance to share the
+        bootstrap results. Only available if preserveQuoteLinkage is false. */
+    BootstrappedYieldCurveNodes bootstrappedYieldCurveNodes() const;
+
+    /*! Update the market after a change of market data. The loader quotes with the names of the given data are set
+        to the new values. The market objects requiring one of these quotes and all objects depending on them are
+        rebuilt in topological order, all other objects are kept. The handles handed out by the market before the
+        update are relinked to the rebuilt objects, so that instruments linked to the market stay linked. Indices
+        handed out before the update forecast off the rebuilt curves.
+
+        The quotes must exist in the loader and the loader must return the same MarketDatum instances on each call,
+        as e.g. the CSVLoader and InMemoryLoader do. Returns the number of rebuilt nodes over all configurations. */
+    Size update(const std::vector<QuantLib::ext::shared_ptr<MarketDatum>>& data);
+
 private:
     // MarketImpl interface
     void require(const MarketObject o, const string& name, const string& configuration,
@@ -125,6 +146,7 @@ private:
     const QuantLib::ext::shared_ptr<ReferenceDataManager> referenceData_;
     const IborFallbackConfig iborFallbackConfig_;
     const bool buildCalibrationInfo_;
+    BootstrappedYieldCurveNodes bootstrappedYieldCurveNodes_;
 
     // initialise market
     void initialise(const Date& asof);
@@ -164,6 +186,30 @@ private:
     mutable map<string, QuantLib::ext::shared_ptr<CorrelationCurve>> requiredCorrelationCurves_;
     // for swap indices we map the configuration name to a map (swap index name => index)
     mutable map<string, map<string, QuantLib::ext::shared_ptr<SwapIndex>>> requiredSwapIndices_;
+
+    /* relinkable handles of the term structures built from a spec, keyed by spec name, these are relinked to the
+       term structures rebuilt in update(), so that the indices built from them see the rebuilt curves */
+    mutable map<string, RelinkableHandle<YieldTermStructure>> yieldCurveLinks_;
+    mutable map<string, RelinkableHandle<YieldTermStructure>> equityForecastCurveLinks_;
+    mutable map<string, RelinkableHandle<YieldTermStructure>> equityDividendCurveLinks_;
+    mutable map<string, RelinkableHandle<ZeroInflationTermStructure>> zeroInflationCurveLinks_;
+    mutable map<string, RelinkableHandle<YoYInflationTermStructure>> yoyInflationCurveLinks_;
+    mutable map<string, RelinkableHandle<QuantExt::PriceTermStructure>> commodityPriceCurveLinks_;
+
+    /* relinkable handles of the entries in the handle maps of MarketImpl, the entries share their links, so that the
+       handles handed out by the market are relinked to the objects rebuilt in update() */
+    struct HandleLinks;
+    QuantLib::ext::shared_ptr<HandleLinks> handleLinks_;
+    void linkHandles() const;
+
+    // the handle maps of MarketImpl
+    auto handleMaps() const {
+        return std::tie(yieldCurves_, iborIndices_, swapIndices_, swaptionCurves_, yieldVolCurves_, fxVols_,
+                        defaultCurves_, cdsVols_, baseCorrelations_, recoveryRates_, capFloorCurves_,
+                        yoyCapFloorVolSurfaces_, zeroInflationIndices_, yoyInflationIndices_,
+                        cpiInflationCapFloorVolatilitySurfaces_, equitySpots_, equityVols_, securitySpreads_,
+                        baseCpis_, correlationCurves_, commodityIndices_, commodityVols_, equityCurves_, cprs_);
+    }
 };
 
 std::ostream& operator<<(std::ostream& o, const DependencyGraph::Node& n);
@@ -73,6 +73,8 @@
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <boost/functional/hash.hpp>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -280,11 +282,12 @@ YieldCurve::YieldCurve(Date asof, YieldCurveSpec curveSpec, const CurveConfigura
                        const FXTriangulation& fxTriangulation,
                        const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                        const IborFallbackConfig& iborFallbackConfig, const bool preserveQuoteLinkage,
-                       const bool buildCalibrationInfo, const Market* market)
+                       const bool buildCalibrationInfo, const Market* market,
+                       const QuantLib::ext::shared_ptr<const BootstrappedNodes>& bootstrappedNodes)
     : asofDate_(asof), curveSpec_(curveSpec), loader_(loader), requiredYieldCurves_(requiredYieldCurves),
       requiredDefaultCurves_(requiredDefaultCurves), fxTriangulation_(fxTriangulation), referenceData_(referenceData),
       iborFallbackConfig_(iborFallbackConfig), preserveQuoteLinkage_(preserveQuoteLinkage),
-      buildCalibrationInfo_(buildCalibrationInfo), market_(market) {
+      buildCalibrationInfo_(buildCalibrationInfo), market_(market), bootstrappedNodes_(bootstrappedNodes) {
 
     try {
 
@@ -401,6 +404,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
     Real maxFactor = curveConfig_->bootstrapConfig().maxFactor();
     Real minFactor = curveConfig_->bootstrapConfig().minFactor();
     Size dontThrowSteps = curveConfig_->bootstrapConfig().dontThrowSteps();
+    bool warmStart = curveConfig_->bootstrapConfig().warmStart();
 
     QuantLib::ext::shared_ptr<YieldTermStructure> yieldts;
     switch (interpolationVariable_) {
@@ -411,21 +415,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, Linear(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::LogLinear: {
             typedef PiecewiseYieldCurve<ZeroYield, LogLinear, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, LogLinear(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::NaturalCubic: {
             typedef PiecewiseYieldCurve<ZeroYield, Cubic, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, Cubic(CubicInterpolation::Kruger, true),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::FinancialCubic: {
             typedef PiecewiseYieldCurve<ZeroYield, Cubic, QuantExt::IterativeBootstrap> my_curve;
@@ -434,21 +438,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                 Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
                       CubicInterpolation::FirstDerivative),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::ConvexMonotone: {
             typedef PiecewiseYieldCurve<ZeroYield, ConvexMonotone, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, ConvexMonotone(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::Hermite: {
              typedef PiecewiseYieldCurve<ZeroYield, Cubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, Cubic(CubicInterpolation::Parabolic),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::CubicSpline: {
              typedef PiecewiseYieldCurve<ZeroYield, Cubic, QuantExt::IterativeBootstrap> my_curve;
@@ -457,7 +461,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  Cubic(CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                        CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::Quadratic: {
              typedef PiecewiseYieldCurve<ZeroYield, QuantExt::Quadratic, QuantExt::IterativeBootstrap> my_curve;
@@ -465,21 +469,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  QuantLib::ext::make_shared<my_curve>(
  					asofDate_, instruments, zeroDayCounter_, QuantExt::Quadratic(1, 0, 1, 0, 1),
  					my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
- 														   minFactor, dontThrowSteps));
+ 														   minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogQuadratic: {
              typedef PiecewiseYieldCurve<ZeroYield, QuantExt::LogQuadratic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, QuantExt::LogQuadratic(1, 0, -1, 0, 1),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogNaturalCubic: {
              typedef PiecewiseYieldCurve<ZeroYield, LogCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, LogCubic(CubicInterpolation::Kruger, true),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogFinancialCubic: {
              typedef PiecewiseYieldCurve<ZeroYield, LogCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -488,7 +492,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  LogCubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
                        CubicInterpolation::FirstDerivative),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogCubicSpline: {
              typedef PiecewiseYieldCurve<ZeroYield, LogCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -497,28 +501,28 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  LogCubic(CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                           CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::DefaultLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<ZeroYield, DefaultLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, DefaultLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::MonotonicLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<ZeroYield, MonotonicLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, MonotonicLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::KrugerLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<ZeroYield, KrugerLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, KrugerLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogMixedLinearCubicNaturalSpline: {
              typedef PiecewiseYieldCurve<ZeroYield, LogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -528,7 +532,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                                      CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                                      CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
         default:
             QL_FAIL("Interpolation method '" << interpolationMethod_ << "' not recognised.");
@@ -541,21 +545,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, Linear(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::LogLinear: {
             typedef PiecewiseYieldCurve<Discount, LogLinear, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, LogLinear(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::NaturalCubic: {
             typedef PiecewiseYieldCurve<Discount, Cubic, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, Cubic(CubicInterpolation::Kruger, true),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::FinancialCubic: {
             typedef PiecewiseYieldCurve<Discount, Cubic, QuantExt::IterativeBootstrap> my_curve;
@@ -564,21 +568,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                 Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
                       CubicInterpolation::FirstDerivative),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::ConvexMonotone: {
             typedef PiecewiseYieldCurve<Discount, ConvexMonotone, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, ConvexMonotone(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::Hermite: {
              typedef PiecewiseYieldCurve<Discount, Cubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, Cubic(CubicInterpolation::Parabolic),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::CubicSpline: {
              typedef PiecewiseYieldCurve<Discount, Cubic, QuantExt::IterativeBootstrap> my_curve;
@@ -587,28 +591,28 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  Cubic(CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                        CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::Quadratic: {
              typedef PiecewiseYieldCurve<Discount, QuantExt::Quadratic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, QuantExt::Quadratic(1, 0, 1, 0, 1),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogQuadratic: {
              typedef PiecewiseYieldCurve<Discount, QuantExt::LogQuadratic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, QuantExt::LogQuadratic(1, 0, -1, 0, 1),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogNaturalCubic: {
              typedef PiecewiseYieldCurve<Discount, LogCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, LogCubic(CubicInterpolation::Kruger, true),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogFinancialCubic: {
              typedef PiecewiseYieldCurve<Discount, LogCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -617,7 +621,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  QuantLib::LogCubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
                                  CubicInterpolation::FirstDerivative),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogCubicSpline: {
              typedef PiecewiseYieldCurve<Discount,LogCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -626,28 +630,28 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  LogCubic(CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                        CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::DefaultLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<Discount, DefaultLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, DefaultLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::MonotonicLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<Discount, MonotonicLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, MonotonicLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::KrugerLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<Discount, KrugerLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, KrugerLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogMixedLinearCubicNaturalSpline: {
              typedef PiecewiseYieldCurve<Discount, LogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -657,7 +661,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                                      CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                                      CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
         default:
             QL_FAIL("Interpolation method '" << interpolationMethod_ << "' not recognised.");
@@ -670,21 +674,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, Linear(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::LogLinear: {
             typedef PiecewiseYieldCurve<ForwardRate, LogLinear, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, LogLinear(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::NaturalCubic: {
             typedef PiecewiseYieldCurve<ForwardRate, Cubic, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, Cubic(CubicInterpolation::Kruger, true),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::FinancialCubic: {
             typedef PiecewiseYieldCurve<ForwardRate, Cubic, QuantExt::IterativeBootstrap> my_curve;
@@ -693,21 +697,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                 Cubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
                       CubicInterpolation::FirstDerivative),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::ConvexMonotone: {
             typedef PiecewiseYieldCurve<ForwardRate, ConvexMonotone, QuantExt::IterativeBootstrap> my_curve;
             yieldts = QuantLib::ext::make_shared<my_curve>(
                 asofDate_, instruments, zeroDayCounter_, ConvexMonotone(),
                 my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                       minFactor, dontThrowSteps));
+                                                       minFactor, dontThrowSteps, warmStart));
         } break;
         case InterpolationMethod::Hermite: {
              typedef PiecewiseYieldCurve<ForwardRate, Cubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, Cubic(CubicInterpolation::Parabolic),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::CubicSpline: {
              typedef PiecewiseYieldCurve<ForwardRate, Cubic, QuantExt::IterativeBootstrap> my_curve;
@@ -716,28 +720,28 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  Cubic(CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                        CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::Quadratic: {
              typedef PiecewiseYieldCurve<ForwardRate, QuantExt::Quadratic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, QuantExt::Quadratic(1, 0, 1, 0, 1),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogQuadratic: {
              typedef PiecewiseYieldCurve<ForwardRate, QuantExt::LogQuadratic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, QuantExt::LogQuadratic(1, 0, -1, 0, 1),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogNaturalCubic: {
              typedef PiecewiseYieldCurve<ForwardRate, LogCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, LogCubic(CubicInterpolation::Kruger, true),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogFinancialCubic: {
              typedef PiecewiseYieldCurve<ForwardRate, LogCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -746,7 +750,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  LogCubic(CubicInterpolation::Kruger, true, CubicInterpolation::SecondDerivative, 0.0,
                        CubicInterpolation::FirstDerivative),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogCubicSpline: {
              typedef PiecewiseYieldCurve<ForwardRate, LogCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -755,28 +759,28 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                  LogCubic(CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                        CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor, minFactor,
-                                          dontThrowSteps));
+                                          dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::DefaultLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<ForwardRate, DefaultLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, DefaultLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::MonotonicLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<ForwardRate, MonotonicLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, MonotonicLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::KrugerLogMixedLinearCubic: {
              typedef PiecewiseYieldCurve<ForwardRate, KrugerLogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
              yieldts = QuantLib::ext::make_shared<my_curve>(
                  asofDate_, instruments, zeroDayCounter_, KrugerLogMixedLinearCubic(mixedInterpolationSize_),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
          case InterpolationMethod::LogMixedLinearCubicNaturalSpline: {
              typedef PiecewiseYieldCurve<ForwardRate, LogMixedLinearCubic, QuantExt::IterativeBootstrap> my_curve;
@@ -786,7 +790,7 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
                                      CubicInterpolation::Spline, false, CubicInterpolation::SecondDerivative, 0.0,
                                      CubicInterpolation::SecondDerivative, 0.0),
                  my_curve::bootstrap_type(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                        minFactor, dontThrowSteps));
+                                                        minFactor, dontThrowSteps, warmStart));
          } break;
         default:
             QL_FAIL("Interpolation method '" << interpolationMethod_ << "' not recognised.");
@@ -821,14 +825,21 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
         }
         zeros[0] = zeros[1];
         forwards[0] = forwards[1];
+        auto nodes = QuantLib::ext::make_shared<BootstrappedNodes>();
+        nodes->dates = dates;
+        nodes->mixedInterpolationSize = mixedInterpolationSize_;
+        nodes->asof = asofDate_;
+        nodes->inputHash = inputHash();
         if (interpolationVariable_ == InterpolationVariable::Zero)
-            p_ = zerocurve(dates, zeros, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
+            nodes->values = zeros;
         else if (interpolationVariable_ == InterpolationVariable::Discount)
-            p_ = discountcurve(dates, discounts, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
+            nodes->values = discounts;
         else if (interpolationVariable_ == InterpolationVariable::Forward)
-            p_ = forwardcurve(dates, forwards, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
+            nodes->values = forwards;
         else
             QL_FAIL("Interpolation variable not recognised.");
+        bootstrappedNodes_ = nodes;
+        p_ = curveFromBootstrappedNodes();
     }
 
     // set calibration info
@@ -1207,10 +1218,76 @@ void YieldCurve::buildDiscountCurve() {
     }
 }
 
+std::size_t YieldCurve::inputHash() const {
+    std::size_t seed = 0;
+    auto addQuote = [this, &seed](const string& name) {
+        boost::hash_combine(seed, name);
+        if (loader_.has(name, asofDate_))
+            boost::hash_combine(seed, loader_.get(name, asofDate_)->quote()->value());
+    };
+    for (auto const& segment : curveSegments_) {
+        for (auto const& q : segment->quotes())
+            addQuote(q.first);
+        if (auto xccySegment = QuantLib::ext::dynamic_pointer_cast<CrossCcyYieldCurveSegment>(segment))
+            addQuote(xccySegment->spotRateID());
+    }
+    // the required yield curves are in turn built from quotes, we compare their discount factors
+    for (auto const& id : curveConfig_->requiredCurveIds(CurveSpec::CurveType::Yield)) {
+        for (auto const& [name, curve] : requiredYieldCurves_) {
+            if (curve->curveSpec().curveConfigID() != id || curve->handle().empty())
+                continue;
+            boost::hash_combine(seed, name);
+            for (auto const& p : YieldCurveCalibrationInfo::defaultPeriods)
+                boost::hash_combine(seed, curve->handle()->discount(asofDate_ + p, true));
+        }
+    }
+    return seed;
+}
+
+QuantLib::ext::shared_ptr<YieldTermStructure> YieldCurve::curveFromBootstrappedNodes() const {
+    const auto& n = *bootstrappedNodes_;
+    if (interpolationVariable_ == InterpolationVariable::Zero)
+        return zerocurve(n.dates, n.values, zeroDayCounter_, interpolationMethod_, n.mixedInterpolationSize);
+    else if (interpolationVariable_ == InterpolationVariable::Discount)
+        return discountcurve(n.dates, n.values, zeroDayCounter_, interpolationMethod_, n.mixedInterpolationSize);
+    else if (interpolationVariable_ == InterpolationVariable::Forward)
+        return forwardcurve(n.dates, n.values, zeroDayCounter_, interpolationMethod_, n.mixedInterpolationSize);
+    else
+        QL_FAIL("Interpolation variable not recognised.");
+}
+
 void YieldCurve::buildBootstrappedCurve() {
 
     QL_REQUIRE(!curveSegments_.empty(), "no curve segments defined.");
 
+    /* If we are given the nodes of a previous bootstrap of this curve, we rebuild the curve from them. This yields
+       the same curve as the code below, since the bootstrapped curve is replaced by an interpolated curve on the
+       same nodes there, too. */
+
+    if (bootstrappedNodes_ != nullptr && !preserveQuoteLinkage_ &&
+        (bootstrappedNodes_->asof != asofDate_ || bootstrappedNodes_->inputHash != inputHash())) {
+        DLOG("Nodes of a previous bootstrap of yield curve "
+             << curveSpec_.name() << " are for asof " << bootstrappedNodes_->asof
+             << " or different market data, the curve is bootstrapped again.");
+        bootstrappedNodes_ = nullptr;
+    }
+
+    if (bootstrappedNodes_ != nullptr && !preserveQuoteLinkage_) {
+        DLOG("Building yield curve " << curveSpec_.name() << " from " << bootstrappedNodes_->dates.size()
+                                     << " nodes of a previous bootstrap");
+        QL_REQUIRE(!bootstrappedNodes_->dates.empty() && bootstrappedNodes_->dates.front() == asofDate_,
+                   "bootstrapped nodes for yield curve " << curveSpec_.name() << " do not start at asof date "
+                                                         << asofDate_);
+        mixedInterpolationSize_ = bootstrappedNodes_->mixedInterpolationSize;
+        p_ = curveFromBootstrappedNodes();
+        if (buildCalibrationInfo_) {
+            calibrationInfo_ = QuantLib::ext::make_shared<PiecewiseYieldCurveCalibrationInfo>();
+            calibrationInfo_->pillarDates.assign(std::next(bootstrappedNodes_->dates.begin()),
+                                                 bootstrappedNodes_->dates.end());
+        }
+        return;
+    }
+
     /* Loop over segments and add helpers for each segment. */
 
     DLOG("Building instrument sets for yield curve segments 0..." << curveSegments_.size() - 1);
@@ -86,6 +86,18 @@ public:
         Svensson            // fitted bond curves only
     };
 
+    //! Nodes of a bootstrapped curve, these allow to rebuild the curve without repeating the bootstrap
+    struct BootstrappedNodes {
+        //! pillar dates including the asof date
+        std::vector<QuantLib::Date> dates;
+        //! values of the interpolation variable on the pillar dates
+        std::vector<QuantLib::Real> values;
+        Size mixedInterpolationSize = 0;
+        //! asof date and hash of the bootstrap inputs (market quotes and required yield curves), see inputHash()
+        QuantLib::Date asof;
+        std::size_t inputHash = 0;
+    };
+
     //! Constructor
     YieldCurve( //! Valuation date
         Date asof,
@@ -113,7 +125,9 @@ public:
         //! build calibration info
         const bool buildCalibrationInfo = true,
 	//! market object to look up external discount curves
-        const Market* market = nullptr);
+        const Market* market = nullptr,
+        //! nodes of a previous bootstrap of the same curve, if given the bootstrap is skipped
+        const QuantLib::ext::shared_ptr<const BootstrappedNodes>& bootstrappedNodes = nullptr);
 
     //! \name Inspectors
     //@{
@@ -123,6 +137,9 @@ public:
     const Currency& currency() const { return currency_; }
     // might be nullptr, if no info was produced for this curve
     QuantLib::ext::shared_ptr<YieldCurveCalibrationInfo> calibrationInfo() const { return calibrationInfo_; }
+    /* nodes of the bootstrapped curve, only available for bootstrapped curves built without preserving the quote
+       linkage, otherwise nullptr */
+    QuantLib::ext::shared_ptr<const BootstrappedNodes> bootstrappedNodes() const { return bootstrappedNodes_; }
     //@}
 
 private:
@@ -172,8 +189,14 @@ private:
     const bool preserveQuoteLinkage_;
     bool buildCalibrationInfo_;
     const Market* market_;
+    QuantLib::ext::shared_ptr<const BootstrappedNodes> bootstrappedNodes_;
 
     QuantLib::ext::shared_ptr<YieldTermStructure> piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instruments);
+    //! Build the interpolated curve from bootstrappedNodes_
+    QuantLib::ext::shared_ptr<YieldTermStructure> curveFromBootstrappedNodes() const;
+    /*! Hash of the bootstrap inputs, i.e. the values of the segment quotes and the discount factors of the required
+        yield curves on a fixed set of dates, used to detect nodes of a bootstrap on different inputs */
+    std::size_t inputHash() const;
 
     /* Functions to build RateHelpers from yield curve segments */
     void addDeposits(const QuantLib::ext::shared_ptr<YieldCurveSegment>& segment,
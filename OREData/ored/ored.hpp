@@ -302,6 +302,7 @@
 #include <ored/portfolio/pairwisevarianceswap.hpp>
 #include <ored/portfolio/performanceoption_01.hpp>
 #include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/portfoliosnapshot.hpp>
 #include <ored/portfolio/premiumdata.hpp>
 #include <ored/portfolio/rainbowoption.hpp>
 #include <ored/portfolio/rangebound.hpp>
@@ -335,6 +336,7 @@
 #include <ored/portfolio/varianceswap.hpp>
 #include <ored/portfolio/windowbarrieroption.hpp>
 #include <ored/portfolio/worstofbasketswap.hpp>
+#include <ored/report/columnarreport.hpp>
 #include <ored/report/csvreport.hpp>
 #include <ored/report/inmemoryreport.hpp>
 #include <ored/report/report.hpp>
@@ -18,6 +18,7 @@
 
 #include <ored/portfolio/builders/cbo.hpp>
 
+#include <qle/models/gaussiancopularandomdefaultmodel.hpp>
 #include <qle/pricingengines/cboengine.hpp>
 #include <qle/pricingengines/cbomcengine.hpp>
 
@@ -46,6 +47,10 @@ QuantLib::ext::shared_ptr<PricingEngine> CboMCEngineBuilder::engine(const QuantL
     double corr = parseReal(engineParameter("Correlation"));
 
     double errorTolerance = parseReal(engineParameter("ErrorTolerance", {}, false, "1.0e-6"));
+    int threads = parseInteger(engineParameter("Threads", {}, false, "1"));
+    int blockSize = parseInteger(engineParameter("BlockSize", {}, false, "1000"));
+    QL_REQUIRE(threads > 0, "CboMCEngineBuilder: Threads (" << threads << ") must be positive");
+    QL_REQUIRE(blockSize > 0, "CboMCEngineBuilder: BlockSize (" << blockSize << ") must be positive");
 
     string lossDistributionPeriods_str = engineParameter("LossDistributionPeriods");
     std::vector<string> lossDistributionPeriods_vec = parseListOfValues(lossDistributionPeriods_str);
@@ -60,10 +65,12 @@ QuantLib::ext::shared_ptr<PricingEngine> CboMCEngineBuilder::engine(const QuantL
 
     vector<DefaultProbKey> keys(pool->size(), dummyDefaultProbKey());
 
-    QuantLib::ext::shared_ptr<RandomDefaultModel> rdm(new GaussianRandomDefaultModel(pool, keys, copula, 1.e-6, seed));
+    QuantLib::ext::shared_ptr<RandomDefaultModel> rdm =
+        QuantLib::ext::make_shared<QuantExt::GaussianCopulaRandomDefaultModel>(pool, keys, copula, 1.e-6, seed);
 
     return QuantLib::ext::make_shared<QuantExt::MonteCarloCBOEngine>(rdm, samples, bins, errorTolerance,
-                                                             lossDistributionPeriods);
+                                                             lossDistributionPeriods, static_cast<Size>(threads),
+                                                             static_cast<Size>(blockSize));
 };
 
 } // namespace data
@@ -80,6 +80,16 @@ std::vector<Handle<DefaultProbabilityTermStructure>> buildPerformanceOptimizedDe
     return dpts;
 }
 
+QuantExt::IHGaussPoolLossModel::LossDistributionMethod parseLossDistributionMethod(const std::string& s) {
+    static const map<string, IHGaussPoolLossModel::LossDistributionMethod> m = {
+        {"Bucketing", IHGaussPoolLossModel::LossDistributionMethod::Bucketing},
+        {"Recursion", IHGaussPoolLossModel::LossDistributionMethod::Recursion},
+        {"FFT", IHGaussPoolLossModel::LossDistributionMethod::FFT}};
+    auto it = m.find(s);
+    QL_REQUIRE(it != m.end(), "Loss distribution method \"" << s << "\" not recognized");
+    return it->second;
+}
+
 QuantLib::ext::shared_ptr<PricingEngine> GaussCopulaBucketingCdoEngineBuilder::engineImpl(
     const Currency& ccy, bool isIndexCDS, const vector<string>& creditCurves,
     const QuantLib::ext::shared_ptr<SimpleQuote>& calibrationFactor,
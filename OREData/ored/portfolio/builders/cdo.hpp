@@ -56,6 +56,9 @@ using namespace std;
 std::vector<QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>>
 buildPerformanceOptimizedDefaultCurves(const std::vector<QuantLib::Handle<QuantLib::DefaultProbabilityTermStructure>>& curves);
 
+//! Convert text (Bucketing, Recursion, FFT) to the loss distribution method of the inhomogeneous pool loss model
+QuantExt::IHGaussPoolLossModel::LossDistributionMethod parseLossDistributionMethod(const std::string& s);
+
 class CdoEngineBuilder
     : public CachingPricingEngineBuilder<vector<string>, const Currency&, bool, const vector<string>&,
                                          const QuantLib::ext::shared_ptr<QuantLib::SimpleQuote>&,
@@ -186,6 +189,26 @@ public:
         Size nBuckets = parseInteger(engineParameter("buckets"));
         bool homogeneousPoolWhenJustified = parseBool(engineParameter("homogeneousPoolWhenJustified"));
 
+        // Optional, the lattice methods Recursion and FFT use the inhomogeneous pool loss model
+        auto lossDistribution =
+            parseLossDistributionMethod(engineParameter("lossDistribution", {}, false, "Bucketing"));
+        if (lossDistribution != QuantExt::IHGaussPoolLossModel::LossDistributionMethod::Bucketing) {
+            QL_REQUIRE(!useStochasticRecovery, "lossDistribution " << engineParameter("lossDistribution")
+                                                                   << " requires deterministic recovery");
+            QL_REQUIRE(!useQuadrature, "lossDistribution " << engineParameter("lossDistribution")
+                                                           << " does not support useQuadrature");
+            Size threads = parseInteger(engineParameter("lossDistributionThreads", {}, false, "1"));
+            LOG("Use inhomogeneous pool loss model with loss distribution " << engineParameter("lossDistribution")
+                                                                            << " and " << threads
+                                                                            << " thread(s) for qualifier "
+                                                                            << qualifier);
+            auto lm = QuantLib::ext::make_shared<QuantExt::GaussianConstantLossLM>(
+                correlation, recoveryRates, LatentModelIntegrationType::GaussianQuadrature, poolSize,
+                GaussianCopulaPolicy::initTraits());
+            return QuantLib::ext::make_shared<QuantExt::IHGaussPoolLossModel>(
+                lm, nBuckets, gaussCopulaMax, gaussCopulaMin, gaussCopulaSteps, lossDistribution, threads);
+        }
+
         homogeneous = homogeneous && homogeneousPoolWhenJustified;
         LOG("Use " << (homogeneous ? "" : "in") << "homogeneous pool loss model for qualifier " << qualifier);
         DLOG("useQuadrature is set to " << std::boolalpha << useQuadrature);
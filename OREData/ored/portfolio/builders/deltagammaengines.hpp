@@ -61,6 +61,7 @@ protected:
         bool computeDelta = parseBool(engineParameter("ComputeDelta"));
         bool computeGamma = parseBool(engineParameter("ComputeGamma"));
         bool computeBPS = false; // parseBool(engineParameter("ComputeBPS"));
+        bool linearInZero = parseBool(engineParameter("LinearInZero", {}, false, "true"));
 
         Handle<YieldTermStructure> yts = discountCurve.empty()
                                              ? market_->discountCurve(ccy.code(), configuration(MarketContext::pricing))
@@ -69,7 +70,7 @@ protected:
             yts = Handle<YieldTermStructure>(QuantLib::ext::make_shared<ZeroSpreadedTermStructure>(
                 yts, market_->securitySpread(securitySpread, configuration(MarketContext::pricing))));
         return QuantLib::ext::make_shared<DiscountingSwapEngineDeltaGamma>(yts, bucketTimes, computeDelta,
-                                                                             computeGamma, computeBPS);
+                                                                             computeGamma, computeBPS, linearInZero);
     }
 };
 
@@ -178,6 +178,7 @@ QuantLib::ext::shared_ptr<PricingEngine> FlexiSwapLGMGridEngineBuilder::engineIm
         QL_FAIL("FlexiSwap engine parameter method (" << engineParameter("method") << ") not recognised");
     }
     Real singleSwaptionThreshold = parseReal(engineParameter("singleSwaptionThreshold"));
+    bool useFft = parseBool(engineParameter("UseFFT", {}, false, "false"));
 
     // Build engine
     DLOG("Build engine (configuration " << configuration(MarketContext::pricing) << ")");
@@ -185,7 +186,7 @@ QuantLib::ext::shared_ptr<PricingEngine> FlexiSwapLGMGridEngineBuilder::engineIm
     string ccy = tryParseIborIndex(key, index) ? index->currency().code() : key;
     Handle<YieldTermStructure> dscCurve = market_->discountCurve(ccy, configuration(MarketContext::pricing));
     return QuantLib::ext::make_shared<QuantExt::NumericLgmFlexiSwapEngine>(lgm, sy, ny, sx, nx, dscCurve, method,
-                                                                   singleSwaptionThreshold);
+                                                                   singleSwaptionThreshold, useFft);
 }
 
 QuantLib::ext::shared_ptr<PricingEngine>
@@ -248,6 +248,7 @@ LGMGridSwaptionEngineBuilder::engineImpl(const string& id, const string& key, co
     Size ny = parseInteger(engineParameter("ny"));
     Real sx = parseReal(engineParameter("sx"));
     Size nx = parseInteger(engineParameter("nx"));
+    bool useFft = parseBool(engineParameter("UseFFT", {}, false, "false"));
 
     // Build engine
     DLOG("Build engine (configuration " << configuration(MarketContext::pricing) << ")");
@@ -260,7 +261,7 @@ LGMGridSwaptionEngineBuilder::engineImpl(const string& id, const string& key, co
         yts = Handle<YieldTermStructure>(QuantLib::ext::make_shared<ZeroSpreadedTermStructure>(
             yts, market_->securitySpread(securitySpread, configuration(MarketContext::pricing))));
     return QuantLib::ext::make_shared<QuantExt::NumericLgmMultiLegOptionEngine>(
-        lgm, sy, ny, sx, nx, yts, isAmerican ? parseInteger(modelParameter("ExerciseTimeStepsPerYear")) : 0);
+        lgm, sy, ny, sx, nx, yts, isAmerican ? parseInteger(modelParameter("ExerciseTimeStepsPerYear")) : 0, useFft);
 }
 
 QuantLib::ext::shared_ptr<PricingEngine>
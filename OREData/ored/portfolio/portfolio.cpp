@@ -26,8 +26,13 @@
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/xmlutils.hpp>
 #include <ql/errors.hpp>
+#include <ql/settings.hpp>
 #include <ql/time/date.hpp>
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 using namespace QuantLib;
 using namespace std;
 
@@ -51,47 +56,8 @@ void Portfolio::fromXML(XMLNode* node) {
     XMLUtils::checkNode(node, "Portfolio");
     vector<XMLNode*> nodes = XMLUtils::getChildrenNodes(node, "Trade");
     for (Size i = 0; i < nodes.size(); i++) {
-        string tradeType = XMLUtils::getChildValue(nodes[i], "TradeType", true);
-
-        // Get the id attribute
-        string id = XMLUtils::getAttribute(nodes[i], "id");
-        QL_REQUIRE(id != "", "No id attribute in Trade Node");
-        DLOG("Parsing trade id:" << id);
-        
-        QuantLib::ext::shared_ptr<Trade> trade;
-        bool failedToLoad = true;
-        try {
-            trade = TradeFactory::instance().build(tradeType);
-            trade->fromXML(nodes[i]);
-            trade->id() = id;
-            add(trade);
-            DLOG("Added Trade " << id << " (" << trade->id() << ")"
-                                << " type:" << tradeType);
-            failedToLoad = false;
-        } catch (std::exception& ex) {
-            StructuredTradeErrorMessage(id, tradeType, "Error parsing Trade XML", ex.what()).log();
-        }
-
-        // If trade loading failed, then insert a dummy trade with same id and envelope
-        if (failedToLoad && buildFailedTrades_) {
-            try {
-                trade = TradeFactory::instance().build("Failed");
-                // this loads only type, id and envelope, but type will be set to the original trade's type
-                trade->fromXML(nodes[i]);
-                // create a dummy trade of type "Dummy"
-                QuantLib::ext::shared_ptr<FailedTrade> failedTrade = QuantLib::ext::make_shared<FailedTrade>();
-                // copy id and envelope
-                failedTrade->id() = id;
-                failedTrade->setUnderlyingTradeType(tradeType);
-                failedTrade->setEnvelope(trade->envelope());
-                // and add it to the portfolio
-                add(failedTrade);
-                WLOG("Added trade id " << failedTrade->id() << " type " << failedTrade->tradeType()
-                                       << " for original trade type " << trade->tradeType());
-            } catch (std::exception& ex) {
-                StructuredTradeErrorMessage(id, tradeType, "Error parsing type and envelope", ex.what()).log();
-            }
-        }
+        if (auto trade = parseTrade(nodes[i], buildFailedTrades_))
+            addParsedTrade(*this, trade, nodes[i]);
     }
     LOG("Finished Parsing XML doc");
 }
@@ -144,6 +110,100 @@ void Portfolio::build(const QuantLib::ext::shared_ptr<EngineFactory>& engineFact
     QL_REQUIRE(trades_.size() > 0, "Portfolio does not contain any built trades, context is '" + context + "'");
 }
 
+void Portfolio::build(const std::function<QuantLib::ext::shared_ptr<EngineFactory>(Size)>& engineFactoryMaker,
+                      const Size nThreads, const std::string& context, const bool emitStructuredError) {
+
+    QL_REQUIRE(nThreads > 0, "Portfolio::build(): nThreads must be positive");
+    QL_REQUIRE(engineFactoryMaker, "Portfolio::build(): no engine factory maker given");
+
+    Size effThreads = std::min(nThreads, trades_.size());
+
+#ifndef QL_ENABLE_SESSIONS
+    if (effThreads > 1) {
+        WLOG("Portfolio::build(): building trades in parallel requires a build with QL_ENABLE_SESSIONS = ON, fall back "
+             "to serial build.");
+        effThreads = 1;
+    }
+#endif
+
+    if (effThreads <= 1) {
+        build(engineFactoryMaker(0), context, emitStructuredError);
+        return;
+    }
+
+    LOG("Building Portfolio of size " << trades_.size() << " for context = '" << context << "' using " << effThreads
+                                      << " threads");
+
+    std::vector<QuantLib::ext::shared_ptr<Trade>*> trades;
+    trades.reserve(trades_.size());
+    for (auto& [_, t] : trades_)
+        trades.push_back(&t);
+
+    std::vector<std::pair<QuantLib::ext::shared_ptr<Trade>, bool>> results(trades.size());
+    std::atomic<Size> next(0);
+
+    // the settings of the calling thread, the workers run in their own sessions
+
+    Date evaluationDate = Settings::instance().evaluationDate();
+    bool includeReferenceDateEvents = Settings::instance().includeReferenceDateEvents();
+    auto includeTodaysCashFlows = Settings::instance().includeTodaysCashFlows();
+    bool enforcesTodaysHistoricFixings = Settings::instance().enforcesTodaysHistoricFixings();
+
+    auto job = [this, &engineFactoryMaker, &context, emitStructuredError, &trades, &results, &next, evaluationDate,
+                includeReferenceDateEvents, includeTodaysCashFlows, enforcesTodaysHistoricFixings](Size id) {
+        Settings::instance().evaluationDate() = evaluationDate;
+        Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+        Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+        Settings::instance().enforcesTodaysHistoricFixings() = enforcesTodaysHistoricFixings;
+        auto engineFactory = engineFactoryMaker(id);
+        QL_REQUIRE(engineFactory, "Portfolio::build(): engine factory maker returned null");
+        for (Size i = next++; i < trades.size(); i = next++) {
+            results[i] = buildTrade(*trades[i], engineFactory, context, ignoreTradeBuildFail(), buildFailedTrades(),
+                                    emitStructuredError);
+        }
+    };
+
+    std::vector<std::exception_ptr> errors(effThreads);
+    std::vector<std::thread> workers;
+    for (Size w = 0; w < effThreads; ++w) {
+        workers.emplace_back([&job, &errors, w]() {
+            try {
+                job(w);
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+
+    // apply the build results in the order of the trade ids, as in the serial build
+
+    Size initialSize = trades_.size();
+    Size failedTrades = 0;
+    Size i = 0;
+    for (auto trade = trades_.begin(); trade != trades_.end(); ++i) {
+        auto& [ft, success] = results[i];
+        if (success) {
+            ++trade;
+        } else if (ft) {
+            (*trade).second = ft;
+            ++failedTrades;
+            ++trade;
+        } else {
+            trade = trades_.erase(trade);
+        }
+    }
+    LOG("Built Portfolio. Initial size = " << initialSize << ", size now " << trades_.size() << ", built "
+                                           << failedTrades << " failed trades, context is " + context);
+
+    QL_REQUIRE(trades_.size() > 0, "Portfolio does not contain any built trades, context is '" + context + "'");
+}
+
 Date Portfolio::maturity() const {
     QL_REQUIRE(trades_.size() > 0, "Cannot get maturity of an empty portfolio");
     Date mat = Date::minDate();
@@ -266,6 +326,75 @@ Portfolio::underlyingIndices(AssetClass assetClass,
     return std::set<std::string>();
 }
 
+namespace {
+// create a dummy trade with the same id and envelope as the trade in the given node
+QuantLib::ext::shared_ptr<Trade> failedTrade(XMLNode* node, const string& id, const string& tradeType) {
+    try {
+        QuantLib::ext::shared_ptr<Trade> trade = TradeFactory::instance().build("Failed");
+        // this loads only type, id and envelope, but type will be set to the original trade's type
+        trade->fromXML(node);
+        // create a dummy trade of type "Dummy"
+        QuantLib::ext::shared_ptr<FailedTrade> failedTrade = QuantLib::ext::make_shared<FailedTrade>();
+        // copy id and envelope
+        failedTrade->id() = id;
+        failedTrade->setUnderlyingTradeType(tradeType);
+        failedTrade->setEnvelope(trade->envelope());
+        WLOG("Created trade id " << failedTrade->id() << " type " << failedTrade->tradeType()
+                                 << " for original trade type " << trade->tradeType());
+        return failedTrade;
+    } catch (std::exception& ex) {
+        StructuredTradeErrorMessage(id, tradeType, "Error parsing type and envelope", ex.what()).log();
+    }
+    return nullptr;
+}
+} // namespace
+
+QuantLib::ext::shared_ptr<Trade> parseTrade(XMLNode* node, const bool buildFailedTrades) {
+    string tradeType = XMLUtils::getChildValue(node, "TradeType", true);
+
+    // Get the id attribute
+    string id = XMLUtils::getAttribute(node, "id");
+    QL_REQUIRE(id != "", "No id attribute in Trade Node");
+    DLOG("Parsing trade id:" << id);
+
+    try {
+        QuantLib::ext::shared_ptr<Trade> trade = TradeFactory::instance().build(tradeType);
+        trade->fromXML(node);
+        trade->id() = id;
+        return trade;
+    } catch (std::exception& ex) {
+        StructuredTradeErrorMessage(id, tradeType, "Error parsing Trade XML", ex.what()).log();
+    }
+
+    // If trade loading failed, then return a dummy trade with same id and envelope
+    return buildFailedTrades ? failedTrade(node, id, tradeType) : nullptr;
+}
+
+void addParsedTrade(Portfolio& portfolio, const QuantLib::ext::shared_ptr<Trade>& trade, XMLNode* node) {
+    try {
+        portfolio.add(trade);
+        DLOG("Added Trade " << trade->id() << " type:" << trade->tradeType());
+        return;
+    } catch (std::exception& ex) {
+        StructuredTradeErrorMessage(trade->id(), trade->tradeType(), "Error parsing Trade XML", ex.what()).log();
+    }
+
+    // If adding the trade failed, then insert a dummy trade with same id and envelope
+    if (portfolio.buildFailedTrades() && !QuantLib::ext::dynamic_pointer_cast<FailedTrade>(trade)) {
+        if (auto ft = failedTrade(node, trade->id(), trade->tradeType())) {
+            try {
+                portfolio.add(ft);
+                WLOG("Added trade id " << ft->id() << " type " << ft->tradeType() << " for original trade type "
+                                       << trade->tradeType());
+            } catch (std::exception& ex) {
+                StructuredTradeErrorMessage(trade->id(), trade->tradeType(), "Error parsing type and envelope",
+                                            ex.what())
+                    .log();
+            }
+        }
+    }
+}
+
 std::pair<QuantLib::ext::shared_ptr<Trade>, bool> buildTrade(QuantLib::ext::shared_ptr<Trade>& trade,
                                                      const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory,
                                                      const std::string& context, const bool ignoreTradeBuildFail,
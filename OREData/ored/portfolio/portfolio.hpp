@@ -29,6 +29,7 @@
 #include <ored/portfolio/tradefactory.hpp>
 #include <ql/time/date.hpp>
 #include <ql/types.hpp>
+#include <functional>
 #include <vector>
 
 namespace ore {
@@ -83,6 +84,22 @@ public:
     void build(const QuantLib::ext::shared_ptr<EngineFactory>&, const std::string& context = "unspecified",
                const bool emitStructuredError = true);
 
+    /*! Call build on all trades in the portfolio using nThreads worker threads. Each worker creates its own engine
+        factory by calling the given maker with its id 0, 1, ... on the worker thread, so neither the engine builders
+        nor the market are shared between threads. The maker typically builds a market for the worker, e.g. a
+        TodaysMarket from a loader cloned for this worker id. The evaluation date and the other global settings of the calling thread are set on the worker before
+        the maker is called, other singletons (e.g. the ObservationMode) have to be set up by the maker.
+
+        The trades are handed out to the workers one by one, build failures are resolved in the order of the trade ids
+        afterwards, so the resulting portfolio is the same as for the serial build. The built trades observe the market
+        objects and settings of the worker that built them.
+
+        Building in parallel requires QL_ENABLE_SESSIONS = ON, otherwise, or if nThreads is 1, the trades are built
+        serially with the engine factory created by the maker for id 0. */
+    void build(const std::function<QuantLib::ext::shared_ptr<EngineFactory>(QuantLib::Size)>& engineFactoryMaker,
+               const QuantLib::Size nThreads, const std::string& context = "unspecified",
+               const bool emitStructuredError = true);
+
     //! Calculates the maturity of the portfolio
     QuantLib::Date maturity() const;
 
@@ -134,6 +151,14 @@ private:
     std::map<AssetClass, std::set<std::string>> underlyingIndicesCache_;
 };
 
+/*! Parse a trade from a Trade node. If parsing fails, a failed trade with the same id and envelope is returned if
+    buildFailedTrades is true, otherwise nullptr. */
+QuantLib::ext::shared_ptr<Trade> parseTrade(XMLNode* node, const bool buildFailedTrades);
+
+/*! Add a trade parsed from the given Trade node to the portfolio. If this fails and the portfolio builds failed trades,
+    a failed trade with the same id and envelope is added instead. */
+void addParsedTrade(Portfolio& portfolio, const QuantLib::ext::shared_ptr<Trade>& trade, XMLNode* node);
+
 std::pair<QuantLib::ext::shared_ptr<Trade>, bool> buildTrade(
     QuantLib::ext::shared_ptr<Trade>& trade,
     const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory,
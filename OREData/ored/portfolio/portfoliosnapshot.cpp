@@ -0,0 +1,268 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/portfoliosnapshot.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/xmlutils.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/settings.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace data {
+
+namespace {
+// 64 bit FNV-1a
+constexpr std::uint64_t fnvOffset = 14695981039346656037ULL;
+std::uint64_t fnv1a(std::uint64_t h, const std::string& data) {
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+} // namespace
+
+PortfolioSnapshot::PortfolioSnapshot(const Portfolio& portfolio) {
+    entries_.reserve(portfolio.size());
+    for (auto const& [id, trade] : portfolio.trades()) {
+        XMLDocument doc;
+        entries_.push_back({id, trade->tradeType(), flatten(trade->toXML(doc))});
+    }
+    contentHash_ = computeContentHash();
+    sourceHash_ = contentHash_;
+    LOG("PortfolioSnapshot: created snapshot with " << entries_.size() << " trades from portfolio");
+}
+
+PortfolioSnapshot PortfolioSnapshot::fromPortfolioFile(const std::string& filename) {
+    std::ifstream is(filename, std::ios::binary);
+    QL_REQUIRE(is.is_open(), "PortfolioSnapshot: could not open portfolio file '" << filename << "'");
+    std::ostringstream content;
+    content << is.rdbuf();
+
+    PortfolioSnapshot snapshot;
+    snapshot.sourceHash_ = hash(content.str());
+
+    XMLDocument doc;
+    doc.fromXMLString(content.str());
+    XMLNode* node = doc.getFirstNode("Portfolio");
+    XMLUtils::checkNode(node, "Portfolio");
+    for (auto const n : XMLUtils::getChildrenNodes(node, "Trade")) {
+        std::string id = XMLUtils::getAttribute(n, "id");
+        QL_REQUIRE(id != "", "No id attribute in Trade Node");
+        snapshot.entries_.push_back({id, XMLUtils::getChildValue(n, "TradeType", true), flatten(n)});
+    }
+    snapshot.contentHash_ = snapshot.computeContentHash();
+
+    LOG("PortfolioSnapshot: created snapshot with " << snapshot.entries_.size() << " trades from '" << filename
+                                                    << "'");
+    return snapshot;
+}
+
+void PortfolioSnapshot::toFile(const std::string& filename) const {
+    std::ofstream os(filename, std::ios::binary);
+    QL_REQUIRE(os.is_open(), "PortfolioSnapshot: could not open file '" << filename << "' for writing");
+    boost::archive::binary_oarchive oa(os);
+    oa << *this;
+}
+
+void PortfolioSnapshot::fromFile(const std::string& filename) {
+    std::ifstream is(filename, std::ios::binary);
+    QL_REQUIRE(is.is_open(), "PortfolioSnapshot: could not open file '" << filename << "'");
+    boost::archive::binary_iarchive ia(is);
+    ia >> *this;
+    QL_REQUIRE(computeContentHash() == contentHash_,
+               "PortfolioSnapshot: content hash of '" << filename << "' does not match, the file is corrupted");
+}
+
+std::string PortfolioSnapshot::toBuffer() const {
+    std::ostringstream os(std::ios::binary);
+    boost::archive::binary_oarchive oa(os);
+    oa << *this;
+    return os.str();
+}
+
+void PortfolioSnapshot::fromBuffer(const std::string& buffer) {
+    std::istringstream is(buffer, std::ios::binary);
+    boost::archive::binary_iarchive ia(is);
+    ia >> *this;
+    QL_REQUIRE(computeContentHash() == contentHash_, "PortfolioSnapshot: content hash of buffer does not match");
+}
+
+std::vector<std::string> PortfolioSnapshot::tradeIds() const {
+    std::vector<std::string> ids;
+    ids.reserve(entries_.size());
+    for (auto const& e : entries_)
+        ids.push_back(e.id);
+    return ids;
+}
+
+bool PortfolioSnapshot::isCurrent(const std::string& portfolioFile) const {
+    std::ifstream is(portfolioFile, std::ios::binary);
+    if (!is.is_open())
+        return false;
+    std::ostringstream content;
+    content << is.rdbuf();
+    return hash(content.str()) == sourceHash_;
+}
+
+QuantLib::ext::shared_ptr<Portfolio> PortfolioSnapshot::portfolio(const bool buildFailedTrades,
+                                                                  const bool ignoreTradeBuildFail,
+                                                                  const std::set<std::string>& tradeIds,
+                                                                  const Size nThreads) const {
+    QL_REQUIRE(nThreads > 0, "PortfolioSnapshot::portfolio(): nThreads must be positive");
+
+    std::vector<const Entry*> entries;
+    for (auto const& e : entries_) {
+        if (tradeIds.empty() || tradeIds.find(e.id) != tradeIds.end())
+            entries.push_back(&e);
+    }
+
+    // the documents are kept until the trades are added, the nodes are needed if a trade can not be added
+    std::vector<std::unique_ptr<XMLDocument>> docs(entries.size());
+    std::vector<XMLNode*> nodes(entries.size());
+    std::vector<QuantLib::ext::shared_ptr<Trade>> trades(entries.size());
+    std::atomic<Size> next(0);
+    auto job = [&entries, &docs, &nodes, &trades, &next, buildFailedTrades]() {
+        for (Size i = next++; i < entries.size(); i = next++) {
+            docs[i] = std::make_unique<XMLDocument>();
+            nodes[i] = unflatten(*docs[i], entries[i]->nodes);
+            trades[i] = parseTrade(nodes[i], buildFailedTrades);
+        }
+    };
+
+    Size effThreads = std::min(nThreads, entries.size());
+    if (effThreads <= 1) {
+        job();
+    } else {
+#ifndef QL_ENABLE_SESSIONS
+        QL_FAIL("PortfolioSnapshot::portfolio() with nThreads > 1 requires a build with QL_ENABLE_SESSIONS = ON.");
+#endif
+        Date today = Settings::instance().evaluationDate();
+        std::vector<std::exception_ptr> errors(effThreads);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < effThreads; ++w) {
+            workers.emplace_back([&job, &errors, w, today]() {
+                try {
+                    // set thread local singletons
+                    Settings::instance().evaluationDate() = today;
+                    job();
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (auto const& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    auto result = QuantLib::ext::make_shared<Portfolio>(buildFailedTrades, ignoreTradeBuildFail);
+    for (Size i = 0; i < trades.size(); ++i) {
+        if (trades[i])
+            addParsedTrade(*result, trades[i], nodes[i]);
+    }
+    LOG("PortfolioSnapshot: loaded " << result->size() << " trades using " << std::max<Size>(effThreads, 1)
+                                     << " threads");
+    return result;
+}
+
+std::uint64_t PortfolioSnapshot::hash(const std::string& data) { return fnv1a(fnvOffset, data); }
+
+std::vector<PortfolioSnapshot::Node> PortfolioSnapshot::flatten(XMLNode* node) {
+    std::vector<Node> nodes;
+    std::vector<std::pair<XMLNode*, std::size_t>> stack(1, {node, noParent});
+    while (!stack.empty()) {
+        auto [n, parent] = stack.back();
+        stack.pop_back();
+        Node flat{n->name(), "", {}, parent};
+        for (auto a = n->first_attribute(); a; a = a->next_attribute())
+            flat.attributes.emplace_back(a->name(), a->value());
+        // push the children in reverse order, so that they are popped in document order
+        std::vector<XMLNode*> children;
+        for (auto c = n->first_node(); c; c = c->next_sibling()) {
+            if (c->type() == rapidxml::node_element)
+                children.push_back(c);
+        }
+        if (children.empty())
+            flat.value = XMLUtils::getNodeValue(n);
+        for (auto c = children.rbegin(); c != children.rend(); ++c)
+            stack.emplace_back(*c, nodes.size());
+        nodes.push_back(std::move(flat));
+    }
+    return nodes;
+}
+
+XMLNode* PortfolioSnapshot::unflatten(XMLDocument& doc, const std::vector<Node>& nodes) {
+    QL_REQUIRE(!nodes.empty() && nodes.front().parent == noParent, "PortfolioSnapshot: invalid trade record");
+    std::vector<XMLNode*> xmlNodes;
+    xmlNodes.reserve(nodes.size());
+    for (auto const& n : nodes) {
+        XMLNode* x = n.value.empty() ? doc.allocNode(n.name) : doc.allocNode(n.name, n.value);
+        for (auto const& [name, value] : n.attributes)
+            XMLUtils::addAttribute(doc, x, name, value);
+        if (n.parent == noParent) {
+            doc.appendNode(x);
+        } else {
+            QL_REQUIRE(n.parent < xmlNodes.size(), "PortfolioSnapshot: invalid trade record");
+            XMLUtils::appendNode(xmlNodes[n.parent], x);
+        }
+        xmlNodes.push_back(x);
+    }
+    return xmlNodes.front();
+}
+
+std::uint64_t PortfolioSnapshot::computeContentHash() const {
+    // the field separator ensures that shifting data between fields changes the hash
+    static const std::string separator(1, '\0');
+    std::uint64_t h = fnvOffset;
+    for (auto const& e : entries_) {
+        h = fnv1a(fnv1a(h, e.id), separator);
+        h = fnv1a(fnv1a(h, e.tradeType), separator);
+        for (auto const& n : e.nodes) {
+            h = fnv1a(fnv1a(h, n.name), separator);
+            h = fnv1a(fnv1a(h, n.value), separator);
+            for (auto const& [name, value] : n.attributes)
+                h = fnv1a(fnv1a(fnv1a(fnv1a(h, name), separator), value), separator);
+            h = fnv1a(fnv1a(h, std::to_string(n.parent)), separator);
+        }
+    }
+    return h;
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file portfolio/portfoliosnapshot.hpp
+    \brief binary snapshot of unbuilt portfolio trade data
+    \ingroup portfolio
+*/
+
+#pragma once
+
+#include <ored/utilities/xmlutils.hpp>
+
+#include <ql/shared_ptr.hpp>
+#include <ql/types.hpp>
+
+#include <boost/serialization/access.hpp>
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+class Portfolio;
+
+//! Binary snapshot of the trade data of a portfolio
+/*! The snapshot holds one record per trade with the trade id, the trade type and the trade's pre-parsed XML tree, i.e.
+    the element names, values and attributes of the trade node and its descendants. The records are written to and
+    read from a boost binary archive. Compared to the portfolio XML it
+
+    - can be created from a portfolio file without parsing the trade data into trade objects,
+    - allows to load a subset of the trades without touching the other trades' data,
+    - rebuilds the XML nodes passed to the trades' fromXML() directly from the records, so that no XML text is written
+      or parsed when trades are loaded from the snapshot,
+    - allows to load the trades on several threads,
+    - carries a hash of the source it was created from, so that stale snapshots can be detected, and a hash of its
+      own content, which is verified when a snapshot is read.
+
+    \ingroup portfolio
+*/
+class PortfolioSnapshot {
+public:
+    PortfolioSnapshot() {}
+
+    //! Create a snapshot from the trades of a portfolio, the source hash is set to the content hash
+    explicit PortfolioSnapshot(const Portfolio& portfolio);
+
+    //! Create a snapshot from a portfolio XML file, the source hash is the hash of the file content
+    static PortfolioSnapshot fromPortfolioFile(const std::string& filename);
+
+    //! \name Serialisation
+    //@{
+    void toFile(const std::string& filename) const;
+    void fromFile(const std::string& filename);
+    std::string toBuffer() const;
+    void fromBuffer(const std::string& buffer);
+    //@}
+
+    //! \name Inspectors
+    //@{
+    QuantLib::Size size() const { return entries_.size(); }
+    std::vector<std::string> tradeIds() const;
+    std::uint64_t contentHash() const { return contentHash_; }
+    std::uint64_t sourceHash() const { return sourceHash_; }
+    //! True if the snapshot was created from the given portfolio file and the file has not changed since
+    bool isCurrent(const std::string& portfolioFile) const;
+    //@}
+
+    /*! Load the trades into a new portfolio. If tradeIds is not empty, only these trades are loaded. With nThreads
+        > 1 the trades are loaded on several threads, this requires a build with QL_ENABLE_SESSIONS = ON. */
+    QuantLib::ext::shared_ptr<Portfolio> portfolio(const bool buildFailedTrades = true,
+                                                   const bool ignoreTradeBuildFail = false,
+                                                   const std::set<std::string>& tradeIds = {},
+                                                   const QuantLib::Size nThreads = 1) const;
+
+    //! 64 bit FNV-1a hash of the given data, used for the source and content hash
+    static std::uint64_t hash(const std::string& data);
+
+private:
+    //! XML element, the nodes of a trade are stored in document order, the parent of the trade node is noParent
+    struct Node {
+        std::string name, value;
+        std::vector<std::pair<std::string, std::string>> attributes;
+        std::size_t parent;
+        template <class Archive> void serialize(Archive& ar, const unsigned int version) {
+            ar& name;
+            ar& value;
+            ar& attributes;
+            ar& parent;
+        }
+    };
+    static constexpr std::size_t noParent = static_cast<std::size_t>(-1);
+
+    struct Entry {
+        std::string id, tradeType;
+        std::vector<Node> nodes;
+        template <class Archive> void serialize(Archive& ar, const unsigned int version) {
+            ar& id;
+            ar& tradeType;
+            ar& nodes;
+        }
+    };
+
+    static std::vector<Node> flatten(XMLNode* node);
+    static XMLNode* unflatten(XMLDocument& doc, const std::vector<Node>& nodes);
+    std::uint64_t computeContentHash() const;
+
+    friend class boost::serialization::access;
+    template <class Archive> void serialize(Archive& ar, const unsigned int version) {
+        ar& sourceHash_;
+        ar& contentHash_;
+        ar& entries_;
+    }
+
+    std::uint64_t sourceHash_ = 0, contentHash_ = 0;
+    std::vector<Entry> entries_;
+};
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,562 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/report/columnarreport.hpp>
+#include <ored/utilities/fileio.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/math/rounding.hpp>
+
+#include <boost/algorithm/string/join.hpp>
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+const char binaryMagic[8] = {'O', 'R', 'E', 'C', 'O', 'L', 'R', '1'};
+
+template <class T> void writePod(std::ostream& os, const T& t) { os.write(reinterpret_cast<const char*>(&t), sizeof(T)); }
+
+template <class T> void writeVector(std::ostream& os, const std::vector<T>& v) {
+    if (!v.empty())
+        os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+void writeString(std::ostream& os, const string& s) {
+    writePod(os, static_cast<std::uint64_t>(s.size()));
+    os.write(s.data(), s.size());
+}
+
+template <class T> T readPod(std::istream& is) {
+    T t;
+    is.read(reinterpret_cast<char*>(&t), sizeof(T));
+    QL_REQUIRE(is, "ColumnarReport: unexpected end of binary input");
+    return t;
+}
+
+template <class T> void readVector(std::istream& is, std::vector<T>& v, Size n) {
+    v.resize(n);
+    if (n > 0)
+        is.read(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+    QL_REQUIRE(is, "ColumnarReport: unexpected end of binary input");
+}
+
+string readString(std::istream& is) {
+    string s(readPod<std::uint64_t>(is), '\0');
+    if (!s.empty())
+        is.read(&s[0], s.size());
+    QL_REQUIRE(is, "ColumnarReport: unexpected end of binary input");
+    return s;
+}
+
+ore::data::Report::ReportType reportTypeFromWhich(int which) {
+    switch (which) {
+    case 0:
+        return Size(0);
+    case 1:
+        return Real(0.0);
+    case 2:
+        return string();
+    case 3:
+        return Date();
+    case 4:
+        return Period();
+    default:
+        QL_FAIL("ColumnarReport: invalid column type " << which);
+    }
+}
+
+} // namespace
+
+Report& ColumnarReport::addColumn(const string& name, const ReportType& rt, Size precision) {
+    Column c;
+    c.header = name;
+    c.type = rt;
+    c.precision = precision;
+    columns_.push_back(std::move(c));
+    i_++;
+    return *this;
+}
+
+Report& ColumnarReport::next() {
+    QL_REQUIRE(i_ == columns_.size(), "Cannot go to next line, only " << i_ << " entries filled, report headers are: "
+                                                                      << boost::join(headers(), ","));
+    i_ = 0;
+    return *this;
+}
+
+Report& ColumnarReport::add(const ReportType& rt) {
+    QL_REQUIRE(i_ < columns_.size(), "No column to add [" << rt << "] to.");
+    Column& c = columns_[i_];
+    QL_REQUIRE(rt.which() == c.type.which(), "Cannot add value " << rt << " of type " << rt.which() << " to column "
+                                                                 << c.header << " of type " << c.type.which()
+                                                                 << ", report headers are: "
+                                                                 << boost::join(headers(), ","));
+    switch (rt.which()) {
+    case 0:
+        c.sizes.push_back(boost::get<Size>(rt));
+        break;
+    case 1:
+        c.reals.push_back(boost::get<Real>(rt));
+        break;
+    case 2:
+        addString(c, boost::get<string>(rt));
+        break;
+    case 3:
+        c.dates.push_back(boost::get<Date>(rt));
+        break;
+    case 4:
+        c.periods.push_back(boost::get<Period>(rt));
+        break;
+    default:
+        QL_FAIL("ColumnarReport: unexpected report type " << rt.which());
+    }
+    i_++;
+    return *this;
+}
+
+void ColumnarReport::end() {
+    QL_REQUIRE(i_ == columns_.size() || i_ == 0, "report is finalized with incomplete row, got data for "
+                                                     << i_ << " columns out of " << columns()
+                                                     << ", report headers are: " << boost::join(headers(), ","));
+}
+
+std::vector<string> ColumnarReport::headers() const {
+    std::vector<string> result;
+    for (auto const& c : columns_)
+        result.push_back(c.header);
+    return result;
+}
+
+void ColumnarReport::addString(Column& c, const string& s) {
+    auto it = c.dictionaryIndex.find(s);
+    if (it == c.dictionaryIndex.end()) {
+        QL_REQUIRE(c.dictionary.size() < std::numeric_limits<std::uint32_t>::max(),
+                   "ColumnarReport: too many distinct strings in column " << c.header);
+        it = c.dictionaryIndex.emplace(s, static_cast<std::uint32_t>(c.dictionary.size())).first;
+        c.dictionary.push_back(s);
+    }
+    c.codes.push_back(it->second);
+}
+
+Size ColumnarReport::size(Size i) const {
+    const Column& c = columns_.at(i);
+    switch (c.type.which()) {
+    case 0:
+        return c.sizes.size();
+    case 1:
+        return c.reals.size();
+    case 2:
+        return c.codes.size();
+    case 3:
+        return c.dates.size();
+    case 4:
+        return c.periods.size();
+    default:
+        QL_FAIL("ColumnarReport: unexpected report type " << c.type.which());
+    }
+}
+
+Report::ReportType ColumnarReport::value(Size j, Size i) const {
+    const Column& c = columns_.at(i);
+    switch (c.type.which()) {
+    case 0:
+        return c.sizes.at(j);
+    case 1:
+        return c.reals.at(j);
+    case 2:
+        return c.dictionary[c.codes.at(j)];
+    case 3:
+        return c.dates.at(j);
+    case 4:
+        return c.periods.at(j);
+    default:
+        QL_FAIL("ColumnarReport: unexpected report type " << c.type.which());
+    }
+}
+
+const ColumnarReport::Column& ColumnarReport::column(Size i, int which) const {
+    const Column& c = columns_.at(i);
+    QL_REQUIRE(c.type.which() == which, "ColumnarReport: column " << i << " (" << c.header << ") has type "
+                                                                  << c.type.which() << ", expected " << which);
+    return c;
+}
+
+const std::vector<Size>& ColumnarReport::sizeData(Size i) const { return column(i, 0).sizes; }
+const std::vector<Real>& ColumnarReport::realData(Size i) const { return column(i, 1).reals; }
+const std::vector<std::uint32_t>& ColumnarReport::stringCodes(Size i) const { return column(i, 2).codes; }
+const std::vector<string>& ColumnarReport::stringDictionary(Size i) const { return column(i, 2).dictionary; }
+const std::vector<Date>& ColumnarReport::dateData(Size i) const { return column(i, 3).dates; }
+const std::vector<Period>& ColumnarReport::periodData(Size i) const { return column(i, 4).periods; }
+
+void ColumnarReport::clearRows() {
+    for (auto& c : columns_) {
+        c.sizes.clear();
+        c.reals.clear();
+        c.codes.clear();
+        c.dictionary.clear();
+        c.dictionaryIndex.clear();
+        c.dates.clear();
+        c.periods.clear();
+    }
+}
+
+void ColumnarReport::toFile(const string& filename, const char sep, const bool commentCharacter, char quoteChar,
+                            const string& nullString, bool lowerHeader) const {
+    ColumnarCSVWriter writer(filename, *this, sep, commentCharacter, quoteChar, nullString, lowerHeader);
+    writer.write(*this);
+    writer.close();
+}
+
+void ColumnarReport::toBinary(std::ostream& os) const {
+    Size nRows = rows();
+    for (Size i = 0; i < columns(); ++i) {
+        QL_REQUIRE(size(i) == nRows, "ColumnarReport::toBinary(): column " << i << " (" << header(i) << ") contains "
+                                                                           << size(i) << " rows, expected " << nRows);
+    }
+    os.write(binaryMagic, sizeof(binaryMagic));
+    writePod(os, static_cast<std::uint64_t>(columns()));
+    writePod(os, static_cast<std::uint64_t>(nRows));
+    for (auto const& c : columns_) {
+        writeString(os, c.header);
+        writePod(os, static_cast<std::uint8_t>(c.type.which()));
+        writePod(os, static_cast<std::uint64_t>(c.precision));
+    }
+    for (auto const& c : columns_) {
+        switch (c.type.which()) {
+        case 0:
+            if (sizeof(Size) == sizeof(std::uint64_t))
+                writeVector(os, c.sizes);
+            else
+                writeVector(os, std::vector<std::uint64_t>(c.sizes.begin(), c.sizes.end()));
+            break;
+        case 1:
+            writeVector(os, c.reals);
+            break;
+        case 2:
+            writePod(os, static_cast<std::uint64_t>(c.dictionary.size()));
+            for (auto const& s : c.dictionary)
+                writeString(os, s);
+            writeVector(os, c.codes);
+            break;
+        case 3: {
+            std::vector<std::int32_t> serials(c.dates.size());
+            for (Size j = 0; j < c.dates.size(); ++j)
+                serials[j] = static_cast<std::int32_t>(c.dates[j].serialNumber());
+            writeVector(os, serials);
+            break;
+        }
+        case 4: {
+            std::vector<std::int32_t> lengths(c.periods.size());
+            std::vector<std::int8_t> units(c.periods.size());
+            for (Size j = 0; j < c.periods.size(); ++j) {
+                lengths[j] = static_cast<std::int32_t>(c.periods[j].length());
+                units[j] = static_cast<std::int8_t>(c.periods[j].units());
+            }
+            writeVector(os, lengths);
+            writeVector(os, units);
+            break;
+        }
+        default:
+            QL_FAIL("ColumnarReport: unexpected report type " << c.type.which());
+        }
+    }
+    QL_REQUIRE(os, "ColumnarReport::toBinary(): error writing report");
+}
+
+void ColumnarReport::toBinaryFile(const string& filename) const {
+    LOG("Writing binary columnar report '" << filename << "'");
+    std::ofstream os(filename, std::ios::binary);
+    QL_REQUIRE(os.is_open(), "ColumnarReport::toBinaryFile(): error opening file '" << filename << "'");
+    toBinary(os);
+}
+
+ColumnarReport ColumnarReport::fromBinary(std::istream& is) {
+    char magic[sizeof(binaryMagic)];
+    is.read(magic, sizeof(magic));
+    QL_REQUIRE(is && std::memcmp(magic, binaryMagic, sizeof(magic)) == 0,
+               "ColumnarReport::fromBinary(): input is not a binary columnar report");
+    Size nColumns = readPod<std::uint64_t>(is);
+    Size nRows = readPod<std::uint64_t>(is);
+    ColumnarReport report;
+    for (Size i = 0; i < nColumns; ++i) {
+        string header = readString(is);
+        int which = readPod<std::uint8_t>(is);
+        Size precision = readPod<std::uint64_t>(is);
+        report.addColumn(header, reportTypeFromWhich(which), precision);
+    }
+    for (auto& c : report.columns_) {
+        switch (c.type.which()) {
+        case 0: {
+            std::vector<std::uint64_t> sizes;
+            readVector(is, sizes, nRows);
+            c.sizes.assign(sizes.begin(), sizes.end());
+            break;
+        }
+        case 1:
+            readVector(is, c.reals, nRows);
+            break;
+        case 2: {
+            Size n = readPod<std::uint64_t>(is);
+            for (Size k = 0; k < n; ++k) {
+                c.dictionary.push_back(readString(is));
+                c.dictionaryIndex.emplace(c.dictionary.back(), static_cast<std::uint32_t>(k));
+            }
+            readVector(is, c.codes, nRows);
+            for (auto const code : c.codes)
+                QL_REQUIRE(code < n, "ColumnarReport::fromBinary(): invalid string code " << code << " in column "
+                                                                                         << c.header);
+            break;
+        }
+        case 3: {
+            std::vector<std::int32_t> serials;
+            readVector(is, serials, nRows);
+            c.dates.reserve(nRows);
+            for (auto const s : serials)
+                c.dates.push_back(s == 0 ? Date() : Date(static_cast<Date::serial_type>(s)));
+            break;
+        }
+        case 4: {
+            std::vector<std::int32_t> lengths;
+            std::vector<std::int8_t> units;
+            readVector(is, lengths, nRows);
+            readVector(is, units, nRows);
+            c.periods.reserve(nRows);
+            for (Size j = 0; j < nRows; ++j)
+                c.periods.push_back(Period(lengths[j], static_cast<QuantLib::TimeUnit>(units[j])));
+            break;
+        }
+        default:
+            QL_FAIL("ColumnarReport: unexpected report type " << c.type.which());
+        }
+    }
+    return report;
+}
+
+ColumnarReport ColumnarReport::fromBinaryFile(const string& filename) {
+    std::ifstream is(filename, std::ios::binary);
+    QL_REQUIRE(is.is_open(), "ColumnarReport::fromBinaryFile(): error opening file '" << filename << "'");
+    return fromBinary(is);
+}
+
+char* formatReal(char* first, char* last, Real d, Size precision) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::to_chars_result r = precision == QuantLib::Null<Size>()
+                                 ? std::to_chars(first, last, d)
+                                 : std::to_chars(first, last, d, std::chars_format::fixed, static_cast<int>(precision));
+    QL_REQUIRE(r.ec == std::errc(), "formatReal(): can not format value " << d);
+    return r.ptr;
+#else
+    int n;
+    if (precision == QuantLib::Null<Size>()) {
+        // 17 significant digits always read back to the same double, use fewer if they are sufficient
+        for (int digits = 15; digits <= 17; ++digits) {
+            n = std::snprintf(first, last - first, "%.*g", digits, d);
+            if (n <= 0 || n >= last - first || std::strtod(first, nullptr) == d)
+                break;
+        }
+    } else {
+        n = std::snprintf(first, last - first, "%.*f", static_cast<int>(precision), d);
+    }
+    QL_REQUIRE(n > 0 && n < last - first, "formatReal(): can not format value " << d);
+    return first + n;
+#endif
+}
+
+ColumnarCSVWriter::ColumnarCSVWriter(const string& filename, const ColumnarReport& layout, const char sep,
+                                     const bool commentCharacter, char quoteChar, const string& nullString,
+                                     bool lowerHeader)
+    : filename_(filename), sep_(sep), quoteChar_(quoteChar), nullString_(nullString) {
+    LOG("Opening CSV file report '" << filename_ << "'");
+    fp_ = FileIO::fopen(filename_.c_str(), "w");
+    QL_REQUIRE(fp_, "Error opening file '" << filename_ << "'");
+    for (Size i = 0; i < layout.columns(); ++i) {
+        types_.push_back(layout.columnType(i).which());
+        precisions_.push_back(layout.columnPrecision(i));
+        if (i == 0 && commentCharacter)
+            buffer_.push_back('#');
+        if (i > 0)
+            buffer_.push_back(sep_);
+        string name = layout.header(i);
+        if (lowerHeader && !name.empty())
+            name[0] = std::tolower(static_cast<unsigned char>(name[0]));
+        buffer_.append(name);
+    }
+}
+
+ColumnarCSVWriter::~ColumnarCSVWriter() {
+    if (fp_) {
+        WLOG("CSV file report '" << filename_ << "' was not closed, call close() on the writer.");
+        fwrite(buffer_.data(), 1, buffer_.size(), fp_);
+        fclose(fp_);
+    }
+}
+
+string ColumnarCSVWriter::quoted(const string& s) const {
+    bool isQuoted = s.size() > 1 && s[0] == quoteChar_ && s[s.size() - 1] == quoteChar_;
+    if (isQuoted || quoteChar_ == '\0')
+        return s;
+    return quoteChar_ + s + quoteChar_;
+}
+
+void ColumnarCSVWriter::flush() {
+    if (!buffer_.empty()) {
+        Size n = fwrite(buffer_.data(), 1, buffer_.size(), fp_);
+        QL_REQUIRE(n == buffer_.size(), "Error writing to file '" << filename_ << "'");
+        buffer_.clear();
+    }
+}
+
+void ColumnarCSVWriter::write(const ColumnarReport& report) {
+    QL_REQUIRE(fp_, "CSV file report '" << filename_ << "' is already closed");
+    QL_REQUIRE(report.columns() == types_.size(), "ColumnarCSVWriter: report has " << report.columns()
+                                                                                   << " columns, expected "
+                                                                                   << types_.size());
+    Size nColumns = types_.size();
+    Size nRows = report.rows();
+    for (Size i = 0; i < nColumns; ++i) {
+        QL_REQUIRE(report.columnType(i).which() == types_[i], "ColumnarCSVWriter: column "
+                                                                  << i << " (" << report.header(i)
+                                                                  << ") has type " << report.columnType(i).which()
+                                                                  << ", expected " << types_[i]);
+        QL_REQUIRE(report.size(i) == nRows, "ColumnarCSVWriter: column " << i << " (" << report.header(i)
+                                                                         << ") contains " << report.size(i)
+                                                                         << " rows, expected " << nRows);
+    }
+
+    // the typed data, the formatted string dictionaries and the roundings, looked up once per column
+    std::vector<const std::vector<Size>*> sizes(nColumns, nullptr);
+    std::vector<const std::vector<Real>*> reals(nColumns, nullptr);
+    std::vector<const std::vector<std::uint32_t>*> codes(nColumns, nullptr);
+    std::vector<const std::vector<Date>*> dates(nColumns, nullptr);
+    std::vector<const std::vector<Period>*> periods(nColumns, nullptr);
+    std::vector<std::vector<string>> dictionaries(nColumns);
+    std::vector<QuantLib::Rounding> roundings(nColumns);
+    for (Size i = 0; i < nColumns; ++i) {
+        switch (types_[i]) {
+        case 0:
+            sizes[i] = &report.sizeData(i);
+            break;
+        case 1:
+            reals[i] = &report.realData(i);
+            if (precisions_[i] != QuantLib::Null<Size>())
+                roundings[i] = QuantLib::Rounding(static_cast<QuantLib::Integer>(precisions_[i]),
+                                                  QuantLib::Rounding::Closest);
+            break;
+        case 2:
+            codes[i] = &report.stringCodes(i);
+            for (auto const& s : report.stringDictionary(i))
+                dictionaries[i].push_back(quoted(s));
+            break;
+        case 3:
+            dates[i] = &report.dateData(i);
+            break;
+        case 4:
+            periods[i] = &report.periodData(i);
+            break;
+        default:
+            QL_FAIL("ColumnarCSVWriter: unexpected report type " << types_[i]);
+        }
+    }
+
+    char buf[512];
+    for (Size j = 0; j < nRows; ++j) {
+        buffer_.push_back('\n');
+        for (Size i = 0; i < nColumns; ++i) {
+            if (i != 0)
+                buffer_.push_back(sep_);
+            switch (types_[i]) {
+            case 0: {
+                Size s = (*sizes[i])[j];
+                if (s == QuantLib::Null<Size>()) {
+                    appendNull();
+                } else {
+                    auto r = std::to_chars(buf, buf + sizeof(buf), s);
+                    buffer_.append(buf, r.ptr);
+                }
+                break;
+            }
+            case 1: {
+                Real d = (*reals[i])[j];
+                if (d == QuantLib::Null<Real>() || !std::isfinite(d)) {
+                    appendNull();
+                    break;
+                }
+                if (precisions_[i] != QuantLib::Null<Size>()) {
+                    d = roundings[i](d);
+                    if (QuantLib::close_enough(d, 0.0))
+                        d = 0.0;
+                }
+                buffer_.append(buf, formatReal(buf, buf + sizeof(buf), d, precisions_[i]));
+                break;
+            }
+            case 2:
+                buffer_.append(dictionaries[i][(*codes[i])[j]]);
+                break;
+            case 3: {
+                const Date& d = (*dates[i])[j];
+                if (d == QuantLib::Null<Date>()) {
+                    appendNull();
+                } else {
+                    auto it = dates_.find(d.serialNumber());
+                    if (it == dates_.end())
+                        it = dates_.emplace(d.serialNumber(), quoted(to_string(d))).first;
+                    buffer_.append(it->second);
+                }
+                break;
+            }
+            case 4:
+                buffer_.append(quoted(to_string((*periods[i])[j])));
+                break;
+            default:
+                QL_FAIL("ColumnarCSVWriter: unexpected report type " << types_[i]);
+            }
+        }
+        if (buffer_.size() > 1048576)
+            flush();
+    }
+}
+
+void ColumnarCSVWriter::close() {
+    QL_REQUIRE(fp_, "CSV file report '" << filename_ << "' is already closed");
+    buffer_.push_back('\n');
+    flush();
+    FILE* fp = fp_;
+    fp_ = nullptr;
+    if (int rc = fclose(fp)) {
+        ALOG("CSV file report '" << filename_ << "' can not be closed (return code " << rc << ")");
+    } else {
+        LOG("CSV file report '" << filename_ << "' closed.");
+    }
+}
+
+} // namespace data
+} // namespace ore
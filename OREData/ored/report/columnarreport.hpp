@@ -0,0 +1,179 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/report/columnarreport.hpp
+    \brief Report class storing typed columns
+    \ingroup report
+*/
+
+#pragma once
+
+#include <ored/report/report.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+/*! ColumnarReport stores the report data column by column in typed vectors instead of one
+    boost::variant per cell. String columns are dictionary encoded, i.e. each distinct string is
+    stored once and the column holds 32 bit codes into the dictionary.
+
+    The report can be written to a csv file, the output is identical to the one of CSVFileReport,
+    and to a binary columnar file. The binary layout (native byte order) is
+
+    <pre>
+     char[8]   magic "ORECOLR1"
+     uint64    number of columns, number of rows
+     per column:
+       uint64 + char[]  header
+       uint8            type (0 Size, 1 Real, 2 string, 3 Date, 4 Period, see ReportType::which())
+       uint64           precision
+     per column, the data:
+       Size:   uint64[rows]
+       Real:   double[rows]
+       string: uint64 dictionary size, dictionary entries (uint64 + char[]), uint32[rows] codes
+       Date:   int32[rows] serial numbers (0 for a null date)
+       Period: int32[rows] lengths, int8[rows] time units
+    </pre>
+
+    \ingroup report
+*/
+class ColumnarReport : public Report {
+public:
+    ColumnarReport() : i_(0) {}
+
+    //! \name Report interface
+    //@{
+    Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override;
+    Report& next() override;
+    Report& add(const ReportType& rt) override;
+    void end() override;
+    //@}
+
+    //! \name Inspectors
+    //@{
+    Size columns() const { return columns_.size(); }
+    std::vector<string> headers() const;
+    //! number of rows, i.e. the size of the first column
+    Size rows() const { return columns_.empty() ? 0 : size(0); }
+    //! number of values stored in column i
+    Size size(Size i) const;
+    const string& header(Size i) const { return columns_.at(i).header; }
+    ReportType columnType(Size i) const { return columns_.at(i).type; }
+    Size columnPrecision(Size i) const { return columns_.at(i).precision; }
+    //! value in row j and column i
+    ReportType value(Size j, Size i) const;
+    //@}
+
+    //! \name Typed column access, throws if the column has a different type
+    //@{
+    const std::vector<Size>& sizeData(Size i) const;
+    const std::vector<Real>& realData(Size i) const;
+    const std::vector<std::uint32_t>& stringCodes(Size i) const;
+    const std::vector<string>& stringDictionary(Size i) const;
+    const std::vector<Date>& dateData(Size i) const;
+    const std::vector<Period>& periodData(Size i) const;
+    //@}
+
+    //! Set the column to which the next value is added
+    void jumpToColumn(Size i) { i_ = i; }
+    //! Removes all rows, the columns are kept
+    void clearRows();
+
+    //! Write the report to a csv file, see CSVFileReport for the parameters
+    void toFile(const string& filename, const char sep = ',', const bool commentCharacter = true,
+                char quoteChar = '\0', const string& nullString = "#N/A", bool lowerHeader = false) const;
+
+    //! \name Binary columnar format
+    //@{
+    void toBinary(std::ostream& os) const;
+    void toBinaryFile(const string& filename) const;
+    static ColumnarReport fromBinary(std::istream& is);
+    static ColumnarReport fromBinaryFile(const string& filename);
+    //@}
+
+private:
+    struct Column {
+        string header;
+        ReportType type;
+        Size precision = 0;
+        std::vector<Size> sizes;
+        std::vector<Real> reals;
+        std::vector<std::uint32_t> codes;
+        std::vector<string> dictionary;
+        std::unordered_map<string, std::uint32_t> dictionaryIndex;
+        std::vector<Date> dates;
+        std::vector<Period> periods;
+    };
+    const Column& column(Size i, int which) const;
+    void addString(Column& c, const string& s);
+
+    Size i_;
+    std::vector<Column> columns_;
+};
+
+/*! Writes d to [first, last) with the given number of decimals in fixed notation, or in the shortest form that
+    reads back to the same double if the precision is QuantLib::Null<Size>(), and returns the end of the output.
+    Falls back to snprintf where std::to_chars does not support floating point types.
+    \ingroup report
+*/
+char* formatReal(char* first, char* last, Real d, Size precision);
+
+/*! Writes the rows of ColumnarReport instances sharing the same columns to a csv file. The
+    output is identical to the one produced by CSVFileReport, but values are formatted without
+    going through the boost::variant visitor and fprintf, and written in large blocks.
+
+    A column precision of QuantLib::Null<Size>() writes Real values in the shortest form that
+    reads back to the same double.
+
+    \ingroup report
+*/
+class ColumnarCSVWriter {
+public:
+    ColumnarCSVWriter(const string& filename, const ColumnarReport& layout, const char sep = ',',
+                      const bool commentCharacter = true, char quoteChar = '\0', const string& nullString = "#N/A",
+                      bool lowerHeader = false);
+    ~ColumnarCSVWriter();
+    //! append the rows of the given report
+    void write(const ColumnarReport& report);
+    //! flush the buffer and close the file
+    void close();
+
+private:
+    void flush();
+    string quoted(const string& s) const;
+    void appendNull() { buffer_.append(nullString_); }
+
+    string filename_;
+    char sep_;
+    char quoteChar_;
+    string nullString_;
+    std::vector<int> types_;
+    std::vector<Size> precisions_;
+    std::unordered_map<Date::serial_type, string> dates_;
+    string buffer_;
+    FILE* fp_;
+};
+
+} // namespace data
+} // namespace ore
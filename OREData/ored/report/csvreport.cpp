@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <ored/report/columnarreport.hpp>
 #include <ored/report/csvreport.hpp>
 #include <ored/utilities/fileio.hpp>
 #include <ored/utilities/log.hpp>
@@ -38,8 +39,10 @@ namespace data {
 // Local class for printing each report type via fprintf
 class ReportTypePrinter : public boost::static_visitor<> {
 public:
-    ReportTypePrinter(FILE* fp, int prec, char quoteChar = '\0', const string& nullString = "#N/A")
-        : fp_(fp), rounding_(prec, QuantLib::Rounding::Closest), quoteChar_(quoteChar), null_(nullString) {}
+    ReportTypePrinter(FILE* fp, Size prec, char quoteChar = '\0', const string& nullString = "#N/A")
+        : fp_(fp), shortest_(prec == QuantLib::Null<Size>()),
+          rounding_(shortest_ ? 0 : static_cast<QuantLib::Integer>(prec), QuantLib::Rounding::Closest),
+          quoteChar_(quoteChar), null_(nullString) {}
 
     void operator()(const Size i) const {
         if (i == QuantLib::Null<Size>()) {
@@ -52,8 +55,17 @@ public:
         if (d == QuantLib::Null<Real>() || !std::isfinite(d)) {
             fprintNull();
         } else {
-            Real r = rounding_(d);
-            fprintf(fp_, "%.*f", rounding_.precision(), QuantLib::close_enough(r, 0.0) ? 0.0 : r);
+            // same output as fprintf("%.*f"), a null precision gives the shortest round trip representation
+            char buf[512];
+            Real r = d;
+            if (!shortest_) {
+                r = rounding_(d);
+                if (QuantLib::close_enough(r, 0.0))
+                    r = 0.0;
+            }
+            char* end = formatReal(buf, buf + sizeof(buf), r,
+                                   shortest_ ? QuantLib::Null<Size>() : static_cast<Size>(rounding_.precision()));
+            fwrite(buf, 1, end - buf, fp_);
         }
     }
     void operator()(const string& s) const { fprintString(s); }
@@ -86,6 +98,7 @@ private:
     }
 
     FILE* fp_;
+    bool shortest_;
     QuantLib::Rounding rounding_;
     char quoteChar_;
     string null_;
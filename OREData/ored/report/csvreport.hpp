@@ -33,6 +33,9 @@ namespace data {
 class ReportTypePrinter;
 /*! CSV Report class
 
+Real values are rounded to the column precision, a precision of QuantLib::Null<Size>() writes the shortest
+representation that reads back to the same value.
+
 \ingroup report
 */
 class CSVFileReport : public Report {
@@ -17,143 +17,141 @@
 */
 
 #include <ored/report/inmemoryreport.hpp>
-#include <ored/utilities/serializationdate.hpp>
-#include <ored/utilities/serializationperiod.hpp>
 
 #include <boost/algorithm/string/join.hpp>
-#include <boost/serialization/serialization.hpp>
-#include <boost/serialization/vector.hpp>
-#include <boost/serialization/variant.hpp>
-#include <boost/archive/binary_oarchive.hpp>
-#include <boost/archive/binary_iarchive.hpp>
 
+#include <cstdio>
 #include <fstream>
 
 namespace ore {
 namespace data {
 
+InMemoryReport::InMemoryReport(const InMemoryReport& other)
+    : Report(other), bufferSize_(other.bufferSize_), data_(other.data_), files_(other.files_),
+      dataCache_(other.dataCache_.size()) {}
+
 Report& InMemoryReport::addColumn(const string& name, const ReportType& rt, Size precision) {
-    headers_.push_back(name);
-    columnTypes_.push_back(rt);
-    columnPrecision_.push_back(precision);
-    data_.push_back(vector<ReportType>()); // Initialise vector for column
-    i_++;
+    data_.addColumn(name, rt, precision);
+    dataCache_.push_back(vector<ReportType>());
     return *this;
 }
 
 Report& InMemoryReport::next() {
-    QL_REQUIRE(i_ == headers_.size(), "Cannot go to next line, only " << i_ << " entries filled, report headers are: "
-                                                                      << boost::join(headers_, ","));
-    i_ = 0;
-    if (bufferSize_ && data_[0].size() == bufferSize_ && !headers_.empty()) {
+    data_.next();
+    if (bufferSize_ && columns() > 0 && data_.rows() == bufferSize_) {
         std::string s = std::tmpnam(nullptr);
         std::ofstream os(s.c_str(), std::ios::binary);
-        boost::archive::binary_oarchive oa(os, boost::archive::no_header);
-        for (Size i = 0; i < headers_.size(); i++) {
-            oa << data_[i];
-            data_[i].clear();
-        }
+        data_.toBinary(os);
         os.close();
+        data_.clearRows();
         files_.push_back(s);
     }
     return *this;
 }
 
 Report& InMemoryReport::add(const ReportType& rt) {
-    // check type is valid
-    QL_REQUIRE(i_ < headers_.size(), "No column to add [" << rt << "] to.");
-    QL_REQUIRE(rt.which() == columnTypes_[i_].which(), "Cannot add value "
-                                                           << rt << " of type " << rt.which() << " to column "
-                                                           << headers_[i_] << " of type " << columnTypes_[i_].which()
-                                                           << ", report headers are: " << boost::join(headers_, ","));
-
-    data_[i_].push_back(rt);
-    i_++;
+    data_.add(rt);
     return *this;
 }
 
 Report& InMemoryReport::add(const InMemoryReport& report) {
     QL_REQUIRE(columns() == report.columns(), "Cannot combine reports of different sizes ("
                                                   << columns() << " vs " << report.columns()
-                                                  << "), report headers are: " << boost::join(headers_, ","));
+                                                  << "), report headers are: " << boost::join(data_.headers(), ","));
     end();
     for (Size i = 0; i < columns(); i++) {
-        string h1 = headers_[i];
+        string h1 = header(i);
         string h2 = report.header(i);
         QL_REQUIRE(h1 == h2, "Cannot combine reports with different headers (\""
                                  << h1 << "\" and \"" << h2
-                                 << "\"), report headers are: " << boost::join(headers_, ","));
+                                 << "\"), report headers are: " << boost::join(data_.headers(), ","));
     }
 
-    if (i_ == headers_.size())
-        next();
-        
+    const ColumnarReport& other = report.columnarData();
     for (Size rowIdx = 0; rowIdx < report.rows(); rowIdx++) {
+        next();
         for (Size columnIdx = 0; columnIdx < report.columns(); columnIdx++) {
-            add(report.data(columnIdx)[rowIdx]);
+            add(other.value(rowIdx, columnIdx));
         }
-        next();
     }
-        
+
     return *this;
 }
 
-void InMemoryReport::end() {
-    QL_REQUIRE(i_ == headers_.size() || i_ == 0, "report is finalized with incomplete row, got data for "
-                                                     << i_ << " columns out of " << columns()
-                                                     << ", report headers are: " << boost::join(headers_, ","));
+void InMemoryReport::end() { data_.end(); }
+
+bool InMemoryReport::hasHeader(string h) const {
+    for (Size i = 0; i < columns(); ++i) {
+        if (header(i) == h)
+            return true;
+    }
+    return false;
+}
+
+void InMemoryReport::checkNotBuffered(const string& method) const {
+    QL_REQUIRE(files_.empty(), "Member function InMemoryReport::" << method << "() is not supported "
+                                                                  "when buffering is active");
 }
 
 const vector<Report::ReportType>& InMemoryReport::data(Size i) const {
-    QL_REQUIRE(files_.empty(), "Member function InMemoryReport::data() is not supported "
-        "when buffering is active");
-    QL_REQUIRE(data_[i].size() == rows(), "internal error: report column "
-                                              << i << " (" << header(i) << ") contains " << data_[i].size()
+    checkNotBuffered("data");
+    QL_REQUIRE(data_.size(i) == rows(), "internal error: report column "
+                                              << i << " (" << header(i) << ") contains " << data_.size(i)
                                               << " rows, expected are " << rows()
-                                              << " rows, report headers are: " << boost::join(headers_, ","));
-    return data_[i];
+                                              << " rows, report headers are: " << boost::join(data_.headers(), ","));
+    // rows are only ever appended, so the cached column is complete if it has the right size
+    std::lock_guard<std::mutex> lock(dataCacheMutex_);
+    vector<ReportType>& column = dataCache_.at(i);
+    if (column.size() != rows()) {
+        column.reserve(rows());
+        for (Size j = column.size(); j < rows(); ++j)
+            column.push_back(data_.value(j, i));
+    }
+    return column;
+}
+
+Report::ReportType InMemoryReport::value(Size j, Size i) const {
+    checkNotBuffered("value");
+    return data_.value(j, i);
+}
+
+const ColumnarReport& InMemoryReport::columnarData() const {
+    checkNotBuffered("columnarData");
+    return data_;
 }
 
 void InMemoryReport::toFile(const string& filename, const char sep, const bool commentCharacter, char quoteChar,
                             const string& nullString, bool lowerHeader) {
+    ColumnarCSVWriter writer(filename, data_, sep, commentCharacter, quoteChar, nullString, lowerHeader);
+    for (auto const& f : files_)
+        writer.write(ColumnarReport::fromBinaryFile(f));
+    writer.write(data_);
+    writer.close();
+}
 
-    CSVFileReport cReport(filename, sep, commentCharacter, quoteChar, nullString, lowerHeader);
-
-    for (Size i = 0; i < headers_.size(); i++) {
-        cReport.addColumn(headers_[i], columnTypes_[i], columnPrecision_[i]);
+void InMemoryReport::toBinaryFile(const string& filename) {
+    if (files_.empty()) {
+        data_.toBinaryFile(filename);
+        return;
     }
-
-    auto numColumns = columns();
-    if (numColumns > 0) {
-
-        for (auto &f : files_) {
-            vector<vector<ReportType>> data(numColumns);
-            std::ifstream is(f.c_str(), std::ios::binary);
-            boost::archive::binary_iarchive ia(is, boost::archive::no_header);
-            for (Size i = 0; i < numColumns; i++) {
-                ia >> data[i];
-            }
-            is.close();
-
-            for (Size i = 0; i < data[0].size(); i++) {
-                cReport.next();
-                for (Size j = 0; j < numColumns; j++) {
-                    cReport.add(data[j][i]);
-                }
-            }
-        }
-
-        auto numRows = data_[0].size();
-
-        for (Size i = 0; i < numRows; i++) {
-            cReport.next();
-            for (Size j = 0; j < numColumns; j++) {
-                cReport.add(data_[j][i]);
-            }
+    // collect the buffered blocks into one report
+    ColumnarReport report;
+    for (Size i = 0; i < columns(); ++i)
+        report.addColumn(header(i), columnType(i), columnPrecision(i));
+    for (auto const& f : files_) {
+        ColumnarReport block = ColumnarReport::fromBinaryFile(f);
+        for (Size j = 0; j < block.rows(); ++j) {
+            report.next();
+            for (Size i = 0; i < columns(); ++i)
+                report.add(block.value(j, i));
         }
     }
-
-    cReport.end();
+    for (Size j = 0; j < data_.rows(); ++j) {
+        report.next();
+        for (Size i = 0; i < columns(); ++i)
+            report.add(data_.value(j, i));
+    }
+    report.toBinaryFile(filename);
 }
 
 } // namespace data
@@ -23,10 +23,12 @@
 
 #pragma once
 
+#include <ored/report/columnarreport.hpp>
 #include <ored/report/csvreport.hpp>
 #include <ored/report/report.hpp>
 #include <ql/errors.hpp>
 #include <ql/tuple.hpp>
+#include <mutex>
 #include <vector>
 
 namespace ore {
@@ -36,11 +38,16 @@ using std::vector;
 
 /*! InMemoryReport just stores report information in local vectors and provides an interface to access
  *  the values. It could be used as a backend to a GUI
+ *
+ *  The values are held in a ColumnarReport, i.e. in typed columns with dictionary encoded strings. If a
+ *  buffer size is given, blocks of that many rows are moved to temporary files in binary columnar format.
  \ingroup report
  */
 class InMemoryReport : public Report {
 public:
-    explicit InMemoryReport(Size bufferSize=100000) : i_(0), bufferSize_(bufferSize) {}
+    explicit InMemoryReport(Size bufferSize=100000) : bufferSize_(bufferSize) {}
+    //! Copies the data, the converted columns returned by data() are not copied
+    InMemoryReport(const InMemoryReport& other);
 
     Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override;
     Report& next() override;
@@ -49,26 +56,33 @@ public:
     void end() override;
 
     // InMemoryInterface
-    Size columns() const { return headers_.size(); }
-    Size rows() const { return columns() == 0 ? 0 : files_.size() * bufferSize_ + data_[0].size(); }
-    const string& header(Size i) const { return headers_[i]; }
-    bool hasHeader(string h) const { return std::find(headers_.begin(), headers_.end(), h) != headers_.end(); }
-    ReportType columnType(Size i) const { return columnTypes_[i]; }
-    Size columnPrecision(Size i) const { return columnPrecision_[i]; }
-    //! Returns the data
+    Size columns() const { return data_.columns(); }
+    Size rows() const { return columns() == 0 ? 0 : files_.size() * bufferSize_ + data_.rows(); }
+    const string& header(Size i) const { return data_.header(i); }
+    bool hasHeader(string h) const;
+    ReportType columnType(Size i) const { return data_.columnType(i); }
+    Size columnPrecision(Size i) const { return data_.columnPrecision(i); }
+    /*! Returns the data, the column is converted to report types on first access and kept alongside the typed
+        column, i.e. it takes additional memory. Use value() to read single values without this copy. */
     const vector<ReportType>& data(Size i) const;
+    //! Returns the value in row j and column i
+    ReportType value(Size j, Size i) const;
+    //! Returns the typed columns, not supported when buffering is active
+    const ColumnarReport& columnarData() const;
     void toFile(const string& filename, const char sep = ',', const bool commentCharacter = true, char quoteChar = '\0',
                 const string& nullString = "#N/A", bool lowerHeader = false);
-    void jumpToColumn(Size i) { i_ = i; }
+    //! Write the report in binary columnar format, see ColumnarReport
+    void toBinaryFile(const string& filename);
+    void jumpToColumn(Size i) { data_.jumpToColumn(i); }
 
 private:
-    Size i_;
+    void checkNotBuffered(const string& method) const;
+
     Size bufferSize_;
-    vector<string> headers_;
-    vector<ReportType> columnTypes_;
-    vector<Size> columnPrecision_;
-    vector<vector<ReportType>> data_;
+    ColumnarReport data_;
     vector<string> files_;
+    mutable vector<vector<ReportType>> dataCache_;
+    mutable std::mutex dataCacheMutex_;
 };
 
 //! InMemoryReport with access to plain types instead of boost::variant<>, to facilitate language bindings
@@ -87,12 +101,12 @@ public:
     vector<Date> dataAsDate(Size i) const { return data_T<Date>(i, 3); }
     vector<Period> dataAsPeriod(Size i) const { return data_T<Period>(i, 4); }
     // for convenience, access by row j and column i
-    Size rows() const { return columns() == 0 ? 0 : imReport_->data(0).size(); }
-    int dataAsSize(Size j, Size i) const { return int(boost::get<Size>(imReport_->data(i).at(j))); }
-    Real dataAsReal(Size j, Size i) const { return boost::get<Real>(imReport_->data(i).at(j)); }
-    string dataAsString(Size j, Size i) const { return boost::get<string>(imReport_->data(i).at(j)); }
-    Date dataAsDate(Size j, Size i) const { return boost::get<Date>(imReport_->data(i).at(j)); }
-    Period dataAsPeriod(Size j, Size i) const { return boost::get<Period>(imReport_->data(i).at(j)); }
+    Size rows() const { return imReport_->rows(); }
+    int dataAsSize(Size j, Size i) const { return int(boost::get<Size>(imReport_->value(j, i))); }
+    Real dataAsReal(Size j, Size i) const { return boost::get<Real>(imReport_->value(j, i)); }
+    string dataAsString(Size j, Size i) const { return boost::get<string>(imReport_->value(j, i)); }
+    Date dataAsDate(Size j, Size i) const { return boost::get<Date>(imReport_->value(j, i)); }
+    Period dataAsPeriod(Size j, Size i) const { return boost::get<Period>(imReport_->value(j, i)); }
 
 private:
     template <typename T> vector<T> data_T(Size i, Size w) const {
@@ -53,6 +53,11 @@ public:
     bool lastCalculationWasValid() const { return lastCalculationWasValid_; }
     const std::string& npvName() const { return npv_; }
 
+    //! true if the engine computes the npv from cached sensitivities w.r.t. the model parameters
+    bool useCachedSensis() const { return useCachedSensis_; }
+    //! true if the cached base npv and sensitivities are available
+    bool haveCachedSensis() const { return useCachedSensis_ && haveBaseValues_; }
+
     void buildComputationGraph() const;
 
 private:
@@ -64,6 +64,53 @@ BOOST_AUTO_TEST_CASE(testSimpleCBO) {
     BOOST_CHECK_CLOSE(p.get("CBO-Constellation")->instrument()->NPV(), expectedNpv, tol);
 }
 
+BOOST_AUTO_TEST_CASE(testMultiThreadedCBO) {
+    BOOST_TEST_MESSAGE("Testing simple CBO with multi-threaded waterfall computation...");
+
+    Settings::instance().evaluationDate() = Date(31, Dec, 2018);
+    Date asof = Settings::instance().evaluationDate();
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto loader = QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"), false);
+    auto market = QuantLib::ext::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs, false);
+
+    // price with one thread and with several threads and small blocks, the results must be identical
+    std::vector<Real> npvs;
+    for (auto const& [threads, blockSize] : std::vector<std::pair<std::string, std::string>>{{"1", "1000"}, {"4", "3"}}) {
+        QuantLib::ext::shared_ptr<EngineData> engineData = QuantLib::ext::make_shared<EngineData>();
+        engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+        engineData->engineParameters("CBO")["Threads"] = threads;
+        engineData->engineParameters("CBO")["BlockSize"] = blockSize;
+        QuantLib::ext::shared_ptr<EngineFactory> factory = QuantLib::ext::make_shared<EngineFactory>(engineData, market);
+
+        Portfolio p;
+        BOOST_CHECK_NO_THROW(p.fromFile(TEST_INPUT_FILE("cbo.xml")));
+        BOOST_CHECK_NO_THROW(p.build(factory));
+        npvs.push_back(p.get("CBO-Constellation")->instrument()->NPV());
+        BOOST_TEST_MESSAGE("threads " << threads << ", block size " << blockSize << ": " << npvs.back());
+    }
+
+    BOOST_CHECK_EQUAL(npvs[0], npvs[1]);
+    BOOST_CHECK_CLOSE(npvs[1], 3013120.939, 0.01);
+
+    // a non-positive thread count is rejected by the engine builder, the trade is built as a failed trade
+    QuantLib::ext::shared_ptr<EngineData> engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    engineData->engineParameters("CBO")["Threads"] = "0";
+    QuantLib::ext::shared_ptr<EngineFactory> factory = QuantLib::ext::make_shared<EngineFactory>(engineData, market);
+    Portfolio p;
+    BOOST_CHECK_NO_THROW(p.fromFile(TEST_INPUT_FILE("cbo.xml")));
+    BOOST_CHECK_NO_THROW(p.build(factory));
+    BOOST_CHECK_EQUAL(p.get("CBO-Constellation")->tradeType(), "Failed");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,15 +18,50 @@
 
 #include <boost/make_shared.hpp>
 #include <boost/test/unit_test.hpp>
+#include <ored/marketdata/marketimpl.hpp>
+#include <ored/portfolio/enginedata.hpp>
 #include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/portfoliosnapshot.hpp>
 #include <oret/toplevelfixture.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
 
 using namespace QuantLib;
 using namespace boost::unit_test_framework;
 using namespace std;
 using namespace ore::data;
 
+namespace {
+
+class TestMarket : public MarketImpl {
+public:
+    TestMarket(const Date& asof) : MarketImpl(false) {
+        asof_ = asof;
+        yieldCurves_[make_tuple(Market::defaultConfiguration, YieldCurveType::Discount, "EUR")] = flatRateYts(0.02);
+        yieldCurves_[make_tuple(Market::defaultConfiguration, YieldCurveType::Discount, "USD")] = flatRateYts(0.03);
+        std::map<std::string, Handle<Quote>> quotes;
+        quotes["EURUSD"] = Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(1.2));
+        fx_ = QuantLib::ext::make_shared<FXTriangulation>(quotes);
+    }
+
+private:
+    Handle<YieldTermStructure> flatRateYts(Real forward) {
+        return Handle<YieldTermStructure>(
+            QuantLib::ext::make_shared<FlatForward>(asof_, forward, Actual365Fixed()));
+    }
+};
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(PortfolioTests)
@@ -119,6 +154,182 @@ BOOST_AUTO_TEST_CASE(testIds) {
     BOOST_CHECK(portfolio->ids() == trade_ids);
 }
 
+BOOST_AUTO_TEST_CASE(testSnapshot) {
+
+    BOOST_TEST_MESSAGE("Testing portfolio snapshot...");
+
+    Portfolio portfolio;
+    for (Size i = 0; i < 10; ++i) {
+        auto trade =
+            QuantLib::ext::make_shared<FxForward>(Envelope("CP"), "2016-02-03", "USD", 1.2E6 + 1000.0 * i, "EUR", 1.0E6);
+        trade->id() = "FxFwd_" + std::to_string(i);
+        portfolio.add(trade);
+    }
+
+    PortfolioSnapshot snapshot(portfolio);
+    BOOST_CHECK_EQUAL(snapshot.size(), portfolio.size());
+
+    // round trip through the binary format
+    std::string buffer = snapshot.toBuffer();
+    PortfolioSnapshot snapshot2;
+    snapshot2.fromBuffer(buffer);
+    BOOST_CHECK_EQUAL(snapshot2.contentHash(), snapshot.contentHash());
+    BOOST_CHECK_EQUAL(snapshot2.portfolio()->toXMLString(), portfolio.toXMLString());
+
+    // subset
+    auto subset = snapshot2.portfolio(true, false, {"FxFwd_3", "FxFwd_7"});
+    BOOST_CHECK(subset->ids() == std::set<std::string>({"FxFwd_3", "FxFwd_7"}));
+
+    // a corrupted buffer is detected
+    std::size_t pos = buffer.find("FxFwd_5");
+    BOOST_REQUIRE(pos != std::string::npos);
+    buffer[pos] = 'X';
+    BOOST_CHECK_THROW(snapshot2.fromBuffer(buffer), std::exception);
+
+    // snapshot from a portfolio file and stale check
+    std::string filename = "portfoliosnapshot_test.xml";
+    portfolio.toFile(filename);
+    auto fileSnapshot = PortfolioSnapshot::fromPortfolioFile(filename);
+    BOOST_CHECK(fileSnapshot.isCurrent(filename));
+    BOOST_CHECK_EQUAL(fileSnapshot.portfolio()->toXMLString(), portfolio.toXMLString());
+    portfolio.remove("FxFwd_0");
+    portfolio.toFile(filename);
+    BOOST_CHECK(!fileSnapshot.isCurrent(filename));
+    std::remove(filename.c_str());
+
+    // trades that can not be parsed or added are handled as in Portfolio::fromXML
+    std::string xml = "<Portfolio>"
+                      "<Trade id=\"Bad\"><TradeType>UnknownTradeType</TradeType>"
+                      "<Envelope><CounterParty>CP</CounterParty></Envelope></Trade>" +
+                      portfolio.get("FxFwd_1")->toXMLString() + portfolio.get("FxFwd_1")->toXMLString() +
+                      "</Portfolio>";
+    Portfolio fromXml;
+    fromXml.fromXMLString(xml);
+    {
+        std::ofstream os(filename);
+        os << xml;
+    }
+    auto badSnapshot = PortfolioSnapshot::fromPortfolioFile(filename);
+    std::remove(filename.c_str());
+    auto fromSnapshot = badSnapshot.portfolio();
+    BOOST_CHECK(fromSnapshot->ids() == std::set<std::string>({"Bad", "FxFwd_1"}));
+    BOOST_CHECK_EQUAL(fromSnapshot->get("Bad")->tradeType(), "Failed");
+    BOOST_CHECK_EQUAL(fromSnapshot->toXMLString(), fromXml.toXMLString());
+}
+
+BOOST_AUTO_TEST_CASE(testSnapshotMultiThreaded) {
+
+    BOOST_TEST_MESSAGE("Testing portfolio snapshot loaded on several threads...");
+
+    Date today(3, Feb, 2015);
+    Settings::instance().evaluationDate() = today;
+
+    // every 7th trade has an unknown currency and fails to build, one trade can not be parsed
+    std::string xml = "<Portfolio><Trade id=\"Bad\"><TradeType>UnknownTradeType</TradeType>"
+                      "<Envelope><CounterParty>CP</CounterParty></Envelope></Trade>";
+    for (Size i = 0; i < 50; ++i) {
+        FxForward trade(Envelope("CP"), "2016-02-03", i % 7 == 3 ? "ABC" : "USD", 1.2E6 + 1000.0 * i, "EUR", 1.0E6);
+        trade.id() = "FxFwd_" + std::to_string(i);
+        xml += trade.toXMLString();
+    }
+    xml += "</Portfolio>";
+    std::string filename = "portfoliosnapshot_mt_test.xml";
+    {
+        std::ofstream os(filename);
+        os << xml;
+    }
+    auto snapshot = PortfolioSnapshot::fromPortfolioFile(filename);
+    std::remove(filename.c_str());
+
+    auto serial = snapshot.portfolio(true, false, {}, 1);
+
+#ifdef QL_ENABLE_SESSIONS
+    auto parallel = snapshot.portfolio(true, false, {}, 4);
+#else
+    BOOST_CHECK_THROW(snapshot.portfolio(true, false, {}, 4), std::exception);
+    auto parallel = snapshot.portfolio(true, false, {}, 1);
+#endif
+
+    BOOST_CHECK(parallel->ids() == serial->ids());
+    BOOST_CHECK_EQUAL(parallel->size(), 51);
+    BOOST_CHECK_EQUAL(parallel->toXMLString(), serial->toXMLString());
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("FxForward") = "DiscountedCashflows";
+    engineData->engine("FxForward") = "DiscountingFxForwardEngine";
+    auto engineFactory =
+        QuantLib::ext::make_shared<EngineFactory>(engineData, QuantLib::ext::make_shared<TestMarket>(today));
+    serial->build(engineFactory);
+    parallel->build(engineFactory);
+
+    BOOST_REQUIRE_EQUAL(parallel->size(), serial->size());
+    for (auto const& [id, t] : serial->trades()) {
+        auto p = parallel->get(id);
+        BOOST_REQUIRE(p != nullptr);
+        BOOST_CHECK_EQUAL(p->tradeType(), t->tradeType());
+        BOOST_CHECK_CLOSE(p->instrument()->NPV(), t->instrument()->NPV(), 1.0E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testParallelBuild) {
+
+    BOOST_TEST_MESSAGE("Testing parallel portfolio build...");
+
+    Date today(3, Feb, 2015);
+    Settings::instance().evaluationDate() = today;
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("FxForward") = "DiscountedCashflows";
+    engineData->engine("FxForward") = "DiscountingFxForwardEngine";
+
+    // each call creates a new market and engine factory, the threads calling the maker are recorded
+    std::mutex mutex;
+    std::set<std::thread::id> makerThreads;
+    auto engineFactoryMaker = [&engineData, &mutex, &makerThreads](Size) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            makerThreads.insert(std::this_thread::get_id());
+        }
+        // the evaluation date is set on the workers by the build
+        Date asof = Settings::instance().evaluationDate();
+        return QuantLib::ext::make_shared<EngineFactory>(engineData, QuantLib::ext::make_shared<TestMarket>(asof));
+    };
+
+    auto makePortfolio = []() {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        for (Size i = 0; i < 50; ++i) {
+            // every 7th trade has an unknown currency and fails to build
+            auto trade = QuantLib::ext::make_shared<FxForward>(Envelope("CP"), "2016-02-03", i % 7 == 3 ? "ABC" : "USD",
+                                                               1.2E6 + 1000.0 * i, "EUR", 1.0E6);
+            trade->id() = "FxFwd_" + std::to_string(i);
+            portfolio->add(trade);
+        }
+        return portfolio;
+    };
+
+    auto serial = makePortfolio();
+    serial->build(engineFactoryMaker(0));
+    auto parallel = makePortfolio();
+    makerThreads.clear();
+    parallel->build(engineFactoryMaker, 4);
+
+#ifdef QL_ENABLE_SESSIONS
+    // one factory per worker, none of them created on this thread
+    BOOST_CHECK_EQUAL(makerThreads.size(), 4);
+    BOOST_CHECK(makerThreads.find(std::this_thread::get_id()) == makerThreads.end());
+#else
+    BOOST_CHECK_EQUAL(makerThreads.size(), 1);
+#endif
+
+    BOOST_REQUIRE_EQUAL(parallel->size(), serial->size());
+    for (auto const& [id, t] : serial->trades()) {
+        auto p = parallel->get(id);
+        BOOST_REQUIRE(p != nullptr);
+        BOOST_CHECK_EQUAL(p->tradeType(), t->tradeType());
+        BOOST_CHECK_CLOSE(p->instrument()->NPV(), t->instrument()->NPV(), 1.0E-10);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
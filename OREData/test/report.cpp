@@ -0,0 +1,174 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <ored/report/columnarreport.hpp>
+#include <ored/report/csvreport.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace ore::data;
+using namespace boost::unit_test_framework;
+using namespace std;
+using namespace QuantLib;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+string tempFile() { return (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string(); }
+
+string readFile(const string& fileName) {
+    std::ifstream is(fileName);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+// fills a report with a few rows covering all column types, null values and repeated strings
+void fillReport(Report& report) {
+    report.addColumn("TradeId", string())
+        .addColumn("Index", Size())
+        .addColumn("NPV", Real(), 2)
+        .addColumn("Value", Real(), Null<Size>())
+        .addColumn("Date", Date())
+        .addColumn("Tenor", Period());
+    for (Size i = 0; i < 7; ++i) {
+        report.next()
+            .add("trade_" + std::to_string(i % 3))
+            .add(i == 4 ? Null<Size>() : i)
+            .add(i == 5 ? Null<Real>() : -1234.565 * i + 0.001)
+            .add(0.1 * i + 1.0 / 3.0)
+            .add(i == 2 ? Date() : Date(15, March, 2024) + static_cast<Integer>(i))
+            .add(Period(static_cast<Integer>(i) + 1, Months));
+    }
+    report.end();
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ReportTests)
+
+BOOST_AUTO_TEST_CASE(testColumnarReportCsvOutput) {
+
+    BOOST_TEST_MESSAGE("Testing columnar report csv output against CSVFileReport");
+
+    string csvFile = tempFile(), columnarFile = tempFile(), inMemoryFile = tempFile();
+    {
+        CSVFileReport csvReport(csvFile, ';', true, '"', "NA");
+        fillReport(csvReport);
+    }
+
+    ColumnarReport columnarReport;
+    fillReport(columnarReport);
+    columnarReport.toFile(columnarFile, ';', true, '"', "NA");
+
+    // buffer blocks of three rows to temporary files
+    InMemoryReport inMemoryReport(3);
+    fillReport(inMemoryReport);
+    inMemoryReport.toFile(inMemoryFile, ';', true, '"', "NA");
+
+    string expected = readFile(csvFile);
+    BOOST_CHECK_EQUAL(readFile(columnarFile), expected);
+    BOOST_CHECK_EQUAL(readFile(inMemoryFile), expected);
+
+    // the strings are dictionary encoded, the null precision column is written in shortest round trip form
+    BOOST_CHECK_EQUAL(columnarReport.stringDictionary(0).size(), Size(3));
+    BOOST_CHECK(expected.find(";0.3333333333333333;") != string::npos);
+
+    boost::filesystem::remove(csvFile);
+    boost::filesystem::remove(columnarFile);
+    boost::filesystem::remove(inMemoryFile);
+}
+
+BOOST_AUTO_TEST_CASE(testColumnarReportBinaryRoundTrip) {
+
+    BOOST_TEST_MESSAGE("Testing columnar report binary format round trip");
+
+    InMemoryReport report(3);
+    fillReport(report);
+    string binaryFile = tempFile();
+    report.toBinaryFile(binaryFile);
+
+    ColumnarReport expected;
+    fillReport(expected);
+    ColumnarReport restored = ColumnarReport::fromBinaryFile(binaryFile);
+    BOOST_REQUIRE_EQUAL(restored.columns(), expected.columns());
+    BOOST_REQUIRE_EQUAL(restored.rows(), expected.rows());
+    for (Size i = 0; i < expected.columns(); ++i) {
+        BOOST_CHECK_EQUAL(restored.header(i), expected.header(i));
+        BOOST_CHECK_EQUAL(restored.columnType(i).which(), expected.columnType(i).which());
+        BOOST_CHECK_EQUAL(restored.columnPrecision(i), expected.columnPrecision(i));
+        for (Size j = 0; j < expected.rows(); ++j)
+            BOOST_CHECK(restored.value(j, i) == expected.value(j, i));
+    }
+
+    std::stringstream garbage("not a report");
+    BOOST_CHECK_THROW(ColumnarReport::fromBinary(garbage), QuantLib::Error);
+
+    boost::filesystem::remove(binaryFile);
+}
+
+BOOST_AUTO_TEST_CASE(testInMemoryReportConcurrentDataAccess) {
+
+    BOOST_TEST_MESSAGE("Testing concurrent access to the in memory report columns");
+
+    InMemoryReport report(0);
+    fillReport(report);
+
+    // the columns are converted on first access, concurrent readers see the same complete columns
+    using Column = vector<Report::ReportType>;
+    vector<vector<const Column*>> columns(4, vector<const Column*>(report.columns()));
+    vector<std::thread> threads;
+    for (Size t = 0; t < columns.size(); ++t) {
+        threads.emplace_back([&report, &columns, t]() {
+            for (Size i = 0; i < report.columns(); ++i)
+                columns[t][i] = &report.data(i);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    for (Size i = 0; i < report.columns(); ++i) {
+        for (Size t = 1; t < columns.size(); ++t)
+            BOOST_CHECK(columns[t][i] == columns[0][i]);
+        BOOST_REQUIRE_EQUAL(columns[0][i]->size(), report.rows());
+        for (Size j = 0; j < report.rows(); ++j)
+            BOOST_CHECK((*columns[0][i])[j] == report.value(j, i));
+    }
+
+    // a copy converts its own columns
+    InMemoryReport copy(report);
+    BOOST_REQUIRE_EQUAL(copy.rows(), report.rows());
+    for (Size i = 0; i < report.columns(); ++i) {
+        BOOST_CHECK(&copy.data(i) != &report.data(i));
+        BOOST_CHECK(copy.data(i) == report.data(i));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
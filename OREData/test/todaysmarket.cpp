@@ -1038,6 +1038,198 @@ BOOST_AUTO_TEST_CASE(testCorrelationCurve) {
     BOOST_CHECK_SMALL(npvCash - expectedNpv2Y, 0.000001);
 }
 
+BOOST_AUTO_TEST_CASE(testYieldCurvesFromBootstrappedNodes) {
+
+    BOOST_TEST_MESSAGE("Testing yield curves rebuilt from bootstrapped nodes...");
+
+    auto nodes = market->bootstrappedYieldCurveNodes();
+    BOOST_REQUIRE(!nodes.empty());
+
+    auto market2 = QuantLib::ext::make_shared<TodaysMarket>(market->asofDate(), marketParameters(),
+                                                            QuantLib::ext::make_shared<MarketDataLoader>(),
+                                                            curveConfigurations(), false, true, false, nullptr, false,
+                                                            IborFallbackConfig::defaultConfig(), true, true, nodes);
+
+    // the second market must not bootstrap again, but reproduce the same nodes
+    auto nodes2 = market2->bootstrappedYieldCurveNodes();
+    BOOST_REQUIRE_EQUAL(nodes2.size(), nodes.size());
+    for (auto const& [name, n] : nodes) {
+        BOOST_CHECK(nodes2.at(name) == n);
+    }
+
+    for (auto const& c : {"EUR", "USD"}) {
+        Handle<YieldTermStructure> ts1 = market->discountCurve(c);
+        Handle<YieldTermStructure> ts2 = market2->discountCurve(c);
+        for (Size i = 1; i <= 360; ++i) {
+            Date d = market->asofDate() + i * Months;
+            BOOST_CHECK_EQUAL(ts1->discount(d), ts2->discount(d));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testYieldCurvesFromStaleBootstrappedNodes) {
+
+    BOOST_TEST_MESSAGE("Testing yield curves are bootstrapped again for nodes from different inputs...");
+
+    auto nodes = market->bootstrappedYieldCurveNodes();
+    BOOST_REQUIRE(!nodes.empty());
+
+    // nodes claiming to be from different market data or from a different asof date
+    BootstrappedYieldCurveNodes staleNodes;
+    bool changeAsof = false;
+    for (auto const& [name, n] : nodes) {
+        auto stale = QuantLib::ext::make_shared<YieldCurve::BootstrappedNodes>(*n);
+        if (changeAsof)
+            stale->asof = n->asof - 1;
+        else
+            stale->inputHash = n->inputHash + 1;
+        // values which would show up in the curves, if the nodes were used
+        for (auto& v : stale->values)
+            v *= 2.0;
+        staleNodes[name] = stale;
+        changeAsof = !changeAsof;
+    }
+
+    auto market2 = QuantLib::ext::make_shared<TodaysMarket>(market->asofDate(), marketParameters(),
+                                                            QuantLib::ext::make_shared<MarketDataLoader>(),
+                                                            curveConfigurations(), false, true, false, nullptr, false,
+                                                            IborFallbackConfig::defaultConfig(), true, true, staleNodes);
+
+    // all curves are bootstrapped again and reproduce the original nodes
+    auto nodes2 = market2->bootstrappedYieldCurveNodes();
+    BOOST_REQUIRE_EQUAL(nodes2.size(), nodes.size());
+    for (auto const& [name, n] : nodes) {
+        BOOST_CHECK(nodes2.at(name) != staleNodes.at(name));
+        BOOST_CHECK_EQUAL(nodes2.at(name)->inputHash, n->inputHash);
+        BOOST_REQUIRE_EQUAL(nodes2.at(name)->values.size(), n->values.size());
+        for (Size i = 0; i < n->values.size(); ++i)
+            BOOST_CHECK_CLOSE(nodes2.at(name)->values[i], n->values[i], 1E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testIncrementalUpdate) {
+
+    BOOST_TEST_MESSAGE("Testing incremental update of todays market...");
+
+    Date asof = market->asofDate();
+    auto loader = QuantLib::ext::make_shared<MarketDataLoader>();
+    auto market1 = QuantLib::ext::make_shared<TodaysMarket>(asof, marketParameters(), loader, curveConfigurations());
+
+    Handle<YieldTermStructure> eurDiscount = market1->discountCurve("EUR");
+    Handle<YieldTermStructure> eurLend = market1->yieldCurve("EUR_LEND");
+    Handle<YieldTermStructure> usdDiscount = market1->discountCurve("USD");
+    auto eonia = *market1->iborIndex("EUR-EONIA");
+    auto usdCurve = usdDiscount.currentLink();
+    Date d = asof + 10 * Years;
+    Real eurDiscount10Y = eurDiscount->discount(d);
+
+    // shift one quote of the EUR Eonia curve
+    string name = "IR_SWAP/RATE/EUR/2D/1D/5Y";
+    auto md = QuantLib::ext::make_shared<MarketDatum>(loader->get(name, asof)->quote()->value() + 0.0010, asof, name,
+                                                      MarketDatum::QuoteType::RATE, MarketDatum::InstrumentType::IR_SWAP);
+    BOOST_CHECK_GT(market1->update({md}), Size(0));
+    BOOST_CHECK(std::fabs(eurDiscount->discount(d) - eurDiscount10Y) > 1.0E-6);
+
+    // the USD curves are not affected and not rebuilt
+    BOOST_CHECK(usdDiscount.currentLink() == usdCurve);
+
+    // the handles obtained before the update see the same curves as a market built from scratch
+    auto market2 = QuantLib::ext::make_shared<TodaysMarket>(asof, marketParameters(), loader, curveConfigurations());
+    for (Size i = 1; i <= 240; ++i) {
+        Date t = asof + i * Months;
+        BOOST_CHECK_CLOSE(eurDiscount->discount(t), market2->discountCurve("EUR")->discount(t), 1.0E-10);
+        BOOST_CHECK_CLOSE(eurLend->discount(t), market2->yieldCurve("EUR_LEND")->discount(t), 1.0E-10);
+        BOOST_CHECK_CLOSE(eonia->forwardingTermStructure()->discount(t),
+                          market2->iborIndex("EUR-EONIA")->forwardingTermStructure()->discount(t), 1.0E-10);
+        BOOST_CHECK_CLOSE(usdDiscount->discount(t), market2->discountCurve("USD")->discount(t), 1.0E-10);
+    }
+
+    // quotes unknown to the loader can not be updated
+    auto unknown = QuantLib::ext::make_shared<MarketDatum>(0.01, asof, "IR_SWAP/RATE/EUR/2D/1D/99Y",
+                                                           MarketDatum::QuoteType::RATE,
+                                                           MarketDatum::InstrumentType::IR_SWAP);
+    BOOST_CHECK_THROW(market1->update({unknown}), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testIncrementalUpdateIndices) {
+
+    BOOST_TEST_MESSAGE("Testing indices obtained before an incremental update of todays market...");
+
+    Date asof = market->asofDate();
+    auto loader = QuantLib::ext::make_shared<MarketDataLoader>();
+    auto market1 = QuantLib::ext::make_shared<TodaysMarket>(asof, marketParameters(), loader, curveConfigurations());
+
+    // the index objects, as e.g. held by the legs of a trade
+    auto fedFunds = *market1->iborIndex("USD-FedFunds");
+    auto libor = *market1->iborIndex("USD-LIBOR-3M");
+    auto cms = *market1->swapIndex("USD-CMS-10Y");
+    auto sp5 = *market1->equityCurve("SP5");
+    auto gold = *market1->commodityIndex("COMDTY_GOLD_USD");
+    Date d = fedFunds->fixingCalendar().adjust(asof + 2 * Years);
+    Date liborDate = libor->fixingCalendar().adjust(d);
+    Date cmsDate = cms->fixingCalendar().adjust(d);
+    Date sp5Date = sp5->fixingCalendar().adjust(d);
+    Date goldDate = gold->fixingCalendar().adjust(Date(31, December, 2018));
+    Real sp5Fixing = sp5->fixing(sp5Date), goldFixing = gold->fixing(goldDate);
+
+    // shift a quote of the USD Fed Funds curve, which is the forecast curve of SP5, and a gold forward quote
+    vector<QuantLib::ext::shared_ptr<MarketDatum>> data;
+    for (auto const& name : {"IR_SWAP/RATE/USD/2D/1D/2Y", "COMMODITY_FWD/PRICE/GOLD/USD/2018-12-31"}) {
+        auto md = loader->get(name, asof);
+        Real shift = md->quoteType() == MarketDatum::QuoteType::PRICE ? 10.0 : 0.0010;
+        data.push_back(QuantLib::ext::make_shared<MarketDatum>(md->quote()->value() + shift, asof, name,
+                                                               md->quoteType(), md->instrumentType()));
+    }
+    BOOST_CHECK_GT(market1->update(data), Size(0));
+    BOOST_CHECK(std::fabs(sp5->fixing(sp5Date) - sp5Fixing) > 1.0E-6);
+    BOOST_CHECK(std::fabs(gold->fixing(goldDate) - goldFixing) > 1.0E-6);
+
+    // the indices obtained before the update forecast off the rebuilt curves
+    auto market2 = QuantLib::ext::make_shared<TodaysMarket>(asof, marketParameters(), loader, curveConfigurations());
+    BOOST_CHECK_CLOSE(fedFunds->fixing(d), market2->iborIndex("USD-FedFunds")->fixing(d), 1.0E-10);
+    BOOST_CHECK_CLOSE(libor->fixing(liborDate), market2->iborIndex("USD-LIBOR-3M")->fixing(liborDate), 1.0E-10);
+    BOOST_CHECK_CLOSE(cms->fixing(cmsDate), market2->swapIndex("USD-CMS-10Y")->fixing(cmsDate), 1.0E-10);
+    BOOST_CHECK_CLOSE(sp5->fixing(sp5Date), market2->equityCurve("SP5")->fixing(sp5Date), 1.0E-10);
+    BOOST_CHECK_CLOSE(gold->fixing(goldDate), market2->commodityIndex("COMDTY_GOLD_USD")->fixing(goldDate), 1.0E-10);
+}
+
+BOOST_AUTO_TEST_CASE(testIncrementalUpdateWithBootstrappedNodes) {
+
+    BOOST_TEST_MESSAGE("Testing incremental update of todays market built from bootstrapped nodes...");
+
+    Date asof = market->asofDate();
+    auto nodes = market->bootstrappedYieldCurveNodes();
+    BOOST_REQUIRE(nodes.count("Yield/EUR/EUR1D") > 0);
+
+    auto loader = QuantLib::ext::make_shared<MarketDataLoader>();
+    auto market1 = QuantLib::ext::make_shared<TodaysMarket>(asof, marketParameters(), loader, curveConfigurations(),
+                                                            false, true, false, nullptr, false,
+                                                            IborFallbackConfig::defaultConfig(), true, true, nodes);
+    Handle<YieldTermStructure> eurDiscount = market1->discountCurve("EUR");
+
+    string name = "IR_SWAP/RATE/EUR/2D/1D/5Y";
+    auto md = QuantLib::ext::make_shared<MarketDatum>(loader->get(name, asof)->quote()->value() + 0.0010, asof, name,
+                                                      MarketDatum::QuoteType::RATE, MarketDatum::InstrumentType::IR_SWAP);
+    BOOST_CHECK_GT(market1->update({md}), Size(0));
+
+    // the updated curve is bootstrapped from the new quotes instead of being rebuilt from the given nodes
+    auto market2 = QuantLib::ext::make_shared<TodaysMarket>(asof, marketParameters(), loader, curveConfigurations());
+    auto nodes1 = market1->bootstrappedYieldCurveNodes();
+    auto nodes2 = market2->bootstrappedYieldCurveNodes();
+    BOOST_REQUIRE(nodes1.count("Yield/EUR/EUR1D") > 0);
+    BOOST_CHECK(nodes1.at("Yield/EUR/EUR1D") != nodes.at("Yield/EUR/EUR1D"));
+    BOOST_REQUIRE_EQUAL(nodes1.at("Yield/EUR/EUR1D")->values.size(), nodes2.at("Yield/EUR/EUR1D")->values.size());
+    for (Size i = 0; i < nodes2.at("Yield/EUR/EUR1D")->values.size(); ++i)
+        BOOST_CHECK_CLOSE(nodes1.at("Yield/EUR/EUR1D")->values[i], nodes2.at("Yield/EUR/EUR1D")->values[i], 1.0E-10);
+    for (Size i = 1; i <= 240; ++i) {
+        Date t = asof + i * Months;
+        BOOST_CHECK_CLOSE(eurDiscount->discount(t), market2->discountCurve("EUR")->discount(t), 1.0E-10);
+    }
+
+    // curves not affected by the update keep the given nodes
+    BOOST_CHECK(nodes1.at("Yield/USD/USD1D") == nodes.at("Yield/USD/USD1D"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
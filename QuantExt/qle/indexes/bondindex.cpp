@@ -49,6 +49,12 @@ BondIndex::BondIndex(const std::string& securityName, const bool dirty, const bo
     registerWith(recoveryRate_);
     registerWith(securitySpread_);
     registerWith(incomeCurve_);
+    // the bond itself might not forward notifications from its cashflows, e.g. floating coupons, if it was not
+    // calculated, so we observe them directly to invalidate the cached forecast fixings
+    if (bond_) {
+        for (auto const& c : bond_->cashflows())
+            registerWith(c);
+    }
 
     vanillaBondEngine_ = QuantLib::ext::make_shared<DiscountingRiskyBondEngine>(discountCurve, defaultCurve, recoveryRate,
                                                                         securitySpread, 6 * Months, boost::none);
@@ -60,14 +66,17 @@ Calendar BondIndex::fixingCalendar() const { return fixingCalendar_; }
 
 bool BondIndex::isValidFixingDate(const Date& d) const { return fixingCalendar().isBusinessDay(d); }
 
-void BondIndex::update() { notifyObservers(); }
+void BondIndex::update() {
+    forecastFixingCache_.clear();
+    notifyObservers();
+}
 
 Real BondIndex::fixing(const Date& fixingDate, bool forecastTodaysFixing) const {
     //! this logic is the same as in InterestRateIndex
     QL_REQUIRE(isValidFixingDate(fixingDate), "Fixing date " << fixingDate << " is not valid for '" << name() << "'");
     Date today = Settings::instance().evaluationDate();
     if (fixingDate > today || (fixingDate == today && forecastTodaysFixing))
-        return forecastFixing(fixingDate);
+        return forecastFixingCache_.value(fixingDate, [this, &fixingDate]() { return forecastFixing(fixingDate); });
     Real adj = priceQuoteMethod_ == PriceQuoteMethod::CurrencyPerUnit ? 1.0 / priceQuoteBaseValue_ : 1.0;
     if (fixingDate < today || Settings::instance().enforcesTodaysHistoricFixings()) {
         // must have been fixed
@@ -86,7 +95,7 @@ Real BondIndex::fixing(const Date& fixingDate, bool forecastTodaysFixing) const
     } catch (Error&) {
         ; // fall through and forecast
     }
-    return forecastFixing(fixingDate);
+    return forecastFixingCache_.value(fixingDate, [this, &fixingDate]() { return forecastFixing(fixingDate); });
 }
 
 Rate BondIndex::forecastFixing(const Date& fixingDate) const {
@@ -35,6 +35,8 @@
 #include <ql/cashflows/floatingratecoupon.hpp>
 #include <ql/cashflows/couponpricer.hpp>
 
+#include <qle/indexes/forecastfixingcache.hpp>
+
 namespace QuantExt {
 
 using namespace QuantLib;
@@ -152,6 +154,8 @@ protected:
     double bidAskAdjustment_;
     QuantLib::ext::shared_ptr<DiscountingRiskyBondEngine> vanillaBondEngine_;
     bool bondIssueDateFallback_ = false;
+    // forecast fixings by fixing date, cleared on notifications
+    ForecastFixingCache forecastFixingCache_;
 };
 
 //! Bond Futures Index
@@ -79,7 +79,7 @@ Real CommodityIndex::fixing(const Date& fixingDate, bool forecastTodaysFixing) c
                                   << "). Eval date is " << today);
 
     if (fixingDate > today || (fixingDate == today && forecastTodaysFixing))
-        return forecastFixing(fixingDate);
+        return forecastFixingCache_.value(fixingDate, [this, &fixingDate]() { return forecastFixing(fixingDate); });
 
     Real result = Null<Decimal>();
 
@@ -96,7 +96,7 @@ Real CommodityIndex::fixing(const Date& fixingDate, bool forecastTodaysFixing) c
             ; // fall through and forecast
         }
         if (result == Null<Real>())
-            return forecastFixing(fixingDate);
+            return forecastFixingCache_.value(fixingDate, [this, &fixingDate]() { return forecastFixing(fixingDate); });
     }
 
     return result;
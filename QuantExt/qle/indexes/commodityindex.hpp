@@ -29,6 +29,7 @@
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/time/calendar.hpp>
 #include <qle/indexes/eqfxindexbase.hpp>
+#include <qle/indexes/forecastfixingcache.hpp>
 #include <qle/termstructures/pricetermstructure.hpp>
 
 namespace QuantExt {
@@ -66,7 +67,10 @@ public:
     //@}
     //! \name Observer interface
     //@{
-    void update() override { notifyObservers(); }
+    void update() override {
+        forecastFixingCache_.clear();
+        notifyObservers();
+    }
     //@}
     //! \name Inspectors
     //@{
@@ -101,6 +105,8 @@ protected:
     bool isFuturesIndex_;
     // Belongs in CommodityFuturesIndex but have put everything else in base class.
     bool keepDays_;
+    // forecast fixings by fixing date, cleared on notifications
+    ForecastFixingCache forecastFixingCache_;
 
     // Shared initialisation
     void init();
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/indexes/forecastfixingcache.hpp
+    \brief cache for forecast fixings of indices
+    \ingroup indexes
+*/
+
+#pragma once
+
+#include <ql/patterns/singleton.hpp>
+#include <ql/settings.hpp>
+#include <ql/time/date.hpp>
+
+#include <map>
+
+namespace QuantExt {
+
+//! Global settings for the forecast fixing caches of indices
+/*! The indices clear their caches on observer notifications. If market data is changed while notifications are
+    disabled or some observers are unregistered, the caches have to be invalidated explicitly by calling invalidate().
+    The caches can also be switched off completely.
+
+    \ingroup indexes
+*/
+class ForecastFixingCacheSettings : public QuantLib::Singleton<ForecastFixingCacheSettings> {
+    friend class QuantLib::Singleton<ForecastFixingCacheSettings>;
+
+private:
+    ForecastFixingCacheSettings() {}
+
+public:
+    bool enabled() const { return enabled_; }
+    void enable(const bool b) {
+        enabled_ = b;
+        invalidate();
+    }
+    //! invalidates the cached values of all indices
+    void invalidate() { ++generation_; }
+    unsigned long generation() const { return generation_; }
+
+private:
+    bool enabled_ = true;
+    unsigned long generation_ = 0;
+};
+
+//! Cache for forecast fixings keyed on the fixing date
+/*! The cached values are dropped if clear() is called, if the evaluation date changes or if the caches are
+    invalidated via the ForecastFixingCacheSettings.
+
+    \ingroup indexes
+*/
+class ForecastFixingCache {
+public:
+    /*! returns the cached value for the fixing date, if not available the value is computed with the given function
+        and stored, unless the caches are switched off */
+    template <class F> QuantLib::Real value(const QuantLib::Date& fixingDate, const F& forecast) const {
+        const ForecastFixingCacheSettings& settings = ForecastFixingCacheSettings::instance();
+        if (!settings.enabled())
+            return forecast();
+        QuantLib::Date today = QuantLib::Settings::instance().evaluationDate();
+        if (generation_ != settings.generation() || today_ != today) {
+            values_.clear();
+            generation_ = settings.generation();
+            today_ = today;
+        }
+        auto v = values_.find(fixingDate);
+        if (v != values_.end())
+            return v->second;
+        QuantLib::Real result = forecast();
+        values_[fixingDate] = result;
+        return result;
+    }
+    void clear() { values_.clear(); }
+
+private:
+    mutable std::map<QuantLib::Date, QuantLib::Real> values_;
+    mutable unsigned long generation_ = 0;
+    mutable QuantLib::Date today_;
+};
+
+} // namespace QuantExt
@@ -163,8 +163,11 @@ Real FxIndex::fixing(const Date& fixingDate, bool forecastTodaysFixing) const {
 
     Real result = Null<Real>();
 
+    // forecasts based on the exchange rate manager are not observable and therefore not cached
+    auto forecast = [this, &adjustedFixingDate]() { return forecastFixing(adjustedFixingDate); };
+
     if (adjustedFixingDate > today || (adjustedFixingDate == today && forecastTodaysFixing))
-        result = forecastFixing(adjustedFixingDate);
+        result = useQuote_ ? forecastFixingCache_.value(adjustedFixingDate, forecast) : forecast();
 
     if (result == Null<Real>()) {
         if (adjustedFixingDate < today || Settings::instance().enforcesTodaysHistoricFixings()) {
@@ -180,7 +183,7 @@ Real FxIndex::fixing(const Date& fixingDate, bool forecastTodaysFixing) const {
                 ; // fall through and forecast
             }
             if (result == Null<Real>())
-                result = forecastFixing(adjustedFixingDate);
+                result = useQuote_ ? forecastFixingCache_.value(adjustedFixingDate, forecast) : forecast();
         }
     }
 
@@ -272,6 +275,7 @@ bool FxIndex::isValidFixingDate(const Date& d) const { return fixingCalendar().i
 
 void FxIndex::update() {
     fxRate_ = Handle<Quote>();
+    forecastFixingCache_.clear();
     notifyObservers();
 }
 
@@ -44,6 +44,7 @@
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/time/calendar.hpp>
 #include <qle/indexes/eqfxindexbase.hpp>
+#include <qle/indexes/forecastfixingcache.hpp>
 
 namespace QuantExt {
 using namespace QuantLib;
@@ -162,6 +163,8 @@ protected:
     // instantaneous fx rate
     mutable Handle<Quote> fxRate_;
     bool useQuote_;
+    // forecast fixings by fixing date, cleared on notifications
+    ForecastFixingCache forecastFixingCache_;
 
 private:
     Calendar fixingCalendar_;
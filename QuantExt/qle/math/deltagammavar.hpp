@@ -25,23 +25,25 @@
 #define quantext_deltagammavar_hpp
 
 #include <qle/math/covariancesalvage.hpp>
+#include <qle/methods/multipathvariategenerator.hpp>
 
 #include <ql/math/comparison.hpp>
 #include <ql/math/array.hpp>
 #include <ql/math/matrix.hpp>
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
+#include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/math/randomnumbers/rngtraits.hpp>
 
-// fix for boost 1.64, see https://lists.boost.org/Archives/boost/2016/11/231756.php
-#if BOOST_VERSION >= 106400
-#include <boost/serialization/array_wrapper.hpp>
-#endif
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/tail_quantile.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <thread>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -61,19 +63,28 @@ Real deltaGammaVarNormal(const Matrix& omega, const Array& delta, const Matrix&
 //! function that computes a delta-gamma VaR using Monte Carlo (single quantile)
 /*! For a given a covariance matrix, a delta vector and a gamma matrix this function computes a parametric var
  * w.r.t. a given confidence level. The var quantile is estimated from Monte-Carlo realisations of a second order
- * sensitivity based PL. */
+ * sensitivity based PL. See below for the details of the simulation. */
 template <class RNG>
 Real deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p, const Size paths,
-                     const Size seed, const CovarianceSalvage& sal = NoCovarianceSalvage());
+                     const Size seed, const CovarianceSalvage& sal = NoCovarianceSalvage(), const Size threads = 1);
 
 //! function that computes a delta-gamma VaR using Monte Carlo (multiple quantiles)
 /*! For a given a covariance matrix, a delta vector and a gamma matrix this function computes a parametric var
  * w.r.t. a vector of given confidence levels. The var quantile is estimated from Monte-Carlo realisations of a second
- * order sensitivity based PL. */
+ * order sensitivity based PL.
+ *
+ * With omega = L L^T the PL is delta^T L z + 1/2 z^T L^T gamma L z for standard normal z. The matrix L^T gamma L is
+ * diagonalised once as V Lambda V^T, in the eigenbasis w = V^T z the PL reads sum_i (d_i w_i + 1/2 lambda_i w_i^2)
+ * with d = V^T L^T delta, so that each path costs O(n). The paths are simulated in blocks of fixed size. For
+ * pseudo random numbers each block uses its own random sequence generator seeded from a Mersenne twister with the
+ * given seed, for low discrepancy numbers the blocks are consecutive parts of one Sobol sequence, see
+ * detail::DeltaGammaVarMcBlockRng. The blocks are distributed on the given number of threads, each block only keeps
+ * the right tail of its PLs that is required for the smallest confidence level. The quantiles are selected from the
+ * union of these tails by partial sorting. The result does not depend on the number of threads. */
 template <class RNG>
 std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamma,
 				  const std::vector<Real>& p, const Size paths, const Size seed,
-				  const CovarianceSalvage& sal = NoCovarianceSalvage());
+				  const CovarianceSalvage& sal = NoCovarianceSalvage(), const Size threads = 1);
 
 namespace detail {
 void check(const Real p);
@@ -87,6 +98,37 @@ template <typename A> Real absMax(const A& a) {
     }
     return tmp;
 }
+
+//! standard normal variates for a block of paths of deltaGammaVarMc(), starting at path firstPath
+/*! The generator of a pseudo random block is seeded with the block seed, so that the blocks are independent. */
+template <class RNG> class DeltaGammaVarMcBlockRng {
+public:
+    DeltaGammaVarMcBlockRng(const Size dim, const Size firstPath, const BigNatural seed, const BigNatural blockSeed)
+        : rsg_(RNG::make_sequence_generator(dim, blockSeed)) {}
+    const std::vector<Real>& next() { return rsg_.nextSequence().value; }
+
+private:
+    typename RNG::rsg_type rsg_;
+};
+
+/*! Reseeding a Sobol sequence does not shift it, so that blocks seeded with the block seed would all replay the same
+    points. Instead, each block skips the Sobol sequence of LowDiscrepancy::make_sequence_generator(dim, seed) ahead
+    to its first path. */
+template <> class DeltaGammaVarMcBlockRng<LowDiscrepancy> {
+public:
+    DeltaGammaVarMcBlockRng(const Size dim, const Size firstPath, const BigNatural seed, const BigNatural blockSeed)
+        : gen_(dim, 1, seed, SobolRsg::Jaeckel) {
+        gen_.skipTo(firstPath);
+    }
+    const Array& next() {
+        sample_ = gen_.next();
+        return sample_.value.front();
+    }
+
+private:
+    MultiPathVariateGeneratorSobol gen_;
+    Sample<std::vector<Array>> sample_{std::vector<Array>(), 0.0};
+};
 } // namespace detail
 
 // implementation
@@ -94,9 +136,11 @@ template <typename A> Real absMax(const A& a) {
 template <class RNG>
 std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamma,
 				  const std::vector<Real>& p, const Size paths, const Size seed,
-				  const CovarianceSalvage& sal) {
+				  const CovarianceSalvage& sal, const Size threads) {
     BOOST_FOREACH (Real q, p) { detail::check(q); }
     detail::check(omega, delta, gamma);
+    QL_REQUIRE(paths > 0, "deltaGammaVarMc: paths must be positive");
+    QL_REQUIRE(threads > 0, "deltaGammaVarMc: threads must be positive");
 
     Real num = std::max(detail::absMax(delta), detail::absMax(gamma));
     if (QuantLib::close_enough(num, 0.0)) {
@@ -109,26 +153,93 @@ std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const
         L = CholeskyDecomposition(omega, true);
     }
 
+    // PL in the eigenbasis of L^T gamma L
+
+    Matrix lgl = transpose(L) * gamma * L;
+    SymmetricSchurDecomposition schur(0.5 * (lgl + transpose(lgl)));
+    const Array& lambda = schur.eigenvalues();
+    Array d = transpose(schur.eigenvectors()) * (transpose(L) * delta);
+    Array halfLambda = 0.5 * lambda;
+    Size dim = d.size();
+
+    // number of largest PLs required for the smallest confidence level
+
     Real pmin = QL_MAX_REAL;
     BOOST_FOREACH (Real q, p) { pmin = std::min(pmin, q); }
+    Size cache = std::min(Size(std::floor(static_cast<double>(paths) * (1.0 - pmin) + 0.5)) + 2, paths);
 
-    Size cache = Size(std::floor(static_cast<double>(paths) * (1.0 - pmin) + 0.5)) + 2;
-    boost::accumulators::accumulator_set<
-        double, boost::accumulators::stats<boost::accumulators::tag::tail_quantile<boost::accumulators::right> > >
-        acc(boost::accumulators::tag::tail<boost::accumulators::right>::cache_size = cache);
+    // blocks of paths with their own generators, the seeds only depend on the block index
 
-    typename RNG::rsg_type rng = RNG::make_sequence_generator(delta.size(), seed);
+    const Size blockSize = 10000;
+    Size nBlocks = (paths - 1) / blockSize + 1;
+    std::vector<BigNatural> blockSeeds(nBlocks);
+    MersenneTwisterUniformRng seedGenerator(seed);
+    for (auto& s : blockSeeds) {
+        // a zero seed would mean a clock based seed for the block generators
+        do {
+            s = seedGenerator.nextInt32();
+        } while (s == 0);
+    }
 
-    for (Size i = 0; i < paths; ++i) {
-        std::vector<Real> seq = rng.nextSequence().value;
-        Array z(seq.begin(), seq.end());
-        Array u = L * z;
-        acc(DotProduct(u, delta) + 0.5 * DotProduct(u, gamma * u));
+    std::vector<std::vector<Real>> tails(nBlocks);
+    auto simulateBlocks = [&](Size firstBlock, Size lastBlock) {
+        for (Size b = firstBlock; b < lastBlock; ++b) {
+            Size n = std::min(blockSize, paths - b * blockSize);
+            detail::DeltaGammaVarMcBlockRng<RNG> rng(dim, b * blockSize, seed, blockSeeds[b]);
+            std::vector<Real>& pl = tails[b];
+            pl.resize(n);
+            for (Size i = 0; i < n; ++i) {
+                const auto& w = rng.next();
+                Real v = 0.0;
+                for (Size k = 0; k < dim; ++k)
+                    v += (d[k] + halfLambda[k] * w[k]) * w[k];
+                pl[i] = v;
+            }
+            // keep the largest values only
+            if (cache < n) {
+                std::nth_element(pl.begin(), pl.begin() + cache, pl.end(), std::greater<Real>());
+                pl.resize(cache);
+            }
+        }
+    };
+
+    Size nThreads = std::min(threads, nBlocks);
+    if (nThreads == 1) {
+        simulateBlocks(0, nBlocks);
+    } else {
+        std::vector<std::exception_ptr> errors(nThreads);
+        std::vector<std::thread> workers;
+        Size chunk = (nBlocks - 1) / nThreads + 1;
+        for (Size t = 0; t < nThreads; ++t) {
+            workers.emplace_back([&simulateBlocks, &errors, t, chunk, nBlocks]() {
+                try {
+                    simulateBlocks(std::min(t * chunk, nBlocks), std::min((t + 1) * chunk, nBlocks));
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (auto const& e : errors)
+            if (e)
+                std::rethrow_exception(e);
     }
 
+    // select the quantiles from the merged tails, the k-th largest PL with k = ceil(paths * (1 - q)) is returned,
+    // as the right tail quantile of boost accumulators does
+
+    std::vector<Real> tail;
+    tail.reserve(nBlocks * cache);
+    for (auto const& t : tails)
+        tail.insert(tail.end(), t.begin(), t.end());
+
     std::vector<Real> res;
     BOOST_FOREACH (Real q, p) {
-        res.push_back(boost::accumulators::quantile(acc, boost::accumulators::quantile_probability = q));
+        Size k = static_cast<Size>(std::ceil(static_cast<double>(paths) * (1.0 - q)));
+        k = std::min(std::max<Size>(k, 1), tail.size());
+        std::nth_element(tail.begin(), tail.begin() + (k - 1), tail.end(), std::greater<Real>());
+        res.push_back(tail[k - 1]);
     }
 
     return res;
@@ -136,10 +247,10 @@ std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const
 
 template <class RNG>
 Real deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p, const Size paths,
-                     const Size seed, const CovarianceSalvage& sal) {
+                     const Size seed, const CovarianceSalvage& sal, const Size threads) {
 
     std::vector<Real> pv(1, p);
-    return deltaGammaVarMc<RNG>(omega, delta, gamma, pv, paths, seed, sal).front();
+    return deltaGammaVarMc<RNG>(omega, delta, gamma, pv, paths, seed, sal, threads).front();
 }
 
 /* delta-gamma VaR using Cornish-Fisher extrapolation (or normal delta-gamma VaR) */
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/fftconvolution.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/fastfouriertransform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace QuantExt {
+
+using namespace QuantLib;
+
+std::vector<Real> fftConvolution(const std::vector<Real>& a, const std::vector<Real>& b) {
+    if (a.empty() || b.empty())
+        return std::vector<Real>();
+
+    Size n = a.size() + b.size() - 1;
+
+    // for short sequences the direct sum is cheaper than the transforms
+    if (std::min(a.size(), b.size()) <= 8) {
+        std::vector<Real> c(n, 0.0);
+        for (Size i = 0; i < a.size(); ++i)
+            for (Size j = 0; j < b.size(); ++j)
+                c[i + j] += a[i] * b[j];
+        return c;
+    }
+
+    FastFourierTransform fft(FastFourierTransform::min_order(n));
+    Size m = fft.output_size();
+
+    std::vector<std::complex<Real>> fa(m, 0.0), fb(m, 0.0), fc(m, 0.0);
+    fft.transform(a.begin(), a.end(), fa.begin());
+    fft.transform(b.begin(), b.end(), fb.begin());
+    for (Size i = 0; i < m; ++i)
+        fa[i] *= fb[i];
+    fft.inverse_transform(fa.begin(), fa.end(), fc.begin());
+
+    // the inverse transform is not normalised
+    std::vector<Real> c(n);
+    Real scale = 1.0 / static_cast<Real>(m);
+    for (Size i = 0; i < n; ++i)
+        c[i] = fc[i].real() * scale;
+    return c;
+}
+
+std::vector<Real> fftShiftedConvolution(const std::vector<Real>& v, const std::vector<Real>& offsets,
+                                        const std::vector<Real>& weights) {
+    QL_REQUIRE(offsets.size() == weights.size(), "fftShiftedConvolution(): offsets size ("
+                                                     << offsets.size() << ") must match weights size ("
+                                                     << weights.size() << ")");
+    if (v.empty())
+        return std::vector<Real>();
+    int n = static_cast<int>(v.size());
+
+    // kernel on integer offsets -p, ..., p, the linear interpolation in V is distributed on the two adjacent nodes
+
+    Real maxOffset = 0.0;
+    for (auto const& d : offsets)
+        maxOffset = std::max(maxOffset, std::abs(d));
+    int p = static_cast<int>(std::ceil(maxOffset)) + 1;
+    std::vector<Real> kernel(2 * p + 1, 0.0);
+    for (Size i = 0; i < offsets.size(); ++i) {
+        int f = static_cast<int>(std::floor(offsets[i]));
+        Real r = offsets[i] - static_cast<Real>(f);
+        // we store the kernel in reversed order, so that the convolution below yields the required correlation
+        kernel[p - f] += weights[i] * (1.0 - r);
+        kernel[p - f - 1] += weights[i] * r;
+    }
+
+    // pad v with p values on both sides, this represents the flat extrapolation exactly
+
+    std::vector<Real> padded(n + 2 * p);
+    for (int l = 0; l < n + 2 * p; ++l)
+        padded[l] = v[std::min(std::max(l - p, 0), n - 1)];
+
+    // u[j] = sum_m kernel(m) padded[j + p + m] = c[j + 2p] for c = padded * reversed kernel
+
+    std::vector<Real> c = fftConvolution(padded, kernel);
+    return std::vector<Real>(c.begin() + 2 * p, c.begin() + 2 * p + n);
+}
+
+std::vector<Real> fftConvolutionRollback(const std::vector<Real>& v, const std::vector<Real>& y,
+                                         const std::vector<Real>& w, const Real std, const Real dx1, const Real dx0) {
+    QL_REQUIRE(v.size() % 2 == 1, "fftConvolutionRollback(): odd grid size expected, got " << v.size());
+    int mx = static_cast<int>(v.size() / 2);
+    std::vector<Real> offsets(y.size());
+    for (Size i = 0; i < y.size(); ++i)
+        offsets[i] = y[i] * std / dx1;
+    std::vector<Real> u = fftShiftedConvolution(v, offsets, w);
+    std::vector<Real> result(v.size());
+    for (int k = 0; k <= 2 * mx; k++) {
+        Real kp = dx0 * (k - mx) / dx1 + mx;
+        int kk = static_cast<int>(std::floor(kp));
+        result[k] = kk < 0 ? u[0] : (kk + 1 > 2 * mx ? u[2 * mx] : (kp - kk) * u[kk + 1] + (1.0 + kk - kp) * u[kk]);
+    }
+    return result;
+}
+
+} // namespace QuantExt
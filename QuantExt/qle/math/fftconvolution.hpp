@@ -0,0 +1,64 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/fftconvolution.hpp
+    \brief linear convolution of real sequences via fast fourier transform
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <vector>
+
+namespace QuantExt {
+
+//! Linear convolution of two real sequences
+/*! Returns the sequence c of size a.size() + b.size() - 1 with
+
+    c[k] = sum_j a[j] * b[k - j]
+
+    computed in O(n log n) using a zero padded radix-2 FFT. If one of the inputs is empty, an empty
+    sequence is returned. */
+std::vector<QuantLib::Real> fftConvolution(const std::vector<QuantLib::Real>& a,
+                                           const std::vector<QuantLib::Real>& b);
+
+//! Weighted sum of shifted values of a piecewise linear grid function
+/*! The values v are interpreted as a function V on [0, v.size() - 1] that is linearly interpolated between the
+    integer grid points and flat extrapolated outside. The function returns u with
+
+    u[j] = sum_i weights[i] * V(j + offsets[i]),  j = 0, ..., v.size() - 1
+
+    This is evaluated as a discrete convolution of the flat padded values v with a kernel on the integer offsets,
+    so the cost is O((n + m) log (n + m)) with n = v.size() and m = max |offsets[i]| instead of O(n * offsets.size())
+    for the direct sum. The result is identical to the direct sum up to rounding. */
+std::vector<QuantLib::Real> fftShiftedConvolution(const std::vector<QuantLib::Real>& v,
+                                                  const std::vector<QuantLib::Real>& offsets,
+                                                  const std::vector<QuantLib::Real>& weights);
+
+//! Rollback step of the LGM convolution solvers using fftShiftedConvolution()
+/*! The values v are given on the equidistant t1 state grid with spacing dx1 and v.size() = 2 * mx + 1 points
+    centered at zero, y and w are the standardised integration points and weights and std is the standard deviation
+    of the state increment from t0 to t1. The convolution is computed on the t1 grid and then interpolated linearly
+    (with flat extrapolation) onto the t0 state grid with spacing dx0 and the same number of points. */
+std::vector<QuantLib::Real> fftConvolutionRollback(const std::vector<QuantLib::Real>& v,
+                                                   const std::vector<QuantLib::Real>& y,
+                                                   const std::vector<QuantLib::Real>& w, const QuantLib::Real std,
+                                                   const QuantLib::Real dx1, const QuantLib::Real dx0);
+
+} // namespace QuantExt
@@ -20,10 +20,26 @@
 
 #include <boost/make_shared.hpp>
 
+#include <cstdint>
+#include <limits>
+
 using namespace QuantLib;
 
 namespace QuantExt {
 
+void MultiPathGeneratorBase::skipTo(const Size k) {
+    reset();
+    for (Size i = 0; i < k; ++i)
+        next();
+}
+
+MultiPathGeneratorSubstream::MultiPathGeneratorSubstream(const QuantLib::ext::shared_ptr<MultiPathGeneratorBase>& generator,
+                                                         const Size firstPath)
+    : generator_(generator), firstPath_(firstPath) {
+    QL_REQUIRE(generator_, "MultiPathGeneratorSubstream: no generator given");
+    MultiPathGeneratorSubstream::reset();
+}
+
 MultiPathGeneratorMersenneTwister::MultiPathGeneratorMersenneTwister(
     const QuantLib::ext::shared_ptr<StochasticProcess>& process, const TimeGrid& grid, BigNatural seed, bool antitheticSampling)
     : process_(process), grid_(grid), seed_(seed), antitheticSampling_(antitheticSampling), antitheticVariate_(true),
@@ -32,7 +48,23 @@ MultiPathGeneratorMersenneTwister::MultiPathGeneratorMersenneTwister(
 }
 
 void MultiPathGeneratorMersenneTwister::reset() {
-    PseudoRandom::rsg_type rsg = PseudoRandom::make_sequence_generator(process_->factors() * (grid_.size() - 1), seed_);
+    initialise(PseudoRandom::make_sequence_generator(process_->factors() * (grid_.size() - 1), seed_));
+}
+
+void MultiPathGeneratorMersenneTwister::skipTo(const Size k) {
+    // one sequence is drawn per path (per pair of paths for antithetic sampling), each sequence consumes one 32 bit
+    // integer per dimension, we discard these directly without generating the paths
+    Size dimension = process_->factors() * (grid_.size() - 1);
+    Size draws = antitheticSampling_ ? k / 2 : k;
+    MersenneTwisterUniformRng rng(seed_);
+    for (Size i = 0; i < draws * dimension; ++i)
+        rng.nextInt32();
+    initialise(PseudoRandom::rsg_type(RandomSequenceGenerator<MersenneTwisterUniformRng>(dimension, rng)));
+    if (antitheticSampling_ && k % 2 == 1)
+        next();
+}
+
+void MultiPathGeneratorMersenneTwister::initialise(const PseudoRandom::rsg_type& rsg) {
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<PseudoRandom::rsg_type>>(tmp, grid_, rsg, false);
     } else {
@@ -69,18 +101,25 @@ MultiPathGeneratorSobol::MultiPathGeneratorSobol(const QuantLib::ext::shared_ptr
 }
 
 void MultiPathGeneratorSobol::reset() {
+    initialise(SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_));
+}
+
+void MultiPathGeneratorSobol::skipTo(const Size k) {
+    QL_REQUIRE(k <= std::numeric_limits<std::uint32_t>::max(),
+               "MultiPathGeneratorSobol::skipTo(): path index " << k << " exceeds the sequence length");
+    SobolRsg rsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_);
+    if (k > 0)
+        rsg.skipTo(static_cast<std::uint32_t>(k));
+    initialise(rsg);
+}
+
+void MultiPathGeneratorSobol::initialise(const SobolRsg& rsg) {
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>>(
-            tmp, grid_,
-            InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(
-                SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_)),
-            false);
-
+            tmp, grid_, InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(rsg), false);
     } else {
         pg_ = QuantLib::ext::make_shared<MultiPathGenerator<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>>(
-            process_, grid_,
-            InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(
-                SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_)));
+            process_, grid_, InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(rsg));
     }
 }
 
@@ -103,18 +142,25 @@ MultiPathGeneratorBurley2020Sobol::MultiPathGeneratorBurley2020Sobol(const Quant
 }
 
 void MultiPathGeneratorBurley2020Sobol::reset() {
+    initialise(
+        Burley2020SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_));
+}
+
+void MultiPathGeneratorBurley2020Sobol::skipTo(const Size k) {
+    // the scrambled sequence is advanced without generating the paths
+    Burley2020SobolRsg rsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_);
+    for (Size i = 0; i < k; ++i)
+        rsg.nextSequence();
+    initialise(rsg);
+}
+
+void MultiPathGeneratorBurley2020Sobol::initialise(const Burley2020SobolRsg& rsg) {
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>>(
-            tmp, grid_,
-            InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(
-                Burley2020SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_)),
-            false);
-
+            tmp, grid_, InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(rsg), false);
     } else {
         pg_ = QuantLib::ext::make_shared<MultiPathGenerator<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>>(
-            process_, grid_,
-            InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(Burley2020SobolRsg(
-                process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_)));
+            process_, grid_, InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(rsg));
     }
 }
 
@@ -160,6 +206,12 @@ const Sample<MultiPath>& MultiPathGeneratorSobolBrownianBridgeBase::next() const
     return next_;
 }
 
+void MultiPathGeneratorSobolBrownianBridgeBase::skipTo(const Size k) {
+    reset();
+    for (Size i = 0; i < k; ++i)
+        gen_->nextPath();
+}
+
 MultiPathGeneratorSobolBrownianBridge::MultiPathGeneratorSobolBrownianBridge(
     const QuantLib::ext::shared_ptr<StochasticProcess>& process, const TimeGrid& grid,
     SobolBrownianGenerator::Ordering ordering, BigNatural seed, SobolRsg::DirectionIntegers directionIntegers)
@@ -211,6 +263,16 @@ makeMultiPathGenerator(const SequenceType s, const QuantLib::ext::shared_ptr<Sto
     }
 }
 
+QuantLib::ext::shared_ptr<MultiPathGeneratorBase>
+makeMultiPathGenerator(const SequenceType s, const QuantLib::ext::shared_ptr<StochasticProcess>& process,
+                       const TimeGrid& timeGrid, const BigNatural seed, const SobolBrownianGenerator::Ordering ordering,
+                       const SobolRsg::DirectionIntegers directionIntegers, const Size firstPath) {
+    auto generator = makeMultiPathGenerator(s, process, timeGrid, seed, ordering, directionIntegers);
+    if (firstPath == 0)
+        return generator;
+    return QuantLib::ext::make_shared<MultiPathGeneratorSubstream>(generator, firstPath);
+}
+
 std::ostream& operator<<(std::ostream& out, const SequenceType s) {
     switch (s) {
     case MersenneTwister:
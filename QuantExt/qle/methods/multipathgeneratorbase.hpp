@@ -51,6 +51,31 @@ public:
     virtual ~MultiPathGeneratorBase() {}
     virtual const Sample<MultiPath>& next() const = 0;
     virtual void reset() = 0;
+    /*! Reset the generator such that the next call to next() returns the path with index k, i.e. the same path as
+        the (k+1)th call to next() after reset(). The default implementation resets the generator and discards k
+        paths, the standard generators jump directly to path k or discard the underlying random numbers only. For
+        pseudo random sequences this is only reproducible for a seed != 0. */
+    virtual void skipTo(const Size k);
+};
+
+//! Substream of a multi path generator
+/*! The substream returns the paths of the given generator starting at index firstPath, also after a reset. Worker
+    threads or processes simulating disjoint ranges of paths with the same seed produce the same paths as a
+    single generator, independent of the number of workers.
+
+    \ingroup methods
+*/
+class MultiPathGeneratorSubstream : public MultiPathGeneratorBase {
+public:
+    MultiPathGeneratorSubstream(const QuantLib::ext::shared_ptr<MultiPathGeneratorBase>& generator,
+                                const Size firstPath);
+    const Sample<MultiPath>& next() const override { return generator_->next(); }
+    void reset() override { generator_->skipTo(firstPath_); }
+    void skipTo(const Size k) override { generator_->skipTo(firstPath_ + k); }
+
+private:
+    QuantLib::ext::shared_ptr<MultiPathGeneratorBase> generator_;
+    Size firstPath_;
 };
 
 //! Instantiation of MultiPathGenerator with standard PseudoRandom traits
@@ -62,8 +87,11 @@ public:
                                       bool antitheticSampling = false);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size k) override;
 
 private:
+    void initialise(const PseudoRandom::rsg_type& rsg);
+
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
     TimeGrid grid_;
     BigNatural seed_;
@@ -94,8 +122,11 @@ public:
                             SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size k) override;
 
 private:
+    void initialise(const SobolRsg& rsg);
+
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
     TimeGrid grid_;
     BigNatural seed_;
@@ -120,8 +151,11 @@ public:
                                       BigNatural scrambleSeed = 43);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size k) override;
 
 private:
+    void initialise(const Burley2020SobolRsg& rsg);
+
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
     TimeGrid grid_;
     BigNatural seed_;
@@ -143,6 +177,8 @@ public:
                                               BigNatural seed = 0,
                                               SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     const Sample<MultiPath>& next() const override;
+    //! discards the bridged variates of k paths without evolving the process
+    void skipTo(const Size k) override;
 
 protected:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
@@ -189,6 +225,12 @@ makeMultiPathGenerator(const SequenceType s, const QuantLib::ext::shared_ptr<Sto
                        const SobolBrownianGenerator::Ordering ordering = SobolBrownianGenerator::Steps,
                        const SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
 
+//! Make function for path generators returning the substream of paths starting at index firstPath
+QuantLib::ext::shared_ptr<MultiPathGeneratorBase>
+makeMultiPathGenerator(const SequenceType s, const QuantLib::ext::shared_ptr<StochasticProcess>& process,
+                       const TimeGrid& timeGrid, const BigNatural seed, const SobolBrownianGenerator::Ordering ordering,
+                       const SobolRsg::DirectionIntegers directionIntegers, const Size firstPath);
+
 //! Output function
 std::ostream& operator<<(std::ostream& out, const SequenceType s);
 
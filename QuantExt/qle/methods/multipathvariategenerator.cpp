@@ -20,6 +20,9 @@
 
 #include <boost/make_shared.hpp>
 
+#include <cstdint>
+#include <limits>
+
 using namespace QuantLib;
 
 namespace QuantExt {
@@ -41,6 +44,12 @@ Sample<std::vector<Array>> MultiPathVariateGeneratorBase::next() const {
     return result;
 }
 
+void MultiPathVariateGeneratorBase::skipTo(const Size k) {
+    reset();
+    for (Size i = 0; i < k; ++i)
+        nextSequence();
+}
+
 MultiPathVariateGeneratorMersenneTwister::MultiPathVariateGeneratorMersenneTwister(const Size dimension,
                                                                                    const Size timeSteps,
                                                                                    BigNatural seed,
@@ -58,6 +67,21 @@ void MultiPathVariateGeneratorMersenneTwister::reset() {
     antitheticVariate_ = true;
 }
 
+void MultiPathVariateGeneratorMersenneTwister::skipTo(const Size k) {
+    // discard one 32 bit integer per dimension and sequence, a sequence is drawn per pair of paths for antithetic
+    // sampling
+    Size draws = antitheticSampling_ ? k / 2 : k;
+    MersenneTwisterUniformRng rng(seed_);
+    for (Size i = 0; i < draws * dimension_ * timeSteps_; ++i)
+        rng.nextInt32();
+    rsg_ = QuantLib::ext::make_shared<
+        InverseCumulativeRsg<RandomSequenceGenerator<MersenneTwisterUniformRng>, InverseCumulativeNormal>>(
+        RandomSequenceGenerator<MersenneTwisterUniformRng>(dimension_ * timeSteps_, rng), InverseCumulativeNormal());
+    antitheticVariate_ = true;
+    if (antitheticSampling_ && k % 2 == 1)
+        nextSequence();
+}
+
 Sample<std::vector<Real>> MultiPathVariateGeneratorMersenneTwister::nextSequence() const {
     if (antitheticSampling_) {
         antitheticVariate_ = !antitheticVariate_;
@@ -84,6 +108,16 @@ void MultiPathVariateGeneratorSobol::reset() {
         SobolRsg(dimension_ * timeSteps_, seed_, directionIntegers_), InverseCumulativeNormal());
 }
 
+void MultiPathVariateGeneratorSobol::skipTo(const Size k) {
+    QL_REQUIRE(k <= std::numeric_limits<std::uint32_t>::max(),
+               "MultiPathVariateGeneratorSobol::skipTo(): path index " << k << " exceeds the sequence length");
+    SobolRsg rsg(dimension_ * timeSteps_, seed_, directionIntegers_);
+    if (k > 0)
+        rsg.skipTo(static_cast<std::uint32_t>(k));
+    rsg_ = QuantLib::ext::make_shared<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>(rsg,
+                                                                                          InverseCumulativeNormal());
+}
+
 Sample<std::vector<Real>> MultiPathVariateGeneratorSobol::nextSequence() const { return rsg_->nextSequence(); }
 
 MultiPathVariateGeneratorBurley2020Sobol::MultiPathVariateGeneratorBurley2020Sobol(
@@ -99,6 +133,14 @@ void MultiPathVariateGeneratorBurley2020Sobol::reset() {
         Burley2020SobolRsg(dimension_ * timeSteps_, seed_, directionIntegers_, scrambleSeed_), InverseCumulativeNormal());
 }
 
+void MultiPathVariateGeneratorBurley2020Sobol::skipTo(const Size k) {
+    Burley2020SobolRsg rsg(dimension_ * timeSteps_, seed_, directionIntegers_, scrambleSeed_);
+    for (Size i = 0; i < k; ++i)
+        rsg.nextSequence();
+    rsg_ = QuantLib::ext::make_shared<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>(
+        rsg, InverseCumulativeNormal());
+}
+
 Sample<std::vector<Real>> MultiPathVariateGeneratorBurley2020Sobol::nextSequence() const {
     return rsg_->nextSequence();
 }
@@ -125,6 +167,12 @@ Sample<std::vector<Array>> MultiPathVariateGeneratorSobolBrownianBridgeBase::nex
     return Sample<std::vector<Array>>(output, weight);
 }
 
+void MultiPathVariateGeneratorSobolBrownianBridgeBase::skipTo(const Size k) {
+    reset();
+    for (Size i = 0; i < k; ++i)
+        gen_->nextPath();
+}
+
 MultiPathVariateGeneratorSobolBrownianBridge::MultiPathVariateGeneratorSobolBrownianBridge(
     const Size dimension, const Size timeSteps, SobolBrownianGenerator::Ordering ordering, BigNatural seed,
     SobolRsg::DirectionIntegers directionIntegers)
@@ -34,6 +34,8 @@ public:
     virtual ~MultiPathVariateGeneratorBase() {}
     virtual Sample<std::vector<Array>> next() const;
     virtual void reset() = 0;
+    //! see MultiPathGeneratorBase::skipTo()
+    virtual void skipTo(const Size k);
 
 protected:
     virtual Sample<std::vector<Real>> nextSequence() const = 0;
@@ -47,6 +49,7 @@ public:
     MultiPathVariateGeneratorMersenneTwister(const Size dimension, const Size timeSteps, BigNatural seed = 0,
                                              bool antitheticSampling = false);
     void reset() override;
+    void skipTo(const Size k) override;
 
 private:
     Sample<std::vector<Real>> nextSequence() const override;
@@ -69,6 +72,7 @@ public:
     MultiPathVariateGeneratorSobol(const Size dimension, const Size timeSteps, BigNatural seed = 0,
                                    SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     void reset() override;
+    void skipTo(const Size k) override;
 
 private:
     Sample<std::vector<Real>> nextSequence() const override;
@@ -84,6 +88,7 @@ public:
     MultiPathVariateGeneratorBurley2020Sobol(const Size dimension, const Size timeSteps, BigNatural seed = 42,
                                              SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7, BigNatural scrambleSeed = 43);
     void reset() override;
+    void skipTo(const Size k) override;
 
 private:
     Sample<std::vector<Real>> nextSequence() const override;
@@ -102,6 +107,7 @@ public:
         SobolBrownianGenerator::Ordering ordering = SobolBrownianGenerator::Steps, BigNatural seed = 0,
         SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     Sample<std::vector<Array>> next() const override;
+    void skipTo(const Size k) override;
 
 protected:
     Sample<std::vector<Real>> nextSequence() const override;
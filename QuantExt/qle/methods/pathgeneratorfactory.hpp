@@ -36,6 +36,18 @@ public:
                                                             const TimeGrid& timeGrid, const BigNatural seed,
                                                             const SobolBrownianGenerator::Ordering ordering,
                                                             const SobolRsg::DirectionIntegers directionIntegers) = 0;
+
+    /*! Build a generator returning the paths starting at index firstPath, see MultiPathGeneratorSubstream. Workers
+        building substreams for disjoint path ranges with the same seed reproduce the paths of a single generator. */
+    QuantLib::ext::shared_ptr<MultiPathGeneratorBase>
+    buildSubstream(const SequenceType s, const QuantLib::ext::shared_ptr<StochasticProcess>& process,
+                   const TimeGrid& timeGrid, const BigNatural seed, const SobolBrownianGenerator::Ordering ordering,
+                   const SobolRsg::DirectionIntegers directionIntegers, const Size firstPath) {
+        auto generator = build(s, process, timeGrid, seed, ordering, directionIntegers);
+        if (firstPath == 0)
+            return generator;
+        return QuantLib::ext::make_shared<MultiPathGeneratorSubstream>(generator, firstPath);
+    }
 };
 
 //! Standard implementation for path generator factory
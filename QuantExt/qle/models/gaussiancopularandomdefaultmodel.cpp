@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/models/gaussiancopularandomdefaultmodel.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/solvers1d/brent.hpp>
+
+namespace QuantExt {
+
+namespace {
+// default probability up to t minus the target probability
+class DefaultTimeRoot {
+public:
+    DefaultTimeRoot(const Handle<DefaultProbabilityTermStructure>& dts, Real p) : dts_(dts), p_(p) {}
+    Real operator()(Real t) const {
+        QL_REQUIRE(t >= 0.0, "GaussianCopulaRandomDefaultModel: negative time " << t);
+        return dts_->defaultProbability(t, true) - p_;
+    }
+
+private:
+    Handle<DefaultProbabilityTermStructure> dts_;
+    Real p_;
+};
+} // namespace
+
+GaussianCopulaRandomDefaultModel::GaussianCopulaRandomDefaultModel(const QuantLib::ext::shared_ptr<Pool>& pool,
+                                                                   const std::vector<DefaultProbKey>& defaultKeys,
+                                                                   const Handle<OneFactorCopula>& copula,
+                                                                   Real accuracy, BigNatural seed,
+                                                                   SequenceType sequenceType)
+    : RandomDefaultModel(pool, defaultKeys), copula_(copula), accuracy_(accuracy), seed_(seed),
+      sequenceType_(sequenceType) {
+    registerWith(copula_);
+    GaussianCopulaRandomDefaultModel::reset();
+}
+
+void GaussianCopulaRandomDefaultModel::nextSequence(Real tmax) {
+    const std::vector<Array> variates = generator_->next().value;
+    const Array& values = variates.front();
+    ++nextSample_;
+    Real a = std::sqrt(copula_->correlation());
+    CumulativeNormalDistribution cnd;
+    for (Size j = 0; j < pool_->size(); j++) {
+        const std::string name = pool_->names()[j];
+        const Handle<DefaultProbabilityTermStructure>& dts = pool_->get(name).defaultProbability(defaultKeys_[j]);
+        Real y = a * values[0] + std::sqrt(1.0 - a * a) * values[j + 1];
+        Real p = cnd(y);
+        if (dts->defaultProbability(tmax, true) < p)
+            pool_->setTime(name, tmax + 1);
+        else
+            pool_->setTime(name, Brent().solve(DefaultTimeRoot(dts, p), accuracy_, 0, 1));
+    }
+}
+
+void GaussianCopulaRandomDefaultModel::reset() {
+    generator_ = makeMultiPathVariateGenerator(sequenceType_, pool_->size() + 1, 1, seed_);
+    nextSample_ = 0;
+}
+
+void GaussianCopulaRandomDefaultModel::skipTo(Size k) {
+    // the samples are usually requested in order, skip only if the sequence is not continued
+    if (k == nextSample_)
+        return;
+    generator_->skipTo(k);
+    nextSample_ = k;
+}
+
+} // namespace QuantExt
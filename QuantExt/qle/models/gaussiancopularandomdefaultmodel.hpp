@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/models/gaussiancopularandomdefaultmodel.hpp
+    \brief random default model for a one factor gaussian copula supporting substreams
+    \ingroup models
+*/
+
+#pragma once
+
+#include <qle/methods/multipathvariategenerator.hpp>
+
+#include <ql/experimental/credit/onefactorcopula.hpp>
+#include <ql/experimental/credit/randomdefaultmodel.hpp>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Random default model for a one factor gaussian copula
+/*! The default times are generated as in QuantLib::GaussianRandomDefaultModel, the variates of a sample are the
+    common factor followed by the idiosyncratic factors of the pool names. They are drawn from a multi path variate
+    generator of the given sequence type with one time step, for the default Mersenne Twister the samples are the same
+    as the ones of QuantLib::GaussianRandomDefaultModel with the same seed.
+
+    The model can be positioned at any sample of its sequence with skipTo(), so that a simulation can be split into
+    blocks of samples, each block using its part of the sequence, see MultiPathVariateGeneratorBase::skipTo().
+
+    \ingroup models
+*/
+class GaussianCopulaRandomDefaultModel : public RandomDefaultModel {
+public:
+    GaussianCopulaRandomDefaultModel(const QuantLib::ext::shared_ptr<Pool>& pool,
+                                     const std::vector<DefaultProbKey>& defaultKeys,
+                                     const Handle<OneFactorCopula>& copula, Real accuracy, BigNatural seed,
+                                     SequenceType sequenceType = SequenceType::MersenneTwister);
+
+    void nextSequence(Real tmax = QL_MAX_REAL) override;
+    void reset() override;
+    void update() override { notifyObservers(); }
+
+    //! the next call to nextSequence() generates sample k, k = 0, 1, ...
+    void skipTo(Size k);
+
+    //! index of the sample generated by the next call to nextSequence()
+    Size nextSample() const { return nextSample_; }
+
+private:
+    Handle<OneFactorCopula> copula_;
+    Real accuracy_;
+    BigNatural seed_;
+    SequenceType sequenceType_;
+    QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase> generator_;
+    Size nextSample_ = 0;
+};
+
+} // namespace QuantExt
@@ -20,12 +20,20 @@
 #define quantext_inhomogenous_pool_default_model_hpp
 
 #include <ql/experimental/credit/lossdistribution.hpp>
+#include <ql/math/comparison.hpp>
 //#include <ql/experimental/credit/basket.hpp>
 #include <qle/models/basket.hpp>
 //#include <ql/experimental/credit/constantlosslatentmodel.hpp>
 #include <qle/models/constantlosslatentmodel.hpp>
 //#include <ql/experimental/credit/defaultlossmodel.hpp>
 #include <qle/models/defaultlossmodel.hpp>
+#include <qle/math/fftconvolution.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <thread>
 
 // Intended to replace InhomogeneousPoolCDOEngine in syntheticcdoengines.hpp
 
@@ -39,6 +47,15 @@ losses into buckets from loses equal to zero to losses up to the value of
 the underlying basket. This is in view of a stochastic loss given default
 but in a constant LGD situation this is a waste and it is more efficient to
 go up to the attainable losses.
+
+The conditional loss distributions can be computed by the Hull-White bucketing of QuantLib (the default) or on a
+loss lattice with unit detachAmount / nBuckets, where each loss given default is split on the two adjacent lattice
+points such that its expectation is preserved. On the lattice, the conditional name losses are either added
+recursively or convolved pairwise by FFT, in both cases the losses beyond the detachment amount are collected in a
+single overflow cell, so that the cost per name is bounded by the number of buckets. The conditional default
+probabilities are cached by date and reused as long as the marginal default probabilities and the factor weights
+do not change, e.g. between the calls with and without zero recovery for the same date. The integration steps over
+the market factor can be distributed on several threads, the result does not depend on the number of threads.
 \todo Extend to the multifactor case for a generic LM
 \todo Many common code with the homogeneous version, both classes perform
 the same work on different loss distribution types, merge and send the
@@ -52,22 +69,35 @@ public:
     // allow base correlations:
     typedef copulaPolicy copulaType;
 
+    //! Algorithm for the loss distributions conditional on the market factor
+    enum class LossDistributionMethod {
+        //! Hull-White bucketing, see QuantLib::LossDistBucketing
+        Bucketing,
+        //! recursion on the loss lattice truncated at the detachment amount
+        Recursion,
+        //! pairwise FFT convolution on the loss lattice truncated at the detachment amount
+        FFT
+    };
+
     InhomogeneousPoolLossModel(
         // restricted to non random recoveries, but it could be possible.
         const QuantLib::ext::shared_ptr<ConstantLossLatentmodel<copulaPolicy>>& copula, Size nBuckets, Real max = 5.,
-        Real min = -5., Real nSteps = 50)
-        : copula_(copula), nBuckets_(nBuckets), max_(max), min_(min), nSteps_(nSteps), delta_((max - min) / nSteps) {
+        Real min = -5., Real nSteps = 50, LossDistributionMethod method = LossDistributionMethod::Bucketing,
+        Size threads = 1)
+        : copula_(copula), nBuckets_(nBuckets), max_(max), min_(min), nSteps_(nSteps), delta_((max - min) / nSteps),
+          method_(method), threads_(threads) {
         QL_REQUIRE(copula->numFactors() == 1, "Inhomogeneous model not implemented for multifactor");
+        QL_REQUIRE(threads_ > 0, "InhomogeneousPoolLossModel: threads must be positive");
     }
     // Write another constructor sending the LM factors and recoveries.
 protected:
-    // RL: additional flag
-    Distribution lossDistrib(const Date& d, bool zeroRecovery = false) const;
+    // RL: additional argument, if given the recovery rate replaces the recovery rates of all names
+    Distribution lossDistrib(const Date& d, Real recoveryRate = Null<Real>()) const;
 
 public:
-    // RL: additional flag
-    Real expectedTrancheLoss(const Date& d, bool zeroRecovery = false) const {
-        Distribution dist = lossDistrib(d, zeroRecovery);
+    // RL: additional argument
+    Real expectedTrancheLoss(const Date& d, Real recoveryRate = Null<Real>()) const override {
+        Distribution dist = lossDistrib(d, recoveryRate);
         // RL: dist.trancheExpectedValue() using x = dist.average(i)
         // FIXME: some remaining inaccuracy in dist.cumulativeDensity(detachAmount_)
         Real expectedLoss = 0;
@@ -84,7 +114,7 @@ public:
         expectedLoss += (detachAmount_ - attachAmount_) * (1.0 - dist.cumulativeDensity(detachAmount_));
         return expectedLoss;
 
-        return lossDistrib(d, zeroRecovery).cumulativeExcessProbability(attachAmount_, detachAmount_);
+        return lossDistrib(d, recoveryRate).cumulativeExcessProbability(attachAmount_, detachAmount_);
         // This one if the distribution is over the whole loss structure:
         // but it becomes very expensive
         /*
@@ -101,6 +131,17 @@ public:
         dist.tranche(attachAmount_, detachAmount_);
         return dist.expectedShortfall(percentile);
     }
+    //! The correlation of the one factor model if the factor weights of all names are equal, Null<Real>() otherwise
+    Real correlation() const override {
+        const std::vector<std::vector<Real>>& weights = copula_->factorWeights();
+        if (weights.empty() || weights[0].size() != 1)
+            return Null<Real>();
+        for (Size i = 1; i < weights.size(); ++i) {
+            if (weights[i].size() != 1 || !close(weights[0][0], weights[i][0]))
+                return Null<Real>();
+        }
+        return weights[0][0] * weights[0][0];
+    }
 
 protected:
     const QuantLib::ext::shared_ptr<ConstantLossLatentmodel<copulaPolicy>> copula_;
@@ -116,6 +157,22 @@ private:
     const Real min_;
     const Real nSteps_;
     const Real delta_;
+    const LossDistributionMethod method_;
+    const Size threads_;
+
+    // conditional default probabilities by integration step and name for one date, together with the inputs they
+    // were computed from
+    struct ConditionalProbabilities {
+        std::vector<Real> marginalProbabilities;
+        std::vector<std::vector<Real>> factorWeights;
+        std::vector<std::vector<Real>> probabilities;
+    };
+    mutable std::map<Date, ConditionalProbabilities> conditionalProbabilities_;
+
+    const std::vector<std::vector<Real>>& conditionalProbabilities(const Date& d) const;
+    // loss distribution on the lattice 0, 1, ..., cap, the last cell holds the losses >= cap
+    static std::vector<Real> latticeLossDistribution(const std::vector<Real>& losses, const std::vector<Real>& probs,
+                                                     Size cap, bool useFft);
 };
 // \todo Add other loss distribution statistics
 typedef InhomogeneousPoolLossModel<GaussianCopulaPolicy> IHGaussPoolLossModel;
@@ -134,40 +191,195 @@ template <class CP> void InhomogeneousPoolLossModel<CP>::resetModel() {
     detachAmount_ = basket_->remainingDetachmentAmount();
 
     copula_->resetBasket(basket_.currentLink());
+    conditionalProbabilities_.clear();
+}
+
+template <class CP>
+const std::vector<std::vector<Real>>& InhomogeneousPoolLossModel<CP>::conditionalProbabilities(const Date& d) const {
+    std::vector<Real> prob = basket_->remainingProbabilities(d);
+    const std::vector<std::vector<Real>>& factorWeights = copula_->factorWeights();
+    auto c = conditionalProbabilities_.find(d);
+    if (c != conditionalProbabilities_.end() && c->second.marginalProbabilities == prob &&
+        c->second.factorWeights == factorWeights)
+        return c->second.probabilities;
+
+    ConditionalProbabilities& result = conditionalProbabilities_[d];
+    result.marginalProbabilities = prob;
+    result.factorWeights = factorWeights;
+    for (Size iName = 0; iName < prob.size(); iName++)
+        prob[iName] = copula_->inverseCumulativeY(prob[iName], iName);
+    Size nSteps = static_cast<Size>(std::ceil(nSteps_));
+    result.probabilities.resize(nSteps);
+    std::vector<Real> mkft(1, min_ + delta_ / 2.);
+    for (Size i = 0; i < nSteps; i++) {
+        result.probabilities[i].resize(prob.size());
+        for (Size iName = 0; iName < prob.size(); iName++)
+            result.probabilities[i][iName] = copula_->conditionalDefaultProbabilityInvP(prob[iName], iName, mkft);
+        mkft[0] += delta_;
+    }
+    return result.probabilities;
 }
-// RL: additional flag
-template <class CP> Distribution InhomogeneousPoolLossModel<CP>::lossDistrib(const Date& d, bool zeroRecovery) const {
+
+template <class CP>
+std::vector<Real> InhomogeneousPoolLossModel<CP>::latticeLossDistribution(const std::vector<Real>& losses,
+                                                                          const std::vector<Real>& probs, Size cap,
+                                                                          bool useFft) {
+    // the loss of name i is split on the lattice points floor(l) and floor(l) + 1 preserving its expectation
+    auto lower = [cap](Real l) { return std::min(static_cast<Size>(std::floor(l)), cap); };
+
+    if (!useFft) {
+        std::vector<Real> p(cap + 1, 0.0), tmp(cap + 1);
+        p[0] = 1.0;
+        // top is the highest lattice point that can have a positive probability so far
+        Size top = 0;
+        for (Size i = 0; i < losses.size(); i++) {
+            Size f = lower(losses[i]);
+            Real r = losses[i] - std::floor(losses[i]);
+            Real q = probs[i];
+            Size newTop = std::min(top + f + 1, cap);
+            std::fill(tmp.begin(), tmp.begin() + newTop + 1, 0.0);
+            for (Size k = 0; k <= top; k++) {
+                if (p[k] == 0.0)
+                    continue;
+                tmp[k] += p[k] * (1.0 - q);
+                tmp[std::min(k + f, cap)] += p[k] * q * (1.0 - r);
+                tmp[std::min(k + f + 1, cap)] += p[k] * q * r;
+            }
+            top = newTop;
+            std::swap(p, tmp);
+        }
+        return p;
+    }
+
+    // product tree of the name loss distributions, the losses beyond cap are folded into the overflow cell
+    std::vector<std::vector<Real>> dists;
+    for (Size i = 0; i < losses.size(); i++) {
+        Size f = lower(losses[i]);
+        Real r = losses[i] - std::floor(losses[i]);
+        std::vector<Real> d(std::min(f + 1, cap) + 1, 0.0);
+        d[0] += 1.0 - probs[i];
+        d[f] += probs[i] * (1.0 - r);
+        d[std::min(f + 1, cap)] += probs[i] * r;
+        dists.push_back(d);
+    }
+    if (dists.empty())
+        dists.push_back(std::vector<Real>(1, 1.0));
+    while (dists.size() > 1) {
+        std::vector<std::vector<Real>> next;
+        for (Size i = 0; i + 1 < dists.size(); i += 2) {
+            std::vector<Real> c = fftConvolution(dists[i], dists[i + 1]);
+            if (c.size() > cap + 1) {
+                for (Size k = cap + 1; k < c.size(); k++)
+                    c[cap] += c[k];
+                c.resize(cap + 1);
+            }
+            // remove rounding noise of the transforms
+            for (auto& x : c)
+                x = std::max(x, 0.0);
+            next.push_back(std::move(c));
+        }
+        if (dists.size() % 2 == 1)
+            next.push_back(std::move(dists.back()));
+        dists.swap(next);
+    }
+    std::vector<Real> p = dists.front();
+    p.resize(cap + 1, 0.0);
+    return p;
+}
+
+// RL: additional argument
+template <class CP>
+Distribution InhomogeneousPoolLossModel<CP>::lossDistrib(const Date& d, Real recoveryRate) const {
     LossDistBucketing bucktLDistBuff(nBuckets_, detachAmount_);
 
     std::vector<Real> lgd; // switch to a mutable cache member
-    // RL: additional option used to set set recovery rates to zero
-    std::vector<Real> recoveries =
-        zeroRecovery ? std::vector<Real>(copula_->recoveries().size(), 0.0) : copula_->recoveries();
+    // RL: additional option used to set the recovery rates of all names, e.g. to zero
+    std::vector<Real> recoveries = recoveryRate != Null<Real>()
+                                       ? std::vector<Real>(copula_->recoveries().size(), recoveryRate)
+                                       : copula_->recoveries();
     std::transform(recoveries.begin(), recoveries.end(), std::back_inserter(lgd), [](Real x) { return 1.0 - x; });
     std::transform(lgd.begin(), lgd.end(), notionals_.begin(), lgd.begin(), std::multiplies<Real>());
-    std::vector<Real> prob = basket_->remainingProbabilities(d);
-    for (Size iName = 0; iName < prob.size(); iName++)
-        prob[iName] = copula_->inverseCumulativeY(prob[iName], iName);
 
-    // integrate locally (1 factor).
-    // use explicitly a 1D latent model object?
+    // conditional default probabilities and factor densities are computed on this thread, the conditional loss
+    // distributions below only require arithmetic on these and can be computed in parallel
+    const std::vector<std::vector<Real>>& conditionalProbs = conditionalProbabilities(d);
+    Size nSteps = conditionalProbs.size();
+    std::vector<Real> densitydm(nSteps);
+    std::vector<Real> mkft(1, min_ + delta_ / 2.);
+    for (Size i = 0; i < nSteps; i++) {
+        densitydm[i] = delta_ * copula_->density(mkft);
+        mkft[0] += delta_;
+    }
+
+    // lattice unit and name losses in lattice units
+    Real unit = detachAmount_ / nBuckets_;
+    std::vector<Real> latticeLosses(lgd.size());
+    if (method_ != LossDistributionMethod::Bucketing) {
+        QL_REQUIRE(unit > 0.0, "InhomogeneousPoolLossModel: positive detachment amount required for lattice methods");
+        for (Size iName = 0; iName < lgd.size(); iName++)
+            latticeLosses[iName] = lgd[iName] / unit;
+    }
+
+    // conditional densities and averages by integration step and bucket
+    std::vector<std::vector<Real>> densities(nSteps), averages(nSteps);
+    auto computeSteps = [&](Size from, Size to) {
+        for (Size i = from; i < to; i++) {
+            if (method_ == LossDistributionMethod::Bucketing) {
+                Distribution cd = bucktLDistBuff(lgd, conditionalProbs[i]);
+                densities[i].resize(nBuckets_);
+                averages[i].resize(nBuckets_);
+                for (Size j = 0; j < nBuckets_; j++) {
+                    densities[i][j] = cd.density(j);
+                    averages[i][j] = cd.average(j);
+                }
+            } else {
+                std::vector<Real> p = latticeLossDistribution(latticeLosses, conditionalProbs[i], nBuckets_,
+                                                              method_ == LossDistributionMethod::FFT);
+                densities[i].resize(nBuckets_);
+                for (Size j = 0; j < nBuckets_; j++)
+                    densities[i][j] = p[j] / unit;
+            }
+        }
+    };
+
+    Size threads = std::max<Size>(std::min(threads_, nSteps), 1);
+    if (threads == 1) {
+        computeSteps(0, nSteps);
+    } else {
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+        Size chunk = (nSteps + threads - 1) / threads;
+        for (Size t = 0; t < threads; t++) {
+            workers.emplace_back([&computeSteps, &errors, t, chunk, nSteps]() {
+                try {
+                    computeSteps(std::min(t * chunk, nSteps), std::min((t + 1) * chunk, nSteps));
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (auto const& e : errors)
+            if (e)
+                std::rethrow_exception(e);
+    }
+
+    // integrate locally (1 factor), in the order of the integration steps
     // \todo Use a library integrator here and in the homogeneous case.
     Distribution dist(nBuckets_, 0.0, detachAmount_);
     // notional_);
-    std::vector<Real> mkft(1, min_ + delta_ / 2.);
-    for (Size i = 0; i < nSteps_; i++) {
-        std::vector<Real> conditionalProbs;
-        for (Size iName = 0; iName < notionals_.size(); iName++)
-            conditionalProbs.push_back(copula_->conditionalDefaultProbabilityInvP(prob[iName], iName, mkft));
-        Distribution d = bucktLDistBuff(lgd, conditionalProbs);
-        Real densitydm = delta_ * copula_->density(mkft);
-        // also, instead of calling the static method it could be wrapped
-        // through an inlined call in the latent model
+    for (Size i = 0; i < nSteps; i++) {
         for (Size j = 0; j < nBuckets_; j++) {
-            dist.addDensity(j, d.density(j) * densitydm);
-            dist.addAverage(j, d.average(j) * densitydm); // RL
+            dist.addDensity(j, densities[i][j] * densitydm[i]);
+            if (method_ == LossDistributionMethod::Bucketing)
+                dist.addAverage(j, averages[i][j] * densitydm[i]); // RL
         }
-        mkft[0] += delta_;
+    }
+    // on the lattice, all losses in bucket j are equal to j * unit
+    if (method_ != LossDistributionMethod::Bucketing) {
+        for (Size j = 0; j < nBuckets_; j++)
+            dist.addAverage(j, j * unit);
     }
     return dist;
 }
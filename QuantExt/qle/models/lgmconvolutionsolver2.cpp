@@ -18,13 +18,15 @@
 
 #include <qle/models/lgmconvolutionsolver2.hpp>
 
+#include <qle/math/fftconvolution.hpp>
+
 #include <ql/math/distributions/normaldistribution.hpp>
 
 namespace QuantExt {
 
 LgmConvolutionSolver2::LgmConvolutionSolver2(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
-                                             const Size ny, const Real sx, const Size nx)
-    : model_(model), nx_(static_cast<int>(nx)) {
+                                             const Size ny, const Real sx, const Size nx, const bool useFft)
+    : model_(model), useFft_(useFft), nx_(static_cast<int>(nx)) {
 
     // precompute weights
 
@@ -95,6 +97,15 @@ RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Re
         // rollback from t1 to t0 > 0
         Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
         Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
+        if (useFft_) {
+            std::vector<Real> vt1(2 * mx_ + 1);
+            for (int k = 0; k <= 2 * mx_; k++)
+                vt1[k] = v[k];
+            std::vector<Real> u = fftConvolutionRollback(vt1, y_, w_, std, dx, dx2);
+            for (int k = 0; k <= 2 * mx_; k++)
+                value.set(k, u[k]);
+            return value;
+        }
         for (int k = 0; k <= 2 * mx_; k++) {
             for (int i = 0; i <= 2 * my_; i++) {
                 // Map y index to x index, not integer in generalTo
@@ -32,12 +32,17 @@ namespace QuantExt {
 //! Numerical convolution solver for the LGM model
 /*! Reference: Hagan, Methodology for callable swaps and Bermudan
                exercise into swaptions
+
+    If useFft is true, a rollback from t1 to t0 > 0 first computes the convolution on the t1 state grid via FFT
+    and then interpolates the result linearly onto the t0 state grid. This reduces the cost per step from
+    O(nx * ny) to O((nx + ny) log(nx + ny)). The result differs from the direct method by the error of the
+    additional linear interpolation, which is of the same order as the discretisation error of the method.
 */
 
 class LgmConvolutionSolver2 : public LgmBackwardSolver {
 public:
     LgmConvolutionSolver2(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
-                          const Real sx, const Size nx);
+                          const Real sx, const Size nx, const bool useFft = false);
     Size gridSize() const override { return 2 * mx_ + 1; }
     RandomVariable stateGrid(const Real t) const override;
     // steps are always ignored, since we can take large steps
@@ -47,6 +52,7 @@ public:
 
 private:
     QuantLib::ext::shared_ptr<LinearGaussMarkovModel> model_;
+    bool useFft_;
     int mx_, my_, nx_;
     Real h_;
     std::vector<Real> y_, w_;
@@ -18,144 +18,133 @@
 
 #include <qle/pricingengines/cbomcengine.hpp>
 #include <qle/math/bucketeddistribution.hpp>
+#include <qle/models/gaussiancopularandomdefaultmodel.hpp>
 #include <ql/experimental/credit/loss.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
 namespace QuantExt {
 
     //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    void MonteCarloCBOEngine::interestWaterfall(Size i, // sample index
-                                    Size j, // date index
-                                    const vector<Date>& dates,
-                                    map<Currency,vector<Cash> >& iFlows, 
-                                    map<Currency,Cash>& tranche,
-                                    map<Currency,vector<vector<Real> > >& balance,
-                                    map<Currency,Real>& interest,
-                                    map<Currency,Real>& interestAcc,
-                                    Real cureAmount) const {
-        Currency ccy = arguments_.ccy;
-
+    void MonteCarloCBOEngine::interestWaterfall(Size j, // date index
+                                    vector<Cash>& iFlows,
+                                    Cash& tranche,
+                                    vector<Real>& balance,
+                                    Real& interest,
+                                    Real interestAcc) const {
         Real tiny = 1e-9;
-        if (balance[ccy][j][i] < tiny) {
-            tranche[ccy].flow_ = 0.0;
-            tranche[ccy].discountedFlow_ = 0.0;
+        if (balance[j] < tiny) {
+            tranche.flow_ = 0.0;
+            tranche.discountedFlow_ = 0.0;
             return;
         }
 
-        Real ccyDis = (iFlows[ccy][j].flow_ > 0 ?
-                       iFlows[ccy][j].discountedFlow_ / iFlows[ccy][j].flow_:
+        Real ccyDis = (iFlows[j].flow_ > 0 ?
+                       iFlows[j].discountedFlow_ / iFlows[j].flow_:
                        0.0);
 
         // Accrued Interest
 
-        Real amount = std::min(iFlows[ccy][j].flow_, interestAcc[ccy]);
+        Real amount = std::min(iFlows[j].flow_, interestAcc);
 
-        tranche[ccy].flow_ += amount;
-        tranche[ccy].discountedFlow_ += amount * ccyDis;
+        tranche.flow_ += amount;
+        tranche.discountedFlow_ += amount * ccyDis;
 
-        iFlows[ccy][j].flow_  -= amount;
-        iFlows[ccy][j].discountedFlow_ -= amount * ccyDis;
+        iFlows[j].flow_  -= amount;
+        iFlows[j].discountedFlow_ -= amount * ccyDis;
 
-        interest[ccy] -= amount;
+        interest -= amount;
 
         // Truncate rounding errors
-        balance[ccy][j][i] = std::max(balance[ccy][j][i], 0.0);
-        iFlows[ccy][j].flow_ = std::max(iFlows[ccy][j].flow_, 0.0);
-        iFlows[ccy][j].discountedFlow_ = std::max(iFlows[ccy][j].discountedFlow_, 0.0);
-        tranche[ccy].discountedFlow_ = std::max(tranche[ccy].discountedFlow_, 0.0);
+        balance[j] = std::max(balance[j], 0.0);
+        iFlows[j].flow_ = std::max(iFlows[j].flow_, 0.0);
+        iFlows[j].discountedFlow_ = std::max(iFlows[j].discountedFlow_, 0.0);
+        tranche.discountedFlow_ = std::max(tranche.discountedFlow_, 0.0);
     }
 
     //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    void MonteCarloCBOEngine::icocInterestWaterfall(Size i, // sample index
-                                                    Size j, // date index
+    void MonteCarloCBOEngine::icocInterestWaterfall(Size j, // date index
                                                     Size l, //tranche
-                                                    const vector<Date>& dates,
-                                                    map<Currency,vector<Cash> >& iFlows,
-                                                    vector<map<Currency,Cash> >& tranches,
-                                                    vector<map<Currency,vector<vector<Real> > > >& balances,
+                                                    vector<Cash>& iFlows,
+                                                    vector<Cash>& tranches,
+                                                    vector<vector<Real> >& balances,
                                                     Real cureAmount) const {
-        Currency ccy = arguments_.ccy;
-
-        Real ccyDis = (iFlows[ccy][j].flow_ > 0 ?
-                       iFlows[ccy][j].discountedFlow_ / iFlows[ccy][j].flow_:
+        Real ccyDis = (iFlows[j].flow_ > 0 ?
+                       iFlows[j].discountedFlow_ / iFlows[j].flow_:
                        0.0);
 
         //IC and OC
 
-        Real cureAvailable = min(iFlows[ccy][j].flow_, cureAmount);
+        Real cureAvailable = min(iFlows[j].flow_, cureAmount);
 
         for(Size k = 0; k <= l; k++){
 
-            Real amount = std::min(balances[k][ccy][j][i], cureAvailable);
+            Real amount = std::min(balances[k][j], cureAvailable);
 
-            tranches[k][ccy].flow_ += amount;
-            tranches[k][ccy].discountedFlow_ += amount * ccyDis;
+            tranches[k].flow_ += amount;
+            tranches[k].discountedFlow_ += amount * ccyDis;
 
-            iFlows[ccy][j].flow_           -= amount;
-            iFlows[ccy][j].discountedFlow_ -= amount * ccyDis;
+            iFlows[j].flow_           -= amount;
+            iFlows[j].discountedFlow_ -= amount * ccyDis;
 
-            balances[k][ccy][j][i] -= amount;
+            balances[k][j] -= amount;
 
             cureAvailable -= amount;
 
             // truncate rounding errors
-            balances[k][ccy][j][i] = std::max(balances[k][ccy][j][i], 0.0);
-            iFlows[ccy][j].flow_ = std::max(iFlows[ccy][j].flow_, 0.0);
-            iFlows[ccy][j].discountedFlow_ = std::max(iFlows[ccy][j].discountedFlow_, 0.0);
-            tranches[k][ccy].discountedFlow_ = std::max(tranches[k][ccy].discountedFlow_, 0.0);
+            balances[k][j] = std::max(balances[k][j], 0.0);
+            iFlows[j].flow_ = std::max(iFlows[j].flow_, 0.0);
+            iFlows[j].discountedFlow_ = std::max(iFlows[j].discountedFlow_, 0.0);
+            tranches[k].discountedFlow_ = std::max(tranches[k].discountedFlow_, 0.0);
         }
     }
 
     //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    void MonteCarloCBOEngine::principalWaterfall(Size i, // sample index
-                                                Size j, // date index
-                                                const vector<Date>& dates,
-                                                map<Currency,vector<Cash> >& pFlows, 
-                                                map<Currency,Cash>& tranche,
-                                                map<Currency,vector<vector<Real> > >& balance,
-                                                map<Currency,Real>& interest) const {
-        Currency ccy = arguments_.ccy;
-
-        Real ccyDis = (pFlows[ccy][j].flow_ > 0 ?
-                       pFlows[ccy][j].discountedFlow_ / pFlows[ccy][j].flow_:
+    void MonteCarloCBOEngine::principalWaterfall(Size j, // date index
+                                                vector<Cash>& pFlows,
+                                                Cash& tranche,
+                                                vector<Real>& balance,
+                                                Real& interest) const {
+        Real ccyDis = (pFlows[j].flow_ > 0 ?
+                       pFlows[j].discountedFlow_ / pFlows[j].flow_:
                        0.0);
 
         //Principal Waterfall
 
-        Real amount = std::min(pFlows[ccy][j].flow_, balance[ccy][j][i]);
+        Real amount = std::min(pFlows[j].flow_, balance[j]);
 
-        tranche[ccy].flow_ += amount;
-        tranche[ccy].discountedFlow_ += amount * ccyDis;
+        tranche.flow_ += amount;
+        tranche.discountedFlow_ += amount * ccyDis;
 
-        pFlows[ccy][j].flow_           -= amount;
-        pFlows[ccy][j].discountedFlow_ -= amount * ccyDis;
+        pFlows[j].flow_           -= amount;
+        pFlows[j].discountedFlow_ -= amount * ccyDis;
 
-        balance[ccy][j][i] -= amount;
+        balance[j] -= amount;
 
         // truncate rounding errors
-        balance[ccy][j][i] = std::max(balance[ccy][j][i], 0.0);
-        pFlows[ccy][j].flow_ = std::max(pFlows[ccy][j].flow_, 0.0);
-        pFlows[ccy][j].discountedFlow_ = std::max(pFlows[ccy][j].discountedFlow_, 0.0);
-        tranche[ccy].discountedFlow_ = std::max(tranche[ccy].discountedFlow_, 0.0);
+        balance[j] = std::max(balance[j], 0.0);
+        pFlows[j].flow_ = std::max(pFlows[j].flow_, 0.0);
+        pFlows[j].discountedFlow_ = std::max(pFlows[j].discountedFlow_, 0.0);
+        tranche.discountedFlow_ = std::max(tranche.discountedFlow_, 0.0);
 
-        interest[ccy] -= std::min(interest[ccy], amount);
+        interest -= std::min(interest, amount);
     }
 
     //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    Real MonteCarloCBOEngine::icocCureAmount(Size i,
-                        Size j,
+    Real MonteCarloCBOEngine::icocCureAmount(Size j,
                         Size k,
                         Real basketNotional,
                         Real basketInterest,
-                        vector<map<Currency ,vector<vector<Real> > > >& trancheBalances,
-                        vector<Real> trancheInterestRates,
+                        const vector<vector<Real> >& trancheBalances,
+                        const vector<Real>& trancheInterestRates,
                         Real icRatio,
                         Real ocRatio) const {
-        Currency ccy = arguments_.ccy;
-
         Real cureAmount;
 
         if((icRatio < 0.) && (ocRatio < 0.)){
@@ -166,8 +155,8 @@ namespace QuantExt {
             Real piC = 0.;
 
             for(Size l = 0; l < k; l++){
-                poC-= trancheBalances[l][ccy][j][i];
-                piC-= trancheBalances[l][ccy][j][i]*trancheInterestRates[l];
+                poC-= trancheBalances[l][j];
+                piC-= trancheBalances[l][j]*trancheInterestRates[l];
             }
 
             poC+= basketNotional/ocRatio;
@@ -182,7 +171,7 @@ namespace QuantExt {
             poC = std::max(poC, 0.);
             Real pTarget = std::min(poC, piC);
 
-            cureAmount = max(trancheBalances[k][ccy][j][i] - pTarget, 0.) ;
+            cureAmount = max(trancheBalances[k][j] - pTarget, 0.) ;
         }
         return cureAmount;
     }
@@ -222,405 +211,413 @@ namespace QuantExt {
     }
 
     //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    void MonteCarloCBOEngine::calculate() const {
+    void MonteCarloCBOEngine::scenarioFlows(const vector<Date>& dates, SampleFlows& flows) const {
 
-        Date today = Settings::instance().evaluationDate();
-        initialize(); //set the underlying Basket 
-        rdm_->reset();
+        Currency ccy = arguments_.ccy;
 
-        // Prepare additional results for loss distributions if they have been requested
-        map<Date, string> lossDistributionDates = getLossDistributionDates(today);
-        vector<Date> lossDistributionDatesVector;
-        map<string, QuantLib::ext::shared_ptr<BucketedDistribution> > lossDistributionMap;
-        if (!lossDistributionDates.empty()) {
+        //Get Collection from bondbasket and exchange into base currency...
+        map<Currency, vector<Cash> > cf_full = arguments_.basket->scenarioCashflow(dates);
+        map<Currency, vector<Cash> > iFlows_full = arguments_.basket->scenarioInterestflow(dates);
+        map<Currency, vector<Cash> > pFlows_full = arguments_.basket->scenarioPrincipalflow(dates);
+        map<Currency, vector<Real> > basketNotional_full = arguments_.basket->scenarioRemainingNotional(dates);
 
-            // calculate max loss from the pool
-            Real maxLoss = 0.0;
-            for (auto& bonds :  arguments_.basket->bonds()) {
-                string name = bonds.first;
-                maxLoss += bonds.second->notional(today) * arguments_.basket->multiplier(name) * (1.0 - arguments_.basket->recoveryRate(name));
-            }
+        set<Currency> basketCurrency = arguments_.basket->unique_currencies();
 
-            // initialise the Loss BucketedDistribtions with the above maxLoss
-            Size numBuckets = 100;
-            for (map<Date, string>::iterator it = lossDistributionDates.begin(); it != lossDistributionDates.end(); it++) {
-                QuantLib::ext::shared_ptr<BucketedDistribution> bucketedDistribution = 
-                    QuantLib::ext::make_shared<BucketedDistribution> (0, maxLoss, numBuckets);
-                // Set all probabilities = 0.0;
-                for (Size i = 0; i < numBuckets; i++)
-                    bucketedDistribution->probabilities()[i] = 0.0;
-                lossDistributionMap[it->second] = bucketedDistribution;
+        if(basketCurrency.size() > 1){
 
-                lossDistributionDatesVector.push_back(it->first);
-            }
-        }
+            flows.cf.resize(dates.size());
+            flows.iFlows.resize(dates.size());
+            flows.pFlows.resize(dates.size());
+            flows.basketNotional.resize(dates.size());
 
-        //get date grid, dependending on tranche (to be valued) 
-        vector<Date> dates = arguments_.schedule.dates();
+            for(size_t d = 0; d < dates.size(); d++){
 
-        //adjust the date grid, such that it starts with today
-        std::vector<Date>::iterator it;
-        for (it=dates.begin(); it<dates.end(); ++it)
-            if(*it > today) break;
+                double cf1 = 0.0;
+                double cf2 = 0.0;
+                double if1 = 0.0;
+                double if2 = 0.0;
+                double pf1 = 0.0;
+                double pf2 = 0.0;
+                double bn = 0.0;
 
-        dates.erase(dates.begin(), it);
-        dates.insert(dates.begin(), today);
+                for(auto& basketCcy : basketCurrency){
+                    cf1 += arguments_.basket->convert(cf_full[basketCcy][d].flow_, basketCcy, dates[d]);
+                    cf2 += arguments_.basket->convert(cf_full[basketCcy][d].discountedFlow_, basketCcy, dates[d]);
 
-        Real tmax = 1.0 + ActualActual(ActualActual::ISDA).yearFraction(today, dates.back());
-
-        arguments_.basket->fillFlowMaps();
+                    if1 += arguments_.basket->convert(iFlows_full[basketCcy][d].flow_, basketCcy, dates[d]);
+                    if2 += arguments_.basket->convert(iFlows_full[basketCcy][d].discountedFlow_, basketCcy, dates[d]);
 
-        arguments_.basket->setGrid(dates);
+                    pf1 += arguments_.basket->convert(pFlows_full[basketCcy][d].flow_, basketCcy, dates[d]);
+                    pf2 += arguments_.basket->convert(pFlows_full[basketCcy][d].discountedFlow_, basketCcy, dates[d]);
 
-        //other requirements 
-        DayCounter feeDayCount = arguments_.feeDayCounter;
-        Currency ccy = arguments_.ccy;
-
-        //asset flows 
-        map<Currency, vector<Cash> > cf;
-        map<Currency, vector<Cash> > iFlows;
-        map<Currency, vector<Cash> > pFlows;
-        map<Currency, vector<Real> > basketNotional;
-
-        //liability flows 
-        vector<Real> basketValue(samples_, 0.0);
-        vector<vector<Real> > trancheValue;
-        vector<Tranche> tranches = arguments_.tranches;
-        for (Size i = 0 ; i < tranches.size() ; i ++){
-            vector<Real> tempTrancheValue(samples_, 0.0);
-            trancheValue.push_back(tempTrancheValue);
+                    bn += arguments_.basket->convert(basketNotional_full[basketCcy][d], basketCcy, dates[d]);
+                }
+                flows.cf[d] = Cash(cf1, cf2);
+                flows.iFlows[d] = Cash(if1, if2);
+                flows.pFlows[d] = Cash(pf1, pf2);
+                flows.basketNotional[d] = bn;
+            }
         }
+        else{
+            QL_REQUIRE(cf_full.find(ccy) != cf_full.end(),
+                       "MonteCarloCBOEngine: no basket flows in CBO currency " << ccy.code());
+            flows.cf = cf_full[ccy];
+            flows.iFlows = iFlows_full[ccy];
+            flows.pFlows = pFlows_full[ccy];
+            flows.basketNotional = basketNotional_full[ccy];
+        }
+    }
 
-        vector <map<Currency, vector<vector<Real> > > > trancheBalance; 
-        trancheBalance.resize(tranches.size());
-        for (Size i = 0 ; i < tranches.size() ; i ++){
-            trancheBalance[i][ccy].resize(
-                                dates.size(), vector<Real>(samples_, 0.0));
+    //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    void MonteCarloCBOEngine::waterfall(Size i, // sample index
+                                        const WaterfallData& data,
+                                        SampleFlows& flows,
+                                        WaterfallBuffers& buffers,
+                                        vector<Real>& basketValue,
+                                        vector<vector<Real> >& trancheValue,
+                                        vector<Real>& feeValue,
+                                        vector<Real>& subfeeValue) const {
+
+        const vector<Tranche>& tranches = arguments_.tranches;
+        const vector<Date>& dates = data.dates;
+
+        vector<Cash>& cf = flows.cf;
+        vector<Cash>& iFlows = flows.iFlows;
+        vector<Cash>& pFlows = flows.pFlows;
+        const vector<Real>& basketNotional = flows.basketNotional;
+
+        vector<vector<Real> >& trancheBalance = buffers.trancheBalance;
+        vector<Real>& trancheInterest = buffers.trancheInterest;
+        vector<Real>& trancheIntAcc = buffers.trancheIntAcc;
+        vector<Cash>& tranche = buffers.tranche;
+
+        for( Size k = 0 ; k < tranches.size() ; k++){
+            trancheBalance[k][0] = tranches[k].faceAmount;
+            trancheInterest[k] = 0.0;
         }
 
-        vector<Real> feeValue(samples_, 0.0);
-        vector<Real> subfeeValue(samples_, 0.0);
+        for (Size j = 1; j < dates.size(); j++) {
 
-        /*
-        //prepare for convergence analysis
-        bool convergenceFlag = false;
-        std::vector<double> runningMean(tranches.size(),0.0);
-        std::vector<double> runningStdev(tranches.size(),0.0);
-        if(ore::data::Log::instance().filter(ORE_DATA)){
-            TLOG("convergence analysis - check first two moments");
-            std::ostringstream labels;
-            labels << "sample";
-            for(Size k = 0 ; k < tranches.size(); k++)
-                labels << "," << tranches[k].name << "-mean,"<< tranches[k].name << "-stdev";
-            TLOG(labels.str());
-            convergenceFlag = true;
-        }
-        */
+            //Back out discountfactors 
 
-        for (Size i = 0; i < samples_; i++) { 
-            rdm_->nextSequence(tmax);
+            Real intCcyDis = (iFlows[j].flow_ > 0 ?
+                           iFlows[j].discountedFlow_ / iFlows[j].flow_ :
+                           0.0);
 
-            for( Size k = 0 ; k < tranches.size() ; k++){
-                trancheBalance[k][ccy][0][i] = arguments_.tranches[k].faceAmount;
-            }
+            /**************************************************************
+             * check flows add up
+             */
+            Real tiny = 1.0e-6;
+            Real flowsCheck = fabs(cf[j].flow_
+                                   -iFlows[j].flow_
+                                   -pFlows[j].flow_);
+            QL_REQUIRE( flowsCheck < tiny,
+                       "Interest and Principal Flows don't sum to Total: "
+                       << flowsCheck);
+
+            Real dfFlowsCheck = fabs(cf[j].discountedFlow_
+                                   -iFlows[j].discountedFlow_
+                                   -pFlows[j].discountedFlow_);
+
+            QL_REQUIRE( dfFlowsCheck < tiny,
+                       "discounted Interest and Principal Flows don't sum to Total: "
+                       << dfFlowsCheck);
 
-            vector< map<Currency, Real> >trancheInterest;
-            trancheInterest.resize(tranches.size());
-            for( Size k = 0 ; k < tranches.size() ; k++){
-                trancheInterest[k][ccy] = 0.0;
+            /**************************************************************
+             * tranche interest claim
+             */
+            const vector<Real>& trancheInterestRates = data.trancheInterestRates[j];
+            for (Size k = 0 ; k< tranches.size(); k++){
+                trancheIntAcc[k] = trancheBalance[k][j-1] * trancheInterestRates[k];
+                trancheInterest[k] += trancheIntAcc[k];
+                trancheBalance[k][j] = trancheBalance[k][j-1];
             }
+            /**************************************************************
+             * Collections
+             */
+            Real ccyDFlow = cf[j].discountedFlow_;
+            Real basketInterest = iFlows[j].flow_; //for cure amount calc
+
+            /**************************************************************
+             * Senior fees
+             */
+            Real ccyFeeClaim = basketNotional[j] * arguments_.seniorFee * data.feeYearFractions[j];
 
-            //Get Collection from bondbasket and exchange into base currency...
-            cf.clear();
-            iFlows.clear();
-            pFlows.clear();
-            basketNotional.clear();
+            Real ccyFeeFlow = std::min(ccyFeeClaim, iFlows[j].flow_);
 
-            map<Currency, vector<Cash> > cf_full = arguments_.basket->scenarioCashflow(dates);
-            map<Currency, vector<Cash> > iFlows_full = arguments_.basket->scenarioInterestflow(dates);
-            map<Currency, vector<Cash> > pFlows_full = arguments_.basket->scenarioPrincipalflow(dates);
-            map<Currency, vector<Real> > basketNotional_full = arguments_.basket->scenarioRemainingNotional(dates);
+            iFlows[j].flow_ -= ccyFeeFlow;
+            iFlows[j].discountedFlow_ -= ccyFeeFlow * intCcyDis;
 
-            set<Currency> basketCurrency = arguments_.basket->unique_currencies();
+            cf[j].flow_ -= ccyFeeFlow;
+            cf[j].discountedFlow_ -= ccyFeeFlow * intCcyDis;
 
-            if(basketCurrency.size() > 1){
+            feeValue[i] += ccyFeeFlow * intCcyDis;
 
-                vector<Cash> cf_single;
-                vector<Cash> iFlows_single;
-                vector<Cash> pFlows_single;
-                vector<Real> basketNotional_single;
+            QL_REQUIRE(cf[j].flow_ >= 0.0, "ccy flows < 0");
 
-                for(size_t d = 0; d < dates.size(); d++){
 
-                    double cf1 = 0.0;
-                    double cf2 = 0.0;
-                    double if1 = 0.0;
-                    double if2 = 0.0;
-                    double pf1 = 0.0;
-                    double pf2 = 0.0;
-                    //Cash pf(0.0, 0.0);
-                    double bn = 0.0;
+            /**************************************************************
+             * tranche waterfall
+             */
+            std::fill(tranche.begin(), tranche.end(), Cash());
 
-                    for(auto& basketCcy : basketCurrency){
-                        cf1 += arguments_.basket->convert(cf_full[basketCcy][d].flow_, basketCcy, dates[d]);
-                        cf2 += arguments_.basket->convert(cf_full[basketCcy][d].discountedFlow_, basketCcy, dates[d]);
+            //Interest Waterfall incl. ICOC
+            for (Size k = 0 ; k < tranches.size() ; k++){
 
-                        if1 += arguments_.basket->convert(iFlows_full[basketCcy][d].flow_, basketCcy, dates[d]);
-                        if2 += arguments_.basket->convert(iFlows_full[basketCcy][d].discountedFlow_, basketCcy, dates[d]);
+                Real icRatio = tranches[k].icRatio;
+                Real ocRatio = tranches[k].ocRatio;
 
-                        pf1 += arguments_.basket->convert(pFlows_full[basketCcy][d].flow_, basketCcy, dates[d]);
-                        pf2 += arguments_.basket->convert(pFlows_full[basketCcy][d].discountedFlow_, basketCcy, dates[d]);
+                //IC and OC Target Balances
+                Real cureAmount = icocCureAmount(j, k,
+                                       basketNotional[j],
+                                       basketInterest,
+                                       trancheBalance,
+                                       trancheInterestRates,
+                                       icRatio,
+                                       ocRatio);
 
-                        bn += arguments_.basket->convert(basketNotional_full[basketCcy][d], basketCcy, dates[d]);
-                    }
-                    cf_single.push_back(Cash(cf1, cf2));
-                    iFlows_single.push_back(Cash(if1,if2));
-                    pFlows_single.push_back(Cash(pf1,pf2));
-                    basketNotional_single.push_back(bn);
-                }
-                cf[ccy] = cf_single;
-                iFlows[ccy] = iFlows_single;
-                pFlows[ccy] = pFlows_single;
-                basketNotional[ccy] = basketNotional_single;
+                interestWaterfall(j, iFlows, tranche[k], trancheBalance[k],
+                                  trancheInterest[k], trancheIntAcc[k]);
+
+                icocInterestWaterfall(j, k, iFlows, tranche, trancheBalance,
+                                      cureAmount);
 
             }
-            else{
-                cf = cf_full;
-                iFlows = iFlows_full;
-                pFlows = pFlows_full;
-                basketNotional = basketNotional_full;
+
+            //Principal Waterfall
+            for (Size k = 0 ; k < tranches.size() ; k++){
+
+                principalWaterfall(j, pFlows, tranche[k], trancheBalance[k],
+                                   trancheInterest[k]);
+
+                cf[j].flow_ -= tranche[k].flow_;
+                cf[j].discountedFlow_ -= tranche[k].discountedFlow_;
+
             }
 
-            for (Size j = 1; j < dates.size(); j++) {
+            /**************************************************************
+             * Subordinated Fee
+             */
 
-                //Back out discountfactors 
+            Real ccysubFeeClaim = basketNotional[j] * arguments_.subordinatedFee * data.feeYearFractions[j];
 
-                Real intCcyDis = (iFlows[ccy][j].flow_ > 0 ?
-                               iFlows[ccy][j].discountedFlow_ / iFlows[ccy][j].flow_ :
-                               0.0);
+            Real ccysubFeeFlow = std::min(ccysubFeeClaim, iFlows[j].flow_);
 
-                /**************************************************************
-                 * check flows add up
-                 */
-                Real tiny = 1.0e-6;
-                Real flowsCheck = fabs(cf[ccy][j].flow_
-                                       -iFlows[ccy][j].flow_
-                                       -pFlows[ccy][j].flow_);
-                QL_REQUIRE( flowsCheck < tiny,
-                           "Interest and Principal Flows don't sum to Total: "
-                           << flowsCheck);
-
-                Real dfFlowsCheck = fabs(cf[ccy][j].discountedFlow_
-                                       -iFlows[ccy][j].discountedFlow_
-                                       -pFlows[ccy][j].discountedFlow_);
-
-                QL_REQUIRE( dfFlowsCheck < tiny,
-                           "discounted Interest and Principal Flows don't sum to Total: "
-                           << dfFlowsCheck);
+            iFlows[j].flow_ -= ccysubFeeFlow;
+            iFlows[j].discountedFlow_ -= ccysubFeeFlow * intCcyDis;
 
-                /**************************************************************
-                 * tranche interest claim
-                 */
-                vector<map<Currency, Real> >trancheIntAcc;
-                trancheIntAcc.resize(tranches.size());
-                vector<Real> trancheInterestRates;
-                // ccy
-                for (Size k = 0 ; k< tranches.size(); k++){
-                    Real trancheInterestRate =
-                        tranches[k].leg[j-1]->amount()/
-                        tranches[k].faceAmount;
-                    trancheInterestRates.push_back(trancheInterestRate);
-                    //ccy
-                    trancheIntAcc[k][ccy] = trancheBalance[k][ccy][j-1][i]
-                        * (trancheInterestRate);
-                    trancheInterest[k][ccy] += trancheIntAcc[k][ccy];
-                    trancheBalance[k][ccy][j][i]
-                        = trancheBalance[k][ccy][j-1][i];
-                }
-                /**************************************************************
-                 * Collections
-                 */
-                Real ccyDFlow = cf[ccy][j].discountedFlow_;
-                Real basketInterest = iFlows[ccy][j].flow_; //for cure amount calc
+            cf[j].flow_ -= ccysubFeeFlow;
+            cf[j].discountedFlow_ -= ccysubFeeFlow * intCcyDis;
 
-                /**************************************************************
-                 * Senior fees
-                 */
-                Real ccyFeeClaim = basketNotional[ccy][j] * arguments_.seniorFee
-                    * feeDayCount.yearFraction(dates[j-1], dates[j]);
+            subfeeValue[i] += ccysubFeeFlow * intCcyDis;
+            QL_REQUIRE(cf[j].flow_ >= -1.0E-5, "ccy flows < 0");
 
-                Real ccyFeeFlow = std::min(ccyFeeClaim, iFlows[ccy][j].flow_);
+            /**************************************************************
+             * Kicker:
+             * Split excess flows between equity tranche (1-x) and senior fee (x)
+             */
+            Real x = arguments_.equityKicker;
 
-                iFlows[ccy][j].flow_ -= ccyFeeFlow;
-                iFlows[ccy][j].discountedFlow_ -= ccyFeeFlow * intCcyDis;
+            Cash residual(0.0, 0.0);
+            residual.discountedFlow_ = pFlows[j].discountedFlow_ + iFlows[j].discountedFlow_;
+            residual.flow_ = pFlows[j].flow_ + iFlows[j].flow_;
 
-                cf[ccy][j].flow_ -= ccyFeeFlow;
-                cf[ccy][j].discountedFlow_ -= ccyFeeFlow * intCcyDis;
+            tranche.back().flow_ += residual.flow_ * (1 - x);
+            tranche.back().discountedFlow_ +=  residual.discountedFlow_ * (1 - x);
 
-                feeValue[i] += ccyFeeFlow * intCcyDis;
+            feeValue[i] += residual.discountedFlow_ * x;
 
-                QL_REQUIRE(cf[ccy][j].flow_ >= 0.0, "ccy flows < 0");
+            cf[j].flow_ -= residual.flow_;
+            cf[j].discountedFlow_ -= residual.discountedFlow_;
 
 
-                /**************************************************************
-                 * tranche waterfall
-                 */
-                vector<map<Currency, Real> > trancheAmortization;
-                vector<map<Currency, Cash> > tranche;
-                trancheAmortization.resize(tranches.size());
-                tranche.resize(tranches.size());
-
-                //Interest Waterfall incl. ICOC
-                for (Size k = 0 ; k < tranches.size() ; k++){
-
-                    tranche[k][ccy].flow_ = 0.;
-                    tranche[k][ccy].discountedFlow_ = 0.;
-
-                    Real icRatio = arguments_.tranches[k].icRatio;
-                    Real ocRatio = arguments_.tranches[k].ocRatio;
-
-                    //IC and OC Target Balances
-                    Real cureAmount = icocCureAmount(i,j,k,
-                                           basketNotional[ccy][j],
-                                           basketInterest,
-                                           trancheBalance,
-                                           trancheInterestRates,
-                                           icRatio,
-                                           ocRatio);
-
-                    interestWaterfall(i, j, dates, iFlows,
-                          tranche[k], trancheBalance[k], 
-                          trancheInterest[k],
-                          trancheIntAcc[k], cureAmount); 
-
-                    icocInterestWaterfall(i, j, k, dates, iFlows,
-                                      tranche, trancheBalance, 
-                                        cureAmount); 
+            /**************************************************************
+             * Consistency checks
+             */
+            QL_REQUIRE(cf[j].flow_ >= -1.e-5, "residual ccy flow < 0: "<<
+                       cf[j].flow_);
 
-                }
+            QL_REQUIRE(ccyFeeFlow  >= -1.e-5, "ccy fee flow < 0");
 
-                //Principal Waterfall
-                for (Size k = 0 ; k < tranches.size() ; k++){
+            for(Size k = 0; k < tranches.size() ; k++){
+                QL_REQUIRE(tranche[k].flow_ >= -1.e-5, "ccy "<<
+                       tranches[k].name <<" flow < 0: "
+                           <<tranche[k].flow_);
+            }
 
-                    principalWaterfall(i, j, dates, pFlows,
-                                       tranche[k], trancheBalance[k],
-                                       trancheInterest[k]);
 
-                    cf[ccy][j].flow_ -= tranche[k][ccy].flow_;
-                    cf[ccy][j].discountedFlow_ -= tranche[k][ccy].discountedFlow_;
+            basketValue[i] += ccyDFlow;
+            for(Size k = 0 ; k < tranches.size() ; k ++){
+                trancheValue[k][i] += tranche[k].discountedFlow_;
+            }
+            Real tranchenpvError(0.);
+            for(Size k = 0 ; k < tranches.size() ; k ++){
+               tranchenpvError +=trancheValue[k][i];
+            }
+            Real  npvError(0.);
+            if(basketValue[i] > 0.){
+               npvError = (feeValue[i] + subfeeValue[i] + tranchenpvError) / basketValue[i] - 1.0;
+               if(fabs(npvError) > errorTolerance_)
+                    QL_FAIL("NPVs do not add up, rel. error " << npvError);
+            }
 
-                }
+            QL_REQUIRE(basketValue[i] >= 0.0,
+                           "negative basket value " << basketValue[i]);
 
-                /**************************************************************
-                 * Subordinated Fee
-                 */
+        } // end dates
+    }
 
-                Real ccysubFeeClaim = basketNotional[ccy][j] * arguments_.subordinatedFee
-                                    * feeDayCount.yearFraction(dates[j-1], dates[j]);
+    //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    void MonteCarloCBOEngine::calculate() const {
 
-                Real ccysubFeeFlow = std::min(ccysubFeeClaim, iFlows[ccy][j].flow_);
+        Date today = Settings::instance().evaluationDate();
+        initialize(); //set the underlying Basket 
+        rdm_->reset();
+        auto substreamRdm = QuantLib::ext::dynamic_pointer_cast<GaussianCopulaRandomDefaultModel>(rdm_);
 
-                iFlows[ccy][j].flow_ -= ccysubFeeFlow;
-                iFlows[ccy][j].discountedFlow_ -= ccysubFeeFlow * intCcyDis;
+        // Prepare additional results for loss distributions if they have been requested
+        map<Date, string> lossDistributionDates = getLossDistributionDates(today);
+        vector<Date> lossDistributionDatesVector;
+        map<string, QuantLib::ext::shared_ptr<BucketedDistribution> > lossDistributionMap;
+        if (!lossDistributionDates.empty()) {
 
-                cf[ccy][j].flow_ -= ccysubFeeFlow;
-                cf[ccy][j].discountedFlow_ -= ccysubFeeFlow * intCcyDis;
+            // calculate max loss from the pool
+            Real maxLoss = 0.0;
+            for (auto& bonds :  arguments_.basket->bonds()) {
+                string name = bonds.first;
+                maxLoss += bonds.second->notional(today) * arguments_.basket->multiplier(name) * (1.0 - arguments_.basket->recoveryRate(name));
+            }
 
-                subfeeValue[i] += ccysubFeeFlow * intCcyDis;
-                QL_REQUIRE(cf[ccy][j].flow_ >= -1.0E-5, "ccy flows < 0");
+            // initialise the Loss BucketedDistribtions with the above maxLoss
+            Size numBuckets = 100;
+            for (map<Date, string>::iterator it = lossDistributionDates.begin(); it != lossDistributionDates.end(); it++) {
+                QuantLib::ext::shared_ptr<BucketedDistribution> bucketedDistribution = 
+                    QuantLib::ext::make_shared<BucketedDistribution> (0, maxLoss, numBuckets);
+                // Set all probabilities = 0.0;
+                for (Size i = 0; i < numBuckets; i++)
+                    bucketedDistribution->probabilities()[i] = 0.0;
+                lossDistributionMap[it->second] = bucketedDistribution;
 
-                /**************************************************************
-                 * Kicker:
-                 * Split excess flows between equity tranche (1-x) and senior fee (x)
-                 */
-                Real x = arguments_.equityKicker;
+                lossDistributionDatesVector.push_back(it->first);
+            }
+        }
 
-                Cash residual(0.0, 0.0);
-                residual.discountedFlow_ = pFlows[ccy][j].discountedFlow_ + iFlows[ccy][j].discountedFlow_;
-                residual.flow_ = pFlows[ccy][j].flow_ + iFlows[ccy][j].flow_;
+        //get date grid, dependending on tranche (to be valued) 
+        vector<Date> dates = arguments_.schedule.dates();
 
-                tranche.back()[ccy].flow_ += residual.flow_ * (1 - x);
-                tranche.back()[ccy].discountedFlow_ +=  residual.discountedFlow_ * (1 - x);
+        //adjust the date grid, such that it starts with today
+        std::vector<Date>::iterator it;
+        for (it=dates.begin(); it<dates.end(); ++it)
+            if(*it > today) break;
 
-                feeValue[i] += residual.discountedFlow_ * x;
+        dates.erase(dates.begin(), it);
+        dates.insert(dates.begin(), today);
 
-                cf[ccy][j].flow_ -= residual.flow_;
-                cf[ccy][j].discountedFlow_ -= residual.discountedFlow_;
+        Real tmax = 1.0 + ActualActual(ActualActual::ISDA).yearFraction(today, dates.back());
 
+        arguments_.basket->fillFlowMaps();
 
-                /**************************************************************
-                 * Consistency checks
-                 */
-                QL_REQUIRE(cf[ccy][j].flow_ >= -1.e-5, "residual ccy flow < 0: "<<
-                           cf[ccy][j].flow_);
+        arguments_.basket->setGrid(dates);
 
-                QL_REQUIRE(ccyFeeFlow  >= -1.e-5, "ccy fee flow < 0");
+        //other requirements 
+        DayCounter feeDayCount = arguments_.feeDayCounter;
+        Currency ccy = arguments_.ccy;
+        vector<Tranche> tranches = arguments_.tranches;
 
-                for(Size k = 0; k < tranches.size() ; k++){
-                    QL_REQUIRE(tranche[k][ccy].flow_ >= -1.e-5, "ccy "<<
-                           tranches[k].name <<" flow < 0: "
-                               <<tranche[k][ccy].flow_);
-                }
+        // sample independent waterfall data, these may require pricing engines and are therefore set up here
+        WaterfallData data;
+        data.dates = dates;
+        data.trancheInterestRates.resize(dates.size());
+        data.feeYearFractions.resize(dates.size(), 0.0);
+        for (Size j = 1; j < dates.size(); j++) {
+            data.feeYearFractions[j] = feeDayCount.yearFraction(dates[j-1], dates[j]);
+            for (Size k = 0; k < tranches.size(); k++)
+                data.trancheInterestRates[j].push_back(tranches[k].leg[j-1]->amount() / tranches[k].faceAmount);
+        }
 
+        //liability flows 
+        vector<Real> basketValue(samples_, 0.0);
+        vector<vector<Real> > trancheValue(tranches.size(), vector<Real>(samples_, 0.0));
+        vector<Real> feeValue(samples_, 0.0);
+        vector<Real> subfeeValue(samples_, 0.0);
 
-                basketValue[i] += ccyDFlow;
-                for(Size k = 0 ; k < tranches.size() ; k ++){
-                    trancheValue[k][i] += tranche[k][ccy].discountedFlow_;
-                }
-                Real tranchenpvError(0.);
-                for(Size k = 0 ; k < tranches.size() ; k ++){
-                   tranchenpvError +=trancheValue[k][i];
-                }
-                Real  npvError(0.);
-                if(basketValue[i] > 0.){
-                   npvError = (feeValue[i] + subfeeValue[i] + tranchenpvError) / basketValue[i] - 1.0;
-                   if(fabs(npvError) > errorTolerance_)
-                        //ALOG("NPVs do not add up, rel. error " << npvError);
-                        QL_FAIL("NPVs do not add up, rel. error " << npvError);
-                }
+        // sample flows and scratch buffers, reused across the blocks
+        Size threads = std::max<Size>(std::min(threads_, (samples_ + blockSize_ - 1) / blockSize_), 1);
+        vector<SampleFlows> flows(std::min(samples_, threads * blockSize_));
+        vector<WaterfallBuffers> buffers(threads);
+        for (auto& b : buffers) {
+            b.trancheBalance.resize(tranches.size(), vector<Real>(dates.size(), 0.0));
+            b.trancheInterest.resize(tranches.size(), 0.0);
+            b.trancheIntAcc.resize(tranches.size(), 0.0);
+            b.tranche.resize(tranches.size());
+        }
 
-                QL_REQUIRE(basketValue[i] >= 0.0,
-                               "negative basket value " << basketValue[i]);
+        for (Size start = 0; start < samples_; start += flows.size()) {
+            Size end = std::min(start + flows.size(), samples_);
 
-            } // end dates
+            // default times and basket flows, the random default model and the basket share the pool
+            for (Size i = start; i < end; i++) {
+                // each block starts at its own first sample of the default model's sequence
+                if (substreamRdm && (i - start) % blockSize_ == 0)
+                    substreamRdm->skipTo(i);
+                rdm_->nextSequence(tmax);
+                scenarioFlows(dates, flows[i - start]);
 
-            /**************************************************************
-             * Loss Distribution
-             */
-            if (!lossDistributionDates.empty()) {
-                // get the losses on this sample for each date
-                map<Currency, vector<Cash> >
-                    lossDist = arguments_.basket->scenarioLossflow(lossDistributionDatesVector);
-
-                // foreach date, we see what bucket our loss falls into and we increase the probability for
-                // that bucket by 1/samples
-                for (Size k = 0; k < lossDistributionDatesVector.size(); k++) {
-                    Real loss = lossDist[ccy][k].flow_;
-                    Date d = lossDistributionDatesVector[k];
-                    string dateString = lossDistributionDates[d];
-
-                    QuantLib::ext::shared_ptr<BucketedDistribution> bd = lossDistributionMap[dateString];
-                    Size index = bd->bucket(loss); // find the bucket we need to update
-                    bd->probabilities()[index] += 1.0 / samples_;
+                /**************************************************************
+                 * Loss Distribution
+                 */
+                if (!lossDistributionDates.empty()) {
+                    // get the losses on this sample for each date
+                    map<Currency, vector<Cash> >
+                        lossDist = arguments_.basket->scenarioLossflow(lossDistributionDatesVector);
+
+                    // foreach date, we see what bucket our loss falls into and we increase the probability for
+                    // that bucket by 1/samples
+                    for (Size k = 0; k < lossDistributionDatesVector.size(); k++) {
+                        Real loss = lossDist[ccy][k].flow_;
+                        Date d = lossDistributionDatesVector[k];
+                        string dateString = lossDistributionDates[d];
+
+                        QuantLib::ext::shared_ptr<BucketedDistribution> bd = lossDistributionMap[dateString];
+                        Size index = bd->bucket(loss); // find the bucket we need to update
+                        bd->probabilities()[index] += 1.0 / samples_;
+                    }
                 }
             }
 
-            /*
-            //convergence
-            if(convergenceFlag){
-                std::ostringstream meanStev;
-                meanStev << i << fixed << setprecision(2);
-                for(Size k = 0 ; k < tranches.size(); k++){
-                    runningMean[k] += trancheValue[k][i];
-                    double mean = runningMean[k] / (i + 1);
-                    meanStev << "," << mean;
-                    runningStdev[k] += trancheValue[k][i]*trancheValue[k][i];
-                    double stdev = sqrt(runningStdev[k] / (i + 1)  - mean * mean);
-                    meanStev << "," << stdev;
+            // waterfalls, one block of samples per thread, each sample writes to its own index only
+            Size nBlocks = (end - start + blockSize_ - 1) / blockSize_;
+            auto runBlock = [&, start, end](Size b) {
+                for (Size i = start + b * blockSize_; i < std::min(start + (b + 1) * blockSize_, end); i++)
+                    waterfall(i, data, flows[i - start], buffers[b], basketValue, trancheValue, feeValue,
+                              subfeeValue);
+            };
+            if (nBlocks == 1) {
+                runBlock(0);
+            } else {
+                vector<std::exception_ptr> errors(nBlocks);
+                vector<std::thread> workers;
+                for (Size b = 1; b < nBlocks; b++) {
+                    workers.emplace_back([&runBlock, &errors, b]() {
+                        try {
+                            runBlock(b);
+                        } catch (...) {
+                            errors[b] = std::current_exception();
+                        }
+                    });
+                }
+                try {
+                    runBlock(0);
+                } catch (...) {
+                    errors[0] = std::current_exception();
                 }
-                TLOG(meanStev.str());
+                for (auto& w : workers)
+                    w.join();
+                // rethrow the error of the first failing block, as the single threaded computation would do
+                for (auto const& e : errors)
+                    if (e)
+                        std::rethrow_exception(e);
             }
-            */
         } // end samples
 
         //handle results...
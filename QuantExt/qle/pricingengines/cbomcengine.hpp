@@ -39,6 +39,15 @@ using namespace std;
      This class implements the waterfall structures and Monte Carlo pricing
      of the cash flow CBO.
 
+     The samples are processed in blocks of \p blockSize samples. The default times and the resulting
+     basket flows of up to \p threads blocks are generated on the calling thread, since the random
+     default model and the basket share the pool of names. If the random default model supports
+     substreams (GaussianCopulaRandomDefaultModel), each block draws its default times from the part of
+     the model's sequence starting at the block's first sample. The waterfalls of these blocks are then
+     computed in parallel, one block per thread with its own scratch buffers. The sample values are
+     aggregated in sample order, so the results do not depend on the number of threads or the block
+     size.
+
      For more information refer to the detailed QuantExt documentation.
 
      \ingroup engines
@@ -60,32 +69,59 @@ public:
         //! npvError tolerance
         double errorTolerance = 1.0e-6,
         //! Periods from valuation date for which to return loss distributions
-        std::vector<QuantLib::Period> lossDistributionPeriods = std::vector<QuantLib::Period>())
+        std::vector<QuantLib::Period> lossDistributionPeriods = std::vector<QuantLib::Period>(),
+        //! Number of threads used for the waterfall computation
+        Size threads = 1,
+        //! Number of samples per block processed by one thread
+        Size blockSize = 1000)
         : rdm_(rdm), samples_(samples), bins_(bins), errorTolerance_(errorTolerance),
-        lossDistributionPeriods_(lossDistributionPeriods) {}
+          lossDistributionPeriods_(lossDistributionPeriods), threads_(threads), blockSize_(blockSize) {
+        QL_REQUIRE(threads_ > 0, "MonteCarloCBOEngine: threads must be positive");
+        QL_REQUIRE(blockSize_ > 0, "MonteCarloCBOEngine: block size must be positive");
+    }
     void calculate() const override;
 
 private:
+    //! basket flows of one sample in the CBO currency, indexed by date
+    struct SampleFlows {
+        vector<Cash> cf, iFlows, pFlows;
+        vector<Real> basketNotional;
+    };
+    //! sample independent waterfall data, indexed by date and tranche
+    struct WaterfallData {
+        vector<Date> dates;
+        vector<vector<Real>> trancheInterestRates;
+        vector<Real> feeYearFractions;
+    };
+    //! scratch buffers for the waterfall of one sample, reused across the samples of a block
+    struct WaterfallBuffers {
+        vector<vector<Real>> trancheBalance;
+        vector<Real> trancheInterest, trancheIntAcc;
+        vector<Cash> tranche;
+    };
+
+    //! basket flows of the current default scenario of the random default model
+    void scenarioFlows(const vector<Date>& dates, SampleFlows& flows) const;
+    //! waterfall of sample \p i, writes the sample values at index \p i
+    void waterfall(Size i, const WaterfallData& data, SampleFlows& flows, WaterfallBuffers& buffers,
+                   vector<Real>& basketValue, vector<vector<Real>>& trancheValue, vector<Real>& feeValue,
+                   vector<Real>& subfeeValue) const;
+
     //! interest waterfall
-    void interestWaterfall(Size sampleIndex, Size dateIndex, const vector<Date>& dates,
-                           map<Currency, vector<Cash>>& basketFlow, map<Currency, Cash>& trancheFlow,
-                           map<Currency, vector<vector<Real>>>& balance, map<Currency, Real>& interest,
-                           map<Currency, Real>& interestAcc, Real cureAmount) const;
+    void interestWaterfall(Size dateIndex, vector<Cash>& basketFlow, Cash& trancheFlow, vector<Real>& balance,
+                           Real& interest, Real interestAcc) const;
     //! icoc interest waterfall
-    void icocInterestWaterfall(Size i, // sample index
-                               Size j, // date index
+    void icocInterestWaterfall(Size j, // date index
                                Size k, // tranche index
-                               const vector<Date>& dates, map<Currency, vector<Cash>>& iFlows,
-                               vector<map<Currency, Cash>>& tranches,
-                               vector<map<Currency, vector<vector<Real>>>>& balances, Real cureAmount) const;
+                               vector<Cash>& iFlows, vector<Cash>& tranches, vector<vector<Real>>& balances,
+                               Real cureAmount) const;
 
     //! pricipal waterfall
-    void principalWaterfall(Size sampleIndex, Size dateIndex, const vector<Date>& dates,
-                            map<Currency, vector<Cash>>& basketFlow, map<Currency, Cash>& trancheFlow,
-                            map<Currency, vector<vector<Real>>>& balance, map<Currency, Real>& interest) const;
+    void principalWaterfall(Size dateIndex, vector<Cash>& basketFlow, Cash& trancheFlow, vector<Real>& balance,
+                            Real& interest) const;
     //! icoc cure amount
-    Real icocCureAmount(Size sampleIndex, Size dateIndex, Size trancheNo, Real basketNotional, Real basketInterest,
-                        vector<map<Currency, vector<vector<Real>>>>& trancheBalances, vector<Real> trancheInterestRates,
+    Real icocCureAmount(Size dateIndex, Size trancheNo, Real basketNotional, Real basketInterest,
+                        const vector<vector<Real>>& trancheBalances, const vector<Real>& trancheInterestRates,
                         Real icRatios, Real ocRatios) const;
 
     //! Return dates on the CBO schedule that are closest to the requested \p lossDistributionPeriods
@@ -98,6 +134,9 @@ private:
 
     //! Periods from valuation date for which to return loss distributions
     std::vector<QuantLib::Period> lossDistributionPeriods_;
+
+    Size threads_;
+    Size blockSize_;
 };
 
 } // namespace QuantExt
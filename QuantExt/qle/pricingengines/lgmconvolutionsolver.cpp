@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <qle/math/fftconvolution.hpp>
 #include <qle/pricingengines/lgmconvolutionsolver.hpp>
 
 #include <ql/math/distributions/normaldistribution.hpp>
@@ -28,8 +29,8 @@ namespace QuantExt {
 */
 
 LgmConvolutionSolver::LgmConvolutionSolver(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
-                                           const Size ny, const Real sx, const Size nx)
-    : model_(model), nx_(nx) {
+                                           const Size ny, const Real sx, const Size nx, const bool useFft)
+    : model_(model), useFft_(useFft), nx_(nx) {
 
     // precompute weights
 
@@ -73,4 +74,13 @@ std::vector<Real> LgmConvolutionSolver::stateGrid(const Real t) const {
     return x;
 }
 
+bool LgmConvolutionSolver::rollbackFft(const std::vector<Real>& v, const Real t1, const Real t0,
+                                       std::vector<Real>& result) const {
+    Real dx = std::sqrt(model_->parametrization()->zeta(t1)) / static_cast<Real>(nx_);
+    Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
+    Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
+    result = fftConvolutionRollback(v, y_, w_, std, dx, dx2);
+    return true;
+}
+
 } // namespace QuantExt
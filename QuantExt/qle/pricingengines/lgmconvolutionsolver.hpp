@@ -31,12 +31,16 @@ namespace QuantExt {
 //! Numerical convolution solver for the LGM model
 /*! Reference: Hagan, Methodology for callable swaps and Bermudan
                exercise into swaptions
+
+    If useFft is true, rollbacks of Real valued grids from t1 to t0 > 0 are computed as an FFT convolution on the
+    t1 state grid followed by a linear interpolation onto the t0 state grid, see LgmConvolutionSolver2. Other value
+    types are always rolled back using the direct method.
 */
 
 class LgmConvolutionSolver {
 public:
     LgmConvolutionSolver(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
-                         const Real sx, const Size nx);
+                         const Real sx, const Size nx, const bool useFft = false);
 
     /* get grid size */
     Size gridSize() const { return 2 * mx_ + 1; }
@@ -53,7 +57,15 @@ public:
     const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model() const { return model_; }
 
 private:
+    /* fft rollback from t1 to t0 > 0, returns false if not applicable to the value type */
+    bool rollbackFft(const std::vector<Real>& v, const Real t1, const Real t0, std::vector<Real>& result) const;
+    template <typename ValueType>
+    bool rollbackFft(const std::vector<ValueType>&, const Real, const Real, std::vector<ValueType>&) const {
+        return false;
+    }
+
     QuantLib::ext::shared_ptr<LinearGaussMarkovModel> model_;
+    bool useFft_;
     int mx_, my_, nx_;
     Real h_;
     std::vector<Real> y_, w_;
@@ -86,6 +98,8 @@ std::vector<ValueType> LgmConvolutionSolver::rollback(const std::vector<ValueTyp
         return std::vector<ValueType>(2 * mx_ + 1, value);
     } else {
         std::vector<ValueType> value(2 * mx_ + 1, zero);
+        if (useFft_ && rollbackFft(v, t1, t0, value))
+            return value;
         // rollback from t1 to t0 > 0
         Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
         Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
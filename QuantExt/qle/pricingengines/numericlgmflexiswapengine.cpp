@@ -39,8 +39,9 @@ Array max(Array x, const Array& y) {
 NumericLgmFlexiSwapEngineBase::NumericLgmFlexiSwapEngineBase(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model,
                                                              const Real sy, const Size ny, const Real sx, const Size nx,
                                                              const Handle<YieldTermStructure>& discountCurve,
-                                                             const Method method, const Real singleSwaptionThreshold)
-    : LgmConvolutionSolver(model, sy, ny, sx, nx), discountCurve_(discountCurve), method_(method),
+                                                             const Method method, const Real singleSwaptionThreshold,
+                                                             const bool useFft)
+    : LgmConvolutionSolver(model, sy, ny, sx, nx, useFft), discountCurve_(discountCurve), method_(method),
       singleSwaptionThreshold_(singleSwaptionThreshold) {}
 
 Real NumericLgmFlexiSwapEngineBase::underlyingValue(const Real x, const Real t, const Date& d, const Size fltIndex,
@@ -362,8 +363,9 @@ std::pair<Real, Real> NumericLgmFlexiSwapEngineBase::calculate() const {
 NumericLgmFlexiSwapEngine::NumericLgmFlexiSwapEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model,
                                                      const Real sy, const Size ny, const Real sx, const Size nx,
                                                      const Handle<YieldTermStructure>& discountCurve,
-                                                     const Method method, const Real singleSwaptionThreshold)
-    : NumericLgmFlexiSwapEngineBase(model, sy, ny, sx, nx, discountCurve, method, singleSwaptionThreshold) {
+                                                     const Method method, const Real singleSwaptionThreshold,
+                                                     const bool useFft)
+    : NumericLgmFlexiSwapEngineBase(model, sy, ny, sx, nx, discountCurve, method, singleSwaptionThreshold, useFft) {
     registerWith(this->model());
     registerWith(discountCurve_);
 } // NumericLgmFlexiSwapEngine::NumericLgmFlexiSwapEngine
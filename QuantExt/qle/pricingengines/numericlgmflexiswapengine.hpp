@@ -59,7 +59,8 @@ public:
     NumericLgmFlexiSwapEngineBase(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
                                   const Real sx, const Size nx,
                                   const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
-                                  const Method method = Method::Automatic, const Real singleSwaptionThreshold = 20.0);
+                                  const Method method = Method::Automatic, const Real singleSwaptionThreshold = 20.0,
+                                  const bool useFft = false);
 
 protected:
     // returns option value, underlying value
@@ -101,7 +102,8 @@ public:
     NumericLgmFlexiSwapEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
                               const Real sx, const Size nx,
                               const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
-                              const Method method = Method::Automatic, const Real singleSwaptionThreshold = 20.0);
+                              const Method method = Method::Automatic, const Real singleSwaptionThreshold = 20.0,
+                              const bool useFft = false);
 
 private:
     void calculate() const override;
@@ -524,8 +524,9 @@ NumericLgmMultiLegOptionEngine::NumericLgmMultiLegOptionEngine(const QuantLib::e
                                                                const Real sy, const Size ny, const Real sx,
                                                                const Size nx,
                                                                const Handle<YieldTermStructure>& discountCurve,
-                                                               const Size americanExerciseTimeStepsPerYear)
-    : NumericLgmMultiLegOptionEngineBase(QuantLib::ext::make_shared<LgmConvolutionSolver2>(model, sy, ny, sx, nx),
+                                                               const Size americanExerciseTimeStepsPerYear,
+                                                               const bool useFft)
+    : NumericLgmMultiLegOptionEngineBase(QuantLib::ext::make_shared<LgmConvolutionSolver2>(model, sy, ny, sx, nx, useFft),
                                          discountCurve, americanExerciseTimeStepsPerYear) {
     registerWith(solver_->model());
     registerWith(discountCurve_);
@@ -563,8 +564,8 @@ void NumericLgmMultiLegOptionEngine::calculate() const {
 NumericLgmSwaptionEngine::NumericLgmSwaptionEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model,
                                                    const Real sy, const Size ny, const Real sx, const Size nx,
                                                    const Handle<YieldTermStructure>& discountCurve,
-                                                   const Size americanExerciseTimeStepsPerYear)
-    : NumericLgmMultiLegOptionEngineBase(QuantLib::ext::make_shared<LgmConvolutionSolver2>(model, sy, ny, sx, nx),
+                                                   const Size americanExerciseTimeStepsPerYear, const bool useFft)
+    : NumericLgmMultiLegOptionEngineBase(QuantLib::ext::make_shared<LgmConvolutionSolver2>(model, sy, ny, sx, nx, useFft),
                                          discountCurve, americanExerciseTimeStepsPerYear) {
     registerWith(solver_->model());
     registerWith(discountCurve_);
@@ -603,8 +604,8 @@ void NumericLgmSwaptionEngine::calculate() const {
 
 NumericLgmNonstandardSwaptionEngine::NumericLgmNonstandardSwaptionEngine(
     const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny, const Real sx, const Size nx,
-    const Handle<YieldTermStructure>& discountCurve, const Size americanExerciseTimeStepsPerYear)
-    : NumericLgmMultiLegOptionEngineBase(QuantLib::ext::make_shared<LgmConvolutionSolver2>(model, sy, ny, sx, nx),
+    const Handle<YieldTermStructure>& discountCurve, const Size americanExerciseTimeStepsPerYear, const bool useFft)
+    : NumericLgmMultiLegOptionEngineBase(QuantLib::ext::make_shared<LgmConvolutionSolver2>(model, sy, ny, sx, nx, useFft),
                                          discountCurve, americanExerciseTimeStepsPerYear) {
     registerWith(solver_->model());
     registerWith(discountCurve_);
@@ -90,7 +90,7 @@ public:
     NumericLgmMultiLegOptionEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
                                    const Real sx, const Size nx,
                                    const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
-                                   const Size americanExerciseTimeStepsPerYear = 24);
+                                   const Size americanExerciseTimeStepsPerYear = 24, const bool useFft = false);
 
     NumericLgmMultiLegOptionEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real maxTime = 50.0,
                                    const QuantLib::FdmSchemeDesc scheme = QuantLib::FdmSchemeDesc::Douglas(),
@@ -108,7 +108,7 @@ public:
     NumericLgmSwaptionEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
                              const Real sx, const Size nx,
                              const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
-                             const Size americanExerciseTimeStepsPerYear = 24);
+                             const Size americanExerciseTimeStepsPerYear = 24, const bool useFft = false);
 
     NumericLgmSwaptionEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real maxTime = 50.0,
                              const QuantLib::FdmSchemeDesc scheme = QuantLib::FdmSchemeDesc::Douglas(),
@@ -127,7 +127,7 @@ public:
     NumericLgmNonstandardSwaptionEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
                                         const Size ny, const Real sx, const Size nx,
                                         const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
-                                        const Size americanExerciseTimeStepsPerYear = 24);
+                                        const Size americanExerciseTimeStepsPerYear = 24, const bool useFft = false);
 
     NumericLgmNonstandardSwaptionEngine(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model,
                                         const Real maxTime = 50.0,
@@ -103,6 +103,7 @@
 #include <qle/indexes/escpi.hpp>
 #include <qle/indexes/fallbackiborindex.hpp>
 #include <qle/indexes/fallbackovernightindex.hpp>
+#include <qle/indexes/forecastfixingcache.hpp>
 #include <qle/indexes/formulabasedindex.hpp>
 #include <qle/indexes/frcpi.hpp>
 #include <qle/indexes/fxindex.hpp>
@@ -230,6 +231,7 @@
 #include <qle/math/deltagammavar.hpp>
 #include <qle/math/differentialevolution_mt.hpp>
 #include <qle/math/discretedistribution.hpp>
+#include <qle/math/fftconvolution.hpp>
 #include <qle/math/fillemptymatrix.hpp>
 #include <qle/math/flatextrapolation.hpp>
 #include <qle/math/flatextrapolation2d.hpp>
@@ -304,6 +306,7 @@
 #include <qle/models/fxeqoptionhelper.hpp>
 #include <qle/models/fxmodel.hpp>
 #include <qle/models/gaussian1dcrossassetadaptor.hpp>
+#include <qle/models/gaussiancopularandomdefaultmodel.hpp>
 #include <qle/models/gaussianlhplossmodel.hpp>
 #include <qle/models/homogeneouspooldef.hpp>
 #include <qle/models/hullwhitebucketing.hpp>
@@ -23,13 +23,18 @@
 #ifndef quantext_iterative_bootstrap_hpp
 #define quantext_iterative_bootstrap_hpp
 
+#include <ql/math/array.hpp>
 #include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/math/matrix.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 #include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
 #include <ql/termstructures/bootstraperror.hpp>
 #include <ql/termstructures/bootstraphelper.hpp>
 #include <ql/utilities/dataformatters.hpp>
 
+#include <atomic>
+#include <cmath>
+
 namespace QuantExt {
 
 namespace detail {
@@ -73,6 +78,13 @@ QuantLib::Real dontThrowFallback(const QuantLib::BootstrapError<Curve>& error, Q
       \c accuracy specified in the \c Curve which is useful in some situations e.g. cubic spline and optionlet
       stripping. If the \c globalAccuracy is set less than the \c accuracy in the \c Curve, the \c accuracy in the
       \c Curve is used instead.
+    - addition of a \c warmStart parameter. If it is \c true, a recalculation of an already bootstrapped curve, e.g.
+      after a quote change, first solves for all pillars at once with a chord Newton iteration that starts from the
+      previous pillar values and reuses the inverse Jacobian of the helper quote errors w.r.t. the pillar values from
+      the last recalculation. The Jacobian is recomputed by finite differences if the iteration does not converge
+      with the stored one. If it does not converge with a fresh Jacobian either, or if an iterate leaves the bounds
+      that the pillar by pillar bootstrap would use for the pillar values, the usual pillar by pillar bootstrap is
+      run.
 */
 template <class Curve> class IterativeBootstrap {
     typedef typename Curve::traits_type Traits;
@@ -91,17 +103,26 @@ public:
         \param minFactor      Factor for min value retry on each iteration if there is a failure.
         \param dontThrowSteps If \p dontThrow is \c true, this gives the number of steps to use when searching
                               for a fallback curve pillar value that gives the minimum bootstrap helper error.
+        \param warmStart      If set to \c true, recalculations of a bootstrapped curve try a Newton iteration
+                              on all pillars starting from the previous pillar values first.
     */
     IterativeBootstrap(QuantLib::Real accuracy = QuantLib::Null<QuantLib::Real>(),
                        QuantLib::Real globalAccuracy = QuantLib::Null<QuantLib::Real>(), bool dontThrow = false,
                        QuantLib::Size maxAttempts = 1, QuantLib::Real maxFactor = 2.0, QuantLib::Real minFactor = 2.0,
-                       QuantLib::Size dontThrowSteps = 10);
+                       QuantLib::Size dontThrowSteps = 10, bool warmStart = false);
 
     void setup(Curve* ts);
     void calculate() const;
 
+    /*! Number of recalculations solved by the warm start iteration. The counter is shared between copies of this
+        instance, so that it can be read from the instance passed to the curve. */
+    QuantLib::Size warmStarts() const { return *warmStarts_; }
+
 private:
     void initialize() const;
+    bool warmStartNewton(QuantLib::Real accuracy) const;
+    bool quoteErrors(const QuantLib::Array& x, QuantLib::Array& errors) const;
+    bool withinBounds() const;
     Curve* ts_;
     QuantLib::Size n_;
     QuantLib::Brent firstSolver_;
@@ -117,15 +138,20 @@ private:
     QuantLib::Real maxFactor_;
     QuantLib::Real minFactor_;
     QuantLib::Size dontThrowSteps_;
+    bool warmStart_;
+    mutable QuantLib::Matrix jacobianInverse_;
+    QuantLib::ext::shared_ptr<std::atomic<QuantLib::Size>> warmStarts_;
 };
 
 template <class Curve>
 IterativeBootstrap<Curve>::IterativeBootstrap(QuantLib::Real accuracy, QuantLib::Real globalAccuracy, bool dontThrow,
                                               QuantLib::Size maxAttempts, QuantLib::Real maxFactor,
-                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps)
+                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps,
+                                              bool warmStart)
     : ts_(0), n_(0), initialized_(false), validCurve_(false), loopRequired_(Interpolator::global),
       firstAliveHelper_(0), alive_(0), accuracy_(accuracy), globalAccuracy_(globalAccuracy), dontThrow_(dontThrow),
-      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps) {}
+      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps),
+      warmStart_(warmStart), warmStarts_(QuantLib::ext::make_shared<std::atomic<QuantLib::Size>>(0)) {}
 
 template <class Curve> void IterativeBootstrap<Curve>::setup(Curve* ts) {
     ts_ = ts;
@@ -236,6 +262,10 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
 
     QuantLib::Size maxIterations = Traits::maxIterations() - 1;
 
+    // solve for all pillars at once starting from the previous curve state, if this is possible and requested
+    if (warmStart_ && validCurve_ && ts_->data_.size() == alive_ + 1 && warmStartNewton(accuracy))
+        return;
+
     // there might be a valid curve state to use as guess
     bool validData = validCurve_;
 
@@ -363,6 +393,99 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
     validCurve_ = true;
 }
 
+template <class Curve>
+bool IterativeBootstrap<Curve>::quoteErrors(const QuantLib::Array& x, QuantLib::Array& errors) const {
+    for (QuantLib::Size i = 1; i <= alive_; ++i)
+        Traits::updateGuess(ts_->data_, x[i - 1], i);
+    ts_->interpolation_.update();
+    for (QuantLib::Size i = 1; i <= alive_; ++i) {
+        errors[i - 1] = errors_[i]->helper()->quoteError();
+        if (!std::isfinite(errors[i - 1]))
+            return false;
+    }
+    return true;
+}
+
+template <class Curve> bool IterativeBootstrap<Curve>::withinBounds() const {
+    for (QuantLib::Size i = 1; i <= alive_; ++i) {
+        QuantLib::Real x = ts_->data_[i];
+        if (x < Traits::minValueAfter(i, ts_, true, firstAliveHelper_) ||
+            x > Traits::maxValueAfter(i, ts_, true, firstAliveHelper_))
+            return false;
+    }
+    return true;
+}
+
+template <class Curve> bool IterativeBootstrap<Curve>::warmStartNewton(QuantLib::Real accuracy) const {
+
+    const QuantLib::Size maxNewtonIterations = 10;
+    std::vector<QuantLib::Real> previousData = ts_->data_;
+    QuantLib::Array start(alive_), startErrors(alive_);
+    for (QuantLib::Size i = 1; i <= alive_; ++i)
+        start[i - 1] = previousData[i];
+
+    try {
+        if (!quoteErrors(start, startErrors))
+            QL_FAIL("invalid quote errors at previous curve state");
+
+        // first attempt with the stored jacobian if there is one, second attempt with a fresh one
+        bool freshJacobian = false;
+        for (QuantLib::Size attempt = 0; attempt < 2; ++attempt) {
+
+            if (jacobianInverse_.rows() != alive_ || attempt == 1) {
+                if (freshJacobian)
+                    break;
+                QuantLib::Matrix jacobian(alive_, alive_);
+                QuantLib::Array bumped(start), bumpedErrors(alive_);
+                for (QuantLib::Size k = 0; k < alive_; ++k) {
+                    QuantLib::Real h = 1.0E-7 * std::max(1.0, std::fabs(start[k]));
+                    bumped[k] = start[k] + h;
+                    if (!quoteErrors(bumped, bumpedErrors))
+                        QL_FAIL("invalid quote errors when computing the jacobian");
+                    for (QuantLib::Size j = 0; j < alive_; ++j)
+                        jacobian[j][k] = (bumpedErrors[j] - startErrors[j]) / h;
+                    bumped[k] = start[k];
+                }
+                jacobianInverse_ = QuantLib::inverse(jacobian);
+                freshJacobian = true;
+            }
+
+            // chord iteration x_{n+1} = x_n - J^{-1} f(x_n)
+            try {
+                QuantLib::Array x(start), errors(startErrors);
+                QuantLib::Real previousMaxError = QL_MAX_REAL;
+                for (QuantLib::Size iteration = 0; iteration < maxNewtonIterations; ++iteration) {
+                    QuantLib::Array dx = jacobianInverse_ * errors;
+                    x -= dx;
+                    // leave it to the pillar by pillar bootstrap if the pillar values get out of its bounds
+                    if (!quoteErrors(x, errors) || !withinBounds())
+                        break;
+                    QuantLib::Real change = 0.0, maxError = 0.0;
+                    for (QuantLib::Size i = 0; i < alive_; ++i) {
+                        change = std::max(change, std::fabs(dx[i]));
+                        maxError = std::max(maxError, std::fabs(errors[i]));
+                    }
+                    if (change <= accuracy) {
+                        ++*warmStarts_;
+                        return true;
+                    }
+                    // stop if the iteration does not improve the quote errors
+                    if (maxError >= previousMaxError)
+                        break;
+                    previousMaxError = maxError;
+                }
+            } catch (...) {
+            }
+        }
+    } catch (...) {
+    }
+
+    // restore the previous curve state as a guess for the pillar by pillar bootstrap
+    std::copy(previousData.begin(), previousData.end(), ts_->data_.begin());
+    ts_->interpolation_.update();
+    return false;
+}
+
 } // namespace QuantExt
 
 #endif
@@ -317,6 +317,62 @@ BOOST_AUTO_TEST_CASE(testCase003) {
     BOOST_CHECK_CLOSE(sdvar, mcvar, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(testMcThreads) {
+    BOOST_TEST_MESSAGE("Testing delta-gamma MC VaR is independent of the number of threads...");
+
+    Array delta(3);
+    delta[0] = 100.0;
+    delta[1] = -50.0;
+    delta[2] = 20.0;
+    Matrix gamma(3, 3, 0.0);
+    gamma[0][0] = 40.0;
+    gamma[1][1] = -30.0;
+    gamma[0][1] = gamma[1][0] = 10.0;
+    gamma[2][2] = 5.0;
+    Matrix omega(3, 3, 0.0);
+    omega[0][0] = omega[1][1] = omega[2][2] = 0.04;
+    omega[0][1] = omega[1][0] = 0.01;
+    omega[1][2] = omega[2][1] = -0.005;
+
+    std::vector<Real> quantiles = {0.95, 0.99};
+    // the path number is not a multiple of the block size
+    const Size paths = 123457;
+    auto var1 = deltaGammaVarMc<PseudoRandom>(omega, delta, gamma, quantiles, paths, 42, NoCovarianceSalvage(), 1);
+    auto var4 = deltaGammaVarMc<PseudoRandom>(omega, delta, gamma, quantiles, paths, 42, NoCovarianceSalvage(), 4);
+    auto varLd1 =
+        deltaGammaVarMc<LowDiscrepancy>(omega, delta, gamma, quantiles, paths, 42, NoCovarianceSalvage(), 1);
+    auto varLd3 =
+        deltaGammaVarMc<LowDiscrepancy>(omega, delta, gamma, quantiles, paths, 42, NoCovarianceSalvage(), 3);
+
+    // the low discrepancy blocks are consecutive parts of one Sobol sequence, i.e. the result must be the same as
+    // for a single sequence covering all paths (PL in the eigenbasis, as in deltaGammaVarMc)
+    Matrix L = CholeskyDecomposition(omega, true);
+    Matrix lgl = transpose(L) * gamma * L;
+    SymmetricSchurDecomposition schur(0.5 * (lgl + transpose(lgl)));
+    Array d = transpose(schur.eigenvectors()) * (transpose(L) * delta);
+    LowDiscrepancy::rsg_type rsg = LowDiscrepancy::make_sequence_generator(3, 42);
+    std::vector<Real> pl(paths);
+    for (Size j = 0; j < paths; ++j) {
+        const std::vector<Real>& w = rsg.nextSequence().value;
+        pl[j] = 0.0;
+        for (Size k = 0; k < 3; ++k)
+            pl[j] += (d[k] + 0.5 * schur.eigenvalues()[k] * w[k]) * w[k];
+    }
+    std::sort(pl.begin(), pl.end(), std::greater<Real>());
+
+    for (Size i = 0; i < quantiles.size(); ++i) {
+        BOOST_TEST_MESSAGE("q=" << quantiles[i] << " var(1 thread)=" << var1[i] << " var(4 threads)=" << var4[i]
+                                << " ld var(1 thread)=" << varLd1[i] << " ld var(3 threads)=" << varLd3[i]);
+        Real saddlepoint = deltaGammaVarSaddlepoint(omega, delta, gamma, quantiles[i]);
+        BOOST_CHECK_EQUAL(var1[i], var4[i]);
+        BOOST_CHECK_CLOSE(var1[i], saddlepoint, 5.0);
+        BOOST_CHECK_EQUAL(varLd1[i], varLd3[i]);
+        BOOST_CHECK_CLOSE(varLd1[i], saddlepoint, 5.0);
+        Size k = static_cast<Size>(std::ceil(static_cast<double>(paths) * (1.0 - quantiles[i])));
+        BOOST_CHECK_CLOSE(varLd1[i], pl[k - 1], 1.0E-8);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
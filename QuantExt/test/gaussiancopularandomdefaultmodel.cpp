@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/currencies/europe.hpp>
+#include <ql/experimental/credit/onefactorgaussiancopula.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <qle/models/gaussiancopularandomdefaultmodel.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+using std::vector;
+
+namespace {
+
+struct PoolData {
+    QuantLib::ext::shared_ptr<Pool> pool = QuantLib::ext::make_shared<Pool>();
+    vector<DefaultProbKey> keys;
+    Handle<OneFactorCopula> copula;
+};
+
+// a new pool on each call, since the default models write the default times into the pool
+PoolData poolData(const Date& today) {
+    PoolData data;
+    DefaultProbKey key(vector<QuantLib::ext::shared_ptr<DefaultType>>(1, QuantLib::ext::make_shared<DefaultType>()),
+                       EURCurrency(), NoSeniority);
+    for (Size i = 0; i < 5; ++i) {
+        Handle<DefaultProbabilityTermStructure> dts(
+            QuantLib::ext::make_shared<FlatHazardRate>(today, 0.02 + 0.03 * i, Actual365Fixed()));
+        std::string name = "Name_" + std::to_string(i);
+        data.pool->add(name, Issuer(vector<Issuer::key_curve_pair>(1, {key, dts})), key);
+        data.keys.push_back(key);
+    }
+    data.copula = Handle<OneFactorCopula>(
+        QuantLib::ext::make_shared<OneFactorGaussianCopula>(Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.3))));
+    return data;
+}
+
+vector<Real> defaultTimes(const Pool& pool) {
+    vector<Real> times;
+    for (auto const& name : pool.names())
+        times.push_back(pool.getTime(name));
+    return times;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(GaussianCopulaRandomDefaultModelTest)
+
+BOOST_AUTO_TEST_CASE(testAgainstQuantLibModel) {
+    BOOST_TEST_MESSAGE("Testing gaussian copula random default model against QuantLib's model...");
+
+    Date today(5, Feb, 2016);
+    Settings::instance().evaluationDate() = today;
+    const Real accuracy = 1.0E-6, tmax = 10.0;
+
+    auto data = poolData(today);
+    GaussianCopulaRandomDefaultModel model(data.pool, data.keys, data.copula, accuracy, 42);
+    auto qlData = poolData(today);
+    GaussianRandomDefaultModel qlModel(qlData.pool, qlData.keys, qlData.copula, accuracy, 42);
+
+    Size defaults = 0;
+    for (Size k = 0; k < 1000; ++k) {
+        model.nextSequence(tmax);
+        qlModel.nextSequence(tmax);
+        auto t = defaultTimes(*data.pool);
+        auto qlt = defaultTimes(*qlData.pool);
+        for (Size j = 0; j < t.size(); ++j) {
+            BOOST_CHECK_SMALL(t[j] - qlt[j], 10.0 * accuracy);
+            if (t[j] <= tmax)
+                ++defaults;
+        }
+    }
+    // the pool contains names with and without defaults before tmax
+    BOOST_CHECK(defaults > 0 && defaults < 5000);
+}
+
+BOOST_AUTO_TEST_CASE(testSkipTo) {
+    BOOST_TEST_MESSAGE("Testing gaussian copula random default model skip ahead...");
+
+    Date today(5, Feb, 2016);
+    Settings::instance().evaluationDate() = today;
+    const Real tmax = 10.0;
+
+    for (auto s : {MersenneTwister, Sobol, Burley2020Sobol}) {
+        auto data = poolData(today);
+        GaussianCopulaRandomDefaultModel model(data.pool, data.keys, data.copula, 1.0E-6, 42, s);
+        vector<vector<Real>> reference;
+        for (Size k = 0; k < 20; ++k) {
+            model.nextSequence(tmax);
+            reference.push_back(defaultTimes(*data.pool));
+        }
+        BOOST_CHECK_EQUAL(model.nextSample(), 20);
+        for (Size k : {7, 8, 3, 19, 0}) {
+            model.skipTo(k);
+            model.nextSequence(tmax);
+            BOOST_CHECK_EQUAL(model.nextSample(), k + 1);
+            auto t = defaultTimes(*data.pool);
+            for (Size j = 0; j < t.size(); ++j)
+                BOOST_CHECK_MESSAGE(close_enough(t[j], reference[k][j]),
+                                    "sequence type " << s << ", sample " << k << ", name " << j << ": " << t[j]
+                                                     << " vs " << reference[k][j]);
+        }
+        model.reset();
+        BOOST_CHECK_EQUAL(model.nextSample(), 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
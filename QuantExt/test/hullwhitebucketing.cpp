@@ -20,9 +20,15 @@
 #include <boost/test/unit_test.hpp>
 #include <oret/datapaths.hpp>
 
+#include <qle/models/basket.hpp>
 #include <qle/models/hullwhitebucketing.hpp>
+#include <qle/models/inhomogeneouspooldef.hpp>
 
+#include <ql/currencies/europe.hpp>
 #include <ql/math/comparison.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
 #include <ql/math/integrals/all.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/experimental/credit/lossdistribution.hpp>
@@ -771,6 +777,64 @@ BOOST_AUTO_TEST_CASE(testBucketingIndex) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testInhomogeneousPoolLossDistributionMethods) {
+
+    BOOST_TEST_MESSAGE("Testing inhomogeneous pool loss model with bucketing, recursion and FFT...");
+
+    SavedSettings backup;
+    Date today(15, March, 2024);
+    Settings::instance().evaluationDate() = today;
+
+    // an inhomogeneous pool, notionals, recoveries and hazard rates vary by name
+    Size n = 25;
+    std::vector<std::string> names;
+    std::vector<Real> notionals, recoveries;
+    auto pool = QuantLib::ext::make_shared<Pool>();
+    for (Size i = 0; i < n; ++i) {
+        names.push_back("Name_" + std::to_string(i));
+        notionals.push_back(1.0 + 0.1 * static_cast<Real>(i % 7));
+        recoveries.push_back(0.2 + 0.05 * static_cast<Real>(i % 5));
+        DefaultProbKey key = NorthAmericaCorpDefaultKey(EURCurrency(), SeniorSec, Period(), 1.0);
+        Handle<DefaultProbabilityTermStructure> curve(QuantLib::ext::make_shared<FlatHazardRate>(
+            today, 0.005 + 0.001 * static_cast<Real>(i % 9), Actual365Fixed()));
+        pool->add(names.back(), Issuer({std::make_pair(key, curve)}, DefaultEventSet()), key);
+    }
+
+    typedef IHGaussPoolLossModel::LossDistributionMethod Method;
+    Handle<Quote> correlation(QuantLib::ext::make_shared<SimpleQuote>(0.3));
+    Size nBuckets = 200;
+
+    auto expectedTrancheLoss = [&](Method method, Size threads, const Date& d, Real recoveryRate) {
+        auto lm = QuantLib::ext::make_shared<GaussianConstantLossLM>(
+            correlation, recoveries, LatentModelIntegrationType::GaussianQuadrature, n,
+            GaussianCopulaPolicy::initTraits());
+        auto basket = QuantLib::ext::make_shared<QuantExt::Basket>(today, names, notionals, pool, 0.0, 0.1);
+        basket->setLossModel(
+            QuantLib::ext::make_shared<IHGaussPoolLossModel>(lm, nBuckets, 5.0, -5.0, 50, method, threads));
+        return basket->expectedTrancheLoss(d, recoveryRate);
+    };
+
+    for (auto const& d : {today + 1 * Years, today + 5 * Years}) {
+        for (auto recoveryRate : {Null<Real>(), 0.0}) {
+            Real bucketing = expectedTrancheLoss(Method::Bucketing, 1, d, recoveryRate);
+            Real recursion = expectedTrancheLoss(Method::Recursion, 1, d, recoveryRate);
+            Real fft = expectedTrancheLoss(Method::FFT, 1, d, recoveryRate);
+            BOOST_TEST_MESSAGE("date " << d << " recovery " << recoveryRate << ": bucketing " << bucketing
+                                       << " recursion " << recursion << " fft " << fft);
+            BOOST_CHECK(bucketing > 0.0);
+            // the lattice methods differ from the bucketing by the discretisation of the losses only
+            BOOST_CHECK_CLOSE(recursion, bucketing, 1.0);
+            // recursion and FFT compute the same lattice distribution
+            BOOST_CHECK_CLOSE(fft, recursion, 1.0E-6);
+            // the result does not depend on the number of threads
+            BOOST_CHECK_EQUAL(expectedTrancheLoss(Method::Recursion, 4, d, recoveryRate), recursion);
+            BOOST_CHECK_EQUAL(expectedTrancheLoss(Method::FFT, 3, d, recoveryRate), fft);
+        }
+        BOOST_CHECK(expectedTrancheLoss(Method::Recursion, 1, d, 0.0) >
+                    expectedTrancheLoss(Method::Recursion, 1, d, Null<Real>()));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
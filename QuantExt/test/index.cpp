@@ -18,10 +18,25 @@
 
 #include "toplevelfixture.hpp"
 #include <boost/test/unit_test.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/currencies/america.hpp>
+#include <ql/currencies/europe.hpp>
 #include <ql/currency.hpp>
 #include <ql/index.hpp>
+#include <ql/instruments/bond.hpp>
+#include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/calendars/unitedstates.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
+#include <qle/indexes/bondindex.hpp>
+#include <qle/indexes/commodityindex.hpp>
+#include <qle/indexes/forecastfixingcache.hpp>
+#include <qle/indexes/fxindex.hpp>
 #include <qle/indexes/ibor/brlcdi.hpp>
 #include <qle/indexes/ibor/chfsaron.hpp>
 #include <qle/indexes/ibor/chftois.hpp>
@@ -59,6 +74,7 @@
 #include <qle/indexes/ibor/thbbibor.hpp>
 #include <qle/indexes/ibor/tonar.hpp>
 #include <qle/indexes/ibor/twdtaibor.hpp>
+#include <qle/termstructures/pricecurve.hpp>
 
 using namespace QuantLib;
 using namespace QuantExt;
@@ -128,6 +144,144 @@ BOOST_AUTO_TEST_CASE(testIborIndex) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testForecastFixingCache) {
+
+    BOOST_TEST_MESSAGE("Testing forecast fixing cache of FxIndex");
+
+    Date today(15, March, 2024);
+    Settings::instance().evaluationDate() = today;
+
+    auto spot = QuantLib::ext::make_shared<SimpleQuote>(1.10);
+    auto eurRate = QuantLib::ext::make_shared<SimpleQuote>(0.02);
+    auto usdRate = QuantLib::ext::make_shared<SimpleQuote>(0.04);
+    Handle<YieldTermStructure> eurCurve(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), Handle<Quote>(eurRate), Actual365Fixed()));
+    Handle<YieldTermStructure> usdCurve(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), Handle<Quote>(usdRate), Actual365Fixed()));
+
+    FxIndex index("GENERIC", 0, EURCurrency(), USDCurrency(), NullCalendar(), Handle<Quote>(spot), eurCurve,
+                  usdCurve);
+
+    Date fixingDate = today + 1 * Years;
+    auto expected = [&spot, &eurRate, &usdRate, &today, &fixingDate]() {
+        Time t = Actual365Fixed().yearFraction(today, fixingDate);
+        return spot->value() * std::exp((usdRate->value() - eurRate->value()) * t);
+    };
+
+    Real tol = 1E-12;
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), expected(), tol);
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), expected(), tol);
+
+    // notifications from the quotes and curves invalidate the cached fixing
+    spot->setValue(1.20);
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), expected(), tol);
+    usdRate->setValue(0.05);
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), expected(), tol);
+
+    // without notifications the cache has to be invalidated explicitly
+    Real stale = index.fixing(fixingDate);
+    ObservableSettings::instance().disableUpdates(false);
+    spot->setValue(1.30);
+    ObservableSettings::instance().enableUpdates();
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), stale, tol);
+    ForecastFixingCacheSettings::instance().invalidate();
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), expected(), tol);
+
+    // with the cache switched off the forecast is computed on each call
+    ForecastFixingCacheSettings::instance().enable(false);
+    ObservableSettings::instance().disableUpdates(false);
+    spot->setValue(1.40);
+    ObservableSettings::instance().enableUpdates();
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), expected(), tol);
+    ForecastFixingCacheSettings::instance().enable(true);
+}
+
+
+BOOST_AUTO_TEST_CASE(testBondIndexForecastFixingCache) {
+
+    BOOST_TEST_MESSAGE("Testing forecast fixing cache of BondIndex");
+
+    Date today(15, March, 2024);
+    Settings::instance().evaluationDate() = today;
+
+    auto rate = QuantLib::ext::make_shared<SimpleQuote>(0.03);
+    auto hazardRate = QuantLib::ext::make_shared<SimpleQuote>(0.02);
+    Handle<YieldTermStructure> discountCurve(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), Handle<Quote>(rate), Actual365Fixed()));
+    Handle<DefaultProbabilityTermStructure> defaultCurve(
+        QuantLib::ext::make_shared<FlatHazardRate>(0, NullCalendar(), Handle<Quote>(hazardRate), Actual365Fixed()));
+
+    Schedule schedule(today, today + 5 * Years, 1 * Years, NullCalendar(), Unadjusted, Unadjusted,
+                      DateGeneration::Forward, false);
+    Leg leg = FixedRateLeg(schedule).withNotionals(100.0).withCouponRates(0.04, Actual365Fixed());
+    auto bond = QuantLib::ext::make_shared<QuantLib::Bond>(0, NullCalendar(), today, leg);
+
+    // the price is not conditional on survival, so it depends on the evaluation date via the default curve
+    BondIndex index("SECURITY", false, true, NullCalendar(), bond, discountCurve, defaultCurve,
+                    Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.4)), Handle<Quote>(),
+                    Handle<YieldTermStructure>(), false);
+
+    Date fixingDate = today + 1 * Years + 2 * Months;
+    Real tol = 1E-12;
+    Real fixing = index.fixing(fixingDate);
+    BOOST_CHECK_CLOSE(fixing, index.forecastFixing(fixingDate), tol);
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), fixing, tol);
+
+    // a quote change invalidates the cached fixing
+    rate->setValue(0.04);
+    Real updated = index.fixing(fixingDate);
+    BOOST_CHECK(std::abs(updated - fixing) > 1E-6);
+    BOOST_CHECK_CLOSE(updated, index.forecastFixing(fixingDate), tol);
+    hazardRate->setValue(0.03);
+    fixing = updated;
+    updated = index.fixing(fixingDate);
+    BOOST_CHECK(std::abs(updated - fixing) > 1E-6);
+    BOOST_CHECK_CLOSE(updated, index.forecastFixing(fixingDate), tol);
+
+    // so does a change of the evaluation date
+    Settings::instance().evaluationDate() = today + 3 * Months;
+    fixing = updated;
+    updated = index.fixing(fixingDate);
+    BOOST_CHECK(std::abs(updated - fixing) > 1E-6);
+    BOOST_CHECK_CLOSE(updated, index.forecastFixing(fixingDate), tol);
+}
+
+BOOST_AUTO_TEST_CASE(testCommodityIndexForecastFixingCache) {
+
+    BOOST_TEST_MESSAGE("Testing forecast fixing cache of CommodityIndex");
+
+    Date today(15, March, 2024);
+    Settings::instance().evaluationDate() = today;
+
+    std::vector<QuantLib::ext::shared_ptr<SimpleQuote>> quotes = {QuantLib::ext::make_shared<SimpleQuote>(60.0),
+                                                                  QuantLib::ext::make_shared<SimpleQuote>(65.0),
+                                                                  QuantLib::ext::make_shared<SimpleQuote>(75.0)};
+    std::vector<Handle<Quote>> quoteHandles(quotes.begin(), quotes.end());
+    Handle<PriceTermStructure> priceCurve(QuantLib::ext::make_shared<InterpolatedPriceCurve<Linear>>(
+        std::vector<Period>{6 * Months, 1 * Years, 2 * Years}, quoteHandles, Actual365Fixed(), USDCurrency()));
+
+    CommoditySpotIndex index("GOLD_USD", NullCalendar(), priceCurve);
+
+    Date fixingDate = today + 1 * Years + 6 * Months;
+    Real tol = 1E-12;
+    Real fixing = index.fixing(fixingDate);
+    BOOST_CHECK_CLOSE(fixing, index.forecastFixing(fixingDate), tol);
+    BOOST_CHECK_CLOSE(index.fixing(fixingDate), fixing, tol);
+
+    // a quote change invalidates the cached fixing
+    quotes[2]->setValue(80.0);
+    Real updated = index.fixing(fixingDate);
+    BOOST_CHECK(std::abs(updated - fixing) > 1E-6);
+    BOOST_CHECK_CLOSE(updated, index.forecastFixing(fixingDate), tol);
+
+    // so does a change of the evaluation date
+    Settings::instance().evaluationDate() = today + 3 * Months;
+    fixing = updated;
+    updated = index.fixing(fixingDate);
+    BOOST_CHECK(std::abs(updated - fixing) > 1E-6);
+    BOOST_CHECK_CLOSE(updated, index.forecastFixing(fixingDate), tol);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,178 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/math/interpolations/cubicinterpolation.hpp>
+#include <ql/math/interpolations/loglinearinterpolation.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/piecewisedefaultcurve.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+#include <qle/termstructures/iterativebootstrap.hpp>
+#include <qle/termstructures/probabilitytraits.hpp>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using std::vector;
+
+namespace {
+
+struct CurveQuotes {
+    CurveQuotes() {
+        vector<Real> depositRates = {0.0300, 0.0310, 0.0320};
+        vector<Period> depositTenors = {1 * Months, 3 * Months, 6 * Months};
+        vector<Real> swapRates = {0.0330, 0.0340, 0.0355, 0.0365, 0.0372, 0.0380, 0.0390};
+        vector<Period> swapTenors = {2 * Years, 3 * Years, 5 * Years, 7 * Years, 10 * Years, 15 * Years, 30 * Years};
+        auto index = QuantLib::ext::make_shared<Euribor6M>();
+        for (Size i = 0; i < depositRates.size(); ++i) {
+            quotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(depositRates[i]));
+            helpers.push_back(QuantLib::ext::make_shared<DepositRateHelper>(
+                Handle<Quote>(quotes.back()), depositTenors[i], 2, TARGET(), ModifiedFollowing, false, Actual360()));
+        }
+        for (Size i = 0; i < swapRates.size(); ++i) {
+            quotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(swapRates[i]));
+            helpers.push_back(QuantLib::ext::make_shared<SwapRateHelper>(Handle<Quote>(quotes.back()), swapTenors[i],
+                                                                         TARGET(), Annual, ModifiedFollowing,
+                                                                         Thirty360(Thirty360::BondBasis), index));
+        }
+    }
+    vector<QuantLib::ext::shared_ptr<SimpleQuote>> quotes;
+    vector<QuantLib::ext::shared_ptr<RateHelper>> helpers;
+};
+
+// bootstraps the same curve with and without warm start and checks that they agree after quote changes
+template <class Traits, class Interpolator> void testWarmStart() {
+
+    typedef PiecewiseYieldCurve<Traits, Interpolator, QuantExt::IterativeBootstrap> Curve;
+    Date today = Settings::instance().evaluationDate();
+    CurveQuotes coldData, warmData;
+    auto coldCurve = QuantLib::ext::make_shared<Curve>(
+        today, coldData.helpers, Actual365Fixed(), Interpolator(),
+        typename Curve::bootstrap_type(1.0E-12, Null<Real>(), false, 5, 2.0, 2.0, 10, false));
+    typename Curve::bootstrap_type warmBootstrap(1.0E-12, Null<Real>(), false, 5, 2.0, 2.0, 10, true);
+    auto warmCurve = QuantLib::ext::make_shared<Curve>(today, warmData.helpers, Actual365Fixed(), Interpolator(),
+                                                       warmBootstrap);
+
+    vector<Real> shifts = {0.0, 0.0001, 0.0001, -0.0005, 0.0025, 0.0001};
+    for (Size k = 0; k < shifts.size(); ++k) {
+        Size warmStarts = warmBootstrap.warmStarts();
+        for (Size i = 0; i < coldData.quotes.size(); ++i) {
+            coldData.quotes[i]->setValue(coldData.quotes[i]->value() + shifts[k]);
+            warmData.quotes[i]->setValue(warmData.quotes[i]->value() + shifts[k]);
+        }
+        for (Size i = 1; i <= 40; ++i) {
+            Date d = today + static_cast<Integer>(9 * i) * Months;
+            BOOST_CHECK_CLOSE(warmCurve->discount(d), coldCurve->discount(d), 1.0E-8);
+        }
+        // the warm started curve reprices its helpers
+        for (Size i = 0; i < warmData.helpers.size(); ++i) {
+            BOOST_CHECK_SMALL(warmData.helpers[i]->quoteError(), 1.0E-10);
+        }
+        // the first calculation is a full bootstrap, the small shifts are solved by the warm start iteration
+        if (k == 0)
+            BOOST_CHECK_EQUAL(warmBootstrap.warmStarts(), Size(0));
+        else if (std::fabs(shifts[k]) <= 0.0001)
+            BOOST_CHECK_EQUAL(warmBootstrap.warmStarts(), warmStarts + 1);
+    }
+}
+
+// quotes the average hazard rate up to the maturity, i.e. -log(S(T)) / T
+class AverageHazardRateHelper : public BootstrapHelper<DefaultProbabilityTermStructure> {
+public:
+    AverageHazardRateHelper(const Handle<Quote>& quote, const Date& maturity)
+        : BootstrapHelper<DefaultProbabilityTermStructure>(quote) {
+        earliestDate_ = maturity;
+        latestDate_ = maturity;
+        pillarDate_ = maturity;
+    }
+    Real impliedQuote() const override {
+        return -std::log(termStructure_->survivalProbability(latestDate_)) /
+               termStructure_->timeFromReference(latestDate_);
+    }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(IterativeBootstrapTest)
+
+BOOST_AUTO_TEST_CASE(testWarmStartLocalInterpolation) {
+    BOOST_TEST_MESSAGE("Testing warm start bootstrap of a discount curve with log-linear interpolation");
+    Settings::instance().evaluationDate() = Date(15, March, 2024);
+    testWarmStart<Discount, LogLinear>();
+}
+
+BOOST_AUTO_TEST_CASE(testWarmStartGlobalInterpolation) {
+    BOOST_TEST_MESSAGE("Testing warm start bootstrap of a zero curve with cubic interpolation");
+    Settings::instance().evaluationDate() = Date(15, March, 2024);
+    testWarmStart<ZeroYield, Cubic>();
+}
+
+BOOST_AUTO_TEST_CASE(testWarmStartBounds) {
+
+    BOOST_TEST_MESSAGE("Testing warm start bootstrap of a survival probability curve respects the pillar bounds");
+
+    // as for CDS curves that do not allow negative hazard rates, the survival probability can not increase
+    typedef PiecewiseDefaultCurve<QuantExt::SurvivalProbability, LogLinear, QuantExt::IterativeBootstrap> Curve;
+    Date today = Date(15, March, 2024);
+    Settings::instance().evaluationDate() = today;
+
+    vector<Real> rates = {0.0200, 0.0150, 0.0130, 0.0120};
+    vector<QuantLib::ext::shared_ptr<SimpleQuote>> coldQuotes, warmQuotes;
+    vector<QuantLib::ext::shared_ptr<BootstrapHelper<DefaultProbabilityTermStructure>>> coldHelpers, warmHelpers;
+    for (Size i = 0; i < rates.size(); ++i) {
+        Date maturity = today + static_cast<Integer>(i + 1) * Years;
+        coldQuotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(rates[i]));
+        warmQuotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(rates[i]));
+        coldHelpers.push_back(
+            QuantLib::ext::make_shared<AverageHazardRateHelper>(Handle<Quote>(coldQuotes.back()), maturity));
+        warmHelpers.push_back(
+            QuantLib::ext::make_shared<AverageHazardRateHelper>(Handle<Quote>(warmQuotes.back()), maturity));
+    }
+    Curve::bootstrap_type coldBootstrap(1.0E-12, Null<Real>(), true, 1, 1.0, 2.0, 100, false);
+    Curve::bootstrap_type warmBootstrap(1.0E-12, Null<Real>(), true, 1, 1.0, 2.0, 100, true);
+    Curve coldCurve(today, coldHelpers, Actual365Fixed(), LogLinear(), coldBootstrap);
+    Curve warmCurve(today, warmHelpers, Actual365Fixed(), LogLinear(), warmBootstrap);
+
+    // a small shift is solved by the warm start iteration, the last one implies a negative forward hazard rate
+    // between the first two pillars which is not within the bounds, i.e. it is left to the pillar by pillar bootstrap
+    vector<Real> shifts = {0.0, 0.0005, 0.0125};
+    vector<Size> expectedWarmStarts = {0, 1, 1};
+    for (Size k = 0; k < shifts.size(); ++k) {
+        coldQuotes[0]->setValue(coldQuotes[0]->value() + shifts[k]);
+        warmQuotes[0]->setValue(warmQuotes[0]->value() + shifts[k]);
+        for (Size i = 1; i <= 16; ++i) {
+            Date d = today + static_cast<Integer>(3 * i) * Months;
+            BOOST_CHECK_CLOSE(warmCurve.survivalProbability(d), coldCurve.survivalProbability(d), 1.0E-8);
+        }
+        for (Size i = 1; i < warmCurve.data().size(); ++i)
+            BOOST_CHECK(warmCurve.data()[i] <= warmCurve.data()[i - 1]);
+        BOOST_CHECK_EQUAL(warmBootstrap.warmStarts(), expectedWarmStarts[k]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
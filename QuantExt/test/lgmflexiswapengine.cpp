@@ -412,6 +412,52 @@ BOOST_AUTO_TEST_CASE(testDeterministicCase) {
 
 } // testDeterministicCase
 
+BOOST_AUTO_TEST_CASE(testFftRollback) {
+
+    BOOST_TEST_MESSAGE("Testing LGM convolution engines with FFT rollback against direct rollback...");
+
+    // vanilla bermudan swaption
+
+    QuantLib::ext::shared_ptr<Exercise> exercise = QuantLib::ext::make_shared<BermudanExercise>(exerciseDates, false);
+    QuantLib::ext::shared_ptr<Swaption> swaption = QuantLib::ext::make_shared<Swaption>(vanillaSwap, exercise);
+
+    swaption->setPricingEngine(QuantLib::ext::make_shared<NumericLgmSwaptionEngine>(lgm, 7.0, 16, 7.0, 32, yts));
+    Real swaptionNpv = swaption->NPV();
+
+    swaption->setPricingEngine(
+        QuantLib::ext::make_shared<NumericLgmSwaptionEngine>(lgm, 7.0, 16, 7.0, 32, yts, 24, true));
+    Real swaptionNpvFft = swaption->NPV();
+
+    BOOST_TEST_MESSAGE("swaption npv direct = " << swaptionNpv << ", fft = " << swaptionNpvFft);
+
+    // flexi swap (rolls back both Real and Array values)
+
+    Size nFixed = fixedSchedule.size() - 1, nFloat = floatingSchedule.size() - 1;
+    QuantLib::ext::shared_ptr<FlexiSwap> flexiSwap = QuantLib::ext::make_shared<FlexiSwap>(
+        VanillaSwap::Payer, std::vector<Real>(nFixed, nominal), std::vector<Real>(nFloat, nominal), fixedSchedule,
+        std::vector<Real>(nFixed, strike), Thirty360(Thirty360::BondBasis), floatingSchedule, euribor6m,
+        std::vector<Real>(nFloat, 1.0), std::vector<Real>(nFloat, 0.0), std::vector<Real>(nFloat, Null<Real>()),
+        std::vector<Real>(nFloat, Null<Real>()), Actual360(), std::vector<Real>(nFixed, 0.0), Position::Long);
+
+    flexiSwap->setPricingEngine(QuantLib::ext::make_shared<NumericLgmFlexiSwapEngine>(
+        lgm, 7.0, 16, 7.0, 32, yts, QuantExt::NumericLgmFlexiSwapEngine::Method::SingleSwaptions));
+    Real flexiNpv = flexiSwap->NPV();
+    flexiSwap->setPricingEngine(QuantLib::ext::make_shared<NumericLgmFlexiSwapEngine>(
+        lgm, 7.0, 16, 7.0, 32, yts, QuantExt::NumericLgmFlexiSwapEngine::Method::SingleSwaptions, 20.0, true));
+    Real flexiNpvFft = flexiSwap->NPV();
+
+    BOOST_TEST_MESSAGE("flexi swap npv direct = " << flexiNpv << ", fft = " << flexiNpvFft);
+
+    // the fft rollback adds one linear interpolation per step, the difference should be well below the
+    // discretisation error of the method
+
+    Real tol = 1E-5 * nominal; // 0.1 bp on nominal
+
+    BOOST_CHECK_SMALL(std::abs(swaptionNpvFft - swaptionNpv), tol);
+    BOOST_CHECK_SMALL(std::abs(flexiNpvFft - flexiNpv), tol);
+
+} // testFftRollback
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/math/matrix.hpp>
+#include <ql/processes/blackscholesprocess.hpp>
+#include <ql/processes/stochasticprocessarray.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/methods/multipathvariategenerator.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+using std::vector;
+
+namespace {
+
+QuantLib::ext::shared_ptr<StochasticProcess1D> blackScholesProcess(const Real spot, const Real vol) {
+    Handle<YieldTermStructure> rate(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    return QuantLib::ext::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(spot)), rate, rate,
+        Handle<BlackVolTermStructure>(
+            QuantLib::ext::make_shared<BlackConstantVol>(0, NullCalendar(), vol, Actual365Fixed())));
+}
+
+const vector<SequenceType> sequenceTypes = {MersenneTwister, MersenneTwisterAntithetic, Sobol,
+                                            Burley2020Sobol, SobolBrownianBridge, Burley2020SobolBrownianBridge};
+
+void checkSamePath(const MultiPath& p, const MultiPath& q, const SequenceType s, const Size k) {
+    BOOST_REQUIRE_EQUAL(p.assetNumber(), q.assetNumber());
+    for (Size j = 0; j < p.assetNumber(); ++j) {
+        for (Size i = 0; i < p.pathSize(); ++i) {
+            BOOST_CHECK_MESSAGE(close_enough(p[j][i], q[j][i]), "sequence type " << s << ", path " << k
+                                                                                   << ", asset " << j << ", step " << i
+                                                                                   << ": " << p[j][i] << " vs "
+                                                                                   << q[j][i]);
+        }
+    }
+}
+
+void testSkipTo(const QuantLib::ext::shared_ptr<StochasticProcess>& process) {
+    TimeGrid grid(5.0, 10);
+    const Size nPaths = 12;
+    for (auto s : sequenceTypes) {
+        auto reference = makeMultiPathGenerator(s, process, grid, 42);
+        vector<MultiPath> paths;
+        for (Size k = 0; k < nPaths; ++k)
+            paths.push_back(reference->next().value);
+
+        // jump to single paths, also backwards
+        auto generator = makeMultiPathGenerator(s, process, grid, 42);
+        for (Size k : {7, 0, 3, 11, 4}) {
+            generator->skipTo(k);
+            checkSamePath(generator->next().value, paths[k], s, k);
+        }
+
+        // substreams for disjoint ranges of paths reproduce the single generator, also after a reset
+        for (Size firstPath : {0, 5, 8}) {
+            auto substream = makeMultiPathGenerator(s, process, grid, 42, SobolBrownianGenerator::Steps,
+                                                    SobolRsg::JoeKuoD7, firstPath);
+            for (Size pass = 0; pass < 2; ++pass) {
+                for (Size k = firstPath; k < nPaths; ++k)
+                    checkSamePath(substream->next().value, paths[k], s, k);
+                substream->reset();
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MultiPathGeneratorTest)
+
+BOOST_AUTO_TEST_CASE(testSkipTo1d) {
+    BOOST_TEST_MESSAGE("Testing path generator skip ahead and substreams for a one dimensional process");
+    testSkipTo(blackScholesProcess(100.0, 0.20));
+}
+
+BOOST_AUTO_TEST_CASE(testSkipToMultiDimensional) {
+    BOOST_TEST_MESSAGE("Testing path generator skip ahead and substreams for a multi dimensional process");
+    Matrix correlation(2, 2, 0.5);
+    correlation[0][0] = correlation[1][1] = 1.0;
+    auto process = QuantLib::ext::make_shared<StochasticProcessArray>(
+        vector<QuantLib::ext::shared_ptr<StochasticProcess1D>>{blackScholesProcess(100.0, 0.20),
+                                                               blackScholesProcess(50.0, 0.30)},
+        correlation);
+    testSkipTo(process);
+}
+
+BOOST_AUTO_TEST_CASE(testVariateGeneratorSkipTo) {
+    BOOST_TEST_MESSAGE("Testing path variate generator skip ahead");
+    const Size dimension = 3, timeSteps = 8, nPaths = 10;
+    for (auto s : sequenceTypes) {
+        auto reference = makeMultiPathVariateGenerator(s, dimension, timeSteps, 42);
+        vector<vector<Array>> variates;
+        for (Size k = 0; k < nPaths; ++k)
+            variates.push_back(reference->next().value);
+        auto generator = makeMultiPathVariateGenerator(s, dimension, timeSteps, 42);
+        for (Size k : {5, 0, 9, 2}) {
+            generator->skipTo(k);
+            auto v = generator->next().value;
+            for (Size i = 0; i < timeSteps; ++i)
+                for (Size j = 0; j < dimension; ++j)
+                    BOOST_CHECK_MESSAGE(close_enough(v[i][j], variates[k][i][j]),
+                                        "sequence type " << s << ", path " << k << ", step " << i << ", factor "
+                                                         << j << ": " << v[i][j] << " vs " << variates[k][i][j]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()